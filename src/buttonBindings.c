@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Button to action bindings functions
+ * buttonBindings.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "buttonBindings.h"
+
+// Button names, button n first
+static const char *buttonNames[BUTTON_TRANSITIONS_MAX] =
+{
+	"ALL", "TEAM", "CHANNEL_1", "CHANNEL_2", "CHANNEL_3", "CHANNEL_4", "COMMAND", "MUTE"
+};
+
+static const char *edgeNames[buttonEdgeCount] =
+{
+	"PRESS",
+	"RELEASE",
+	"DOWN",
+	"UP"
+};
+
+static const char *actionNames[buttonActionTypeCount] =
+{
+	"mute_input",
+	"unmute_input",
+	"mute_output",
+	"unmute_output",
+	"away",
+	"back",
+	"bookmark"
+};
+
+static const char *skipBlanks(const char *cursor)
+{
+	while (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')
+		cursor++;
+
+	return cursor;
+}
+
+// Gets the index of the name starting the cursor in a table, -1 if none : the longest name followed
+// by a character that can't continue a name matches (CHANNEL_1 and not CHANNEL_ of a longer name)
+static int parseName(const char **cursor, const char **names, int nameCount)
+{
+	int index, found = -1;
+	size_t foundLength = 0;
+
+	for (index = 0; index < nameCount; index++)
+	{
+		size_t length = strlen(names[index]);
+		char next = (*cursor)[length];
+
+		if (length > foundLength && strncmp(*cursor, names[index], length) == 0
+			&& !((next >= 'A' && next <= 'Z') || (next >= 'a' && next <= 'z') || (next >= '0' && next <= '9') || next == '_'))
+		{
+			found = index;
+			foundLength = length;
+		}
+	}
+
+	*cursor += foundLength;
+	return found;
+}
+
+// Skips the event prefix starting the cursor, followed by '_'
+static BOOL parsePrefix(const char **cursor, const char *prefix)
+{
+	size_t length = strlen(prefix);
+
+	if (strncmp(*cursor, prefix, length) != 0 || (*cursor)[length] != '_')
+		return FALSE;
+
+	*cursor += length + 1;
+	return TRUE;
+}
+
+// Gets the buttons of an event, one or more names separated by '+'
+static BOOL parseButtons(const char **cursor, byte *buttons)
+{
+	*buttons = 0;
+	for (;;)
+	{
+		int button = parseName(cursor, buttonNames, BUTTON_TRANSITIONS_MAX);
+
+		if (button < 0 || (*buttons & (1 << button)))
+			return FALSE;
+
+		*buttons |= (byte) (1 << button);
+		if (**cursor != '+')
+			return TRUE;
+		(*cursor)++;
+	}
+}
+
+// Gets the event code of a button event or a gesture, its prefix followed by its buttons
+static BOOL parseEvent(const char **cursor, unsigned int *eventCode, byte *buttons)
+{
+	int edge, type = -1;
+	byte bit;
+
+	for (edge = 0; edge < buttonEdgeCount && !parsePrefix(cursor, edgeNames[edge]); edge++)
+		;
+	if (edge == buttonEdgeCount)
+	{
+		edge = -1;
+		for (type = 0; type < gestureTypeCount && !parsePrefix(cursor, getGestureTypeName((enum GestureType) type)); type++)
+			;
+		if (type == gestureTypeCount)
+			return FALSE;
+	}
+
+	if (!parseButtons(cursor, buttons))
+		return FALSE;
+
+	// A chord is made of several buttons, the other events of one
+	bit = (byte) (*buttons & -*buttons);
+	if (type == gestureChord ? bit == *buttons : bit != *buttons)
+		return FALSE;
+
+	if (edge >= 0)
+	{
+		int button = 0;
+
+		while (!(bit & (1 << button)))
+			button++;
+		*eventCode = getButtonEventCode((enum ButtonEdge) edge, button);
+	}
+	else
+	{
+		*eventCode = getGestureEventCode((enum GestureType) type, *buttons);
+	}
+
+	return TRUE;
+}
+
+// Gets the modifiers of a binding : buttons held (+) or released (-), other than the ones of its event
+static BOOL parseModifiers(const char **cursor, byte eventButtons, ButtonBinding *binding)
+{
+	binding->modifierMask = 0;
+	binding->modifierState = 0;
+	if (**cursor != '/')
+		return TRUE;
+	(*cursor)++;
+
+	do
+	{
+		BOOL held = **cursor == '+';
+		int button;
+
+		if (**cursor != '+' && **cursor != '-')
+			return FALSE;
+		(*cursor)++;
+
+		button = parseName(cursor, buttonNames, BUTTON_TRANSITIONS_MAX);
+		if (button < 0 || ((eventButtons | binding->modifierMask) & (1 << button)))
+			return FALSE;
+
+		binding->modifierMask |= (byte) (1 << button);
+		if (held)
+			binding->modifierState |= (byte) (1 << button);
+	} while (**cursor == '+' || **cursor == '-');
+
+	return TRUE;
+}
+
+// Gets an action and its argument, up to the next action or binding
+static BOOL parseAction(const char **cursor, ButtonAction *action)
+{
+	const char *end;
+	size_t length;
+	int type = parseName(cursor, actionNames, buttonActionTypeCount);
+
+	if (type < 0)
+		return FALSE;
+
+	action->type = (enum ButtonActionType) type;
+	action->argument[0] = '\0';
+	*cursor = skipBlanks(*cursor);
+
+	// The bookmark label only, up to the next separator without the blanks around it
+	if ((**cursor == ':') != (type == actionConnectBookmark))
+		return FALSE;
+	if (**cursor != ':')
+		return TRUE;
+
+	*cursor = skipBlanks(*cursor + 1);
+	end = *cursor + strcspn(*cursor, ",;\n");
+	length = (size_t) (end - *cursor);
+	while (length > 0 && ((*cursor)[length - 1] == ' ' || (*cursor)[length - 1] == '\t' || (*cursor)[length - 1] == '\r'))
+		length--;
+
+	if (length == 0 || length >= BUTTON_ACTION_ARGUMENT_SIZE)
+		return FALSE;
+
+	memcpy(action->argument, *cursor, length);
+	action->argument[length] = '\0';
+	*cursor = end;
+	return TRUE;
+}
+
+BOOL parseButtonBindings(const char *setting, ButtonBindings *bindings)
+{
+	// Bindings in the order of the setting, compiled by event code once all parsed
+	ButtonBinding parsed[BUTTON_BINDINGS_MAX];
+	unsigned short eventCodes[BUTTON_BINDINGS_MAX];
+	ButtonBindings compiled;
+	const char *cursor = setting;
+	unsigned int code, index;
+
+	memset(&compiled, 0, sizeof(compiled));
+	for (;;)
+	{
+		ButtonBinding *binding = &parsed[compiled.bindingCount];
+		unsigned int eventCode;
+		byte buttons;
+
+		cursor = skipBlanks(cursor);
+		if (*cursor == ';' || *cursor == '\n')
+		{
+			cursor++;
+			continue;
+		}
+		if (*cursor == '\0')
+			break;
+
+		if (compiled.bindingCount == BUTTON_BINDINGS_MAX || !parseEvent(&cursor, &eventCode, &buttons)
+			|| !parseModifiers(&cursor, buttons, binding))
+			return FALSE;
+
+		cursor = skipBlanks(cursor);
+		if (*cursor != '=')
+			return FALSE;
+
+		binding->firstAction = (unsigned short) compiled.actionCount;
+		do
+		{
+			if (compiled.actionCount == BUTTON_ACTIONS_MAX)
+				return FALSE;
+
+			cursor = skipBlanks(cursor + 1);
+			if (!parseAction(&cursor, &compiled.actions[compiled.actionCount++]))
+				return FALSE;
+
+			cursor = skipBlanks(cursor);
+		} while (*cursor == ',');
+
+		if (*cursor != ';' && *cursor != '\n' && *cursor != '\0')
+			return FALSE;
+
+		binding->actionCount = (unsigned short) (compiled.actionCount - binding->firstAction);
+		eventCodes[compiled.bindingCount++] = (unsigned short) eventCode;
+	}
+
+	// Counting sort by event code, the bindings of an event keep their order
+	for (index = 0; index < compiled.bindingCount; index++)
+		compiled.dispatch[eventCodes[index] + 1]++;
+	for (code = 0; code < BINDING_EVENT_CODES; code++)
+		compiled.dispatch[code + 1] += compiled.dispatch[code];
+	for (code = 0; code < BINDING_EVENT_CODES; code++)
+	{
+		unsigned short position = compiled.dispatch[code];
+
+		for (index = 0; index < compiled.bindingCount; index++)
+		{
+			if (eventCodes[index] == code)
+				compiled.bindings[position++] = parsed[index];
+		}
+	}
+
+	*bindings = compiled;
+	return TRUE;
+}
+
+unsigned int getButtonEventCode(enum ButtonEdge edge, int button)
+{
+	return (unsigned int) edge * BUTTON_TRANSITIONS_MAX + (unsigned int) button;
+}
+
+unsigned int getGestureEventCode(enum GestureType type, byte buttons)
+{
+	return BUTTON_EVENT_CODES + (unsigned int) type * 256 + buttons;
+}
+
+const ButtonBinding *getEventBindings(const ButtonBindings *bindings, unsigned int eventCode, unsigned int *count)
+{
+	*count = eventCode < BINDING_EVENT_CODES ? (unsigned int) (bindings->dispatch[eventCode + 1] - bindings->dispatch[eventCode]) : 0;
+	return *count == 0 ? NULL : &bindings->bindings[bindings->dispatch[eventCode]];
+}
+
+BOOL matchesBindingModifiers(const ButtonBinding *binding, byte state)
+{
+	return (state & binding->modifierMask) == binding->modifierState;
+}
+
+const char *getBindingButtonName(int button)
+{
+	return button >= 0 && button < BUTTON_TRANSITIONS_MAX ? buttonNames[button] : "UNKNOWN";
+}
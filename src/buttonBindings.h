@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Button to action bindings functions header
+ * buttonBindings.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUTTONBINDINGS_H
+#define BUTTONBINDINGS_H
+
+#include "buttonTransitions.h"
+#include "gestureRecognizer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Environment variable holding the bindings replacing the default ones, see parseButtonBindings
+#define BINDINGS_VARIABLE "GAMEVOICE_BINDINGS"
+
+// Bindings without any setting : the microphone and sound buttons mute the input and the output,
+// the team and all buttons connect to the bookmarks of the same name, unless muted
+#define DEFAULT_BUTTON_BINDINGS "DOWN_MUTE=mute_input;UP_MUTE=unmute_input;" \
+	"DOWN_COMMAND/-MUTE=mute_output;UP_COMMAND/-MUTE=unmute_output;" \
+	"PRESS_TEAM/-MUTE-COMMAND=bookmark:TEAM;PRESS_ALL/-MUTE-COMMAND=bookmark:ALL"
+
+// Bindings and actions kept by a table, and length of an action argument (bookmark label)
+#define BUTTON_BINDINGS_MAX 64
+#define BUTTON_ACTIONS_MAX 128
+#define BUTTON_ACTION_ARGUMENT_SIZE 64
+
+// Button events bound : the press and the release of a button, and its state (down or up) on every command
+enum ButtonEdge {buttonPress, buttonRelease, buttonDown, buttonUp, buttonEdgeCount};
+
+// Event codes : the button events of every button, then the gestures of every button combination
+#define BUTTON_EVENT_CODES (buttonEdgeCount * BUTTON_TRANSITIONS_MAX)
+#define BINDING_EVENT_CODES (BUTTON_EVENT_CODES + gestureTypeCount * 256)
+
+// Action run by a binding, the TS3 client side is up to the caller
+enum ButtonActionType
+{
+	actionMuteInput,
+	actionUnmuteInput,
+	actionMuteOutput,
+	actionUnmuteOutput,
+	actionAway,				// Away on every server
+	actionBack,				// Back on every server
+	actionConnectBookmark,	// Connect to the bookmark labelled by the argument
+	buttonActionTypeCount
+};
+
+typedef struct ButtonAction
+{
+	enum ButtonActionType type;
+	char argument[BUTTON_ACTION_ARGUMENT_SIZE];
+} ButtonAction;
+
+// Binding of an event : run while the buttons of the modifier mask are in the modifier state,
+// its actions are actions[firstAction] to actions[firstAction + actionCount - 1] of the table
+typedef struct ButtonBinding
+{
+	byte modifierMask;
+	byte modifierState;
+	unsigned short firstAction;
+	unsigned short actionCount;
+} ButtonBinding;
+
+// Bindings compiled by event code : the bindings of an event code are bindings[dispatch[code]]
+// to bindings[dispatch[code + 1] - 1], in the order of the setting. No string is looked at
+// once compiled, an event gets its bindings with two array reads.
+typedef struct ButtonBindings
+{
+	unsigned short dispatch[BINDING_EVENT_CODES + 1];
+	unsigned int bindingCount;
+	unsigned int actionCount;
+	ButtonBinding bindings[BUTTON_BINDINGS_MAX];
+	ButtonAction actions[BUTTON_ACTIONS_MAX];
+} ButtonBindings;
+
+/* Parses and compiles bindings, separated by semicolons or new lines : <event>[/<modifiers>]=<action>[,<action>...]
+ * The event is a button event, PRESS_, RELEASE_, DOWN_ or UP_ followed by a button name (DOWN_MUTE),
+ * or a gesture named like its key identifier (TAP_TEAM, CHORD_ALL+TEAM). The modifiers are the other buttons
+ * held (+) or released (-) for the binding to run (PRESS_TEAM/+MUTE-COMMAND). The actions are mute_input,
+ * unmute_input, mute_output, unmute_output, away, back and bookmark:<label>. Blanks around the elements are skipped.
+ * Returns FALSE, leaving the bindings alone, if the setting is malformed or exceeds the table.
+ */
+BOOL parseButtonBindings(const char *setting, ButtonBindings *bindings);
+
+/* Gets the event code of a button event, or of a gesture of a button combination.
+ */
+unsigned int getButtonEventCode(enum ButtonEdge edge, int button);
+unsigned int getGestureEventCode(enum GestureType type, byte buttons);
+
+/* Gets the bindings of an event code and their count. Constant time, no string compare.
+ */
+const ButtonBinding *getEventBindings(const ButtonBindings *bindings, unsigned int eventCode, unsigned int *count);
+
+/* Determines whether a binding runs with a state of the button register (its modifiers).
+ */
+BOOL matchesBindingModifiers(const ButtonBinding *binding, byte state);
+
+/* Gets the name of a button (bit n of the register) in the bindings and the gesture key identifiers.
+ */
+const char *getBindingButtonName(int button);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Button debounce functions
+ * buttonDebouncer.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include "stdafx.h"
+#include "buttonDebouncer.h"
+
+BOOL parseDebounceWindows(const char *setting, unsigned long long *windows)
+{
+	unsigned long long parsed[BUTTON_TRANSITIONS_MAX];
+	const char *cursor = setting;
+	char *end;
+	int button, count = 0;
+
+	do
+	{
+		long window = strtol(cursor, &end, 10);
+
+		if (end == cursor || window < 0 || window > 1000 || count == BUTTON_TRANSITIONS_MAX)
+			return FALSE;
+
+		parsed[count++] = (unsigned long long) window * 1000000ULL;
+		cursor = end + 1;
+	} while (*end == ',');
+
+	if (*end != '\0' || (count != 1 && count != BUTTON_TRANSITIONS_MAX))
+		return FALSE;
+
+	for (button = 0; button < BUTTON_TRANSITIONS_MAX; button++)
+		windows[button] = parsed[count == 1 ? 0 : button];
+
+	return TRUE;
+}
+
+void initButtonDebouncer(ButtonDebouncer *debouncer, const unsigned long long *windows, byte state)
+{
+	memcpy(debouncer->windows, windows, sizeof(debouncer->windows));
+	memset(debouncer->lockedUntil, 0, sizeof(debouncer->lockedUntil));
+	debouncer->state = state;
+	debouncer->rawState = state;
+}
+
+byte debounceButtons(ButtonDebouncer *debouncer, byte rawState, unsigned long long time, int *filtered)
+{
+	ButtonTransitions transitions = getButtonTransitions(debouncer->state, rawState);
+	byte accepted = 0;
+	int transition;
+
+	debouncer->rawState = rawState;
+	for (transition = 0; transition < transitions.count; transition++)
+	{
+		int button = getTransitionButton(&transitions, transition);
+
+		if (time < debouncer->lockedUntil[button])
+		{
+			if (filtered != NULL)
+				(*filtered)++;
+			continue;
+		}
+
+		accepted |= (byte) (1 << button);
+		debouncer->lockedUntil[button] = time + debouncer->windows[button];
+	}
+
+	debouncer->state ^= accepted;
+	return debouncer->state;
+}
+
+unsigned long long getDebounceDeadline(const ButtonDebouncer *debouncer)
+{
+	ButtonTransitions transitions = getButtonTransitions(debouncer->state, debouncer->rawState);
+	unsigned long long deadline = 0;
+	int transition;
+
+	for (transition = 0; transition < transitions.count; transition++)
+	{
+		unsigned long long lockedUntil = debouncer->lockedUntil[getTransitionButton(&transitions, transition)];
+
+		if (deadline == 0 || lockedUntil < deadline)
+			deadline = lockedUntil;
+	}
+
+	return deadline;
+}
+
+byte settleButtons(ButtonDebouncer *debouncer, unsigned long long time)
+{
+	return debounceButtons(debouncer, debouncer->rawState, time, NULL);
+}
+
+void rebaseButtons(ButtonDebouncer *debouncer, byte state)
+{
+	debouncer->state = state;
+	debouncer->rawState = state;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Button debounce functions header
+ * buttonDebouncer.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUTTONDEBOUNCER_H
+#define BUTTONDEBOUNCER_H
+
+#include "buttonTransitions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Environment variable holding the debounce windows (milliseconds) : one for every button,
+// or one per button (button 0 first) separated by commas, e.g. "10" or "10,10,10,10,10,10,30,30"
+#define DEBOUNCE_VARIABLE "GAMEVOICE_DEBOUNCE"
+
+// Debounce window of the buttons without any setting (milliseconds)
+#define DEFAULT_DEBOUNCE_WINDOW 10
+
+// Debounced button register of a device. A change of a button is taken at once, then the button
+// is locked for its window : the changes meanwhile (contact bounce) are filtered, and the button
+// settles on its last state read once the window is over.
+typedef struct ButtonDebouncer
+{
+	// Window of every button (nanoseconds), 0 does not filter
+	unsigned long long windows[BUTTON_TRANSITIONS_MAX];
+
+	// Debounced state, and the last state read
+	byte state;
+	byte rawState;
+
+	// Time (monotonic, nanoseconds) every button is locked until
+	unsigned long long lockedUntil[BUTTON_TRANSITIONS_MAX];
+} ButtonDebouncer;
+
+/* Parses debounce windows (see DEBOUNCE_VARIABLE) into nanoseconds.
+ * Returns FALSE, leaving the windows alone, if the setting is malformed.
+ */
+BOOL parseDebounceWindows(const char *setting, unsigned long long *windows);
+
+/* Starts debouncing from a state, the buttons unlocked.
+ */
+void initButtonDebouncer(ButtonDebouncer *debouncer, const unsigned long long *windows, byte state);
+
+/* Filters a state read at the specified time, returns the debounced state.
+ * The number of button changes filtered is added to filtered (optional).
+ */
+byte debounceButtons(ButtonDebouncer *debouncer, byte rawState, unsigned long long time, int *filtered);
+
+/* Gets the time the changes filtered so far are settled (see settleButtons), 0 if there is none.
+ */
+unsigned long long getDebounceDeadline(const ButtonDebouncer *debouncer);
+
+/* Settles the buttons whose window is over on their last state read, returns the debounced state.
+ */
+byte settleButtons(ButtonDebouncer *debouncer, unsigned long long time);
+
+/* Moves to a state the device set itself (LED write echoed) : not a change of the buttons,
+ * nothing is filtered and the buttons locked stay locked.
+ */
+void rebaseButtons(ButtonDebouncer *debouncer, byte state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Button transition engine
+ * buttonTransitions.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "buttonTransitions.h"
+
+// Buttons changed of a mask of changed buttons : their number and indexes, packed like ButtonTransitions.order
+typedef struct ButtonOrder
+{
+	byte count;
+	unsigned int order;
+} ButtonOrder;
+
+// The table is generated by the preprocessor : the slot of a changed button in the order
+// is the number of changed buttons below it (button 0 packs as 0 wherever it is)
+#define MASK_BIT(mask, bit) (((mask) >> (bit)) & 1)
+#define MASK_COUNT(mask) (MASK_BIT(mask, 0) + MASK_BIT(mask, 1) + MASK_BIT(mask, 2) + MASK_BIT(mask, 3) \
+	+ MASK_BIT(mask, 4) + MASK_BIT(mask, 5) + MASK_BIT(mask, 6) + MASK_BIT(mask, 7))
+#define MASK_RANK(mask, bit) MASK_COUNT((mask) & ((1 << (bit)) - 1))
+#define ORDER_SLOT(mask, bit) ((unsigned int) MASK_BIT(mask, bit) * ((unsigned int) (bit) << (4 * MASK_RANK(mask, bit))))
+#define ORDER(mask) (ORDER_SLOT(mask, 1) | ORDER_SLOT(mask, 2) | ORDER_SLOT(mask, 3) \
+	| ORDER_SLOT(mask, 4) | ORDER_SLOT(mask, 5) | ORDER_SLOT(mask, 6) | ORDER_SLOT(mask, 7))
+#define BUTTON_ORDER(mask) {MASK_COUNT(mask), ORDER(mask)}
+#define BUTTON_ORDER_ROW(row) \
+	BUTTON_ORDER((row) * 16 + 0), BUTTON_ORDER((row) * 16 + 1), BUTTON_ORDER((row) * 16 + 2), BUTTON_ORDER((row) * 16 + 3), \
+	BUTTON_ORDER((row) * 16 + 4), BUTTON_ORDER((row) * 16 + 5), BUTTON_ORDER((row) * 16 + 6), BUTTON_ORDER((row) * 16 + 7), \
+	BUTTON_ORDER((row) * 16 + 8), BUTTON_ORDER((row) * 16 + 9), BUTTON_ORDER((row) * 16 + 10), BUTTON_ORDER((row) * 16 + 11), \
+	BUTTON_ORDER((row) * 16 + 12), BUTTON_ORDER((row) * 16 + 13), BUTTON_ORDER((row) * 16 + 14), BUTTON_ORDER((row) * 16 + 15)
+
+static const ButtonOrder buttonOrders[256] =
+{
+	BUTTON_ORDER_ROW(0), BUTTON_ORDER_ROW(1), BUTTON_ORDER_ROW(2), BUTTON_ORDER_ROW(3),
+	BUTTON_ORDER_ROW(4), BUTTON_ORDER_ROW(5), BUTTON_ORDER_ROW(6), BUTTON_ORDER_ROW(7),
+	BUTTON_ORDER_ROW(8), BUTTON_ORDER_ROW(9), BUTTON_ORDER_ROW(10), BUTTON_ORDER_ROW(11),
+	BUTTON_ORDER_ROW(12), BUTTON_ORDER_ROW(13), BUTTON_ORDER_ROW(14), BUTTON_ORDER_ROW(15)
+};
+
+ButtonTransitions getButtonTransitions(byte previous, byte current)
+{
+	ButtonTransitions transitions;
+	byte changed = previous ^ current;
+
+	transitions.pressed = changed & current;
+	transitions.released = changed & previous;
+	transitions.count = buttonOrders[changed].count;
+	transitions.order = buttonOrders[changed].order;
+
+	return transitions;
+}
+
+int getTransitionButton(const ButtonTransitions *transitions, int transition)
+{
+	return (transitions->order >> (4 * transition)) & 0x7;
+}
+
+BOOL isPressTransition(const ButtonTransitions *transitions, int transition)
+{
+	return (transitions->pressed >> getTransitionButton(transitions, transition)) & 1;
+}
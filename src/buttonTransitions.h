@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Button transition engine header
+ * buttonTransitions.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BUTTONTRANSITIONS_H
+#define BUTTONTRANSITIONS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of transitions between two states : one per button of the 8 bits register
+#define BUTTON_TRANSITIONS_MAX 8
+
+// Buttons pressed and released between two states of the button register (bit n : button n),
+// and the buttons changed in order, from the lowest one
+typedef struct ButtonTransitions
+{
+	byte pressed;
+	byte released;
+
+	// Number of buttons changed and their indexes, 4 bits each from the lowest bits
+	byte count;
+	unsigned int order;
+} ButtonTransitions;
+
+/* Gets the transitions from a state of the button register to the next one : every button pressed
+ * and released at once, whatever their number. Pure and branch free, callable from any thread.
+ */
+ButtonTransitions getButtonTransitions(byte previous, byte current);
+
+/* Gets the index of the button of a transition (0 to count - 1, from the lowest button).
+ */
+int getTransitionButton(const ButtonTransitions *transitions, int transition);
+
+/* Determines whether a transition is a press (or a release) of its button.
+ */
+BOOL isPressTransition(const ButtonTransitions *transitions, int transition);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Command state functions
+ * commandState.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include "stdafx.h"
+#include "platform.h"
+#include "commandState.h"
+
+#define COMMAND_STATE_LEDS ((long long) 0xFF << COMMAND_STATE_LEDS_SHIFT)
+
+void initCommandState(CommandState *commandState)
+{
+	storeAtomic64(&commandState->sequence, 0);
+	storeAtomic64(&commandState->state, 0);
+	storeAtomic64(&commandState->time, 0);
+}
+
+void publishCommandState(CommandState *commandState, byte buttons, byte previousButtons, size_t effectiveCommand, unsigned long long commandTime)
+{
+	long long sequence = loadAtomic64(&commandState->sequence);
+	long long command = (long long) buttons | ((long long) previousButtons << 8) | ((long long) (effectiveCommand & 0xFFFF) << 16);
+	long long state;
+
+	storeAtomic64(&commandState->sequence, sequence + 1);
+
+	// Only retried if the LEDs are set meanwhile
+	do
+	{
+		state = loadAtomic64(&commandState->state);
+	} while (!compareExchangeAtomic64(&commandState->state, state, (state & COMMAND_STATE_LEDS) | command));
+
+	storeAtomic64(&commandState->time, (long long) commandTime);
+	storeAtomic64(&commandState->sequence, sequence + 2);
+}
+
+void setCommandStateLeds(CommandState *commandState, byte mask, byte leds)
+{
+	long long bits = (long long) mask << COMMAND_STATE_LEDS_SHIFT;
+	long long state;
+
+	do
+	{
+		state = loadAtomic64(&commandState->state);
+	} while (!compareExchangeAtomic64(&commandState->state, state, (state & ~bits) | (((long long) leds << COMMAND_STATE_LEDS_SHIFT) & bits)));
+}
+
+void readCommandState(CommandState *commandState, GameVoiceSnapshot *snapshot)
+{
+	long long sequence, state, time;
+
+	do
+	{
+		sequence = loadAtomic64(&commandState->sequence);
+		state = loadAtomic64(&commandState->state);
+		time = loadAtomic64(&commandState->time);
+	} while ((sequence & 1) || loadAtomic64(&commandState->sequence) != sequence);
+
+	snapshot->sequence = (unsigned long long) sequence / 2;
+	snapshot->buttons = (byte) state;
+	snapshot->previousButtons = (byte) (state >> 8);
+	snapshot->effectiveCommand = (size_t) ((state >> 16) & 0xFFFF);
+	snapshot->commandTime = (unsigned long long) time;
+	snapshot->leds = (byte) (state >> COMMAND_STATE_LEDS_SHIFT);
+}
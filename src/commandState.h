@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Command state functions header
+ * commandState.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef COMMANDSTATE_H
+#define COMMANDSTATE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Consistent view of the state of a device, read from any thread without lock nor IO (see readCommandState)
+typedef struct GameVoiceSnapshot
+{
+	// Command states published so far, the snapshot changed if it differs
+	unsigned long long sequence;
+	// Buttons of the last and previous commands received (debounced), and the effective command
+	byte buttons;
+	byte previousButtons;
+	size_t effectiveCommand;
+	// Monotonic time (nanoseconds) the last command was received
+	unsigned long long commandTime;
+	// LEDs of the last feature sent
+	byte leds;
+} GameVoiceSnapshot;
+
+// LEDs in the state word (bits 32-39), below them the last and previous buttons and the effective command
+// (bits 0-7, 8-15 and 16-31)
+#define COMMAND_STATE_LEDS_SHIFT 32
+
+// Command state of a device, a seqlock with a single writer : the thread receiving the commands of the
+// device publishes them, the sequence is odd meanwhile. The LEDs are set from any thread in the same word,
+// with a compare and swap : they never tear the command published with them.
+typedef struct CommandState
+{
+	volatile long long sequence;
+	volatile long long state;
+	volatile long long time;
+} CommandState;
+
+/* Sets up a state with no command received and no LED.
+ */
+void initCommandState(CommandState *commandState);
+
+/* Publishes a command received, the LEDs are kept. Only called by the thread receiving the commands of the
+ * device (or resetting it while none does) : the readers retry meanwhile, the writer never waits.
+ */
+void publishCommandState(CommandState *commandState, byte buttons, byte previousButtons, size_t effectiveCommand, unsigned long long commandTime);
+
+/* Sets the LEDs of a mask (button model register), the others are left as they are. Lock free, callable from any thread.
+ */
+void setCommandStateLeds(CommandState *commandState, byte mask, byte leds);
+
+/* Reads a consistent snapshot of the state, from any thread without lock :
+ * the state is read again until no publication overlapped the read.
+ */
+void readCommandState(CommandState *commandState, GameVoiceSnapshot *snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * HID transaction flight recorder functions
+ * flightRecorder.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include "stdafx.h"
+#include "platform.h"
+#include "flightRecorder.h"
+
+static const char *typeNames[flightRecordTypeCount] =
+{
+	"input",
+	"output",
+	"set feature",
+	"get feature",
+	"get input",
+	"attached",
+	"detached",
+	"broken"
+};
+
+static const char *resultNames[flightRecordResultCount] =
+{
+	"ok",
+	"failed",
+	"unchanged",
+	"ignored",
+	"dropped",
+	"echo"
+};
+
+// Ring of the transactions : a record is claimed by incrementing the count,
+// its position in the ring is the count modulo the ring size
+static PLATFORM_CACHE_ALIGNED FlightRecord records[FLIGHT_RECORDER_SIZE];
+static PLATFORM_CACHE_ALIGNED volatile long long recordCount = 0;
+
+// First record dumped, the ones before have been cleared
+static volatile long long firstRecord = 0;
+
+void recordFlight(enum FlightRecordType type, int deviceIndex, enum FlightRecordResult result, const unsigned char *report, DWORD reportLength, unsigned long long time)
+{
+	long long index = addAtomic64(&recordCount, 1) - 1;
+	FlightRecord *record = &records[index & (FLIGHT_RECORDER_SIZE - 1)];
+	DWORD dataLength = report == NULL ? 0 : (reportLength < FLIGHT_RECORD_DATA_SIZE ? reportLength : FLIGHT_RECORD_DATA_SIZE);
+
+	// The record is claimed by the count : the dump skips it until its sequence is set
+	record->time = time;
+	record->type = (unsigned char) type;
+	record->deviceIndex = (unsigned char) deviceIndex;
+	record->result = (unsigned char) result;
+	record->dataLength = (unsigned char) dataLength;
+	record->reportLength = report == NULL ? 0 : reportLength;
+	if (dataLength != 0)
+		memcpy(record->data, report, dataLength);
+
+	storeAtomic64((volatile long long *) &record->sequence, index + 1);
+}
+
+// Copies a record of the ring, FALSE if it is not written yet or may have been overwritten meanwhile :
+// a record is overwritten once the count is a ring size ahead of it
+static BOOL copyRecord(long long index, FlightRecord *copy)
+{
+	FlightRecord *record = &records[index & (FLIGHT_RECORDER_SIZE - 1)];
+
+	if (loadAtomic64((volatile long long *) &record->sequence) != index + 1)
+		return FALSE;
+
+	memcpy(copy, record, sizeof(FlightRecord));
+	return loadAtomic64(&recordCount) - FLIGHT_RECORDER_SIZE <= index && copy->sequence == (unsigned long long) (index + 1);
+}
+
+BOOL dumpFlightRecorder(const char *path)
+{
+	FlightRecorderFileHeader header;
+	FlightRecord record;
+	long long index, last, first;
+	FILE *file;
+	BOOL written;
+
+	file = fopen(path, "wb");
+	if (file == NULL)
+	{
+		OutputDebugString("dumpFlightRecorder: /!\\ Can't create the dump file");
+		return FALSE;
+	}
+
+	last = loadAtomic64(&recordCount);
+	first = last > FLIGHT_RECORDER_SIZE ? last - FLIGHT_RECORDER_SIZE : 0;
+	if (first < loadAtomic64(&firstRecord))
+		first = loadAtomic64(&firstRecord);
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, FLIGHT_RECORDER_MAGIC, sizeof(header.magic));
+	header.version = FLIGHT_RECORDER_VERSION;
+	header.recordSize = sizeof(FlightRecord);
+	header.dumpTime = getMonotonicTime();
+
+	// The header is written again once the records kept are counted
+	written = fwrite(&header, sizeof(header), 1, file) == 1;
+	for (index = first; index < last && written; index++)
+	{
+		if (!copyRecord(index, &record))
+			continue;
+
+		written = fwrite(&record, sizeof(record), 1, file) == 1;
+		header.recordCount++;
+	}
+
+	written = written && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+	written = fclose(file) == 0 && written;
+	if (!written)
+		OutputDebugString("dumpFlightRecorder: /!\\ Failed to write the dump file");
+
+	return written;
+}
+
+FILE *openFlightRecorderDump(const char *path, FlightRecorderFileHeader *header)
+{
+	FILE *file = fopen(path, "rb");
+
+	if (file == NULL)
+		return NULL;
+
+	if (fread(header, sizeof(FlightRecorderFileHeader), 1, file) != 1
+		|| memcmp(header->magic, FLIGHT_RECORDER_MAGIC, sizeof(header->magic)) != 0
+		|| header->version != FLIGHT_RECORDER_VERSION || header->recordSize != sizeof(FlightRecord))
+	{
+		fclose(file);
+		return NULL;
+	}
+
+	return file;
+}
+
+void clearFlightRecorder(void)
+{
+	storeAtomic64(&firstRecord, loadAtomic64(&recordCount));
+}
+
+const char *getFlightRecordTypeName(unsigned int type)
+{
+	return type < flightRecordTypeCount ? typeNames[type] : "unknown";
+}
+
+const char *getFlightRecordResultName(unsigned int result)
+{
+	return result < flightRecordResultCount ? resultNames[result] : "unknown";
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * HID transaction flight recorder functions header
+ * flightRecorder.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FLIGHTRECORDER_H
+#define FLIGHTRECORDER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Environment variable holding the file the flight recorder is dumped to when a device is found broken
+#define FLIGHT_RECORDER_VARIABLE "GAMEVOICE_FLIGHT_RECORDER"
+
+// Number of transactions kept, the oldest ones are overwritten (power of two)
+#define FLIGHT_RECORDER_SIZE 4096
+
+// Report bytes kept by a record, from the report ID byte : the Game Voice register is byte 1,
+// the tail of its 65 bytes reports is always zero
+#define FLIGHT_RECORD_DATA_SIZE 40
+
+// Dump file identification, followed by the version of its layout
+#define FLIGHT_RECORDER_MAGIC "GVFR"
+#define FLIGHT_RECORDER_VERSION 1
+
+// Transaction recorded
+enum FlightRecordType
+{
+	flightInputReport,		// Input report read by the event loop
+	flightOutputReport,		// Output report written (command, or LEDs of the devices holding them in an output report)
+	flightSetFeature,		// Feature report written (LEDs)
+	flightGetFeature,		// Feature report read on demand
+	flightGetInputReport,	// Input report read on demand (state resynchronization)
+	flightDeviceAttached,	// Device opened and handed over to the event loop
+	flightDeviceDetached,	// Device detached on purpose or unplugged
+	flightDeviceBroken,		// Device found broken (transfer not completed in time, or failing to open)
+	flightRecordTypeCount
+};
+
+// Outcome of a transaction
+enum FlightRecordResult
+{
+	flightSucceeded,		// Transferred, or queued for receiveCommand (input report)
+	flightFailed,			// Transfer failed
+	flightUnchanged,		// Not transferred : the device already holds the LED state
+	flightIgnored,			// Input report not queued : not the report of the buttons
+	flightDropped,			// Input report lost, the report queue was full
+	flightEcho,				// Input report queued as the echo of a feature write, not a command
+	flightRecordResultCount
+};
+
+// Transaction record, one cache line. The sequence (position in the recording, from 1) is written last :
+// a record whose sequence does not match its position is being written and is skipped by the dump.
+typedef struct FlightRecord
+{
+	unsigned long long sequence;
+	unsigned long long time;
+	unsigned char type;
+	unsigned char deviceIndex;
+	unsigned char result;
+	unsigned char dataLength;
+	unsigned int reportLength;
+	unsigned char data[FLIGHT_RECORD_DATA_SIZE];
+} FlightRecord;
+
+// Dump file header, followed by recordCount records from the oldest to the newest.
+// The file is written in the byte order of the machine recording it.
+typedef struct FlightRecorderFileHeader
+{
+	char magic[4];
+	unsigned int version;
+	unsigned int recordSize;
+	unsigned int recordCount;
+	unsigned long long dumpTime;
+} FlightRecorderFileHeader;
+
+/* Records a transaction of a device : its report (NULL for none), result and monotonic time,
+ * the one the caller already took for its own needs if any. Lock free and allocation free,
+ * callable from any thread : a couple of atomic operations and a copy of the report head.
+ */
+void recordFlight(enum FlightRecordType type, int deviceIndex, enum FlightRecordResult result, const unsigned char *report, DWORD reportLength, unsigned long long time);
+
+/* Writes the transactions kept to a dump file, from the oldest to the newest.
+ * Transactions recorded meanwhile may be missing. Returns FALSE if the file can't be written.
+ */
+BOOL dumpFlightRecorder(const char *path);
+
+/* Opens a dump file for reading and reads its header : the records follow.
+ * Returns NULL if the file can't be read or is not a dump of this version.
+ */
+FILE *openFlightRecorderDump(const char *path, FlightRecorderFileHeader *header);
+
+/* Forgets the transactions recorded so far.
+ */
+void clearFlightRecorder(void);
+
+/* Gets the name of a transaction type or result, for the dump decoders.
+ */
+const char *getFlightRecordTypeName(unsigned int type);
+const char *getFlightRecordResultName(unsigned int result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,353 +1,708 @@
-/*
- * Copyright (c) 2012-2019 JoeBilly
- *
- * Game voice helper functions
- * gamevoice_functions.c
- * JoeBilly (joebilly@users.sourceforge.net)
- * https://github.com/ghoebilly/ts3gamevoice
- *
- *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
- *
- *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
- *	you can redistribute it and/or modify it under the terms of the
- *	GNU General Public License as published by the Free Software Foundation,
- *	either version 3 of the License, or (at your option) any later version.
- *
- *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
- *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
- *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
- *  See the GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
- *  If not, see <http://www.gnu.org/licenses/>.
- */
-
-#include "stdafx.h"
-#include "usbHidCommunication.h"
-#include "gamevoice_functions.h"
-
-static struct UsbHidCommunication usbHidCommunicator;
-
-static size_t effectiveCommand = NULL;
-static byte lastCommandReceived = NULL;
-static byte previousCommandReceived = NULL;
-static byte lastFeatureSent = NULL;
-static BOOL featureSent = NULL;
-
-/* Gets the effective command applied to the device after a waitForCommand or waitForExternalCommand
- * Effective command contains buttons (Command) that are activated or deactivated (Action)
- */
-static size_t getEffectiveCommand()
-{
-	return effectiveCommand;
-}
-
-/* Gets the last command received from the device during a waitForCommand or waitForExternalCommand
- */
-static byte getLastCommandReceived()
-{
-	return lastCommandReceived;
-}
-
-/* Gets the previous command received from the device after a waitForCommand or waitForExternalCommand
- */
-static byte getPreviousCommandReceived()
-{
-	return previousCommandReceived;
-}
-
-/* Gets the last feature sent to the device during a forceFeature or sendFeature
- */
-static byte getLastFeatureSent()
-{
-	return lastFeatureSent;
-}
-
-/* Determines whether the specified value is a new command and match the specified command.
- * A new command is a command different from the previous command received
- */
-/*static BOOL isNewCommand(byte value, size_t command)
-{
-return !(previousCommandReceived & command) && (value & command);
-}*/
-
-/* Determines whether the last command is a new command and match the specified command.
- * A new command is a command different from the previous command received.
- */
-/*static BOOL isNewLastCommand(size_t command)
-{
-return !(previousCommandReceived & command) && (lastCommandReceived & command);
-}*/
-
-/* Determines whether the specified button has been activated during a waitForcommand or waitForExternalCommand.
- * A button is activated if its a new command and different from the last feature sent.
- */
-static BOOL isButtonActivated(size_t command)
-{
-	return !(lastFeatureSent & command) && (effectiveCommand & command) && (effectiveCommand & ACTIVATED);
-}
-
-/* Determines whether the specified button is active on the device.
-  */
-static BOOL isButtonActive(size_t command)
-{
-	return (usbHidCommunicator.getInputReport() & command);
-}
-
-/* Determines whether the specified button has been deactivated during a waitForcommand or waitForExternalCommand.
- * A button is deactivated if its a new command and different from the last feature sent.
- */
-static BOOL isButtonDeactivated(size_t command)
-{
-	return !(lastFeatureSent & command) && (effectiveCommand & command) && (effectiveCommand & DEACTIVATED);
-}
-
-/* Determines whether the specified button is inactive on the device.
- */
-static BOOL isButtonInactive(size_t command)
-{
-	return !(usbHidCommunicator.getInputReport() & command);
-}
-
-/* Determines whether the specified value is a new user command and match the specified command.
- * A new command is a command different from the previous command received.
- */
-//static BOOL isNewExternalCommand(byte value, size_t command)
-//{
-//	return (lastFeatureSent != command) && !(previousCommandReceived & command) && (value & command);
-//}
-//
-//static BOOL isNewLastExternalCommand(size_t command)
-//{
-//	return (lastFeatureSent != command) && !(previousCommandReceived & command) && (lastCommandReceived & command);
-//}
-
-/* Loads the device : find it and attach to it
-*/
-static BOOL loadDevice()
-{
-	usbHidCommunicator = CreateUsbHidCommunicator();
-	usbHidCommunicator.initUsbHidCommunication();
-	usbHidCommunicator.findDevice(0x045E, 0x003B);
-
-	return usbHidCommunicator.isDeviceAttached();
-}
-
-/* Resets the device to its base state.
-*/
-static void resetDevice()
-{
-	effectiveCommand = NULL;
-	lastCommandReceived = NULL;
-	previousCommandReceived = NULL;
-	lastFeatureSent = NULL;
-	featureSent = NULL;
-	usbHidCommunicator.forceFeature(NONE);
-	usbHidCommunicator.forceFeature(NONE);
-}
-
-/* Unload the device : reset and detach it
-*/
-static void unloadDevice()
-{
-	resetDevice();
-	usbHidCommunicator.finalizeUsbHidCommunication();
-}
-
-/* Reads the last command received from the device
-*/
-static byte readCommand()
-{
-	return usbHidCommunicator.readFromTheInputBuffer(1);
-}
-
-/* Waits for a command from the device.
-*/
-static BOOL waitForCommand()
-{
-	char debugOutput[65];
-	previousCommandReceived = lastCommandReceived;
-	if (usbHidCommunicator.receiveCommand())
-	{
-		byte command;
-		lastCommandReceived = readCommand();
-		command = (previousCommandReceived ^ lastCommandReceived);
-
-		if (command & COMMAND)
-			command = COMMAND;
-
-		if (command & lastCommandReceived)
-			effectiveCommand = lastCommandReceived | ACTIVATED;
-		else
-			effectiveCommand = command | DEACTIVATED;
-
-		snprintf(debugOutput, 65, "waitForCommand:lastFeatureSent:%d", lastFeatureSent);
-		OutputDebugString(debugOutput);
-		snprintf(debugOutput, 65, "waitForCommand:lastCommandReceived:%d", lastCommandReceived);
-		OutputDebugString(debugOutput);
-		snprintf(debugOutput, 65, "waitForCommand:effectiveCommand:%d", effectiveCommand);
-		OutputDebugString(debugOutput);		
-	}
-	else
-		return FALSE;
-
-	return TRUE;
-}
-
-/* Waits for an external command from the device.
-* An external command is a command different from the last feature sent.
-*/
-static BOOL waitForExternalCommand()
-{
-	BOOL result;
-	do
-	{
-		featureSent = FALSE;
-		result = waitForCommand();
-		//char debugOutput[65];
-		//snprintf(debugOutput, 65, "waitForExternalCommand:featureSent:%d", featureSent);
-		//OutputDebugString(debugOutput);
-		Sleep(5);
-	} while (result && featureSent);
-
-	return result;
-}
-
-/* Forces a feature to the device (sent immediately)
-*/
-static BOOL forceFeature(size_t command)
-{
-	featureSent = usbHidCommunicator.forceFeature(command);
-	if (featureSent)
-		lastFeatureSent = command;
-	else
-		return FALSE;
-
-	return TRUE;
-}
-
-/* Sends a feature to the device when its available
-*/
-static BOOL sendFeature(size_t command)
-{
-	featureSent = usbHidCommunicator.sendFeature(command);
-	if (featureSent)
-		lastFeatureSent = command;
-	else
-		return FALSE;
-
-	return TRUE;
-}
-
-/* Activate the specified button
-*/
-static BOOL activateButton(size_t command)
-{
-	byte currentFeature;
-	currentFeature = usbHidCommunicator.getInputReport();
-
-	// Button already active
-	if (currentFeature & command)
-		return FALSE;
-
-	return forceFeature(currentFeature | command);
-}
-
-/* Deactivate the specified button
-*/
-static BOOL deactivateButton(size_t command)
-{
-	byte currentFeature;
-	currentFeature = usbHidCommunicator.getInputReport();
-
-	// Button already inactive
-	if (!(currentFeature & command))
-		return FALSE;
-
-	return forceFeature(currentFeature ^ command);
-}
-
-/* Runs a clockwise led chase effect by activating & deactivating all device buttons sequentially
-*/
-static void runDeviceLedChase()
-{
-	sendFeature(CHANNEL_1);
-	Sleep(75);
-	sendFeature(CHANNEL_2);
-	Sleep(75);
-	sendFeature(CHANNEL_3);
-	Sleep(75);
-	sendFeature(CHANNEL_4);
-	Sleep(75);
-	sendFeature(NONE);
-	sendFeature(COMMAND);
-	Sleep(75);
-	sendFeature(NONE);
-	sendFeature(TEAM);
-	Sleep(75);
-	sendFeature(ALL);
-	Sleep(75);
-	sendFeature(NONE);
-}
-
-/* Blinks the device leds/button by activating & deactivating device buttons.
- */
-static void blinkDevice()
-{
-	byte previousState = usbHidCommunicator.getInputReport();
-
-	forceFeature(NONE);
-	Sleep(75);
-	forceFeature(CHANNEL_1 | CHANNEL_2 | CHANNEL_3 | CHANNEL_4);
-	Sleep(100);
-	forceFeature(NONE);
-	Sleep(75);
-	forceFeature(CHANNEL_1 | CHANNEL_2 | CHANNEL_3 | CHANNEL_4);
-	Sleep(100);
-	forceFeature(NONE);
-	Sleep(75);
-	forceFeature(CHANNEL_1 | CHANNEL_2 | CHANNEL_3 | CHANNEL_4);
-	Sleep(100);
-	forceFeature(NONE);
-	Sleep(75);
-	forceFeature(CHANNEL_1 | CHANNEL_2 | CHANNEL_3 | CHANNEL_4);
-	Sleep(100);
-	forceFeature(NONE);
-	Sleep(75);
-	forceFeature(previousState);
-}
-
-// GameVoiceFunctions factory
-GameVoiceFunctions InitGameVoiceFunctions()
-{
-	GameVoiceFunctions gamevoiceFunctions;
-	gamevoiceFunctions.blinkDevice = blinkDevice;
-	gamevoiceFunctions.forceFeature = forceFeature;
-	gamevoiceFunctions.getEffectiveCommand = getEffectiveCommand;
-	gamevoiceFunctions.getLastCommandReceived = getLastCommandReceived;
-	gamevoiceFunctions.getLastFeatureSent = getLastFeatureSent;
-	gamevoiceFunctions.getPreviousCommandReceived = getPreviousCommandReceived;
-	//gamevoiceFunctions.getPreviousState = getPreviousState;
-	gamevoiceFunctions.isButtonActivated = isButtonActivated;
-	gamevoiceFunctions.isButtonActive = isButtonActive;
-	gamevoiceFunctions.isButtonDeactivated = isButtonDeactivated;
-	gamevoiceFunctions.isButtonInactive = isButtonInactive;
-	//gamevoiceFunctions.isNewCommand = isNewCommand;
-	//gamevoiceFunctions.isNewLastCommand = isNewLastCommand;
-	//gamevoiceFunctions.isNewExternalCommand = isNewExternalCommand;
-	//gamevoiceFunctions.isNewLastExternalCommand = isNewLastExternalCommand;
-	gamevoiceFunctions.loadDevice = loadDevice;
-	gamevoiceFunctions.readCommand = readCommand;
-	gamevoiceFunctions.resetDevice = resetDevice;
-	gamevoiceFunctions.runDeviceLedChase = runDeviceLedChase;
-	gamevoiceFunctions.sendFeature = sendFeature;
-	gamevoiceFunctions.unloadDevice = unloadDevice;
-	gamevoiceFunctions.waitForCommand = waitForCommand;
-	gamevoiceFunctions.waitForExternalCommand = waitForExternalCommand;
-
-	gamevoiceFunctions.activateButton = activateButton;
-	gamevoiceFunctions.deactivateButton = deactivateButton;
-
-	return gamevoiceFunctions;
-}
\ No newline at end of file
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Game voice helper functions
+ * gamevoice_functions.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "usbHidCommunication.h"
+#include "buttonDebouncer.h"
+#include "buttonTransitions.h"
+#include "commandState.h"
+#include "gamevoice_functions.h"
+#include "gestureRecognizer.h"
+#include "ledAnimation.h"
+#include "ledCompositor.h"
+#include "statistics.h"
+
+// Layers of the animations of the plugin : the blink shows over the LED chase
+#define LED_CHASE_LAYER 0
+#define BLINK_LAYER 1
+
+// Time (nanoseconds) the reset of a device waits for its animations to be cancelled
+#define ANIMATION_CANCEL_TIMEOUT 500000000ULL
+
+static struct UsbHidCommunication usbHidCommunicator;
+
+// Devices driven by the plugin : the SideWinder Game Voice. Other button boxes are added here,
+// their buttons and LEDs are mapped onto the Game Voice ones from their report descriptor.
+static UsbDeviceId supportedDevices[USB_HID_MAX_DEVICE_IDS + 1] =
+{
+	{0x045E, 0x003B},	// Microsoft SideWinder Game Voice
+	{0, 0}
+};
+
+struct GameVoiceDevice
+{
+	// Index of the USB device in the communicator registry
+	int deviceIndex;
+
+	ButtonTransitions transitions;
+	ButtonDebouncer debouncer;
+	GestureRecognizer gestures;
+
+	// Commands received, published by the thread receiving them, and the LEDs of the last feature sent
+	// from any thread : read together from any thread (see readDeviceSnapshot)
+	CommandState commandState;
+};
+
+// Devices, parallel to the communicator device registry
+static GameVoiceDevice gameVoiceDevices[USB_HID_MAX_DEVICES];
+
+// Debounce window of every button (nanoseconds), from the configuration, see setTimings
+static unsigned long long debounceWindows[BUTTON_TRANSITIONS_MAX];
+
+// Gesture timings, from the configuration
+static GestureTimings gestureTimings;
+
+// Clockwise LED chase : every button lit in turn
+static const LedKeyframe ledChaseKeyframes[] =
+{
+	{CHANNEL_1, 75},
+	{CHANNEL_2, 75},
+	{CHANNEL_3, 75},
+	{CHANNEL_4, 75},
+	{COMMAND, 75},
+	{TEAM, 75},
+	{ALL, 75}
+};
+static const LedTimeline ledChase = {ledChaseKeyframes, sizeof(ledChaseKeyframes) / sizeof(LedKeyframe), 1};
+
+// Blink : the channel buttons lit four times
+static const LedKeyframe blinkKeyframes[] =
+{
+	{NONE, 75},
+	{CHANNEL_1 | CHANNEL_2 | CHANNEL_3 | CHANNEL_4, 100},
+	{NONE, 75},
+	{CHANNEL_1 | CHANNEL_2 | CHANNEL_3 | CHANNEL_4, 100},
+	{NONE, 75},
+	{CHANNEL_1 | CHANNEL_2 | CHANNEL_3 | CHANNEL_4, 100},
+	{NONE, 75},
+	{CHANNEL_1 | CHANNEL_2 | CHANNEL_3 | CHANNEL_4, 100},
+	{NONE, 75}
+};
+static const LedTimeline blink = {blinkKeyframes, sizeof(blinkKeyframes) / sizeof(LedKeyframe), 1};
+
+/* Gets the USB device of a Game Voice device, NULL if it has not been found by the last detection
+ */
+static UsbHidDevice *getUsbDevice(GameVoiceDevice *device)
+{
+	return usbHidCommunicator.getDevice(device->deviceIndex);
+}
+
+
+/* Gets the Game Voice device of a USB device
+ */
+static GameVoiceDevice *getGameVoiceDevice(UsbHidDevice *usbDevice)
+{
+	return &gameVoiceDevices[usbHidCommunicator.getDeviceIndex(usbDevice)];
+}
+
+/* Reads a consistent snapshot of the device state, from any thread without lock nor IO
+ */
+static void readDeviceSnapshot(GameVoiceDevice *device, GameVoiceSnapshot *snapshot)
+{
+	readCommandState(&device->commandState, snapshot);
+}
+
+/* Gets the effective command applied to the device after a waitForCommand or waitForExternalCommand
+ * Effective command contains buttons (Command) that are activated or deactivated (Action)
+ */
+static size_t getEffectiveCommand(GameVoiceDevice *device)
+{
+	GameVoiceSnapshot snapshot;
+
+	readDeviceSnapshot(device, &snapshot);
+	return snapshot.effectiveCommand;
+}
+
+/* Gets the buttons pressed and released by the last command received during a waitForCommand or waitForExternalCommand
+ */
+static const ButtonTransitions *getCommandTransitions(GameVoiceDevice *device)
+{
+	return &device->transitions;
+}
+
+/* Gets the last command received from the device during a waitForCommand or waitForExternalCommand
+ */
+static byte getLastCommandReceived(GameVoiceDevice *device)
+{
+	GameVoiceSnapshot snapshot;
+
+	readDeviceSnapshot(device, &snapshot);
+	return snapshot.buttons;
+}
+
+/* Gets the previous command received from the device after a waitForCommand or waitForExternalCommand
+ */
+static byte getPreviousCommandReceived(GameVoiceDevice *device)
+{
+	GameVoiceSnapshot snapshot;
+
+	readDeviceSnapshot(device, &snapshot);
+	return snapshot.previousButtons;
+}
+
+/* Gets the last feature sent to the device during a forceFeature or sendFeature
+ */
+static byte getLastFeatureSent(GameVoiceDevice *device)
+{
+	GameVoiceSnapshot snapshot;
+
+	readDeviceSnapshot(device, &snapshot);
+	return snapshot.leds;
+}
+
+/* Gets the monotonic time (nanoseconds) the last command was received from the device
+ */
+static unsigned long long getLastCommandTime(GameVoiceDevice *device)
+{
+	GameVoiceSnapshot snapshot;
+
+	readDeviceSnapshot(device, &snapshot);
+	return snapshot.commandTime;
+}
+
+/* Determines whether the specified value is a new command and match the specified command.
+ * A new command is a command different from the previous command received
+ */
+/*static BOOL isNewCommand(byte value, size_t command)
+{
+return !(previousCommandReceived & command) && (value & command);
+}*/
+
+/* Determines whether the last command is a new command and match the specified command.
+ * A new command is a command different from the previous command received.
+ */
+/*static BOOL isNewLastCommand(size_t command)
+{
+return !(previousCommandReceived & command) && (lastCommandReceived & command);
+}*/
+
+/* Determines whether the specified button has been activated during a waitForcommand or waitForExternalCommand.
+ * The echoes of the features sent are not commands : a button is activated by the user only.
+ */
+static BOOL isButtonActivated(GameVoiceDevice *device, size_t command)
+{
+	return (device->transitions.pressed & command) != 0;
+}
+
+/* Determines whether the specified button is active on the device (cached state, no IO).
+  */
+static BOOL isButtonActive(GameVoiceDevice *device, size_t command)
+{
+	return (usbHidCommunicator.getDeviceState(getUsbDevice(device)) & command);
+}
+
+/* Determines whether the specified button has been deactivated during a waitForcommand or waitForExternalCommand.
+ * The echoes of the features sent are not commands : a button is deactivated by the user only.
+ */
+static BOOL isButtonDeactivated(GameVoiceDevice *device, size_t command)
+{
+	return (device->transitions.released & command) != 0;
+}
+
+/* Determines whether the specified button is inactive on the device (cached state, no IO).
+ */
+static BOOL isButtonInactive(GameVoiceDevice *device, size_t command)
+{
+	return !(usbHidCommunicator.getDeviceState(getUsbDevice(device)) & command);
+}
+
+/* Gets the buttons active on the device (cached state, no IO).
+ */
+static byte getActiveButtons(GameVoiceDevice *device)
+{
+	return usbHidCommunicator.getDeviceState(getUsbDevice(device));
+}
+
+/* Replaces the debounce windows and the gesture timings of the devices, their state is kept :
+ * the windows and timings running are over at the old times, the next ones use the new times.
+ */
+static void setTimings(const unsigned long long *windows, const GestureTimings *timings)
+{
+	int deviceIndex;
+
+	memcpy(debounceWindows, windows, sizeof(debounceWindows));
+	gestureTimings = *timings;
+	for (deviceIndex = 0; deviceIndex < USB_HID_MAX_DEVICES; deviceIndex++)
+	{
+		memcpy(gameVoiceDevices[deviceIndex].debouncer.windows, debounceWindows, sizeof(debounceWindows));
+		gameVoiceDevices[deviceIndex].gestures.timings = gestureTimings;
+	}
+}
+
+/* Determines whether the specified value is a new user command and match the specified command.
+ * A new command is a command different from the previous command received.
+ */
+//static BOOL isNewExternalCommand(byte value, size_t command)
+//{
+//	return (lastFeatureSent != command) && !(previousCommandReceived & command) && (value & command);
+//}
+//
+//static BOOL isNewLastExternalCommand(size_t command)
+//{
+//	return (lastFeatureSent != command) && !(previousCommandReceived & command) && (lastCommandReceived & command);
+//}
+
+/* Sets the device models the next loadDevices finds and attaches
+*/
+static void setSupportedDevices(const UsbDeviceId *deviceIds)
+{
+	int idIndex;
+
+	for (idIndex = 0; idIndex < USB_HID_MAX_DEVICE_IDS && deviceIds[idIndex].vid != 0; idIndex++)
+		supportedDevices[idIndex] = deviceIds[idIndex];
+	supportedDevices[idIndex].vid = 0;
+	supportedDevices[idIndex].pid = 0;
+}
+
+/* Loads the devices : find them all and attach to them
+*/
+static BOOL loadDevices()
+{
+	int deviceIndex, deviceCount;
+	BOOL deviceAttached = FALSE;
+	usbHidCommunicator = CreateUsbHidCommunicator();
+	usbHidCommunicator.initUsbHidCommunication();
+
+	// The timings are the ones of the configuration, see setTimings
+	for (deviceIndex = 0; deviceIndex < USB_HID_MAX_DEVICES; deviceIndex++)
+	{
+		memset(&gameVoiceDevices[deviceIndex], 0, sizeof(GameVoiceDevice));
+		gameVoiceDevices[deviceIndex].deviceIndex = deviceIndex;
+		initCommandState(&gameVoiceDevices[deviceIndex].commandState);
+		initButtonDebouncer(&gameVoiceDevices[deviceIndex].debouncer, debounceWindows, 0);
+		initGestureRecognizer(&gameVoiceDevices[deviceIndex].gestures, &gestureTimings);
+	}
+
+	deviceCount = usbHidCommunicator.findDevices(supportedDevices);
+	for (deviceIndex = 0; deviceIndex < deviceCount; deviceIndex++)
+		deviceAttached |= usbHidCommunicator.isDeviceAttached(usbHidCommunicator.getDevice(deviceIndex));
+
+	// Attach the devices plugged in later, the attached ones are left alone by the other USB changes
+	if (!usbHidCommunicator.startHotplugMonitoring(supportedDevices))
+		OutputDebugString("loadDevices: /!\\ Devices plugged in later won't be detected");
+
+	return deviceAttached;
+}
+
+/* Gets the number of devices found by loadDevices
+*/
+static int getDeviceCount()
+{
+	return usbHidCommunicator.getDeviceCount();
+}
+
+/* Gets a device found by loadDevices
+*/
+static GameVoiceDevice *getDevice(int deviceIndex)
+{
+	if (usbHidCommunicator.getDevice(deviceIndex) == NULL)
+		return NULL;
+
+	return &gameVoiceDevices[deviceIndex];
+}
+
+/* Determines whether the device is attached
+*/
+static BOOL isDeviceAttached(GameVoiceDevice *device)
+{
+	return usbHidCommunicator.isDeviceAttached(getUsbDevice(device));
+}
+
+/* Resets the device to its base state.
+ * No thread may wait for the commands meanwhile : the command state, the debounce and the gestures are theirs.
+*/
+static void resetDevice(GameVoiceDevice *device)
+{
+	HidRequest *request = usbHidCommunicator.submitAnimation(getUsbDevice(device), NULL, LED_ANIMATION_ALL_LAYERS, NULL, NULL);
+
+	// The animations are over before the LEDs are switched off
+	if (request != NULL && !waitForHidRequest(request, getMonotonicTime() + ANIMATION_CANCEL_TIMEOUT))
+		OutputDebugString("resetDevice: /!\\ The animations were not cancelled in time");
+	releaseHidRequest(request);
+
+	publishCommandState(&device->commandState, 0, 0, 0, 0);
+	memset(&device->transitions, 0, sizeof(ButtonTransitions));
+	setCommandStateLeds(&device->commandState, 0xFF, 0);
+	initButtonDebouncer(&device->debouncer, debounceWindows, 0);
+	initGestureRecognizer(&device->gestures, &gestureTimings);
+	usbHidCommunicator.setLedLayer(getUsbDevice(device), ledNotificationLayer, 0, 0);
+	usbHidCommunicator.setLedLayer(getUsbDevice(device), ledOverrideLayer, 0, 0);
+	usbHidCommunicator.forceFeature(getUsbDevice(device), NONE);
+	usbHidCommunicator.forceFeature(getUsbDevice(device), NONE);
+}
+
+/* Detaches all the devices, the threads waiting for a command are released.
+*/
+static void detachDevices()
+{
+	usbHidCommunicator.detachDevices();
+}
+
+/* Releases the thread waiting for a command, for good
+*/
+static void releaseCommandWaiters()
+{
+	usbHidCommunicator.releaseCommandWaiters();
+}
+
+/* Unload the devices : reset each of them once, then detach them
+*/
+static void unloadDevices()
+{
+	int deviceIndex;
+
+	for (deviceIndex = 0; deviceIndex < usbHidCommunicator.getDeviceCount(); deviceIndex++)
+		resetDevice(&gameVoiceDevices[deviceIndex]);
+
+	usbHidCommunicator.finalizeUsbHidCommunication();
+}
+
+/* Reads the last command received from the device (debounced)
+*/
+static byte readCommand(GameVoiceDevice *device)
+{
+	return getLastCommandReceived(device);
+}
+
+/* Reads the oldest gesture recognized on the device and not read yet
+*/
+static BOOL readDeviceGesture(GameVoiceDevice *device, Gesture *gesture)
+{
+	return readGesture(&device->gestures, gesture);
+}
+
+/* Gets the time to wait for the earliest timer of the devices (milliseconds, rounded up) :
+ * a button change filtered by the debounce to settle, or a gesture timer.
+ * PLATFORM_WAIT_INFINITE if none is running.
+ */
+static DWORD getWaitTimeout()
+{
+	unsigned long long deadline = 0, now;
+	int deviceIndex;
+
+	for (deviceIndex = 0; deviceIndex < usbHidCommunicator.getDeviceCount(); deviceIndex++)
+	{
+		unsigned long long debounceDeadline = getDebounceDeadline(&gameVoiceDevices[deviceIndex].debouncer);
+		unsigned long long gestureDeadline = getGestureDeadline(&gameVoiceDevices[deviceIndex].gestures);
+
+		if (debounceDeadline != 0 && (deadline == 0 || debounceDeadline < deadline))
+			deadline = debounceDeadline;
+		if (gestureDeadline != 0 && (deadline == 0 || gestureDeadline < deadline))
+			deadline = gestureDeadline;
+	}
+
+	if (deadline == 0)
+		return PLATFORM_WAIT_INFINITE;
+
+	now = getMonotonicTime();
+	return deadline > now ? (DWORD) ((deadline - now + 999999ULL) / 1000000ULL) : 0;
+}
+
+/* Settles the button changes filtered by the debounce whose window is over.
+ * Returns the first device whose debounced state changed, NULL if none did.
+ */
+static GameVoiceDevice *settleDevices()
+{
+	unsigned long long now = getMonotonicTime();
+	int deviceIndex;
+
+	for (deviceIndex = 0; deviceIndex < usbHidCommunicator.getDeviceCount(); deviceIndex++)
+	{
+		GameVoiceDevice *device = &gameVoiceDevices[deviceIndex];
+		unsigned long long deadline = getDebounceDeadline(&device->debouncer);
+
+		if (deadline != 0 && deadline <= now && settleButtons(&device->debouncer, now) != getLastCommandReceived(device))
+			return device;
+	}
+
+	return NULL;
+}
+
+/* Runs the gesture timers that are due.
+ * Returns the first device with gestures recognized and not read yet, NULL if there is none.
+ */
+static GameVoiceDevice *advanceDeviceGestures()
+{
+	unsigned long long now = getMonotonicTime();
+	int deviceIndex;
+
+	for (deviceIndex = 0; deviceIndex < usbHidCommunicator.getDeviceCount(); deviceIndex++)
+	{
+		GameVoiceDevice *device = &gameVoiceDevices[deviceIndex];
+
+		advanceGestures(&device->gestures, now);
+		if (hasGestures(&device->gestures))
+			return device;
+	}
+
+	return NULL;
+}
+
+/* Waits for a command from any device.
+ * The reports go through the glitch filter (states the device can't report) and the debounce :
+ * a report changing no debounced button is not a command.
+ * The gestures are recognized from the commands, the wait ending for the gesture timers too :
+ * the device returned may have gestures recognized and no command (no transition).
+*/
+static GameVoiceDevice *waitForCommand()
+{
+	GameVoiceDevice *device;
+	GameVoiceSnapshot snapshot;
+	size_t effectiveCommand;
+	unsigned long long commandTime;
+	byte command;
+
+	for (;;)
+	{
+		BOOL timedOut;
+		UsbHidDevice *usbDevice = usbHidCommunicator.receiveCommandWithin(getWaitTimeout(), &timedOut);
+		byte state;
+		int filtered = 0;
+
+		if (timedOut)
+		{
+			device = settleDevices();
+			if (device != NULL)
+				break;
+
+			device = advanceDeviceGestures();
+			if (device != NULL)
+			{
+				memset(&device->transitions, 0, sizeof(ButtonTransitions));
+				return device;
+			}
+			continue;
+		}
+
+		if (usbDevice == NULL)
+			return NULL;
+
+		device = getGameVoiceDevice(usbDevice);
+		state = usbHidCommunicator.getInputState(usbDevice);
+		readDeviceSnapshot(device, &snapshot);
+
+		// The echo of a feature is the LED state written : the base of the next commands, not a command
+		if (usbHidCommunicator.isInputEcho(usbDevice))
+		{
+			rebaseButtons(&device->debouncer, state);
+			publishCommandState(&device->commandState, state, snapshot.previousButtons, snapshot.effectiveCommand, snapshot.commandTime);
+			continue;
+		}
+
+		if (!usbHidCommunicator.isValidInputState(usbDevice, state))
+		{
+			incrementStatistic(STATISTIC_REPORTS_INVALID);
+			continue;
+		}
+
+		state = debounceButtons(&device->debouncer, state, usbHidCommunicator.getInputReportTime(usbDevice), &filtered);
+		if (filtered != 0)
+			addStatistic(STATISTIC_TRANSITIONS_FILTERED, filtered);
+		if (state != snapshot.buttons)
+			break;
+	}
+
+	// Read again : a command settled by a timer comes without a report
+	readDeviceSnapshot(device, &snapshot);
+	commandTime = usbHidCommunicator.getInputReportTime(getUsbDevice(device));
+	device->transitions = getButtonTransitions(snapshot.buttons, device->debouncer.state);
+
+	// Single direction summary of the transitions, the COMMAND button first
+	command = device->transitions.pressed | device->transitions.released;
+	if (command & COMMAND)
+		command = COMMAND;
+
+	if (command & device->transitions.pressed)
+		effectiveCommand = device->debouncer.state | ACTIVATED;
+	else
+		effectiveCommand = command | DEACTIVATED;
+
+	// Published at once for the other threads : the buttons, the previous ones, the effective command and its time
+	publishCommandState(&device->commandState, device->debouncer.state, snapshot.buttons, effectiveCommand, commandTime);
+	// The Game Voice reports the presses as toggles of its latched register
+	if (usbHidCommunicator.hasLatchedButtons(getUsbDevice(device)))
+		feedGestureToggles(&device->gestures, &device->transitions, commandTime);
+	else
+		feedGestureTransitions(&device->gestures, &device->transitions, commandTime);
+
+	return device;
+}
+
+/* Waits for an external command from any device.
+* An external command is a command of the user : the communicator classifies the echoes
+* of the features sent as they are read, they are never commands.
+*/
+static GameVoiceDevice *waitForExternalCommand()
+{
+	return waitForCommand();
+}
+
+/* Forces a feature to the device (sent immediately)
+*/
+static BOOL forceFeature(GameVoiceDevice *device, size_t command)
+{
+	enum FeatureWriteResult result = usbHidCommunicator.forceFeature(getUsbDevice(device), command);
+
+	if (result == featureWriteFailed)
+		return FALSE;
+
+	setCommandStateLeds(&device->commandState, 0xFF, (byte) command);
+	return TRUE;
+}
+
+/* Sends a feature to the device when its available
+*/
+static BOOL sendFeature(GameVoiceDevice *device, size_t command)
+{
+	if (!usbHidCommunicator.sendFeature(getUsbDevice(device), command))
+		return FALSE;
+
+	setCommandStateLeds(&device->commandState, 0xFF, (byte) command);
+	return TRUE;
+}
+
+/* Submits the specified buttons active or inactive to the device I/O thread, the others are left as they are :
+ * the event loop sets them in the device state, the buttons toggled meanwhile by the user are kept.
+ * No IO nor wait, the callback (optional) is called on completion from the device I/O thread.
+ */
+static BOOL submitButtons(GameVoiceDevice *device, size_t command, BOOL active, HidRequestCallback callback, LPVOID context)
+{
+	byte leds = active ? (byte) command : NONE;
+	HidRequest *request = usbHidCommunicator.submitFeatureLeds(getUsbDevice(device), (byte) command, leds, callback, context);
+
+	if (request == NULL)
+		return FALSE;
+	releaseHidRequest(request);
+
+	setCommandStateLeds(&device->commandState, (byte) command, leds);
+	return TRUE;
+}
+
+/* Activate the specified button (no wait)
+*/
+static BOOL activateButton(GameVoiceDevice *device, size_t command)
+{
+	return submitButtons(device, command, TRUE, NULL, NULL);
+}
+
+/* Deactivate the specified button (no wait)
+*/
+static BOOL deactivateButton(GameVoiceDevice *device, size_t command)
+{
+	return submitButtons(device, command, FALSE, NULL, NULL);
+}
+
+/* Shows LEDs on a layer above the device state (see ledCompositor.h), no wait
+*/
+static BOOL setLedLayer(GameVoiceDevice *device, enum LedLayer layer, byte mask, byte leds)
+{
+	return usbHidCommunicator.setLedLayer(getUsbDevice(device), layer, mask, leds);
+}
+
+/* Reads the button/LED state from the device, reconciling the cached state
+*/
+static byte resyncDeviceState(GameVoiceDevice *device)
+{
+	return usbHidCommunicator.resyncDeviceState(getUsbDevice(device));
+}
+
+/* Starts an LED animation on a layer of the device, played by the device I/O thread (no wait)
+*/
+static BOOL startAnimation(GameVoiceDevice *device, const LedTimeline *timeline, int layer)
+{
+	return usbHidCommunicator.startAnimation(getUsbDevice(device), timeline, layer);
+}
+
+/* Cancels the LED animation of a layer of the device (no wait)
+*/
+static BOOL cancelAnimation(GameVoiceDevice *device, int layer)
+{
+	return usbHidCommunicator.cancelAnimation(getUsbDevice(device), layer);
+}
+
+/* Runs a clockwise led chase effect by activating & deactivating all device buttons sequentially
+*/
+static void runDeviceLedChase(GameVoiceDevice *device)
+{
+	startAnimation(device, &ledChase, LED_CHASE_LAYER);
+}
+
+/* Blinks the device leds/button by activating & deactivating device buttons.
+ */
+static void blinkDevice(GameVoiceDevice *device)
+{
+	startAnimation(device, &blink, BLINK_LAYER);
+}
+
+// GameVoiceFunctions factory
+GameVoiceFunctions InitGameVoiceFunctions()
+{
+	GameVoiceFunctions gamevoiceFunctions;
+	gamevoiceFunctions.blinkDevice = blinkDevice;
+	gamevoiceFunctions.cancelAnimation = cancelAnimation;
+	gamevoiceFunctions.detachDevices = detachDevices;
+	gamevoiceFunctions.forceFeature = forceFeature;
+	gamevoiceFunctions.getDevice = getDevice;
+	gamevoiceFunctions.getDeviceCount = getDeviceCount;
+	gamevoiceFunctions.getCommandTransitions = getCommandTransitions;
+	gamevoiceFunctions.getEffectiveCommand = getEffectiveCommand;
+	gamevoiceFunctions.getLastCommandReceived = getLastCommandReceived;
+	gamevoiceFunctions.getLastFeatureSent = getLastFeatureSent;
+	gamevoiceFunctions.getLastCommandTime = getLastCommandTime;
+	gamevoiceFunctions.getPreviousCommandReceived = getPreviousCommandReceived;
+	//gamevoiceFunctions.getPreviousState = getPreviousState;
+	gamevoiceFunctions.isButtonActivated = isButtonActivated;
+	gamevoiceFunctions.isButtonActive = isButtonActive;
+	gamevoiceFunctions.isButtonDeactivated = isButtonDeactivated;
+	gamevoiceFunctions.isButtonInactive = isButtonInactive;
+	gamevoiceFunctions.getActiveButtons = getActiveButtons;
+	gamevoiceFunctions.setSupportedDevices = setSupportedDevices;
+	gamevoiceFunctions.setTimings = setTimings;
+	gamevoiceFunctions.isDeviceAttached = isDeviceAttached;
+	//gamevoiceFunctions.isNewCommand = isNewCommand;
+	//gamevoiceFunctions.isNewLastCommand = isNewLastCommand;
+	//gamevoiceFunctions.isNewExternalCommand = isNewExternalCommand;
+	//gamevoiceFunctions.isNewLastExternalCommand = isNewLastExternalCommand;
+	gamevoiceFunctions.loadDevices = loadDevices;
+	gamevoiceFunctions.readCommand = readCommand;
+	gamevoiceFunctions.readDeviceSnapshot = readDeviceSnapshot;
+	gamevoiceFunctions.readGesture = readDeviceGesture;
+	gamevoiceFunctions.releaseCommandWaiters = releaseCommandWaiters;
+	gamevoiceFunctions.resetDevice = resetDevice;
+	gamevoiceFunctions.resyncDeviceState = resyncDeviceState;
+	gamevoiceFunctions.runDeviceLedChase = runDeviceLedChase;
+	gamevoiceFunctions.sendFeature = sendFeature;
+	gamevoiceFunctions.setLedLayer = setLedLayer;
+	gamevoiceFunctions.startAnimation = startAnimation;
+	gamevoiceFunctions.submitButtons = submitButtons;
+	gamevoiceFunctions.unloadDevices = unloadDevices;
+	gamevoiceFunctions.waitForCommand = waitForCommand;
+	gamevoiceFunctions.waitForExternalCommand = waitForExternalCommand;
+
+	gamevoiceFunctions.activateButton = activateButton;
+	gamevoiceFunctions.deactivateButton = deactivateButton;
+
+	return gamevoiceFunctions;
+}
@@ -1,124 +1,212 @@
-/* 
- * Copyright (c) 2012-2019 JoeBilly 
- *
- * Game Voice helper functions header
- * gamevoice_functions.h
- * JoeBilly (joebilly@users.sourceforge.net)
- * https://github.com/ghoebilly/ts3gamevoice
- *
- *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
- *
- *  TeamSpeak 3 SideWinder Game Voice Plugin is free software: 
- *	you can redistribute it and/or modify it under the terms of the 
- *	GNU General Public License as published by the Free Software Foundation, 
- *	either version 3 of the License, or any later version.
- *
- *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope 
- *  that it will be useful, but WITHOUT ANY WARRANTY; without even the 
- *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
- *  See the GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with TeamSpeak 3 SideWinder Game Voice Plugin. 
- *  If not, see <http://www.gnu.org/licenses/>.
- */
-
-#ifndef GAMEVOICE_FUNCTIONS_H
-#define GAMEVOICE_FUNCTIONS_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-// Flags for the device commands
-enum Command {NONE = 0,  ALL = 1, TEAM = 2, CHANNEL_1 = 4, CHANNEL_2 = 8, CHANNEL_3 = 16, CHANNEL_4 = 32, COMMAND = 64, MUTE = 128};
-enum Action {DEACTIVATED = 1024, ACTIVATED = 2048};
-
-typedef struct GameVoiceFunctions
-{
-	// Device state functions
-	/* Gets the effective command applied tp the device after a waitForCommand or waitForUserCommand
-	 * Effective command contains buttons (Command) that are activated or deactivated (Action)
-	 */
-	size_t (*getEffectiveCommand)(void);
-	/* Gets the last command received from the device during a waitForCommand or waitForUserCommand.
-	 */
-	byte (*getLastCommandReceived)(void);
-	/* Gets the previous command received from the device after a waitForCommand or waitForUserCommand.
-	 */
-	byte (*getPreviousCommandReceived)(void);
-	/* Gets the last feature sent to the device during a forceFeature or sendFeature.
-	 */
-	byte (*getLastFeatureSent)(void);
-	/* Gets the device previous state after a waitForCommand or waitForUserCommand.
-	 */
-	// byte (*getPreviousState)(void);
-	/* Determines whether the specified button has been activated during a waitForcommand or waitForExternalCommand.
-	 * A button is activated if its a new command and different from the last feature sent.
-	 */
-	BOOL (*isButtonActivated)(size_t command);
-	/* Determines whether the specified button is active on the device.
-	 */
-	BOOL (*isButtonActive)(size_t command);
-	/* Determines whether the specified button has been deactivated during a waitForcommand or waitForExternalCommand.
-	 * A button is deactivated if its a new command and different from the last feature sent.
-	 */
-	BOOL (*isButtonDeactivated)(size_t command);
-	/* Determines whether the specified button is inactive on the device.
-	 */
-	BOOL (*isButtonInactive)(size_t command);
-
-	// Device general methods
-	/* Blinks the device leds/button by activating & deactivating device buttons.
-	 */
-	void (*blinkDevice)();
-	/* Loads the device : find it and attach to it
-	 */
-	BOOL (*loadDevice)();
-	/* Resets the device to its base state.
-	 */
-	void (*resetDevice)();
-	/* Runs a clockwise led chase effect by activating & deactivating all device buttons sequentially
-	 */
-	void (*runDeviceLedChase)();
-	/* Unload the device : reset and detach it
-	 */
-	void (*unloadDevice)();
-
-	// Commands handling
-	/* Reads the last command received from the device
-	 */
-	byte (*readCommand)();	
-	/* Waits for a command from the device.
-	 */
-	BOOL (*waitForCommand)();
-	/* Waits for an external command from the device.
-	 * An external command is a command different from the last feature sent.
-	 */
-	BOOL (*waitForExternalCommand)();
-
-	// Feature handling
-	/* Forces a feature to the device (sent immediately)
-	 */
-	BOOL (*forceFeature)(size_t command);
-	/* Sends a feature to the device when its available
-	 */
-	BOOL (*sendFeature)(size_t command);
-
-	// Button handling
-	/* Activate the specified button
-	*/
-	BOOL (*activateButton)(size_t command);
-
-	/* Deactivate the specified button
-	*/
-	BOOL(*deactivateButton)(size_t command);
-} GameVoiceFunctions;
-
-GameVoiceFunctions InitGameVoiceFunctions();
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif
\ No newline at end of file
+/* 
+ * Copyright (c) 2012-2019 JoeBilly 
+ *
+ * Game Voice helper functions header
+ * gamevoice_functions.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software: 
+ *	you can redistribute it and/or modify it under the terms of the 
+ *	GNU General Public License as published by the Free Software Foundation, 
+ *	either version 3 of the License, or any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope 
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the 
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin. 
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GAMEVOICE_FUNCTIONS_H
+#define GAMEVOICE_FUNCTIONS_H
+
+#include "buttonTransitions.h"
+#include "commandState.h"
+#include "gestureRecognizer.h"
+#include "hidRequest.h"
+#include "ledAnimation.h"
+#include "ledCompositor.h"
+#include "usbHidCommunication.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Flags for the device commands : the bits of the button/LED register, button n of any device is bit n
+enum Command {NONE = 0,  ALL = 1, TEAM = 2, CHANNEL_1 = 4, CHANNEL_2 = 8, CHANNEL_3 = 16, CHANNEL_4 = 32, COMMAND = 64, MUTE = 128};
+enum Action {DEACTIVATED = 1024, ACTIVATED = 2048};
+
+// Game Voice device found by loadDevices, with its own command state.
+// A device keeps its address until the devices are unloaded.
+typedef struct GameVoiceDevice GameVoiceDevice;
+
+typedef struct GameVoiceFunctions
+{
+	// Device state functions
+	/* Gets the effective command applied tp the device after a waitForCommand or waitForUserCommand
+	 * Effective command contains buttons (Command) that are activated or deactivated (Action)
+	 */
+	size_t (*getEffectiveCommand)(GameVoiceDevice *device);
+	/* Gets the buttons pressed and released by the last command received during a waitForCommand or waitForExternalCommand,
+	 * all of them : unlike the effective command, simultaneous presses and releases are kept apart.
+	 */
+	const ButtonTransitions *(*getCommandTransitions)(GameVoiceDevice *device);
+	/* Gets the last command received from the device during a waitForCommand or waitForUserCommand.
+	 */
+	byte (*getLastCommandReceived)(GameVoiceDevice *device);
+	/* Gets the previous command received from the device after a waitForCommand or waitForUserCommand.
+	 */
+	byte (*getPreviousCommandReceived)(GameVoiceDevice *device);
+	/* Gets the last feature sent to the device during a forceFeature or sendFeature.
+	 */
+	byte (*getLastFeatureSent)(GameVoiceDevice *device);
+	/* Gets the monotonic time (nanoseconds) the last command was received from the device.
+	 */
+	unsigned long long (*getLastCommandTime)(GameVoiceDevice *device);
+	/* Reads the state of the device as a whole : the command state published at once by the thread waiting
+	 * for the commands, and the last feature sent. Callable from any thread (TS3 callbacks), without lock nor IO :
+	 * the getters above read it too, one field at a time.
+	 */
+	void (*readDeviceSnapshot)(GameVoiceDevice *device, GameVoiceSnapshot *snapshot);
+	/* Gets the device previous state after a waitForCommand or waitForUserCommand.
+	 */
+	// byte (*getPreviousState)(void);
+	/* Determines whether the specified button has been activated (pressed) during a waitForcommand or waitForExternalCommand.
+	 * The echoes of the features sent are not commands : a button is activated by the user only.
+	 */
+	BOOL (*isButtonActivated)(GameVoiceDevice *device, size_t command);
+	/* Determines whether the specified button is active on the device.
+	 */
+	BOOL (*isButtonActive)(GameVoiceDevice *device, size_t command);
+	/* Determines whether the specified button has been deactivated (released) during a waitForcommand or waitForExternalCommand.
+	 * The echoes of the features sent are not commands : a button is deactivated by the user only.
+	 */
+	BOOL (*isButtonDeactivated)(GameVoiceDevice *device, size_t command);
+	/* Determines whether the specified button is inactive on the device.
+	 */
+	BOOL (*isButtonInactive)(GameVoiceDevice *device, size_t command);
+	/* Gets the buttons active on the device (cached state, no IO), the register the bindings are run with.
+	 */
+	byte (*getActiveButtons)(GameVoiceDevice *device);
+	/* Sets the debounce windows (nanoseconds, one per button) and the gesture timings of the devices (see pluginConfig.h),
+	 * before loadDevices, which attaches them with these. Called again from the thread waiting for the commands,
+	 * it replaces them without resetting the devices : the buttons held keep their state.
+	 */
+	void (*setTimings)(const unsigned long long *debounceWindows, const GestureTimings *timings);
+
+	// Device general methods
+	/* Blinks the device leds/button by activating & deactivating device buttons.
+	 * The blink is an animation played over the others, the call does not wait for it.
+	 */
+	void (*blinkDevice)(GameVoiceDevice *device);
+	/* Sets the device models (VID and PID, ended by a zero VID) the next loadDevices finds and attaches,
+	 * the Game Voice only until then. At most USB_HID_MAX_DEVICE_IDS models are kept.
+	 */
+	void (*setSupportedDevices)(const UsbDeviceId *deviceIds);
+	/* Loads the devices : find them all and attach to them.
+	 * Returns TRUE if at least one device is attached.
+	 */
+	BOOL (*loadDevices)();
+	/* Gets the number of devices found by loadDevices (attached or not anymore).
+	 */
+	int (*getDeviceCount)();
+	/* Gets a device found by loadDevices, NULL if there are not as many devices.
+	 */
+	GameVoiceDevice *(*getDevice)(int deviceIndex);
+	/* Determines whether the device is attached.
+	 */
+	BOOL (*isDeviceAttached)(GameVoiceDevice *device);
+	/* Resets the device to its base state.
+	 * No thread may wait for the commands meanwhile (see releaseCommandWaiters) : the command state is theirs.
+	 */
+	void (*resetDevice)(GameVoiceDevice *device);
+	/* Reads the button/LED state from the device, reconciling the cached state the button queries use.
+	 * The device I/O thread reads it, the call waits for it : the only button query performing IO.
+	 */
+	byte (*resyncDeviceState)(GameVoiceDevice *device);
+	/* Runs a clockwise led chase effect by activating & deactivating all device buttons sequentially.
+	 * The chase is an animation, the call does not wait for it.
+	 */
+	void (*runDeviceLedChase)(GameVoiceDevice *device);
+	/* Starts an LED animation on a layer of the device (see ledAnimation.h), replacing the one playing there.
+	 * The device I/O thread plays it on the animation layer of the LEDs, the call does not wait : the buttons are read
+	 * meanwhile, and the features sent meanwhile are shown once no animation plays. The timeline must live as long as it plays.
+	 */
+	BOOL (*startAnimation)(GameVoiceDevice *device, const LedTimeline *timeline, int layer);
+	/* Cancels the LED animation of a layer of the device, of every layer with LED_ANIMATION_ALL_LAYERS (no wait).
+	 */
+	BOOL (*cancelAnimation)(GameVoiceDevice *device, int layer);
+	/* Shows the LEDs of a mask on a layer above the device state (see ledCompositor.h) : a notification
+	 * or a user override, a mask of 0 clears the layer. The device I/O thread composes the layers and writes
+	 * the LEDs only when they change, the call does not wait. The reset of the device clears the layers.
+	 */
+	BOOL (*setLedLayer)(GameVoiceDevice *device, enum LedLayer layer, byte mask, byte leds);
+	/* Detaches all the devices, the threads waiting for a command are released.
+	 */
+	void (*detachDevices)();
+	/* Releases the thread waiting for a command, for good : waitForCommand returns NULL from then on.
+	 * The devices stay attached, so that they can be unloaded once the thread is over.
+	 */
+	void (*releaseCommandWaiters)();
+	/* Unload the devices : reset each of them once, then detach them.
+	 * The thread waiting for a command must be over (see releaseCommandWaiters), it owns their state.
+	 */
+	void (*unloadDevices)();
+
+	// Commands handling
+	/* Reads the last command received from the device, debounced
+	 */
+	byte (*readCommand)(GameVoiceDevice *device);	
+	/* Reads the oldest gesture recognized on the device and not read yet (see GESTURES_VARIABLE).
+	 * Returns FALSE if there is none.
+	 */
+	BOOL (*readGesture)(GameVoiceDevice *device, Gesture *gesture);
+	/* Waits for a command from any device : a change of its buttons, debounced (see DEBOUNCE_VARIABLE).
+	 * The reports of a button state the device can't report (glitches) are dropped.
+	 * The wait also ends on gestures recognized by a timer : the device returned has no command transition then.
+	 * Returns the device the command has been received from, NULL once the waiters are released (see releaseCommandWaiters).
+	 */
+	GameVoiceDevice *(*waitForCommand)();
+	/* Waits for an external command from any device.
+	 * An external command is a command of the user, the echoes of the features sent are never commands.
+	 * Returns the device the command has been received from, NULL once the waiters are released (see releaseCommandWaiters).
+	 */
+	GameVoiceDevice *(*waitForExternalCommand)();
+
+	// Feature handling
+	/* Forces a feature to the device (sent immediately)
+	 */
+	BOOL (*forceFeature)(GameVoiceDevice *device, size_t command);
+	/* Sends a feature to the device when its available
+	 */
+	BOOL (*sendFeature)(GameVoiceDevice *device, size_t command);
+
+	// Button handling
+	/* Activate the specified button, the others are left as they are (even if the user toggles them meanwhile).
+	 * Submitted to the device I/O thread without IO nor wait : safe from the TS3 client callbacks.
+	 * Returns FALSE if the device is not attached or not responding.
+	*/
+	BOOL (*activateButton)(GameVoiceDevice *device, size_t command);
+
+	/* Deactivate the specified button, like activateButton
+	*/
+	BOOL(*deactivateButton)(GameVoiceDevice *device, size_t command);
+
+	/* Submits the specified buttons active or inactive like activateButton and deactivateButton,
+	 * the callback (optional) is called from the device I/O thread once the LEDs show them (must not block).
+	 */
+	BOOL (*submitButtons)(GameVoiceDevice *device, size_t command, BOOL active, HidRequestCallback callback, LPVOID context);
+} GameVoiceFunctions;
+
+GameVoiceFunctions InitGameVoiceFunctions();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
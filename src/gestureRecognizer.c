@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Button gesture recognition functions
+ * gestureRecognizer.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdlib.h>
+#include "stdafx.h"
+#include "gestureRecognizer.h"
+
+static const char *typeNames[gestureTypeCount] =
+{
+	"TAP",
+	"DOUBLE",
+	"HOLD",
+	"CHORD"
+};
+
+BOOL parseGestureTimings(const char *setting, GestureTimings *timings)
+{
+	GestureTimings parsed = *timings;
+	const char *cursor = setting;
+	char *end;
+
+	do
+	{
+		const char *value = strchr(cursor, '=');
+		unsigned long long *timing;
+		long time;
+
+		if (value == NULL)
+			return FALSE;
+
+		if (value - cursor == 4 && strncmp(cursor, "hold", 4) == 0)
+			timing = &parsed.holdTime;
+		else if (value - cursor == 6 && strncmp(cursor, "double", 6) == 0)
+			timing = &parsed.doubleTapTime;
+		else if (value - cursor == 5 && strncmp(cursor, "chord", 5) == 0)
+			timing = &parsed.chordTime;
+		else
+			return FALSE;
+
+		cursor = value + 1;
+		time = strtol(cursor, &end, 10);
+		if (end == cursor || time < 0 || time > 5000)
+			return FALSE;
+
+		*timing = (unsigned long long) time * 1000000ULL;
+		cursor = end + 1;
+	} while (*end == ',');
+
+	if (*end != '\0')
+		return FALSE;
+
+	*timings = parsed;
+	return TRUE;
+}
+
+void initGestureRecognizer(GestureRecognizer *recognizer, const GestureTimings *timings)
+{
+	memset(recognizer, 0, sizeof(GestureRecognizer));
+	recognizer->timings = *timings;
+	recognizer->phase = gesturesIdle;
+}
+
+// Queues a gesture start or end, dropped if the queue is full
+static void queueGesture(GestureRecognizer *recognizer, enum GestureType type, BOOL down)
+{
+	Gesture *gesture;
+
+	if (recognizer->queueCount == GESTURE_QUEUE_SIZE)
+		return;
+
+	gesture = &recognizer->queue[(recognizer->queueHead + recognizer->queueCount++) % GESTURE_QUEUE_SIZE];
+	gesture->type = type;
+	gesture->buttons = recognizer->buttons;
+	gesture->down = down;
+	gesture->pressTime = recognizer->pressTime;
+	gesture->inputTime = recognizer->inputTime;
+}
+
+// Starts the gesture of the buttons held, it ends on their release
+static void startGesture(GestureRecognizer *recognizer, enum GestureType type)
+{
+	queueGesture(recognizer, type, TRUE);
+	recognizer->activeType = type;
+	recognizer->phase = gestureActive;
+	recognizer->deadline = 0;
+}
+
+// Starts and ends a gesture at once, then waits for the buttons still held to be released
+static void completeGesture(GestureRecognizer *recognizer, enum GestureType type)
+{
+	queueGesture(recognizer, type, TRUE);
+	queueGesture(recognizer, type, FALSE);
+	recognizer->phase = recognizer->held != 0 ? gestureConsumed : gesturesIdle;
+	recognizer->deadline = 0;
+}
+
+// Waits for more buttons pressed with the ones held, or recognizes the chord at once without chord time
+static void waitForChord(GestureRecognizer *recognizer, unsigned long long time)
+{
+	if (recognizer->timings.chordTime == 0)
+	{
+		startGesture(recognizer, gestureChord);
+		return;
+	}
+
+	recognizer->phase = gestureChording;
+	recognizer->deadline = time + recognizer->timings.chordTime;
+}
+
+// Starts recognizing from the buttons pressed while none was held
+static void beginGesture(GestureRecognizer *recognizer, byte pressed, unsigned long long time)
+{
+	recognizer->buttons = pressed;
+	recognizer->pressTime = time;
+	recognizer->inputTime = time;
+
+	if (pressed & (pressed - 1))
+		waitForChord(recognizer, time);
+	else
+	{
+		recognizer->phase = gesturePressed;
+		recognizer->deadline = recognizer->timings.holdTime != 0 ? time + recognizer->timings.holdTime : 0;
+	}
+}
+
+static void pressButtons(GestureRecognizer *recognizer, byte pressed, unsigned long long time)
+{
+	recognizer->held |= pressed;
+
+	switch (recognizer->phase)
+	{
+	case gesturesIdle:
+		beginGesture(recognizer, pressed, time);
+		break;
+
+	case gestureReleased:
+		// The same button again makes a double tap, another button ends the tap
+		if (pressed == recognizer->buttons)
+		{
+			recognizer->inputTime = time;
+			startGesture(recognizer, gestureDoubleTap);
+			break;
+		}
+		completeGesture(recognizer, gestureTap);
+		beginGesture(recognizer, pressed, time);
+		break;
+
+	case gesturePressed:
+	case gestureChording:
+		recognizer->buttons |= pressed;
+		recognizer->inputTime = time;
+		waitForChord(recognizer, time);
+		break;
+
+	default:
+		break;
+	}
+}
+
+static void releaseButtons(GestureRecognizer *recognizer, byte released, unsigned long long time)
+{
+	recognizer->held &= (byte) ~released;
+
+	switch (recognizer->phase)
+	{
+	case gesturePressed:
+		recognizer->inputTime = time;
+		if (recognizer->timings.doubleTapTime == 0)
+		{
+			completeGesture(recognizer, gestureTap);
+			break;
+		}
+		recognizer->phase = gestureReleased;
+		recognizer->deadline = time + recognizer->timings.doubleTapTime;
+		break;
+
+	case gestureChording:
+		completeGesture(recognizer, gestureChord);
+		break;
+
+	case gestureActive:
+		queueGesture(recognizer, recognizer->activeType, FALSE);
+		recognizer->phase = recognizer->held != 0 ? gestureConsumed : gesturesIdle;
+		break;
+
+	case gestureConsumed:
+		if (recognizer->held == 0)
+			recognizer->phase = gesturesIdle;
+		break;
+
+	default:
+		break;
+	}
+}
+
+void feedGestureTransitions(GestureRecognizer *recognizer, const ButtonTransitions *transitions, unsigned long long time)
+{
+	advanceGestures(recognizer, time);
+
+	if (transitions->pressed != 0)
+		pressButtons(recognizer, transitions->pressed, time);
+	if (transitions->released != 0)
+		releaseButtons(recognizer, transitions->released, time);
+}
+
+void feedGestureToggles(GestureRecognizer *recognizer, const ButtonTransitions *transitions, unsigned long long time)
+{
+	byte toggled = transitions->pressed | transitions->released;
+
+	advanceGestures(recognizer, time);
+
+	if (toggled != 0)
+	{
+		pressButtons(recognizer, toggled, time);
+		releaseButtons(recognizer, toggled, time);
+	}
+}
+
+void advanceGestures(GestureRecognizer *recognizer, unsigned long long time)
+{
+	if (recognizer->deadline == 0 || time < recognizer->deadline)
+		return;
+
+	switch (recognizer->phase)
+	{
+	case gesturePressed:
+		startGesture(recognizer, gestureHold);
+		break;
+
+	case gestureChording:
+		startGesture(recognizer, gestureChord);
+		break;
+
+	case gestureReleased:
+		completeGesture(recognizer, gestureTap);
+		break;
+
+	default:
+		recognizer->deadline = 0;
+		break;
+	}
+}
+
+unsigned long long getGestureDeadline(const GestureRecognizer *recognizer)
+{
+	return recognizer->deadline;
+}
+
+BOOL readGesture(GestureRecognizer *recognizer, Gesture *gesture)
+{
+	if (recognizer->queueCount == 0)
+		return FALSE;
+
+	*gesture = recognizer->queue[recognizer->queueHead];
+	recognizer->queueHead = (recognizer->queueHead + 1) % GESTURE_QUEUE_SIZE;
+	recognizer->queueCount--;
+	return TRUE;
+}
+
+BOOL hasGestures(const GestureRecognizer *recognizer)
+{
+	return recognizer->queueCount != 0;
+}
+
+const char *getGestureTypeName(enum GestureType type)
+{
+	return (unsigned int) type < gestureTypeCount ? typeNames[type] : "UNKNOWN";
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Button gesture recognition functions header
+ * gestureRecognizer.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef GESTURERECOGNIZER_H
+#define GESTURERECOGNIZER_H
+
+#include "buttonTransitions.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Environment variable holding the gesture timings (milliseconds), any of them in any order,
+// e.g. "hold=500,double=250,chord=50"
+#define GESTURES_VARIABLE "GAMEVOICE_GESTURES"
+
+// Gesture timings without any setting (milliseconds)
+#define DEFAULT_HOLD_TIME 500
+#define DEFAULT_DOUBLE_TAP_TIME 250
+#define DEFAULT_CHORD_TIME 50
+
+// Gestures recognized and not read yet kept by a recognizer, the newer ones are dropped
+#define GESTURE_QUEUE_SIZE 16
+
+// Gesture made with the buttons
+enum GestureType
+{
+	gestureTap,			// Button pressed and released, no second press within the double tap time
+	gestureDoubleTap,	// Button pressed again within the double tap time, recognized on the second press
+	gestureHold,		// Button held alone for the hold time, recognized while it is still held
+	gestureChord,		// Buttons held together, the others pressed before the first one makes a hold :
+						// recognized once no button is pressed for the chord time, or on the first release
+	gestureTypeCount
+};
+
+// Gesture timings (nanoseconds). A hold time of 0 turns the holds off, a double tap time of 0
+// turns the double taps off (taps are recognized on release), a chord time of 0 recognizes the
+// chords on the second button pressed.
+typedef struct GestureTimings
+{
+	unsigned long long holdTime;
+	unsigned long long doubleTapTime;
+	unsigned long long chordTime;
+} GestureTimings;
+
+// Gesture recognized : it starts (down) once recognized and ends (up) on the release of its buttons.
+// A tap, or a chord released before its chord time, starts and ends at once.
+typedef struct Gesture
+{
+	enum GestureType type;
+	byte buttons;
+	BOOL down;
+
+	// Time (monotonic, nanoseconds) of the first press of the gesture, and of the input
+	// it was recognized from : the release of a tap, the second press of a double tap, the last press
+	// of a chord or hold. Recognitions by a timer happen after the input time.
+	unsigned long long pressTime;
+	unsigned long long inputTime;
+} Gesture;
+
+enum GesturePhase
+{
+	gesturesIdle,		// No button held
+	gesturePressed,		// A button held, hold time running
+	gestureChording,	// Buttons held, chord time running
+	gestureReleased,	// A button released, double tap time running
+	gestureActive,		// Gesture started, ends on a release
+	gestureConsumed		// Gesture ended, waits for all the buttons released
+};
+
+// Gesture recognizer of a device, fed with its button transitions and driven by its deadline :
+// one gesture at a time, the presses made while a gesture is active or consumed are ignored.
+typedef struct GestureRecognizer
+{
+	GestureTimings timings;
+	enum GesturePhase phase;
+	enum GestureType activeType;
+	byte held;
+	byte buttons;
+	unsigned long long pressTime;
+	unsigned long long inputTime;
+	unsigned long long deadline;
+
+	Gesture queue[GESTURE_QUEUE_SIZE];
+	unsigned int queueHead;
+	unsigned int queueCount;
+} GestureRecognizer;
+
+/* Parses gesture timings (see GESTURES_VARIABLE) into nanoseconds, the timings missing are left alone.
+ * Returns FALSE, leaving the timings alone, if the setting is malformed.
+ */
+BOOL parseGestureTimings(const char *setting, GestureTimings *timings);
+
+/* Starts recognizing from all the buttons released.
+ */
+void initGestureRecognizer(GestureRecognizer *recognizer, const GestureTimings *timings);
+
+/* Feeds the button transitions read at the specified time (monotonic, nanoseconds).
+ * The timers due by then are run first.
+ */
+void feedGestureTransitions(GestureRecognizer *recognizer, const ButtonTransitions *transitions, unsigned long long time);
+
+/* Feeds the button transitions of a latched register (see HidDeviceModel) : a press toggles the button
+ * and its release is not reported, so every transition is a press of its button, released at once.
+ * Taps, double taps and the chords of the buttons reported together are recognized, holds never are.
+ */
+void feedGestureToggles(GestureRecognizer *recognizer, const ButtonTransitions *transitions, unsigned long long time);
+
+/* Runs the timers due by the specified time : hold, chord and double tap times over.
+ */
+void advanceGestures(GestureRecognizer *recognizer, unsigned long long time);
+
+/* Gets the time the next timer is due (see advanceGestures), 0 if none is running.
+ */
+unsigned long long getGestureDeadline(const GestureRecognizer *recognizer);
+
+/* Reads the oldest gesture recognized and not read yet.
+ * Returns FALSE if there is none.
+ */
+BOOL readGesture(GestureRecognizer *recognizer, Gesture *gesture);
+
+/* Determines whether gestures have been recognized and not read yet.
+ */
+BOOL hasGestures(const GestureRecognizer *recognizer);
+
+/* Gets the name of a gesture type, the key identifiers prefix of its gestures.
+ */
+const char *getGestureTypeName(enum GestureType type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
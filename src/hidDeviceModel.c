@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * HID device model functions
+ * hidDeviceModel.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include "stdafx.h"
+#include "hidDeviceModel.h"
+
+// Report types, in the order of their main item tags
+enum HidReportType {hidInputReport, hidOutputReport, hidFeatureReport, hidReportTypeCount};
+
+// Item types and the tags used by the parser (HID 1.11, 6.2.2)
+#define HID_ITEM_MAIN 0
+#define HID_ITEM_GLOBAL 1
+#define HID_ITEM_LOCAL 2
+#define HID_ITEM_LONG 0xFE
+
+#define HID_MAIN_INPUT 0x8
+#define HID_MAIN_OUTPUT 0x9
+#define HID_MAIN_FEATURE 0xB
+
+#define HID_GLOBAL_USAGE_PAGE 0x0
+#define HID_GLOBAL_REPORT_SIZE 0x7
+#define HID_GLOBAL_REPORT_ID 0x8
+#define HID_GLOBAL_REPORT_COUNT 0x9
+#define HID_GLOBAL_PUSH 0xA
+#define HID_GLOBAL_POP 0xB
+
+#define HID_LOCAL_USAGE 0x0
+#define HID_LOCAL_USAGE_MINIMUM 0x1
+#define HID_LOCAL_USAGE_MAXIMUM 0x2
+
+// Main item data flags : constant (padding) and variable (one field per usage)
+#define HID_MAIN_CONSTANT 0x01
+#define HID_MAIN_VARIABLE 0x02
+
+// Usages of a main item kept by the parser, further ones repeat the last one
+#define HID_MAX_USAGES 32
+
+// Depth of the global items stack (push/pop)
+#define HID_MAX_GLOBALS_DEPTH 4
+
+// Report IDs fit in a byte, 0 when the device does not number its reports
+#define HID_REPORT_IDS 256
+
+// Global items state
+typedef struct HidGlobals
+{
+	unsigned long usagePage;
+	unsigned long reportSize;
+	unsigned long reportCount;
+	unsigned long reportId;
+} HidGlobals;
+
+// Parser state : the current global and local items, and the bits described for every report
+typedef struct HidParser
+{
+	HidGlobals globals;
+	HidGlobals globalsStack[HID_MAX_GLOBALS_DEPTH];
+	int globalsDepth;
+
+	unsigned long usages[HID_MAX_USAGES];
+	int usageCount;
+	unsigned long usageMinimum;
+	unsigned long usageMaximum;
+	BOOL usageRange;
+
+	// Data bits of every report (report ID byte excluded), and the first report ID of each type
+	unsigned long reportBits[hidReportTypeCount][HID_REPORT_IDS];
+	int firstReportId[hidReportTypeCount];
+
+	// Report of the buttons and of the LEDs, -1 until found
+	int buttonReportId;
+	int ledReportId;
+	enum HidReportType ledReportType;
+	int ledCount;
+} HidParser;
+
+static void resetHidDeviceModel(HidDeviceModel *model)
+{
+	int button;
+
+	memset(model, 0, sizeof(HidDeviceModel));
+	for (button = 0; button < HID_MODEL_MAX_BUTTONS; button++)
+	{
+		model->buttonBits[button] = -1;
+		model->ledBits[button] = -1;
+	}
+	model->ledReport = hidLedsNone;
+}
+
+// Sets the Game Voice buttons and LEDs : bit n of byte 1 is button n, latched, the register is echoed
+static void setGameVoiceBits(HidDeviceModel *model)
+{
+	int button;
+
+	for (button = 0; button < HID_MODEL_MAX_BUTTONS; button++)
+	{
+		model->buttonBits[button] = 8 + button;
+		model->ledBits[button] = 8 + button;
+	}
+	model->ledReport = hidLedsInFeature;
+	model->echoesLedState = TRUE;
+	model->latchedButtons = TRUE;
+}
+
+// The Game Voice register never holds all its channel, team and all buttons (63) nor the values
+// from 205 up, a report of them is a glitch
+void setHidModelValidStates(HidDeviceModel *model, BOOL gameVoice)
+{
+	int state, button;
+	byte buttonMask = 0;
+
+	for (button = 0; button < HID_MODEL_MAX_BUTTONS; button++)
+	{
+		if (model->buttonBits[button] >= 0)
+			buttonMask |= (byte) (1 << button);
+	}
+
+	memset(model->validStates, 0, sizeof(model->validStates));
+	for (state = 0; state < HID_MODEL_STATES; state++)
+	{
+		if ((state & ~buttonMask) != 0 || (gameVoice && (state == 63 || state >= 205)))
+			continue;
+
+		model->validStates[state / 8] |= (unsigned char) (1 << (state % 8));
+	}
+}
+
+void initGameVoiceDeviceModel(HidDeviceModel *model)
+{
+	resetHidDeviceModel(model);
+	model->inputReportLength = REPORT_SIZE;
+	model->outputReportLength = REPORT_SIZE;
+	model->featureReportLength = REPORT_SIZE;
+	setGameVoiceBits(model);
+	setHidModelValidStates(model, TRUE);
+}
+
+// Gets the usage of the field of a main item, with its page (extended usage), 0 if there is none
+static unsigned long getFieldUsage(HidParser *parser, unsigned long field)
+{
+	unsigned long usage;
+
+	if (parser->usageCount > 0)
+		usage = parser->usages[field < (unsigned long) parser->usageCount ? field : (unsigned long) parser->usageCount - 1];
+	else if (parser->usageRange && parser->usageMinimum + field <= parser->usageMaximum)
+		usage = parser->usageMinimum + field;
+	else
+		return 0;
+
+	// A 4 bytes usage holds its page in the high word
+	if (usage <= 0xFFFF)
+		usage |= parser->globals.usagePage << 16;
+	return usage;
+}
+
+// Records the fields of an input, output or feature main item
+static void addMainItem(HidParser *parser, enum HidReportType type, unsigned long flags, HidDeviceModel *model)
+{
+	unsigned long reportId = parser->globals.reportId;
+	unsigned long field;
+
+	if (parser->firstReportId[type] < 0)
+		parser->firstReportId[type] = (int) reportId;
+
+	for (field = 0; field < parser->globals.reportCount && field < 8 * REPORT_SIZE; field++)
+	{
+		unsigned long usage = getFieldUsage(parser, field);
+		unsigned long page = usage >> 16;
+		unsigned long bit = 8 + parser->reportBits[type][reportId] + field * parser->globals.reportSize;
+
+		// Only the 1 bit data fields (padding excluded) within the report buffers are buttons or LEDs
+		if ((flags & HID_MAIN_CONSTANT) || !(flags & HID_MAIN_VARIABLE) || parser->globals.reportSize != 1 || bit >= 8 * REPORT_SIZE)
+			continue;
+
+		// Button n of the first report holding buttons is button n of the model
+		if (type == hidInputReport && page == HID_USAGE_PAGE_BUTTON && (usage & 0xFFFF) >= 1 && (usage & 0xFFFF) <= HID_MODEL_MAX_BUTTONS
+			&& (parser->buttonReportId < 0 || parser->buttonReportId == (int) reportId)
+			&& model->buttonBits[(usage & 0xFFFF) - 1] < 0)
+		{
+			parser->buttonReportId = (int) reportId;
+			model->buttonBits[(usage & 0xFFFF) - 1] = (int) bit;
+		}
+
+		// The LEDs of the first report holding LEDs, in their order, light the buttons of the model
+		if (type != hidInputReport && page == HID_USAGE_PAGE_LED && parser->ledCount < HID_MODEL_MAX_BUTTONS
+			&& (parser->ledReportId < 0 || (parser->ledReportId == (int) reportId && parser->ledReportType == type)))
+		{
+			parser->ledReportId = (int) reportId;
+			parser->ledReportType = type;
+			model->ledBits[parser->ledCount++] = (int) bit;
+		}
+	}
+
+	parser->reportBits[type][reportId] += parser->globals.reportCount * parser->globals.reportSize;
+}
+
+// Gets the length of a report buffer, report ID byte included, 0 if the report does not exist
+static DWORD getReportLength(HidParser *parser, enum HidReportType type, int reportId)
+{
+	unsigned long length;
+
+	if (reportId < 0 || parser->reportBits[type][reportId] == 0)
+		return 0;
+
+	length = 1 + (parser->reportBits[type][reportId] + 7) / 8;
+	return length > REPORT_SIZE ? REPORT_SIZE : (DWORD) length;
+}
+
+BOOL parseHidReportDescriptor(const unsigned char *descriptor, DWORD length, HidDeviceModel *model)
+{
+	HidParser *parser;
+	DWORD position = 0;
+	int type;
+	BOOL parsed = TRUE, gameVoiceLayout;
+
+	resetHidDeviceModel(model);
+
+	// Too large for the stack of the caller
+	parser = (HidParser *) allocatePlatformMemory(sizeof(HidParser));
+	if (parser == NULL)
+		return FALSE;
+
+	for (type = 0; type < hidReportTypeCount; type++)
+		parser->firstReportId[type] = -1;
+	parser->buttonReportId = -1;
+	parser->ledReportId = -1;
+
+	while (parsed && position < length)
+	{
+		unsigned char prefix = descriptor[position++];
+		unsigned long value = 0;
+		int size = prefix & 0x3;
+		int item, tag, byteIndex;
+
+		// Long items are reserved, skip them
+		if (prefix == HID_ITEM_LONG)
+		{
+			if (position + 2 > length)
+			{
+				parsed = FALSE;
+				break;
+			}
+			position += 2 + descriptor[position];
+			continue;
+		}
+
+		if (size == 3)
+			size = 4;
+		if (position + size > length)
+		{
+			parsed = FALSE;
+			break;
+		}
+
+		for (byteIndex = 0; byteIndex < size; byteIndex++)
+			value |= (unsigned long) descriptor[position + byteIndex] << (8 * byteIndex);
+		position += size;
+
+		item = (prefix >> 2) & 0x3;
+		tag = prefix >> 4;
+
+		if (item == HID_ITEM_MAIN)
+		{
+			if (tag == HID_MAIN_INPUT)
+				addMainItem(parser, hidInputReport, value, model);
+			else if (tag == HID_MAIN_OUTPUT)
+				addMainItem(parser, hidOutputReport, value, model);
+			else if (tag == HID_MAIN_FEATURE)
+				addMainItem(parser, hidFeatureReport, value, model);
+
+			// Local items only apply to the next main item
+			parser->usageCount = 0;
+			parser->usageRange = FALSE;
+		}
+		else if (item == HID_ITEM_GLOBAL)
+		{
+			switch (tag)
+			{
+			case HID_GLOBAL_USAGE_PAGE:
+				parser->globals.usagePage = value & 0xFFFF;
+				break;
+
+			case HID_GLOBAL_REPORT_SIZE:
+				parser->globals.reportSize = value;
+				break;
+
+			case HID_GLOBAL_REPORT_ID:
+				if (value == 0 || value >= HID_REPORT_IDS)
+					parsed = FALSE;
+				parser->globals.reportId = value & 0xFF;
+				model->numberedReports = TRUE;
+				break;
+
+			case HID_GLOBAL_REPORT_COUNT:
+				parser->globals.reportCount = value;
+				break;
+
+			case HID_GLOBAL_PUSH:
+				if (parser->globalsDepth == HID_MAX_GLOBALS_DEPTH)
+					parsed = FALSE;
+				else
+					parser->globalsStack[parser->globalsDepth++] = parser->globals;
+				break;
+
+			case HID_GLOBAL_POP:
+				if (parser->globalsDepth == 0)
+					parsed = FALSE;
+				else
+					parser->globals = parser->globalsStack[--parser->globalsDepth];
+				break;
+
+			default:
+				break;
+			}
+		}
+		else if (item == HID_ITEM_LOCAL)
+		{
+			switch (tag)
+			{
+			case HID_LOCAL_USAGE:
+				if (parser->usageCount < HID_MAX_USAGES)
+					parser->usages[parser->usageCount++] = value;
+				break;
+
+			case HID_LOCAL_USAGE_MINIMUM:
+				parser->usageMinimum = value;
+				parser->usageRange = TRUE;
+				break;
+
+			case HID_LOCAL_USAGE_MAXIMUM:
+				parser->usageMaximum = value;
+				parser->usageRange = TRUE;
+				break;
+
+			default:
+				break;
+			}
+		}
+	}
+
+	// Vendor defined reports only : the Game Voice layout in the reports described
+	gameVoiceLayout = parsed && parser->buttonReportId < 0 && parser->firstReportId[hidInputReport] >= 0;
+	if (gameVoiceLayout)
+	{
+		parser->buttonReportId = parser->firstReportId[hidInputReport];
+		parser->ledReportId = parser->firstReportId[hidFeatureReport];
+		parser->ledReportType = hidFeatureReport;
+		setGameVoiceBits(model);
+		if (parser->ledReportId < 0)
+			model->ledReport = hidLedsNone;
+	}
+	else if (parser->ledReportId >= 0)
+		model->ledReport = parser->ledReportType == hidOutputReport ? hidLedsInOutput : hidLedsInFeature;
+
+	// The reports used : the ones of the buttons and the LEDs, the first ones of their type otherwise
+	model->inputReportId = (unsigned char) (parser->buttonReportId >= 0 ? parser->buttonReportId : 0);
+	model->inputReportLength = getReportLength(parser, hidInputReport, parser->buttonReportId);
+	model->outputReportId = (unsigned char) (model->ledReport == hidLedsInOutput ? parser->ledReportId : (parser->firstReportId[hidOutputReport] >= 0 ? parser->firstReportId[hidOutputReport] : 0));
+	model->outputReportLength = getReportLength(parser, hidOutputReport, model->outputReportId);
+	model->featureReportId = (unsigned char) (model->ledReport == hidLedsInFeature ? parser->ledReportId : (parser->firstReportId[hidFeatureReport] >= 0 ? parser->firstReportId[hidFeatureReport] : 0));
+	model->featureReportLength = getReportLength(parser, hidFeatureReport, model->featureReportId);
+
+	// Bits beyond the report lengths (reports larger than the buffers) are dropped
+	for (type = 0; type < HID_MODEL_MAX_BUTTONS; type++)
+	{
+		if (model->buttonBits[type] >= (int) (8 * model->inputReportLength))
+			model->buttonBits[type] = -1;
+		if (model->ledBits[type] >= (int) (8 * (model->ledReport == hidLedsInOutput ? model->outputReportLength : model->featureReportLength)))
+			model->ledBits[type] = -1;
+	}
+
+	setHidModelValidStates(model, gameVoiceLayout);
+	parsed = parsed && model->inputReportLength > 0;
+	freePlatformMemory(parser);
+	return parsed;
+}
+
+BOOL decodeHidButtons(const HidDeviceModel *model, const unsigned char *report, DWORD length, byte *state)
+{
+	int button;
+
+	if (length == 0 || (model->numberedReports && report[0] != model->inputReportId))
+		return FALSE;
+
+	*state = 0;
+	for (button = 0; button < HID_MODEL_MAX_BUTTONS; button++)
+	{
+		int bit = model->buttonBits[button];
+
+		if (bit >= 0 && (DWORD) (bit / 8) < length && (report[bit / 8] & (1 << (bit % 8))))
+			*state |= (byte) (1 << button);
+	}
+
+	return TRUE;
+}
+
+BOOL isValidHidButtonState(const HidDeviceModel *model, byte state)
+{
+	return (model->validStates[state / 8] >> (state % 8)) & 1;
+}
+
+byte decodeHidLeds(const HidDeviceModel *model, const unsigned char *report, DWORD length)
+{
+	byte state = 0;
+	int led;
+
+	for (led = 0; led < HID_MODEL_MAX_BUTTONS; led++)
+	{
+		int bit = model->ledBits[led];
+
+		if (bit >= 0 && (DWORD) (bit / 8) < length && (report[bit / 8] & (1 << (bit % 8))))
+			state |= (byte) (1 << led);
+	}
+
+	return state;
+}
+
+DWORD encodeHidLeds(const HidDeviceModel *model, byte state, unsigned char *report)
+{
+	DWORD length;
+	int led;
+
+	if (model->ledReport == hidLedsNone)
+		return 0;
+
+	length = model->ledReport == hidLedsInOutput ? model->outputReportLength : model->featureReportLength;
+	memset(report, 0, length);
+	report[0] = model->ledReport == hidLedsInOutput ? model->outputReportId : model->featureReportId;
+
+	for (led = 0; led < HID_MODEL_MAX_BUTTONS; led++)
+	{
+		int bit = model->ledBits[led];
+
+		if (bit >= 0 && (state & (1 << led)))
+			report[bit / 8] |= (unsigned char) (1 << (bit % 8));
+	}
+
+	return length;
+}
+
+DWORD encodeHidButtons(const HidDeviceModel *model, byte state, unsigned char *report)
+{
+	int button;
+
+	memset(report, 0, model->inputReportLength);
+	report[0] = model->inputReportId;
+
+	for (button = 0; button < HID_MODEL_MAX_BUTTONS; button++)
+	{
+		int bit = model->buttonBits[button];
+
+		if (bit >= 0 && (state & (1 << button)))
+			report[bit / 8] |= (unsigned char) (1 << (bit % 8));
+	}
+
+	return model->inputReportLength;
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * HID device model functions header
+ * hidDeviceModel.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HIDDEVICEMODEL_H
+#define HIDDEVICEMODEL_H
+
+#include "reportQueue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of buttons (and LEDs) of the button model : the bits of its 8 bits register,
+// button n of a device (HID Button usage n + 1) is bit n of the register
+#define HID_MODEL_MAX_BUTTONS 8
+
+// Number of states of the button register
+#define HID_MODEL_STATES 256
+
+// HID usage pages of the buttons and the LEDs
+#define HID_USAGE_PAGE_BUTTON 0x09
+#define HID_USAGE_PAGE_LED 0x08
+
+// Report carrying the LED state of a device
+enum HidLedReport {hidLedsNone, hidLedsInOutput, hidLedsInFeature};
+
+// Layout of the reports of a device, found from its report descriptor at attach time :
+// the report IDs and lengths, and the bits of the buttons and LEDs mapped onto the button model.
+// Lengths count the report ID byte (byte 0, 0 when the device does not number its reports)
+// like the transport buffers, and never exceed REPORT_SIZE. A length of 0 means there is no such report.
+typedef struct HidDeviceModel
+{
+	BOOL numberedReports;
+
+	unsigned char inputReportId;
+	DWORD inputReportLength;
+	unsigned char outputReportId;
+	DWORD outputReportLength;
+	unsigned char featureReportId;
+	DWORD featureReportLength;
+
+	// Bit offsets (from the start of the report buffer) of the buttons in the input report, -1 if missing
+	int buttonBits[HID_MODEL_MAX_BUTTONS];
+
+	// Report and bit offsets of the LEDs, -1 if missing
+	enum HidLedReport ledReport;
+	int ledBits[HID_MODEL_MAX_BUTTONS];
+
+	// The device reports its register back as an input report after every LED write (Game Voice)
+	BOOL echoesLedState;
+
+	// The buttons are latched (Game Voice) : a press toggles the button state and its LED, the release
+	// is not reported. Momentary buttons report both, their state is whether they are held.
+	BOOL latchedButtons;
+
+	// Button register states the device can report, bit n of the mask is state n : the states of
+	// the buttons it has, except the impossible ones of the Game Voice (glitches of its register)
+	unsigned char validStates[HID_MODEL_STATES / 8];
+} HidDeviceModel;
+
+/* Sets the model of the SideWinder Game Voice : 65 bytes reports without ID,
+ * the buttons in byte 1 of the input report and the LEDs in byte 1 of the feature report, echoed back.
+ */
+void initGameVoiceDeviceModel(HidDeviceModel *model);
+
+/* Parses a HID report descriptor into a model.
+ * The buttons are the 1 bit Button page usages of the input reports and the LEDs the 1 bit
+ * LED page usages of the feature or output reports. A descriptor with vendor defined reports only
+ * (the Game Voice) gets the Game Voice button and LED bits with the lengths it describes.
+ * Returns FALSE if the descriptor is malformed or does not describe any input report.
+ */
+BOOL parseHidReportDescriptor(const unsigned char *descriptor, DWORD length, HidDeviceModel *model);
+
+/* Gets the button model register from an input report.
+ * Returns FALSE if the report is not the one of the buttons (other report ID).
+ */
+BOOL decodeHidButtons(const HidDeviceModel *model, const unsigned char *report, DWORD length, byte *state);
+
+/* Sets the button register states the device can report from its buttons,
+ * for a model built without parseHidReportDescriptor. The Game Voice glitches are left out for its layout.
+ */
+void setHidModelValidStates(HidDeviceModel *model, BOOL gameVoice);
+
+/* Determines whether the device can report a button register state (see validStates).
+ */
+BOOL isValidHidButtonState(const HidDeviceModel *model, byte state);
+
+/* Gets the button model register from a LED report (feature or output).
+ */
+byte decodeHidLeds(const HidDeviceModel *model, const unsigned char *report, DWORD length);
+
+/* Builds the LED report (feature or output, see the model) of a button model register
+ * into a REPORT_SIZE buffer. Returns the length of the report, 0 if the device has no LED.
+ */
+DWORD encodeHidLeds(const HidDeviceModel *model, byte state, unsigned char *report);
+
+/* Builds the input report of a button model register into a REPORT_SIZE buffer
+ * (simulated devices). Returns the length of the report.
+ */
+DWORD encodeHidButtons(const HidDeviceModel *model, byte state, unsigned char *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * HID request functions
+ * hidRequest.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include "stdafx.h"
+#include "hidRequest.h"
+#include "platform.h"
+
+// Requests reused by createHidRequest, their completion event is created once by initHidRequestPool
+static HidRequest requestPool[HID_REQUEST_POOL_SIZE];
+
+// Bit set for each pool request in use
+static volatile long long requestPoolUsage = 0;
+
+// Takes a free request of the pool, NULL if all of them are in use
+static HidRequest *acquirePooledRequest(void)
+{
+	long long usage;
+	int index;
+
+	do
+	{
+		usage = loadAtomic64(&requestPoolUsage);
+		if (usage == -1LL)
+			return NULL;
+
+		index = 0;
+		while (usage & (long long) (1ULL << index))
+			index++;
+	} while (!compareExchangeAtomic64(&requestPoolUsage, usage, usage | (long long) (1ULL << index)));
+
+	return &requestPool[index];
+}
+
+static void releasePooledRequest(HidRequest *request)
+{
+	long long usage;
+
+	do
+	{
+		usage = loadAtomic64(&requestPoolUsage);
+	} while (!compareExchangeAtomic64(&requestPoolUsage, usage, usage & ~(long long) (1ULL << request->poolIndex)));
+}
+
+HidRequest *createHidRequest(enum HidRequestType type, const unsigned char *buffer, HidRequestCallback callback, LPVOID context)
+{
+	HidRequest *request = acquirePooledRequest();
+
+	// Pool requests without their event (pool not initialized) are not used
+	if (request != NULL && request->completedEvent == NULL)
+	{
+		releasePooledRequest(request);
+		request = NULL;
+	}
+
+	// Pool requests get their event reset when released
+	if (request == NULL)
+	{
+		request = (HidRequest *) allocatePlatformMemory(sizeof(HidRequest));
+		if (request == NULL)
+			return NULL;
+
+		request->poolIndex = -1;
+
+		// Manual reset : every waiter is released and later waits return at once
+		request->completedEvent = createPlatformEvent(TRUE, FALSE);
+		if (request->completedEvent == NULL)
+		{
+			freePlatformMemory(request);
+			return NULL;
+		}
+	}
+
+	request->type = type;
+	if (buffer != NULL)
+		memcpy(request->buffer, buffer, REPORT_SIZE);
+	request->ledMask = 0xFF;
+	request->timeline = NULL;
+	request->layer = 0;
+	request->status = hidRequestPending;
+	request->references = 1;
+	request->callback = callback;
+	request->callbackContext = context;
+	request->submitTime = getMonotonicTime();
+	request->completionTime = 0;
+	request->next = NULL;
+
+	return request;
+}
+
+void releaseHidRequest(HidRequest *request)
+{
+	if (request == NULL || addAtomic64(&request->references, -1) > 0)
+		return;
+
+	// Reset by the last owner rather than the next submitter : a system call less on the submission path
+	if (request->poolIndex >= 0)
+	{
+		resetPlatformEvent(request->completedEvent);
+		releasePooledRequest(request);
+		return;
+	}
+
+	destroyPlatformEvent(request->completedEvent);
+	freePlatformMemory(request);
+}
+
+BOOL initHidRequestPool(void)
+{
+	int index;
+
+	for (index = 0; index < HID_REQUEST_POOL_SIZE; index++)
+	{
+		requestPool[index].poolIndex = index;
+
+		// Manual reset : every waiter is released and later waits return at once
+		if (requestPool[index].completedEvent == NULL)
+			requestPool[index].completedEvent = createPlatformEvent(TRUE, FALSE);
+		if (requestPool[index].completedEvent == NULL)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+void finalizeHidRequestPool(void)
+{
+	int index;
+
+	for (index = 0; index < HID_REQUEST_POOL_SIZE; index++)
+	{
+		// Requests still in use keep their event
+		if (loadAtomic64(&requestPoolUsage) & (long long) (1ULL << index))
+			continue;
+
+		destroyPlatformEvent(requestPool[index].completedEvent);
+		requestPool[index].completedEvent = NULL;
+	}
+}
+
+enum HidRequestStatus getHidRequestStatus(HidRequest *request)
+{
+	return (enum HidRequestStatus) loadAtomic64(&request->status);
+}
+
+BOOL waitForHidRequest(HidRequest *request, unsigned long long deadline)
+{
+	unsigned long long now;
+
+	if (getHidRequestStatus(request) != hidRequestPending)
+		return TRUE;
+
+	if (deadline == HID_REQUEST_NO_DEADLINE)
+		return waitForPlatformEvent(request->completedEvent, PLATFORM_WAIT_INFINITE);
+
+	// Round the remaining time up to the millisecond so the deadline is never cut short
+	now = getMonotonicTime();
+	if (now < deadline)
+		waitForPlatformEvent(request->completedEvent, (DWORD) ((deadline - now + 999999ULL) / 1000000ULL));
+
+	return getHidRequestStatus(request) != hidRequestPending;
+}
+
+void completeHidRequest(HidRequest *request, BOOL succeeded)
+{
+	request->completionTime = getMonotonicTime();
+	storeAtomic64(&request->status, succeeded ? hidRequestSucceeded : hidRequestFailed);
+	setPlatformEvent(request->completedEvent);
+
+	if (request->callback != NULL)
+		request->callback(request, request->callbackContext);
+
+	// The queue reference
+	releaseHidRequest(request);
+}
+
+void pushHidRequest(HidRequestQueue *queue, HidRequest *request)
+{
+	HidRequest *head;
+
+	addAtomic64(&request->references, 1);
+
+	// Lock-free stack push, the consumer restores the submission order
+	do
+	{
+		head = (HidRequest *) queue->head;
+		request->next = head;
+	} while (!compareExchangeAtomicPointer((void *volatile *) &queue->head, head, request));
+}
+
+HidRequest *takeHidRequests(HidRequestQueue *queue)
+{
+	HidRequest *request = (HidRequest *) exchangeAtomicPointer((void *volatile *) &queue->head, NULL);
+	HidRequest *oldest = NULL;
+
+	// Reverse the stack into the submission order
+	while (request != NULL)
+	{
+		HidRequest *next = request->next;
+		request->next = oldest;
+		oldest = request;
+		request = next;
+	}
+
+	return oldest;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * HID request functions header
+ * hidRequest.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HIDREQUEST_H
+#define HIDREQUEST_H
+
+#include "ledAnimation.h"
+#include "platform.h"
+#include "reportQueue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Deadline value to wait for a request without time limit
+#define HID_REQUEST_NO_DEADLINE 0ULL
+
+// Number of requests reused without allocation, a request is only allocated
+// while all of them are in flight (one bit of a 64 bits mask per request)
+#define HID_REQUEST_POOL_SIZE 64
+
+// Transfer performed by a request, or LED animation started or cancelled by the worker thread.
+// A read request gets the button/LED register of the device in byte 1 of its buffer, a get feature request
+// the LEDs of its feature report.
+enum HidRequestType {hidWriteRequest, hidSetFeatureRequest, hidAnimationRequest, hidReadRegisterRequest, hidGetFeatureRequest};
+
+// State of a request
+enum HidRequestStatus {hidRequestPending, hidRequestSucceeded, hidRequestFailed};
+
+typedef struct HidRequest HidRequest;
+
+// Function called on completion of a request, on the thread completing it (must not block)
+typedef void (*HidRequestCallback)(HidRequest *request, LPVOID context);
+
+// I/O request submitted to the HID worker thread.
+// The submitter gets a reference on the request to wait for it, poll it or
+// just release it, and may attach a callback called on completion.
+struct HidRequest
+{
+	enum HidRequestType type;
+	unsigned char buffer[REPORT_SIZE];
+
+	// LEDs of the register in byte 1 set by a feature request, the others are left as they are
+	byte ledMask;
+
+	// Timeline started on the layer (animation requests), NULL to cancel the layer
+	const LedTimeline *timeline;
+	int layer;
+
+	// enum HidRequestStatus, set once on completion
+	volatile long long status;
+
+	// Owners of the request : the submitter and the queue until completion
+	volatile long long references;
+
+	// Signaled on completion
+	PlatformEvent *completedEvent;
+
+	HidRequestCallback callback;
+	LPVOID callbackContext;
+
+	// Monotonic times (nanoseconds) of the submission and the completion
+	unsigned long long submitTime;
+	unsigned long long completionTime;
+
+	// Next request of the queue
+	HidRequest *next;
+
+	// Index of the request in the pool, -1 for a request allocated out of the pool
+	int poolIndex;
+};
+
+// Multiple producers / single consumer queue of requests
+typedef struct HidRequestQueue
+{
+	// Last request pushed, linked to the previous ones
+	HidRequest *volatile head;
+} HidRequestQueue;
+
+/* Creates a request transferring the specified report buffer (REPORT_SIZE bytes, NULL for none).
+ * The request is taken from the pool and only allocated if the pool is exhausted.
+ * The callback is optional. Returns NULL if the request cannot be created.
+ * The request must be released with releaseHidRequest.
+ */
+HidRequest *createHidRequest(enum HidRequestType type, const unsigned char *buffer, HidRequestCallback callback, LPVOID context);
+
+/* Releases a request reference, the request is returned to the pool
+ * or destroyed with its last reference.
+ */
+void releaseHidRequest(HidRequest *request);
+
+/* Creates the events of the pool requests, so that creating a request never allocates
+ * until the pool is exhausted. Returns FALSE if an event cannot be created.
+ */
+BOOL initHidRequestPool(void);
+
+/* Destroys the events of the pool requests, once every request has been released.
+ */
+void finalizeHidRequestPool(void);
+
+/* Gets the state of a request without waiting.
+ */
+enum HidRequestStatus getHidRequestStatus(HidRequest *request);
+
+/* Waits for the completion of a request until the deadline (monotonic time in nanoseconds,
+ * see getMonotonicTime) or without time limit with HID_REQUEST_NO_DEADLINE.
+ * Returns TRUE if the request is completed.
+ */
+BOOL waitForHidRequest(HidRequest *request, unsigned long long deadline);
+
+/* Completes a request : sets its state, releases its waiters and calls its callback.
+ */
+void completeHidRequest(HidRequest *request, BOOL succeeded);
+
+/* Pushes a request to the queue, from any thread. The queue holds a reference until completion.
+ */
+void pushHidRequest(HidRequestQueue *queue, HidRequest *request);
+
+/* Takes all the requests of the queue (consumer only).
+ * Returns the oldest request, linked to the next ones in submission order.
+ */
+HidRequest *takeHidRequests(HidRequestQueue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
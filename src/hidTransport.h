@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * HID transport functions header
+ * hidTransport.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HIDTRANSPORT_H
+#define HIDTRANSPORT_H
+
+#include "platform.h"
+#include "hidDeviceModel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Result of a device opening
+enum HidTransportOpenResult {deviceNotFound, deviceOpened, deviceBroken};
+
+// Result of a report reading
+enum HidTransportReadResult {reportRead, readPending, readFailed};
+
+// Device opened by a transport, each transport defines its own content
+typedef struct HidDevice HidDevice;
+
+// Size of a device path buffer, including the terminating null character
+#define HID_DEVICE_PATH_SIZE 256
+
+// Device change reported by the hotplug monitor
+enum HidHotplugEvent {hidDeviceArrived, hidDeviceRemoved};
+
+// Function called by the hotplug monitor, on its own thread, for every HID device plugged in or unplugged
+typedef void (*HidHotplugCallback)(enum HidHotplugEvent event, const char *devicePath, LPVOID context);
+
+// Operating system specific access to HID devices.
+// The UsbHidCommunication event loop and methods are built on top of these functions.
+// Every device is independent : several devices may be opened at once.
+//
+// Report buffers follow the Windows HID layout : byte 0 is the report ID
+// (0 when the device does not number its reports), followed by the report data.
+typedef struct HidTransport
+{
+	// Searches for the devices matching the VID and PID and gets the path of the one of the specified index
+	// (0 for the first one, in a stable order while the devices stay plugged in) into a HID_DEVICE_PATH_SIZE buffer.
+	// A device keeps its path until it is unplugged, the hotplug monitor reports the same path.
+	// Returns FALSE if there are not as many devices.
+	BOOL (*findDevicePath)(int usbVid, int usbPid, int deviceIndex, char *devicePath);
+
+	// Determines whether the device of the specified path, plugged in, matches the VID and PID
+	BOOL (*isMatchingDevicePath)(const char *devicePath, int usbVid, int usbPid);
+
+	// Opens the device of the specified path.
+	// Returns deviceNotFound if the device is not plugged in, deviceBroken if it cannot be used.
+	enum HidTransportOpenResult (*openDevice)(const char *devicePath, HidDevice **device);
+
+	// Gets the report layout of a device from its report descriptor, read when the device is opened.
+	// Returns FALSE if the descriptor can't be read or parsed.
+	BOOL (*getDeviceModel)(HidDevice *device, HidDeviceModel *model);
+
+	// Closes a device opened by openDevice
+	void (*closeDevice)(HidDevice *device);
+
+	// Cancels the pending IO operations of the device, a further readReport returns readFailed.
+	// The transfers in progress fail as well where the operating system allows it.
+	// May be called from any thread.
+	void (*cancelIo)(HidDevice *device);
+
+	// Gets the event signaled when an input report may be read, to wait for
+	// several devices at once. The event belongs to the device.
+	PlatformEvent *(*getReadEvent)(HidDevice *device);
+
+	// Reads the next input report sent by the device without blocking, report ID in byte 0.
+	// Returns readPending when no report is there yet (the read event is signaled
+	// once there is one), readFailed if the IO is cancelled or the device unplugged.
+	enum HidTransportReadResult (*readReport)(HidDevice *device, unsigned char *buffer, DWORD bufferLength, DWORD *bytesRead);
+
+	// Writes an output report to the device
+	BOOL (*writeReport)(HidDevice *device, unsigned char *buffer, DWORD bufferLength);
+
+	// Sends a feature report to the device
+	BOOL (*setFeature)(HidDevice *device, unsigned char *buffer, DWORD bufferLength);
+
+	// Gets a feature report from the device, byte 0 holds the requested report ID
+	BOOL (*getFeature)(HidDevice *device, unsigned char *buffer, DWORD bufferLength);
+
+	// Gets the current input report from the device, byte 0 holds the requested report ID
+	BOOL (*getInputReport)(HidDevice *device, unsigned char *buffer, DWORD bufferLength);
+
+	// Starts reporting the HID devices plugged in or unplugged to the callback, whatever their VID and PID.
+	// The events of the other device classes are filtered out.
+	// Returns FALSE if the device changes can't be monitored.
+	BOOL (*startHotplugMonitor)(HidHotplugCallback callback, LPVOID context);
+
+	// Stops the hotplug monitor, the callback is not called anymore once it returns
+	void (*stopHotplugMonitor)(void);
+} HidTransport;
+
+// HidTransport factory for the SetupAPI and HidD functions (Windows)
+HidTransport CreateWindowsHidTransport();
+
+// HidTransport factory for the hidraw driver (Linux)
+HidTransport CreateHidrawTransport();
+
+// HidTransport factory for the operating system the plugin is built for
+HidTransport CreatePlatformHidTransport();
+
+// Environment variable holding the script of the simulated device.
+// When defined, the plugin uses the simulated device instead of the real one.
+#define SIMULATED_DEVICE_VARIABLE "GAMEVOICE_SIMULATED_DEVICE"
+
+// HidTransport factory for a simulated device, used to load test the plugin without hardware.
+// The device models the 8 bits button/LED register : it plays a timeline of register values
+// as input reports and echoes feature writes back as input reports like the real device.
+// Its reports follow the report descriptor of the layout played.
+//
+// The script is a list of space or semicolon separated settings :
+//   devices=<count>             number of devices plugged in, each one plays the timeline (default 1)
+//   rate=<events per second>    0 plays the events as fast as they are read (default 1000)
+//   count=<events>              number of events to play, 0 loops forever (default)
+//   churn=<events per second>   unrelated devices plugged in and unplugged, reported by
+//                               the hotplug monitor (default 0)
+//   stall=<LED write>           the n-th LED write (feature or output report, of all the devices) never completes
+//                               until its IO is cancelled, like a device not responding (default 0 : none)
+//   hang=<LED write>            the n-th LED write blocks 2 seconds even when its IO is cancelled,
+//                               leaving the caller stuck (default 0 : none)
+//   layout=<gamevoice|buttonbox> report descriptor of the devices : the Game Voice vendor reports,
+//                               or a button box with numbered button input and LED output reports
+//                               that does not echo its LEDs (default gamevoice)
+//   steps=<value>,<value>,...   register values played in turn, a press sets a button bit
+//                               and the release clears it (default : every button pressed
+//                               and released in turn)
+//   replay=<dump>               plays the input reports of a flight recorder dump (see flightRecorder.h)
+//                               instead of the steps, at their recorded times or as fast as they are read
+//                               with rate=0 : the devices recorded are plugged in, each one replaying its reports
+//                               once startSimulatedReplay is called
+//   speed=<factor>              replays the reports that many times faster than recorded (default 1)
+// e.g. "rate=20000 count=100000 steps=0x04,0,0x08,0"
+HidTransport CreateSimulatedHidTransport(const char *script);
+
+// Gets the number of timeline events played (read) by the simulated devices
+long long getSimulatedEventsPlayed(void);
+
+// Gets the number of timeline events lost because the simulated devices were not read fast enough
+long long getSimulatedEventsDropped(void);
+
+// Gets the number of input reports replayed by the simulated devices, 0 without replay
+long long getSimulatedReplayEventCount(void);
+
+// Starts the replay of the simulated devices, e.g. once the plugin is done with its startup
+void startSimulatedReplay(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,474 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * HID transport for Linux (hidraw driver)
+ * hidTransportHidraw.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef __linux__
+
+#define _GNU_SOURCE		// versionsort
+#include <stdio.h>
+#include "stdafx.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <linux/hidraw.h>
+#include <linux/netlink.h>
+#include "hidTransport.h"
+#include "platform.h"
+
+// Directory listing the hidraw devices and their sysfs attributes
+#define HIDRAW_CLASS_PATH "/sys/class/hidraw"
+
+// Directory of the hidraw device nodes
+#define HIDRAW_DEVICE_PATH "/dev/"
+
+// USB bus type as reported in the HID_ID uevent variable
+#define HIDRAW_BUS_USB 0x03
+
+// Netlink multicast group of the kernel uevents
+#define HIDRAW_UEVENT_GROUP 1
+
+// Time (milliseconds) udev has to grant access to a device node plugged in
+#define HIDRAW_ACCESS_TIMEOUT 2000
+
+// Opened hidraw node : the non blocking device descriptor, the IO cancellation
+// flag, the event signaled while the descriptor is readable and the report layout
+struct HidDevice
+{
+	int descriptor;
+	volatile long long ioCancelled;
+	PlatformEvent *readEvent;
+	BOOL modelParsed;
+	HidDeviceModel model;
+};
+
+// Hotplug monitor : the kernel uevent socket and the thread listening to it
+static int ueventSocket = -1;
+static PlatformEvent *ueventEvent = NULL;
+static PlatformEvent *hotplugStopEvent = NULL;
+static PlatformThread *hotplugThread = NULL;
+static HidHotplugCallback hotplugCallback = NULL;
+static LPVOID hotplugContext = NULL;
+
+// Determines whether a hidraw node belongs to the specified USB VID and PID
+// by reading the HID_ID=bus:vendor:product line of its uevent attributes
+static BOOL isMatchingDevice(const char *hidrawName, int usbVid, int usbPid)
+{
+	char ueventPath[300];
+	char line[256];
+	unsigned int bus, vendor, product;
+	BOOL matching = FALSE;
+	FILE *uevent;
+
+	snprintf(ueventPath, sizeof(ueventPath), HIDRAW_CLASS_PATH "/%s/device/uevent", hidrawName);
+	uevent = fopen(ueventPath, "r");
+	if (uevent == NULL)
+		return FALSE;
+
+	while (fgets(line, sizeof(line), uevent) != NULL)
+	{
+		if (sscanf(line, "HID_ID=%x:%x:%x", &bus, &vendor, &product) == 3)
+		{
+			matching = bus == HIDRAW_BUS_USB && vendor == (unsigned int) usbVid && product == (unsigned int) usbPid;
+			break;
+		}
+	}
+
+	fclose(uevent);
+	return matching;
+}
+
+// Formats the device node path of a hidraw name, FALSE (and the name skipped) when it does not fit
+static BOOL formatDevicePath(char *devicePath, const char *hidrawName)
+{
+	int length = snprintf(devicePath, HID_DEVICE_PATH_SIZE, HIDRAW_DEVICE_PATH "%s", hidrawName);
+
+	return length > 0 && length < HID_DEVICE_PATH_SIZE;
+}
+
+// Selects the hidraw nodes of the class directory
+static int isHidrawNode(const struct dirent *entry)
+{
+	return strncmp(entry->d_name, "hidraw", 6) == 0;
+}
+
+// This method searches for the target USB device among the hidraw nodes.
+// The matching nodes are counted in the hidraw minor order (hidraw2 before hidraw10).
+static BOOL findDevicePath(int usbVid, int usbPid, int deviceIndex, char *devicePath)
+{
+	struct dirent **entries;
+	int entryCount, entry, matches = 0;
+	BOOL found = FALSE;
+
+	entryCount = scandir(HIDRAW_CLASS_PATH, &entries, isHidrawNode, versionsort);
+	if (entryCount < 0)
+	{
+		OutputDebugString("findDevicePath: hidraw is not available");
+		return FALSE;
+	}
+
+	for (entry = 0; entry < entryCount; entry++)
+	{
+		if (!found && isMatchingDevice(entries[entry]->d_name, usbVid, usbPid) && formatDevicePath(devicePath, entries[entry]->d_name)
+			&& matches++ == deviceIndex)
+		{
+			OutputDebugString("findDevicePath: Device found, path is below");
+			OutputDebugString(devicePath);
+			found = TRUE;
+		}
+		free(entries[entry]);
+	}
+	free(entries);
+
+	return found;
+} // END findDevicePath
+
+// Determines whether a hidraw device node belongs to the specified USB VID and PID
+static BOOL isMatchingDevicePath(const char *devicePath, int usbVid, int usbPid)
+{
+	if (strncmp(devicePath, HIDRAW_DEVICE_PATH "hidraw", strlen(HIDRAW_DEVICE_PATH "hidraw")) != 0)
+		return FALSE;
+
+	return isMatchingDevice(devicePath + strlen(HIDRAW_DEVICE_PATH), usbVid, usbPid);
+}
+
+// Reads the report descriptor of a hidraw node and parses it
+static BOOL readDeviceModel(int descriptor, HidDeviceModel *model)
+{
+	struct hidraw_report_descriptor reportDescriptor;
+	int descriptorSize = 0;
+
+	if (ioctl(descriptor, HIDIOCGRDESCSIZE, &descriptorSize) < 0 || descriptorSize <= 0 || descriptorSize > HID_MAX_DESCRIPTOR_SIZE)
+	{
+		OutputDebugString("readDeviceModel: /!\\ Can't get the report descriptor size");
+		return FALSE;
+	}
+
+	reportDescriptor.size = (__u32) descriptorSize;
+	if (ioctl(descriptor, HIDIOCGRDESC, &reportDescriptor) < 0)
+	{
+		OutputDebugString("readDeviceModel: /!\\ Can't get the report descriptor");
+		return FALSE;
+	}
+
+	return parseHidReportDescriptor(reportDescriptor.value, reportDescriptor.size, model);
+}
+
+// This method opens a hidraw device node
+static enum HidTransportOpenResult openDevice(const char *devicePath, HidDevice **openedDevice)
+{
+	HidDevice *device;
+	int descriptor;
+
+	// Non blocking reads, the event loop waits for the descriptor to be readable
+	descriptor = open(devicePath, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+	if (descriptor < 0)
+	{
+		if (errno == ENOENT || errno == ENODEV || errno == ENXIO)
+			return deviceNotFound;
+
+		// Usually a permission issue, an udev rule granting access to the device is required
+		OutputDebugString("openDevice: Failed ! Can't open the device :(");
+		return deviceBroken;
+	}
+
+	device = (HidDevice *) allocatePlatformMemory(sizeof(HidDevice));
+	if (device != NULL)
+	{
+		device->descriptor = descriptor;
+		device->ioCancelled = 0;
+		device->readEvent = createPlatformEventFromDescriptor(descriptor);
+		device->modelParsed = readDeviceModel(descriptor, &device->model);
+	}
+
+	if (device == NULL || device->readEvent == NULL)
+	{
+		freePlatformMemory(device);
+		close(descriptor);
+		return deviceBroken;
+	}
+
+	*openedDevice = device;
+	return deviceOpened;
+} // END openDevice
+
+// Closes the device descriptor
+static void closeDevice(HidDevice *device)
+{
+	destroyPlatformEvent(device->readEvent);
+	close(device->descriptor);
+	freePlatformMemory(device);
+} // END closeDevice
+
+// Cancels any pending IO operations : further reads fail.
+// Reads never block, the feature and output transfers can't be interrupted.
+static void cancelIo(HidDevice *device)
+{
+	storeAtomic64(&device->ioCancelled, 1);
+} // END cancelIo
+
+static BOOL getDeviceModel(HidDevice *device, HidDeviceModel *model)
+{
+	if (!device->modelParsed)
+		return FALSE;
+
+	*model = device->model;
+	return TRUE;
+}
+
+static PlatformEvent *getReadEvent(HidDevice *device)
+{
+	return device->readEvent;
+}
+
+static enum HidTransportReadResult readReport(HidDevice *device, unsigned char *buffer, DWORD bufferLength, DWORD *bytesRead)
+{
+	ssize_t length;
+
+	*bytesRead = 0;
+	if (bufferLength < 2 || loadAtomic64(&device->ioCancelled))
+		return readFailed;
+
+	// hidraw returns the report ID first only when the device numbers its reports,
+	// prepend the report ID 0 like Windows does otherwise
+	if (device->modelParsed && device->model.numberedReports)
+	{
+		do
+		{
+			length = read(device->descriptor, buffer, bufferLength);
+		} while (length < 0 && errno == EINTR);
+
+		if (length < 0)
+			return errno == EAGAIN ? readPending : readFailed;
+
+		*bytesRead = (DWORD) length;
+		return reportRead;
+	}
+
+	do
+	{
+		length = read(device->descriptor, buffer + 1, bufferLength - 1);
+	} while (length < 0 && errno == EINTR);
+
+	if (length < 0)
+		return errno == EAGAIN ? readPending : readFailed;
+
+	buffer[0] = 0;
+	*bytesRead = (DWORD) length + 1;
+	return reportRead;
+}
+
+static BOOL writeReport(HidDevice *device, unsigned char *buffer, DWORD bufferLength)
+{
+	return write(device->descriptor, buffer, bufferLength) == (ssize_t) bufferLength;
+}
+
+static BOOL setFeature(HidDevice *device, unsigned char *buffer, DWORD bufferLength)
+{
+	return ioctl(device->descriptor, HIDIOCSFEATURE(bufferLength), buffer) >= 0;
+}
+
+static BOOL getFeature(HidDevice *device, unsigned char *buffer, DWORD bufferLength)
+{
+	return ioctl(device->descriptor, HIDIOCGFEATURE(bufferLength), buffer) >= 0;
+}
+
+static BOOL getInputReport(HidDevice *device, unsigned char *buffer, DWORD bufferLength)
+{
+#ifdef HIDIOCGINPUT
+	return ioctl(device->descriptor, HIDIOCGINPUT(bufferLength), buffer) >= 0;
+#else
+	// Kernel headers older than 5.11 can't get input reports on demand
+	return FALSE;
+#endif
+}
+
+// Reports a kernel uevent of the hidraw subsystem.
+// The message is the "action@devpath" header followed by KEY=value strings, all null terminated.
+static void handleUevent(const char *message, size_t length)
+{
+	const char *action = NULL, *subsystem = NULL, *deviceName = NULL;
+	char devicePath[HID_DEVICE_PATH_SIZE];
+	enum HidHotplugEvent event;
+	size_t offset;
+	int waited;
+
+	for (offset = strlen(message) + 1; offset < length; offset += strlen(message + offset) + 1)
+	{
+		const char *variable = message + offset;
+
+		if (strncmp(variable, "ACTION=", 7) == 0)
+			action = variable + 7;
+		else if (strncmp(variable, "SUBSYSTEM=", 10) == 0)
+			subsystem = variable + 10;
+		else if (strncmp(variable, "DEVNAME=", 8) == 0)
+			deviceName = variable + 8;
+	}
+
+	// Only the hidraw nodes are of interest, not the USB interfaces nor the other HID drivers
+	if (action == NULL || subsystem == NULL || deviceName == NULL || strcmp(subsystem, "hidraw") != 0)
+		return;
+
+	if (strcmp(action, "add") == 0)
+		event = hidDeviceArrived;
+	else if (strcmp(action, "remove") == 0)
+		event = hidDeviceRemoved;
+	else
+		return;
+
+	// DEVNAME is relative to /dev
+	if (strncmp(deviceName, HIDRAW_DEVICE_PATH, strlen(HIDRAW_DEVICE_PATH)) == 0)
+		deviceName += strlen(HIDRAW_DEVICE_PATH);
+	if (!formatDevicePath(devicePath, deviceName))
+		return;
+
+	// The kernel reports the node before udev applies its rules : wait for the access to be granted
+	for (waited = 0; event == hidDeviceArrived && waited < HIDRAW_ACCESS_TIMEOUT && access(devicePath, R_OK | W_OK) != 0; waited += 100)
+	{
+		if (waitForPlatformEvent(hotplugStopEvent, 100))
+			return;
+	}
+
+	hotplugCallback(event, devicePath, hotplugContext);
+}
+
+// Listens to the kernel uevents until the monitor is stopped
+static DWORD WINAPI hotplugMonitorThread(LPVOID argument)
+{
+	PlatformEvent *events[2];
+	char message[4096];
+	struct sockaddr_nl sender;
+	socklen_t senderLength;
+	ssize_t length;
+
+	events[0] = hotplugStopEvent;
+	events[1] = ueventEvent;
+
+	while (waitForPlatformEvents(events, 2, PLATFORM_WAIT_INFINITE) == 1)
+	{
+		for (;;)
+		{
+			senderLength = sizeof(sender);
+			length = recvfrom(ueventSocket, message, sizeof(message) - 1, 0, (struct sockaddr *) &sender, &senderLength);
+			if (length < 0 && errno == EINTR)
+				continue;
+			if (length <= 0)
+				break;
+
+			// Only trust the kernel, user space processes may send to the group too
+			if (senderLength != sizeof(sender) || sender.nl_pid != 0)
+				continue;
+
+			message[length] = '\0';
+			handleUevent(message, (size_t) length);
+		}
+	}
+
+	return 0;
+}
+
+// Starts listening to the kernel uevents of the hidraw nodes
+static BOOL startHotplugMonitor(HidHotplugCallback callback, LPVOID context)
+{
+	struct sockaddr_nl address;
+
+	ueventSocket = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+	if (ueventSocket < 0)
+	{
+		OutputDebugString("startHotplugMonitor: /!\\ Can't open the uevent socket");
+		return FALSE;
+	}
+
+	memset(&address, 0, sizeof(address));
+	address.nl_family = AF_NETLINK;
+	address.nl_groups = HIDRAW_UEVENT_GROUP;
+	hotplugCallback = callback;
+	hotplugContext = context;
+	ueventEvent = createPlatformEventFromDescriptor(ueventSocket);
+	hotplugStopEvent = createPlatformEvent(TRUE, FALSE);
+
+	if (bind(ueventSocket, (struct sockaddr *) &address, sizeof(address)) < 0 || ueventEvent == NULL || hotplugStopEvent == NULL
+		|| (hotplugThread = createPlatformThread(hotplugMonitorThread, NULL)) == NULL)
+	{
+		OutputDebugString("startHotplugMonitor: /!\\ Can't listen to the uevents");
+		destroyPlatformEvent(ueventEvent);
+		destroyPlatformEvent(hotplugStopEvent);
+		ueventEvent = NULL;
+		hotplugStopEvent = NULL;
+		close(ueventSocket);
+		ueventSocket = -1;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void stopHotplugMonitor(void)
+{
+	if (hotplugThread == NULL)
+		return;
+
+	setPlatformEvent(hotplugStopEvent);
+	joinPlatformThread(hotplugThread, PLATFORM_WAIT_INFINITE);
+	hotplugThread = NULL;
+
+	destroyPlatformEvent(ueventEvent);
+	destroyPlatformEvent(hotplugStopEvent);
+	ueventEvent = NULL;
+	hotplugStopEvent = NULL;
+	close(ueventSocket);
+	ueventSocket = -1;
+}
+
+// HidTransport factory
+HidTransport CreateHidrawTransport()
+{
+	HidTransport transport;
+	transport.cancelIo = cancelIo;
+	transport.closeDevice = closeDevice;
+	transport.findDevicePath = findDevicePath;
+	transport.getDeviceModel = getDeviceModel;
+	transport.getFeature = getFeature;
+	transport.getInputReport = getInputReport;
+	transport.getReadEvent = getReadEvent;
+	transport.isMatchingDevicePath = isMatchingDevicePath;
+	transport.openDevice = openDevice;
+	transport.readReport = readReport;
+	transport.setFeature = setFeature;
+	transport.startHotplugMonitor = startHotplugMonitor;
+	transport.stopHotplugMonitor = stopHotplugMonitor;
+	transport.writeReport = writeReport;
+
+	return transport;
+}
+
+HidTransport CreatePlatformHidTransport()
+{
+	return CreateHidrawTransport();
+}
+
+#endif
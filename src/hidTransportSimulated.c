@@ -0,0 +1,795 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * HID transport simulating a Game Voice device (load testing)
+ * hidTransportSimulated.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "stdafx.h"
+
+#include <ctype.h>
+#include "flightRecorder.h"
+#include "hidTransport.h"
+#include "platform.h"
+#include "reportQueue.h"
+#include "statistics.h"
+
+// Maximum number of steps of a timeline
+#define SIMULATED_MAX_STEPS 256
+
+// Maximum number of simulated devices
+#define SIMULATED_MAX_DEVICES 16
+
+// Number of input reports buffered by the operating system driver (Windows default),
+// further reports are dropped while the reader is behind
+#define SIMULATED_INPUT_BUFFERS 32
+
+// No feature echo pending
+#define SIMULATED_NO_ECHO -1
+
+// Time (milliseconds) a hanging feature write blocks, whatever the IO cancellation
+#define SIMULATED_HANG_TIME 2000
+
+// Maximum length of the path of a replayed dump
+#define SIMULATED_REPLAY_PATH_SIZE 260
+
+// Path prefixes of the simulated devices and of the unrelated devices the hotplug monitor reports
+#define SIMULATED_DEVICE_PATH "simulated:"
+#define SIMULATED_UNRELATED_PATH "unrelated:"
+
+// Report descriptor of the Game Voice : 64 bytes vendor defined input, output and feature reports
+static const unsigned char gameVoiceDescriptor[] =
+{
+	0x06, 0x00, 0xFF,		// Usage Page (Vendor Defined 0xFF00)
+	0x09, 0x01,				// Usage (0x01)
+	0xA1, 0x01,				// Collection (Application)
+	0x15, 0x00,				//   Logical Minimum (0)
+	0x26, 0xFF, 0x00,		//   Logical Maximum (255)
+	0x75, 0x08,				//   Report Size (8)
+	0x95, 0x40,				//   Report Count (64)
+	0x09, 0x01,				//   Usage (0x01)
+	0x81, 0x02,				//   Input (Data, Variable, Absolute)
+	0x09, 0x01,				//   Usage (0x01)
+	0x91, 0x02,				//   Output (Data, Variable, Absolute)
+	0x09, 0x01,				//   Usage (0x01)
+	0xB1, 0x02,				//   Feature (Data, Variable, Absolute)
+	0xC0					// End Collection
+};
+
+// Report descriptor of a generic button box : 8 buttons in input report 1, 8 LEDs in output report 2
+static const unsigned char buttonBoxDescriptor[] =
+{
+	0x05, 0x01,				// Usage Page (Generic Desktop)
+	0x09, 0x05,				// Usage (Game Pad)
+	0xA1, 0x01,				// Collection (Application)
+	0x85, 0x01,				//   Report ID (1)
+	0x05, 0x09,				//   Usage Page (Button)
+	0x19, 0x01,				//   Usage Minimum (1)
+	0x29, 0x08,				//   Usage Maximum (8)
+	0x15, 0x00,				//   Logical Minimum (0)
+	0x25, 0x01,				//   Logical Maximum (1)
+	0x75, 0x01,				//   Report Size (1)
+	0x95, 0x08,				//   Report Count (8)
+	0x81, 0x02,				//   Input (Data, Variable, Absolute)
+	0x85, 0x02,				//   Report ID (2)
+	0x05, 0x08,				//   Usage Page (LED)
+	0x09, 0x4B,				//   Usage (Generic Indicator)
+	0x91, 0x02,				//   Output (Data, Variable, Absolute)
+	0xC0					// End Collection
+};
+
+// Simulated device : the 8 bits button/LED register (the LEDs apart when they are not echoed),
+// the reports buffered by the driver and the thread playing the timeline into them
+struct HidDevice
+{
+	int deviceIndex;
+	volatile long long deviceRegister;
+	volatile long long ledRegister;
+	volatile long long pendingEcho;
+	volatile long long ioCancelled;
+
+	// Input reports buffered by the driver, pushed by the timeline thread only
+	ReportQueue inputBuffers;
+
+	PlatformThread *timelineThread;
+	PlatformEvent *stopEvent;
+	PlatformEvent *consumedEvent;
+	PlatformEvent *cancelledEvent;
+	unsigned long long timelineStartTime;
+};
+
+// Script played by the devices
+static byte steps[SIMULATED_MAX_STEPS];
+static int stepCount = 0;
+static long long eventRate = 0;
+static long long eventCount = 0;
+static long long deviceCount = 1;
+static long long churnRate = 0;
+static long long stallFeature = 0;
+static long long hangFeature = 0;
+
+// Input report replayed from a flight recorder dump, timed from the first one replayed
+typedef struct ReplayEvent
+{
+	unsigned long long time;
+	int deviceIndex;
+	unsigned char data[FLIGHT_RECORD_DATA_SIZE];
+} ReplayEvent;
+
+// Input reports replayed instead of the steps, each device plays the ones recorded for its index
+static BOOL replaying = FALSE;
+static ReplayEvent replayEvents[FLIGHT_RECORDER_SIZE];
+static long long replayEventCount = 0;
+static long long replayDeviceCount = 0;
+static long long replaySpeed = 1;
+
+// Signaled when the replay starts, the devices hold their reports until then
+static PlatformEvent *replayStartEvent = NULL;
+
+// Report layout of the devices, parsed from the descriptor of the script layout
+static const unsigned char *reportDescriptor = gameVoiceDescriptor;
+static DWORD reportDescriptorLength = sizeof(gameVoiceDescriptor);
+static HidDeviceModel deviceModel;
+
+// LED writes (feature or output reports) of all the devices, to find the stalling or hanging one
+static volatile long long featureWrites = 0;
+
+// Hotplug monitor reporting the unrelated devices
+static PlatformThread *hotplugThread = NULL;
+static PlatformEvent *hotplugStopEvent = NULL;
+static HidHotplugCallback hotplugCallback = NULL;
+static LPVOID hotplugContext = NULL;
+
+// Timeline progress of all the devices
+static volatile long long eventsPlayed = 0;
+static volatile long long eventsDropped = 0;
+
+// Loads the input reports of a flight recorder dump : the ones read from the devices (queued or dropped),
+// the feature echoes are left out as the simulated devices echo the LED writes of the replay themselves
+static BOOL loadReplay(const char *path)
+{
+	FlightRecorderFileHeader header;
+	FlightRecord record;
+	unsigned long long startTime = 0;
+	unsigned int recordIndex;
+	FILE *file = openFlightRecorderDump(path, &header);
+
+	if (file == NULL)
+		return FALSE;
+
+	replayEventCount = 0;
+	replayDeviceCount = 0;
+	for (recordIndex = 0; recordIndex < header.recordCount && replayEventCount < FLIGHT_RECORDER_SIZE; recordIndex++)
+	{
+		ReplayEvent *event;
+
+		if (fread(&record, sizeof(record), 1, file) != 1)
+		{
+			fclose(file);
+			return FALSE;
+		}
+
+		if (record.type != flightInputReport || (record.result != flightSucceeded && record.result != flightDropped)
+			|| record.deviceIndex >= SIMULATED_MAX_DEVICES)
+			continue;
+
+		if (replayEventCount == 0)
+			startTime = record.time;
+
+		event = &replayEvents[replayEventCount++];
+		event->time = record.time - startTime;
+		event->deviceIndex = record.deviceIndex;
+		memset(event->data, 0, FLIGHT_RECORD_DATA_SIZE);
+		memcpy(event->data, record.data, record.dataLength < FLIGHT_RECORD_DATA_SIZE ? record.dataLength : FLIGHT_RECORD_DATA_SIZE);
+		if (record.deviceIndex >= replayDeviceCount)
+			replayDeviceCount = record.deviceIndex + 1;
+	}
+
+	fclose(file);
+	return TRUE;
+}
+
+// Parses the script, see CreateSimulatedHidTransport
+static BOOL parseScript(const char *script)
+{
+	const char *cursor = script;
+	char *end;
+
+	// Defaults : a press and release of every button, a thousand events per second, looping
+	static const byte defaultSteps[] = {1, 0, 2, 0, 4, 0, 8, 0, 16, 0, 32, 0, 64, 0, 128, 0};
+	memcpy(steps, defaultSteps, sizeof(defaultSteps));
+	stepCount = sizeof(defaultSteps);
+	eventRate = 1000;
+	eventCount = 0;
+	deviceCount = 1;
+	churnRate = 0;
+	stallFeature = 0;
+	hangFeature = 0;
+	reportDescriptor = gameVoiceDescriptor;
+	reportDescriptorLength = sizeof(gameVoiceDescriptor);
+	replaying = FALSE;
+	replayEventCount = 0;
+	replaySpeed = 1;
+
+	while (*cursor != '\0')
+	{
+		if (isspace((unsigned char) *cursor) || *cursor == ';')
+		{
+			cursor++;
+			continue;
+		}
+
+		if (strncmp(cursor, "devices=", 8) == 0)
+		{
+			deviceCount = strtoll(cursor + 8, &end, 0);
+			if (end == cursor + 8 || deviceCount < 1 || deviceCount > SIMULATED_MAX_DEVICES)
+				return FALSE;
+		}
+		else if (strncmp(cursor, "churn=", 6) == 0)
+		{
+			churnRate = strtoll(cursor + 6, &end, 0);
+			if (end == cursor + 6 || churnRate < 0 || churnRate > 1000)
+				return FALSE;
+		}
+		else if (strncmp(cursor, "stall=", 6) == 0)
+		{
+			stallFeature = strtoll(cursor + 6, &end, 0);
+			if (end == cursor + 6 || stallFeature < 0)
+				return FALSE;
+		}
+		else if (strncmp(cursor, "hang=", 5) == 0)
+		{
+			hangFeature = strtoll(cursor + 5, &end, 0);
+			if (end == cursor + 5 || hangFeature < 0)
+				return FALSE;
+		}
+		else if (strncmp(cursor, "layout=", 7) == 0)
+		{
+			end = (char *) cursor + 7;
+			if (strncmp(end, "gamevoice", 9) == 0)
+			{
+				reportDescriptor = gameVoiceDescriptor;
+				reportDescriptorLength = sizeof(gameVoiceDescriptor);
+				end += 9;
+			}
+			else if (strncmp(end, "buttonbox", 9) == 0)
+			{
+				reportDescriptor = buttonBoxDescriptor;
+				reportDescriptorLength = sizeof(buttonBoxDescriptor);
+				end += 9;
+			}
+			else
+				return FALSE;
+		}
+		else if (strncmp(cursor, "replay=", 7) == 0)
+		{
+			char path[SIMULATED_REPLAY_PATH_SIZE];
+			size_t length = 0;
+
+			end = (char *) cursor + 7;
+			while (*end != '\0' && !isspace((unsigned char) *end) && *end != ';' && length < SIMULATED_REPLAY_PATH_SIZE - 1)
+				path[length++] = *end++;
+			path[length] = '\0';
+			if (length == 0 || !loadReplay(path))
+				return FALSE;
+			replaying = TRUE;
+		}
+		else if (strncmp(cursor, "speed=", 6) == 0)
+		{
+			replaySpeed = strtoll(cursor + 6, &end, 0);
+			if (end == cursor + 6 || replaySpeed < 1)
+				return FALSE;
+		}
+		else if (strncmp(cursor, "rate=", 5) == 0)
+		{
+			eventRate = strtoll(cursor + 5, &end, 0);
+			if (end == cursor + 5 || eventRate < 0)
+				return FALSE;
+		}
+		else if (strncmp(cursor, "count=", 6) == 0)
+		{
+			eventCount = strtoll(cursor + 6, &end, 0);
+			if (end == cursor + 6 || eventCount < 0)
+				return FALSE;
+		}
+		else if (strncmp(cursor, "steps=", 6) == 0)
+		{
+			end = (char *) cursor + 5;
+			stepCount = 0;
+			do
+			{
+				const char *value = end + 1;
+				long step = strtol(value, &end, 0);
+				if (end == value || step < 0 || step > 255 || stepCount == SIMULATED_MAX_STEPS)
+					return FALSE;
+				steps[stepCount++] = (byte) step;
+			} while (*end == ',');
+		}
+		else
+			return FALSE;
+
+		cursor = end;
+	}
+
+	// A replay plugs in the devices recorded
+	if (replaying)
+		deviceCount = replayDeviceCount > 0 ? replayDeviceCount : 1;
+
+	return parseHidReportDescriptor(reportDescriptor, reportDescriptorLength, &deviceModel);
+}
+
+// Gets the timestamp the specified event of the timeline is due
+static unsigned long long getEventTime(HidDevice *device, long long event)
+{
+	if (eventRate == 0)
+		return device->timelineStartTime;
+
+	return device->timelineStartTime + (unsigned long long) (event * 1000000000LL / eventRate);
+}
+
+// Plays the timeline of a device : the events due are buffered as input reports,
+// the ones not fitting in the driver buffers are lost
+static DWORD WINAPI timelineThread(LPVOID argument)
+{
+	HidDevice *device = (HidDevice *) argument;
+	PlatformEvent *events[2];
+	unsigned char report[2] = {0, 0};
+	long long played = 0;
+
+	events[0] = device->stopEvent;
+	events[1] = device->consumedEvent;
+
+	while (stepCount != 0 && (eventCount == 0 || played < eventCount))
+	{
+		long long due;
+		DWORD timeout = PLATFORM_WAIT_INFINITE;
+		unsigned long long now = getMonotonicTime();
+
+		// Events generated on demand without rate, as many as the reader makes room for
+		if (eventRate == 0)
+			due = played + SIMULATED_INPUT_BUFFERS - getQueuedReportCount(&device->inputBuffers);
+		else
+			due = (long long) ((now - device->timelineStartTime) / 1000) * eventRate / 1000000 + 1;
+		if (eventCount != 0 && due > eventCount)
+			due = eventCount;
+
+		for (; played < due; played++)
+		{
+			if (getQueuedReportCount(&device->inputBuffers) >= SIMULATED_INPUT_BUFFERS)
+			{
+				addAtomic64(&eventsDropped, due - played);
+				played = due;
+				break;
+			}
+
+			report[1] = steps[played % stepCount];
+			storeAtomic64(&device->deviceRegister, report[1]);
+			pushReport(&device->inputBuffers, report, sizeof(report), now, FALSE);
+		}
+
+		// Wait for the next event to be due (rounded up to the millisecond,
+		// the events due meanwhile are buffered at once), or for room in the buffers
+		if (eventRate != 0)
+		{
+			unsigned long long next = getEventTime(device, played);
+			timeout = next > now ? (DWORD) ((next - now + 999999ULL) / 1000000ULL) : 0;
+		}
+		if (waitForPlatformEvents(events, 2, timeout) == 0)
+			break;
+	}
+
+	// Timeline over, wait for the device to be closed
+	waitForPlatformEvent(device->stopEvent, PLATFORM_WAIT_INFINITE);
+	return 0;
+}
+
+// Plays the input reports replayed for a device at their recorded times (relative to the replay start,
+// divided by the replay speed), or as fast as they are read without rate. Like the timeline, the ones not fitting in the driver buffers are lost.
+static DWORD WINAPI replayThread(LPVOID argument)
+{
+	HidDevice *device = (HidDevice *) argument;
+	PlatformEvent *events[2];
+	long long eventIndex;
+	BOOL stopped;
+
+	events[0] = device->stopEvent;
+	events[1] = replayStartEvent;
+	stopped = waitForPlatformEvents(events, 2, PLATFORM_WAIT_INFINITE) == 0;
+	device->timelineStartTime = getMonotonicTime();
+	events[1] = device->consumedEvent;
+
+	for (eventIndex = 0; eventIndex < replayEventCount && !stopped; eventIndex++)
+	{
+		ReplayEvent *event = &replayEvents[eventIndex];
+		unsigned long long now = getMonotonicTime();
+		byte state;
+
+		if (event->deviceIndex != device->deviceIndex)
+			continue;
+
+		if (eventRate == 0)
+		{
+			while (!stopped && getQueuedReportCount(&device->inputBuffers) >= SIMULATED_INPUT_BUFFERS)
+				stopped = waitForPlatformEvents(events, 2, PLATFORM_WAIT_INFINITE) == 0;
+		}
+		else
+		{
+			unsigned long long due = device->timelineStartTime + event->time / (unsigned long long) replaySpeed;
+
+			while (!stopped && now < due)
+			{
+				stopped = waitForPlatformEvent(device->stopEvent, (DWORD) ((due - now + 999999ULL) / 1000000ULL));
+				now = getMonotonicTime();
+			}
+
+			if (getQueuedReportCount(&device->inputBuffers) >= SIMULATED_INPUT_BUFFERS)
+			{
+				addAtomic64(&eventsDropped, 1);
+				continue;
+			}
+		}
+
+		if (stopped)
+			break;
+
+		if (decodeHidButtons(&deviceModel, event->data, FLIGHT_RECORD_DATA_SIZE, &state))
+			storeAtomic64(&device->deviceRegister, state);
+		pushReport(&device->inputBuffers, event->data, FLIGHT_RECORD_DATA_SIZE, now, FALSE);
+	}
+
+	// Replay over, wait for the device to be closed
+	waitForPlatformEvent(device->stopEvent, PLATFORM_WAIT_INFINITE);
+	return 0;
+}
+
+static void destroyDevice(HidDevice *device)
+{
+	destroyPlatformEvent(device->stopEvent);
+	destroyPlatformEvent(device->consumedEvent);
+	destroyPlatformEvent(device->cancelledEvent);
+	finalizeReportQueue(&device->inputBuffers);
+	freePlatformMemory(device);
+}
+
+// The simulated devices are always found, whatever the VID and PID
+static BOOL findDevicePath(int usbVid, int usbPid, int deviceIndex, char *devicePath)
+{
+	if (deviceIndex >= deviceCount)
+		return FALSE;
+
+	snprintf(devicePath, HID_DEVICE_PATH_SIZE, SIMULATED_DEVICE_PATH "%d", deviceIndex);
+	return TRUE;
+}
+
+static BOOL isMatchingDevicePath(const char *devicePath, int usbVid, int usbPid)
+{
+	return strncmp(devicePath, SIMULATED_DEVICE_PATH, strlen(SIMULATED_DEVICE_PATH)) == 0;
+}
+
+static enum HidTransportOpenResult openDevice(const char *devicePath, HidDevice **openedDevice)
+{
+	HidDevice *device;
+	char *end;
+	long deviceIndex;
+
+	if (!isMatchingDevicePath(devicePath, 0, 0))
+		return deviceNotFound;
+
+	deviceIndex = strtol(devicePath + strlen(SIMULATED_DEVICE_PATH), &end, 10);
+	if (*end != '\0' || deviceIndex < 0 || deviceIndex >= deviceCount)
+		return deviceNotFound;
+
+	device = (HidDevice *) allocatePlatformMemory(sizeof(HidDevice));
+	if (device == NULL)
+		return deviceBroken;
+
+	device->stopEvent = createPlatformEvent(TRUE, FALSE);
+	device->consumedEvent = createPlatformEvent(FALSE, FALSE);
+	device->cancelledEvent = createPlatformEvent(TRUE, FALSE);
+	if (!initReportQueue(&device->inputBuffers) || device->stopEvent == NULL || device->consumedEvent == NULL || device->cancelledEvent == NULL)
+	{
+		destroyDevice(device);
+		return deviceBroken;
+	}
+
+	device->deviceIndex = (int) deviceIndex;
+	device->pendingEcho = SIMULATED_NO_ECHO;
+	device->timelineStartTime = getMonotonicTime();
+	device->timelineThread = createPlatformThread(replaying ? replayThread : timelineThread, device);
+	if (device->timelineThread == NULL)
+	{
+		destroyDevice(device);
+		return deviceBroken;
+	}
+
+	OutputDebugString("openDevice: Simulated device opened");
+	*openedDevice = device;
+	return deviceOpened;
+}
+
+static void closeDevice(HidDevice *device)
+{
+	setPlatformEvent(device->stopEvent);
+	joinPlatformThread(device->timelineThread, PLATFORM_WAIT_INFINITE);
+	destroyDevice(device);
+}
+
+// Cancels the pending IO operations, a further read fails
+static void cancelIo(HidDevice *device)
+{
+	storeAtomic64(&device->ioCancelled, 1);
+	setPlatformEvent(device->inputBuffers.readyEvent);
+	setPlatformEvent(device->cancelledEvent);
+}
+
+static BOOL getDeviceModel(HidDevice *device, HidDeviceModel *model)
+{
+	*model = deviceModel;
+	return TRUE;
+}
+
+static PlatformEvent *getReadEvent(HidDevice *device)
+{
+	return device->inputBuffers.readyEvent;
+}
+
+// Reads the next input report : a feature echo, or the next event buffered
+// (a replayed report is read as recorded, the bytes past the ones recorded are zero)
+static enum HidTransportReadResult readReport(HidDevice *device, unsigned char *buffer, DWORD bufferLength, DWORD *bytesRead)
+{
+	unsigned char inputReport[REPORT_SIZE];
+	TimedReport report;
+	long long echo;
+	byte state;
+
+	*bytesRead = 0;
+	if (bufferLength < deviceModel.inputReportLength || loadAtomic64(&device->ioCancelled))
+		return readFailed;
+
+	// The Game Voice reports its register after every feature write
+	echo = exchangeAtomic64(&device->pendingEcho, SIMULATED_NO_ECHO);
+	if (echo != SIMULATED_NO_ECHO)
+		state = (byte) echo;
+	else if (popReport(&device->inputBuffers, &report))
+	{
+		addAtomic64(&eventsPlayed, 1);
+		setPlatformEvent(device->consumedEvent);
+
+		// The time the button changed is known here only, the HID worker timestamps the report it reads
+		recordLatency(STATISTIC_DEVICE_TO_READ, getMonotonicTime() - report.time);
+		if (replaying)
+		{
+			*bytesRead = deviceModel.inputReportLength;
+			memcpy(buffer, report.data, *bytesRead);
+			return reportRead;
+		}
+		state = report.data[1];
+	}
+	else
+		return readPending;
+
+	*bytesRead = encodeHidButtons(&deviceModel, state, inputReport);
+	memcpy(buffer, inputReport, *bytesRead);
+	return reportRead;
+}
+
+// Transfers an LED report : the stalling write never completes (until cancelled),
+// the hanging one blocks even when cancelled
+static void transferLedReport(HidDevice *device)
+{
+	long long write = addAtomic64(&featureWrites, 1);
+
+	if (write == stallFeature)
+	{
+		OutputDebugString("transferLedReport: Simulated device stalled");
+		waitForPlatformEvent(device->cancelledEvent, PLATFORM_WAIT_INFINITE);
+	}
+	else if (write == hangFeature)
+	{
+		OutputDebugString("transferLedReport: Simulated device hanging");
+		Sleep(SIMULATED_HANG_TIME);
+	}
+}
+
+// Sets the LEDs of the layouts holding them in an output report, the other output reports are ignored
+static BOOL writeReport(HidDevice *device, unsigned char *buffer, DWORD bufferLength)
+{
+	BOOL ledReport = deviceModel.ledReport == hidLedsInOutput && bufferLength >= deviceModel.outputReportLength && buffer[0] == deviceModel.outputReportId;
+
+	if (ledReport)
+		transferLedReport(device);
+
+	if (loadAtomic64(&device->ioCancelled))
+		return FALSE;
+
+	if (ledReport)
+		storeAtomic64(&device->ledRegister, decodeHidLeds(&deviceModel, buffer, bufferLength));
+	return TRUE;
+}
+
+// Sets the button/LED register, the Game Voice echoes it as an input report.
+// Writes not read yet are coalesced into the last register value.
+static BOOL setFeature(HidDevice *device, unsigned char *buffer, DWORD bufferLength)
+{
+	transferLedReport(device);
+
+	if (bufferLength < deviceModel.featureReportLength || loadAtomic64(&device->ioCancelled))
+		return FALSE;
+
+	if (deviceModel.ledReport == hidLedsInFeature)
+	{
+		byte state = decodeHidLeds(&deviceModel, buffer, bufferLength);
+
+		storeAtomic64(&device->ledRegister, state);
+		if (deviceModel.echoesLedState)
+		{
+			storeAtomic64(&device->deviceRegister, state);
+			storeAtomic64(&device->pendingEcho, state);
+			setPlatformEvent(device->inputBuffers.readyEvent);
+		}
+	}
+	return TRUE;
+}
+
+static BOOL getFeature(HidDevice *device, unsigned char *buffer, DWORD bufferLength)
+{
+	unsigned char featureReport[REPORT_SIZE];
+
+	if (deviceModel.ledReport != hidLedsInFeature || bufferLength < deviceModel.featureReportLength || loadAtomic64(&device->ioCancelled))
+		return FALSE;
+
+	memcpy(buffer, featureReport, encodeHidLeds(&deviceModel, (byte) loadAtomic64(&device->ledRegister), featureReport));
+	return TRUE;
+}
+
+static BOOL getInputReport(HidDevice *device, unsigned char *buffer, DWORD bufferLength)
+{
+	unsigned char inputReport[REPORT_SIZE];
+
+	if (bufferLength < deviceModel.inputReportLength || loadAtomic64(&device->ioCancelled))
+		return FALSE;
+
+	memcpy(buffer, inputReport, encodeHidButtons(&deviceModel, (byte) loadAtomic64(&device->deviceRegister), inputReport));
+	return TRUE;
+}
+
+long long getSimulatedEventsPlayed(void)
+{
+	return loadAtomic64(&eventsPlayed);
+}
+
+long long getSimulatedEventsDropped(void)
+{
+	return loadAtomic64(&eventsDropped);
+}
+
+long long getSimulatedReplayEventCount(void)
+{
+	return replaying ? replayEventCount : 0;
+}
+
+void startSimulatedReplay(void)
+{
+	if (replayStartEvent != NULL)
+		setPlatformEvent(replayStartEvent);
+}
+
+// Plugs in and unplugs unrelated devices at the churn rate, until the monitor is stopped
+static DWORD WINAPI hotplugMonitorThread(LPVOID argument)
+{
+	char devicePath[HID_DEVICE_PATH_SIZE];
+	long long event = 0;
+
+	while (!waitForPlatformEvent(hotplugStopEvent, (DWORD) (1000 / churnRate)))
+	{
+		snprintf(devicePath, HID_DEVICE_PATH_SIZE, SIMULATED_UNRELATED_PATH "%lld", event / 2);
+		hotplugCallback(event % 2 == 0 ? hidDeviceArrived : hidDeviceRemoved, devicePath, hotplugContext);
+		event++;
+	}
+
+	return 0;
+}
+
+// The simulated devices stay plugged in, only unrelated devices come and go
+static BOOL startHotplugMonitor(HidHotplugCallback callback, LPVOID context)
+{
+	if (churnRate == 0)
+		return TRUE;
+
+	hotplugCallback = callback;
+	hotplugContext = context;
+	hotplugStopEvent = createPlatformEvent(TRUE, FALSE);
+	if (hotplugStopEvent == NULL)
+		return FALSE;
+
+	hotplugThread = createPlatformThread(hotplugMonitorThread, NULL);
+	if (hotplugThread == NULL)
+	{
+		destroyPlatformEvent(hotplugStopEvent);
+		hotplugStopEvent = NULL;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void stopHotplugMonitor(void)
+{
+	if (hotplugThread == NULL)
+		return;
+
+	setPlatformEvent(hotplugStopEvent);
+	joinPlatformThread(hotplugThread, PLATFORM_WAIT_INFINITE);
+	hotplugThread = NULL;
+	destroyPlatformEvent(hotplugStopEvent);
+	hotplugStopEvent = NULL;
+}
+
+// HidTransport factory
+HidTransport CreateSimulatedHidTransport(const char *script)
+{
+	HidTransport transport;
+
+	if (!parseScript(script))
+	{
+		OutputDebugString("CreateSimulatedHidTransport: /!\\ Invalid script, no event will be played");
+		stepCount = 0;
+		replaying = FALSE;
+		replayEventCount = 0;
+		reportDescriptor = gameVoiceDescriptor;
+		reportDescriptorLength = sizeof(gameVoiceDescriptor);
+		parseHidReportDescriptor(reportDescriptor, reportDescriptorLength, &deviceModel);
+	}
+
+	storeAtomic64(&eventsPlayed, 0);
+	storeAtomic64(&eventsDropped, 0);
+	storeAtomic64(&featureWrites, 0);
+
+	if (replayStartEvent == NULL)
+		replayStartEvent = createPlatformEvent(TRUE, FALSE);
+	else
+		resetPlatformEvent(replayStartEvent);
+	if (replaying && replayStartEvent == NULL)
+	{
+		OutputDebugString("CreateSimulatedHidTransport: /!\\ Can't create the replay event, no report will be replayed");
+		replaying = FALSE;
+		stepCount = 0;
+	}
+
+	transport.cancelIo = cancelIo;
+	transport.closeDevice = closeDevice;
+	transport.findDevicePath = findDevicePath;
+	transport.getDeviceModel = getDeviceModel;
+	transport.getFeature = getFeature;
+	transport.getInputReport = getInputReport;
+	transport.getReadEvent = getReadEvent;
+	transport.isMatchingDevicePath = isMatchingDevicePath;
+	transport.openDevice = openDevice;
+	transport.readReport = readReport;
+	transport.setFeature = setFeature;
+	transport.startHotplugMonitor = startHotplugMonitor;
+	transport.stopHotplugMonitor = stopHotplugMonitor;
+	transport.writeReport = writeReport;
+
+	return transport;
+}
@@ -0,0 +1,719 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ * Copyright (c) 2010 Simon Inns
+ *
+ * HID transport for Windows (SetupAPI and HidD functions)
+ * hidTransportWindows.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ * Code adapted from usbHidCommunication
+ * v1_1 2010-03-31
+ * Simon Inns (simon.inns@gmail.com)
+ * http://www.waitingforfriday.com
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef _WIN32
+
+#include <stdio.h>
+#include "stdafx.h"
+
+#include <tchar.h>
+#include <winioctl.h>
+#include "hidsdi.h"			// From Windows DDK
+#include "hidTransport.h"
+#include "platform.h"
+
+// HID class IOCTLs behind HidD_SetFeature, HidD_GetFeature and HidD_GetInputReport (hidclass.h),
+// issued directly to run them overlapped
+#ifndef IOCTL_HID_SET_FEATURE
+#define IOCTL_HID_SET_FEATURE CTL_CODE(FILE_DEVICE_KEYBOARD, 100, METHOD_IN_DIRECT, FILE_ANY_ACCESS)
+#endif
+#ifndef IOCTL_HID_GET_FEATURE
+#define IOCTL_HID_GET_FEATURE CTL_CODE(FILE_DEVICE_KEYBOARD, 100, METHOD_OUT_DIRECT, FILE_ANY_ACCESS)
+#endif
+#ifndef IOCTL_HID_GET_INPUT_REPORT
+#define IOCTL_HID_GET_INPUT_REPORT CTL_CODE(FILE_DEVICE_KEYBOARD, 104, METHOD_OUT_DIRECT, FILE_ANY_ACCESS)
+#endif
+
+// Number of transfers (besides the read) a device runs at once without creating an event
+#define HID_TRANSFER_EVENTS 4
+
+// Transfers multiplexed on the device handle besides the reads
+enum HidTransferType {transferWrite, transferSetFeature, transferGetFeature, transferGetInputReport};
+
+// Opened device : the single overlapped handle every transfer goes through.
+// A read stays pending into its own buffer until a report comes in, the event
+// loop waits for its completion event along with the other devices.
+// The other transfers wait for their own completion event, taken from the device ones.
+struct HidDevice
+{
+	HANDLE DeviceHandle;
+	BOOL modelParsed;
+	HidDeviceModel model;
+
+	OVERLAPPED readOverlapped;
+	BOOL readPending;
+	unsigned char readBuffer[REPORT_SIZE];
+	PlatformEvent *readEvent;
+
+	HANDLE transferEvents[HID_TRANSFER_EVENTS];
+	volatile long long transferEventsInUse;
+};
+
+// Window class of the hotplug monitor message-only window
+#define HOTPLUG_WINDOW_CLASS "GameVoiceHotplugMonitor"
+
+// Hotplug monitor : the message-only window receiving the HID interface notifications
+// and the thread running its message loop
+static HWND hotplugWindow = NULL;
+static HDEVNOTIFY hotplugNotification = NULL;
+static PlatformThread *hotplugThread = NULL;
+static PlatformEvent *hotplugReadyEvent = NULL;
+static HidHotplugCallback hotplugCallback = NULL;
+static LPVOID hotplugContext = NULL;
+
+// Define the Globally Unique Identifier (GUID) for HID class devices
+static const GUID hidInterfaceClassGuid = {0x4d1e55b2, 0xf16f, 0x11cf, 0x88, 0xcb, 0x00, 0x11, 0x11, 0x00, 0x00, 0x30};
+
+// Copies a device interface path in lower case : SetupAPI and the device notifications
+// do not use the same case, the hotplug monitor must report the path findDevicePath got
+static void copyDevicePath(char *devicePath, const char *interfacePath)
+{
+	snprintf(devicePath, HID_DEVICE_PATH_SIZE, "%s", interfacePath);
+	CharLowerA(devicePath);
+}
+
+// Determines whether a device interface path belongs to the specified USB VID and PID
+static BOOL isMatchingDevicePath(const char *devicePath, int usbVid, int usbPid)
+{
+	char usbId[18];
+	char lowerCasePath[HID_DEVICE_PATH_SIZE];
+
+	snprintf(usbId, 18, "vid_%04x&pid_%04x", usbVid, usbPid);
+	copyDevicePath(lowerCasePath, devicePath);
+	return strstr(lowerCasePath, usbId) != NULL;
+}
+
+// This method attempts to find the target USB device interface path.
+// The matching devices are counted in the SetupAPI enumeration order.
+static BOOL findDevicePath(int usbVid, int usbPid, int deviceIndex, char *devicePath)
+{
+	HDEVINFO                         hDevInfo;
+	SP_DEVICE_INTERFACE_DATA         DevIntfData;
+	PSP_DEVICE_INTERFACE_DETAIL_DATA DevIntfDetailData;
+	SP_DEVINFO_DATA                  DevData;
+
+	DWORD dwSize, dwMemberIdx;
+
+	BOOL found = FALSE;
+	int matches = 0;
+
+	GUID GUID_DEVINTERFACE_USB_DEVICE = hidInterfaceClassGuid;
+
+	OutputDebugString("findDevicePath: SetupDiGetClassDevs: Initializing HID class devices...");
+	// We will try to get device information set for all USB devices that have a
+	// device interface and are currently present on the system (plugged in).
+	hDevInfo = SetupDiGetClassDevs(
+		&GUID_DEVINTERFACE_USB_DEVICE, NULL, 0, DIGCF_DEVICEINTERFACE | DIGCF_PRESENT);
+
+	if (hDevInfo != INVALID_HANDLE_VALUE)
+	{
+		// Prepare to enumerate all device interfaces for the device information
+		// set that we retrieved with SetupDiGetClassDevs(..)
+		DevIntfData.cbSize = sizeof(SP_DEVICE_INTERFACE_DATA);
+		dwMemberIdx = 0;
+
+		OutputDebugString("findDevicePath: SetupDiEnumDeviceInfo: Enumerating devices...");
+		// Next, we will keep calling this SetupDiEnumDeviceInterfaces(..) until this
+		// function causes GetLastError() to return  ERROR_NO_MORE_ITEMS. With each
+		// call the dwMemberIdx value needs to be incremented to retrieve the next
+		// device interface information.
+
+		SetupDiEnumDeviceInterfaces(hDevInfo, NULL, &GUID_DEVINTERFACE_USB_DEVICE,
+			dwMemberIdx, &DevIntfData);
+
+		while(GetLastError() != ERROR_NO_MORE_ITEMS)
+		{
+			// As a last step we will need to get some more details for each
+			// of device interface information we are able to retrieve. This
+			// device interface detail gives us the information we need to identify
+			// the device (VID/PID), and decide if it's useful to us. It will also
+			// provide a DEVINFO_DATA structure which we can use to know the serial
+			// port name for a virtual com port.
+
+			DevData.cbSize = sizeof(DevData);
+
+			// Get the required buffer size. Call SetupDiGetDeviceInterfaceDetail with
+			// a NULL DevIntfDetailData pointer, a DevIntfDetailDataSize
+			// of zero, and a valid RequiredSize variable. In response to such a call,
+			// this function returns the required buffer size at dwSize.
+			SetupDiGetDeviceInterfaceDetail(
+					hDevInfo, &DevIntfData, NULL, 0, &dwSize, NULL);
+
+			// Allocate memory for the DeviceInterfaceDetail struct. Don't forget to
+			// deallocate it later!
+			DevIntfDetailData = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, dwSize);
+			DevIntfDetailData->cbSize = sizeof(SP_DEVICE_INTERFACE_DETAIL_DATA);
+
+			OutputDebugString("findDevicePath: SetupDiGetDeviceInterfaceDetail: Getting device interface detail to open the read and write handles required for USB communication...");
+
+			if (SetupDiGetDeviceInterfaceDetail(hDevInfo, &DevIntfData,
+				DevIntfDetailData, dwSize, &dwSize, &DevData))
+			{
+				// Finally we can start checking if we've found a useable device,
+				// by inspecting the DevIntfDetailData->DevicePath variable.
+				if (isMatchingDevicePath(DevIntfDetailData->DevicePath, usbVid, usbPid) && matches++ == deviceIndex)
+				{
+					OutputDebugString("findDevicePath: Device found, path is below");
+					OutputDebugString(DevIntfDetailData->DevicePath);
+					copyDevicePath(devicePath, DevIntfDetailData->DevicePath);
+					found = TRUE;
+				}
+			}
+
+			HeapFree(GetProcessHeap(), 0, DevIntfDetailData);
+
+			if (found)
+				break;
+
+			// Device not found, continue looping
+			SetupDiEnumDeviceInterfaces(
+				hDevInfo, NULL, &GUID_DEVINTERFACE_USB_DEVICE, ++dwMemberIdx, &DevIntfData);
+		}
+
+		SetupDiDestroyDeviceInfoList(hDevInfo);
+	}
+
+	return found;
+} // END findDevicePath
+
+// Releases the device handle and events
+static void destroyDevice(HidDevice *device)
+{
+	int slot;
+
+	for (slot = 0; slot < HID_TRANSFER_EVENTS; slot++)
+	{
+		if (device->transferEvents[slot] != NULL)
+			CloseHandle(device->transferEvents[slot]);
+	}
+	destroyPlatformEvent(device->readEvent);
+	if (device->readOverlapped.hEvent != NULL)
+		CloseHandle(device->readOverlapped.hEvent);
+	if (device->DeviceHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(device->DeviceHandle);
+
+	freePlatformMemory(device);
+}
+
+// Number of button capabilities of a report type looked at for the buttons and LEDs
+#define HID_MAX_BUTTON_CAPS 32
+
+// Gets the bit of a usage within its report buffer : the bit set when the usage alone is on, -1 if none
+static int locateUsageBit(PHIDP_PREPARSED_DATA preparsedData, HIDP_REPORT_TYPE reportType, USAGE usagePage, USAGE usage, UCHAR reportId, ULONG reportLength)
+{
+	unsigned char emptyReport[REPORT_SIZE];
+	unsigned char report[REPORT_SIZE];
+	ULONG usageCount = 1;
+	ULONG bit;
+
+	if (HidP_InitializeReportForID(reportType, reportId, preparsedData, (PCHAR) emptyReport, reportLength) != HIDP_STATUS_SUCCESS)
+		return -1;
+
+	memcpy(report, emptyReport, reportLength);
+	if (HidP_SetUsages(reportType, usagePage, 0, &usage, &usageCount, preparsedData, (PCHAR) report, reportLength) != HIDP_STATUS_SUCCESS)
+		return -1;
+
+	for (bit = 8; bit < 8 * reportLength; bit++)
+	{
+		if ((report[bit / 8] ^ emptyReport[bit / 8]) & (1 << (bit % 8)))
+			return (int) bit;
+	}
+
+	return -1;
+}
+
+// Finds the bits of the usages of a page in the first report holding them.
+// Usage n goes to bits[n - 1] when mapped by usage (buttons), to the next free bit otherwise (LEDs).
+// Returns the number of bits found.
+static int findUsageBits(PHIDP_PREPARSED_DATA preparsedData, HIDP_REPORT_TYPE reportType, USAGE usagePage, ULONG reportLength, BOOL mappedByUsage, int *bits, unsigned char *reportId)
+{
+	HIDP_BUTTON_CAPS buttonCaps[HID_MAX_BUTTON_CAPS];
+	USHORT capsCount = HID_MAX_BUTTON_CAPS;
+	USHORT caps;
+	int found = 0;
+
+	if (reportLength == 0 || HidP_GetSpecificButtonCaps(reportType, usagePage, 0, 0, buttonCaps, &capsCount, preparsedData) != HIDP_STATUS_SUCCESS || capsCount == 0)
+		return 0;
+
+	*reportId = buttonCaps[0].ReportID;
+	for (caps = 0; caps < capsCount; caps++)
+	{
+		USAGE usage, usageMinimum, usageMaximum;
+
+		if (buttonCaps[caps].ReportID != *reportId)
+			continue;
+
+		usageMinimum = buttonCaps[caps].IsRange ? buttonCaps[caps].Range.UsageMin : buttonCaps[caps].NotRange.Usage;
+		usageMaximum = buttonCaps[caps].IsRange ? buttonCaps[caps].Range.UsageMax : buttonCaps[caps].NotRange.Usage;
+
+		for (usage = usageMinimum; usage <= usageMaximum && usage >= usageMinimum; usage++)
+		{
+			int index = mappedByUsage ? usage - 1 : found;
+			int bit;
+
+			if (index < 0 || index >= HID_MODEL_MAX_BUTTONS || bits[index] >= 0)
+				continue;
+
+			bit = locateUsageBit(preparsedData, reportType, usagePage, usage, *reportId, reportLength);
+			if (bit >= 0)
+			{
+				bits[index] = bit;
+				found++;
+			}
+		}
+	}
+
+	return found;
+}
+
+// Builds the report layout of the device from its HID capabilities
+static BOOL readDeviceModel(HANDLE deviceHandle, HidDeviceModel *model)
+{
+	PHIDP_PREPARSED_DATA preparsedData;
+	HIDP_CAPS caps;
+	int buttonBits[HID_MODEL_MAX_BUTTONS];
+	int ledBits[HID_MODEL_MAX_BUTTONS];
+	unsigned char buttonReportId = 0, ledReportId = 0;
+	int button;
+
+	if (!HidD_GetPreparsedData(deviceHandle, &preparsedData))
+	{
+		OutputDebugString("readDeviceModel: /!\\ Can't get the device capabilities");
+		return FALSE;
+	}
+
+	if (HidP_GetCaps(preparsedData, &caps) != HIDP_STATUS_SUCCESS || caps.InputReportByteLength == 0)
+	{
+		HidD_FreePreparsedData(preparsedData);
+		return FALSE;
+	}
+
+	// The Game Voice layout unless the device describes its buttons
+	initGameVoiceDeviceModel(model);
+	model->inputReportLength = caps.InputReportByteLength < REPORT_SIZE ? caps.InputReportByteLength : REPORT_SIZE;
+	model->outputReportLength = caps.OutputReportByteLength < REPORT_SIZE ? caps.OutputReportByteLength : REPORT_SIZE;
+	model->featureReportLength = caps.FeatureReportByteLength < REPORT_SIZE ? caps.FeatureReportByteLength : REPORT_SIZE;
+	if (model->featureReportLength == 0)
+		model->ledReport = hidLedsNone;
+
+	for (button = 0; button < HID_MODEL_MAX_BUTTONS; button++)
+	{
+		buttonBits[button] = -1;
+		ledBits[button] = -1;
+	}
+
+	if (findUsageBits(preparsedData, HidP_Input, HID_USAGE_PAGE_BUTTON, model->inputReportLength, TRUE, buttonBits, &buttonReportId) > 0)
+	{
+		memcpy(model->buttonBits, buttonBits, sizeof(buttonBits));
+		model->inputReportId = buttonReportId;
+		model->echoesLedState = FALSE;
+		model->latchedButtons = FALSE;
+
+		if (findUsageBits(preparsedData, HidP_Output, HID_USAGE_PAGE_LED, model->outputReportLength, FALSE, ledBits, &ledReportId) > 0)
+		{
+			model->ledReport = hidLedsInOutput;
+			model->outputReportId = ledReportId;
+		}
+		else if (findUsageBits(preparsedData, HidP_Feature, HID_USAGE_PAGE_LED, model->featureReportLength, FALSE, ledBits, &ledReportId) > 0)
+		{
+			model->ledReport = hidLedsInFeature;
+			model->featureReportId = ledReportId;
+		}
+		else
+			model->ledReport = hidLedsNone;
+		memcpy(model->ledBits, ledBits, sizeof(ledBits));
+		setHidModelValidStates(model, FALSE);
+	}
+
+	// Windows always reports the ID byte, numbered reports are the ones with a non zero ID
+	model->numberedReports = model->inputReportId != 0 || model->outputReportId != 0 || model->featureReportId != 0;
+
+	HidD_FreePreparsedData(preparsedData);
+	return TRUE;
+}
+
+// This method opens the device handle
+static enum HidTransportOpenResult openDevice(const char *devicePath, HidDevice **openedDevice)
+{
+	DWORD ErrorStatus;
+	int slot;
+	BOOL eventsCreated;
+
+	HidDevice *device = (HidDevice *) allocatePlatformMemory(sizeof(HidDevice));
+
+	if (device == NULL)
+		return deviceBroken;
+
+	OutputDebugString("openDevice: Opening the device, path is below");
+	OutputDebugString(devicePath);
+
+	// Open the device handle (overlapped, so a pending read can be waited along with other events
+	// and every transfer can be cancelled)
+	device->DeviceHandle = CreateFile(devicePath,
+		GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, 0);
+	ErrorStatus = GetLastError();
+
+	// Create the completion events (manual reset, as overlapped IO requires)
+	device->readOverlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (device->readOverlapped.hEvent != NULL)
+		device->readEvent = createPlatformEventFromHandle(device->readOverlapped.hEvent);
+	device->readPending = FALSE;
+
+	eventsCreated = device->readEvent != NULL;
+	for (slot = 0; slot < HID_TRANSFER_EVENTS; slot++)
+	{
+		device->transferEvents[slot] = CreateEvent(NULL, TRUE, FALSE, NULL);
+		eventsCreated = eventsCreated && device->transferEvents[slot] != NULL;
+	}
+	device->transferEventsInUse = 0;
+
+	// Check to see if we opened the handle successfully
+	if (device->DeviceHandle != INVALID_HANDLE_VALUE && eventsCreated)
+	{
+		device->modelParsed = readDeviceModel(device->DeviceHandle, &device->model);
+		OutputDebugString("openDevice: Success ! Device handle is opened");
+		*openedDevice = device;
+		return deviceOpened;
+	}
+
+	OutputDebugString("openDevice: Failed ! Something went wrong... Can't use the device :(");
+
+	// Something went wrong... Release what has been opened and report the device
+	// as broken since we found the device but, for some reason, can't use it.
+	destroyDevice(device);
+
+	// The device has been unplugged meanwhile
+	if (ErrorStatus == ERROR_FILE_NOT_FOUND || ErrorStatus == ERROR_DEVICE_NOT_CONNECTED)
+		return deviceNotFound;
+
+	return deviceBroken;
+} // END openDevice
+
+// Closes the device file handle
+static void closeDevice(HidDevice *device)
+{
+	DWORD bytesRead;
+
+	// The pending read must be over before its buffer and event are released
+	if (device->readPending)
+	{
+		CancelIoEx(device->DeviceHandle, &device->readOverlapped);
+		GetOverlappedResult(device->DeviceHandle, &device->readOverlapped, &bytesRead, TRUE);
+	}
+
+	destroyDevice(device);
+} // END closeDevice
+
+// Cancels any pending IO operations : the read and the transfers in progress, whatever their thread
+static void cancelIo(HidDevice *device)
+{
+	CancelIoEx(device->DeviceHandle, NULL);
+} // END cancelIo
+
+static BOOL getDeviceModel(HidDevice *device, HidDeviceModel *model)
+{
+	if (!device->modelParsed)
+		return FALSE;
+
+	*model = device->model;
+	return TRUE;
+}
+
+static PlatformEvent *getReadEvent(HidDevice *device)
+{
+	return device->readEvent;
+}
+
+static enum HidTransportReadResult readReport(HidDevice *device, unsigned char *buffer, DWORD bufferLength, DWORD *bytesRead)
+{
+	DWORD length = 0;
+
+	*bytesRead = 0;
+
+	// Start a read unless the previous one is still pending, ReadFile resets the completion event
+	if (!device->readPending)
+	{
+		if (!ReadFile(device->DeviceHandle, device->readBuffer, sizeof(device->readBuffer), NULL, &device->readOverlapped) && GetLastError() != ERROR_IO_PENDING)
+			return readFailed;
+		device->readPending = TRUE;
+	}
+
+	if (!GetOverlappedResult(device->DeviceHandle, &device->readOverlapped, &length, FALSE))
+	{
+		if (GetLastError() == ERROR_IO_INCOMPLETE)
+			return readPending;
+
+		// Read cancelled (detach) or failed (device unplugged)
+		device->readPending = FALSE;
+		return readFailed;
+	}
+
+	device->readPending = FALSE;
+	if (length > bufferLength)
+		length = bufferLength;
+	memcpy(buffer, device->readBuffer, length);
+	*bytesRead = length;
+	return reportRead;
+}
+
+// Takes a free completion event of the device, -1 if they are all in use
+static int acquireTransferEvent(HidDevice *device)
+{
+	long long inUse;
+	int slot;
+
+	for (slot = 0; slot < HID_TRANSFER_EVENTS; slot++)
+	{
+		inUse = loadAtomic64(&device->transferEventsInUse);
+		if (!(inUse & (1LL << slot)) && compareExchangeAtomic64(&device->transferEventsInUse, inUse, inUse | (1LL << slot)))
+			return slot;
+	}
+
+	return -1;
+}
+
+// Runs a transfer on the device handle and waits for its completion.
+// The transfers may run from several threads at once, cancelIo aborts them.
+static BOOL transfer(HidDevice *device, enum HidTransferType type, unsigned char *buffer, DWORD bufferLength)
+{
+	OVERLAPPED overlapped;
+	DWORD bytesTransferred = 0;
+	BOOL started, completed;
+	int slot = acquireTransferEvent(device);
+
+	memset(&overlapped, 0, sizeof(overlapped));
+	overlapped.hEvent = slot >= 0 ? device->transferEvents[slot] : CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (overlapped.hEvent == NULL)
+		return FALSE;
+	ResetEvent(overlapped.hEvent);
+
+	switch (type)
+	{
+	case transferWrite:
+		started = WriteFile(device->DeviceHandle, buffer, bufferLength, NULL, &overlapped);
+		break;
+
+	case transferSetFeature:
+		started = DeviceIoControl(device->DeviceHandle, IOCTL_HID_SET_FEATURE, buffer, bufferLength, NULL, 0, NULL, &overlapped);
+		break;
+
+	case transferGetFeature:
+		started = DeviceIoControl(device->DeviceHandle, IOCTL_HID_GET_FEATURE, buffer, bufferLength, buffer, bufferLength, NULL, &overlapped);
+		break;
+
+	default:
+		started = DeviceIoControl(device->DeviceHandle, IOCTL_HID_GET_INPUT_REPORT, buffer, bufferLength, buffer, bufferLength, NULL, &overlapped);
+		break;
+	}
+
+	completed = (started || GetLastError() == ERROR_IO_PENDING)
+		&& GetOverlappedResult(device->DeviceHandle, &overlapped, &bytesTransferred, TRUE);
+
+	if (slot >= 0)
+		addAtomic64(&device->transferEventsInUse, -(1LL << slot));
+	else
+		CloseHandle(overlapped.hEvent);
+
+	return completed;
+}
+
+static BOOL writeReport(HidDevice *device, unsigned char *buffer, DWORD bufferLength)
+{
+	return transfer(device, transferWrite, buffer, bufferLength);
+}
+
+static BOOL setFeature(HidDevice *device, unsigned char *buffer, DWORD bufferLength)
+{
+	return transfer(device, transferSetFeature, buffer, bufferLength);
+}
+
+static BOOL getFeature(HidDevice *device, unsigned char *buffer, DWORD bufferLength)
+{
+	return transfer(device, transferGetFeature, buffer, bufferLength);
+}
+
+static BOOL getInputReport(HidDevice *device, unsigned char *buffer, DWORD bufferLength)
+{
+	return transfer(device, transferGetInputReport, buffer, bufferLength);
+}
+
+// Hotplug monitor window procedure : reports the HID interfaces arrivals and removals
+static LRESULT CALLBACK hotplugWindowProc(HWND window, UINT message, WPARAM wParam, LPARAM lParam)
+{
+	switch (message)
+	{
+	case WM_DEVICECHANGE:
+		if (wParam == DBT_DEVICEARRIVAL || wParam == DBT_DEVICEREMOVECOMPLETE)
+		{
+			DEV_BROADCAST_HDR *header = (DEV_BROADCAST_HDR *) lParam;
+			char devicePath[HID_DEVICE_PATH_SIZE];
+
+			// The notifications are registered for the HID interface class only
+			if (header != NULL && header->dbch_devicetype == DBT_DEVTYP_DEVICEINTERFACE)
+			{
+				copyDevicePath(devicePath, ((DEV_BROADCAST_DEVICEINTERFACE_A *) header)->dbcc_name);
+				hotplugCallback(wParam == DBT_DEVICEARRIVAL ? hidDeviceArrived : hidDeviceRemoved, devicePath, hotplugContext);
+			}
+		}
+		return TRUE;
+
+	case WM_CLOSE:
+		DestroyWindow(window);
+		return 0;
+
+	case WM_DESTROY:
+		PostQuitMessage(0);
+		return 0;
+
+	default:
+		return DefWindowProcA(window, message, wParam, lParam);
+	}
+}
+
+// Creates the hotplug monitor message-only window and runs its message loop until it is closed
+static DWORD WINAPI hotplugMonitorThread(LPVOID argument)
+{
+	WNDCLASSEXA windowClass;
+	DEV_BROADCAST_DEVICEINTERFACE_A notificationFilter;
+	HINSTANCE instance = NULL;
+	MSG message;
+
+	// The window class belongs to the plugin module, not to the client executable
+	GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+		(LPCSTR) hotplugWindowProc, &instance);
+
+	memset(&windowClass, 0, sizeof(windowClass));
+	windowClass.cbSize = sizeof(windowClass);
+	windowClass.lpfnWndProc = hotplugWindowProc;
+	windowClass.hInstance = instance;
+	windowClass.lpszClassName = HOTPLUG_WINDOW_CLASS;
+	RegisterClassExA(&windowClass);
+
+	hotplugWindow = CreateWindowExA(0, HOTPLUG_WINDOW_CLASS, NULL, 0, 0, 0, 0, 0, HWND_MESSAGE, NULL, instance, NULL);
+	if (hotplugWindow != NULL)
+	{
+		// Register for the WM_DEVICECHANGE notifications of the HID interfaces
+		memset(&notificationFilter, 0, sizeof(notificationFilter));
+		notificationFilter.dbcc_size = sizeof(notificationFilter);
+		notificationFilter.dbcc_devicetype = DBT_DEVTYP_DEVICEINTERFACE;
+		notificationFilter.dbcc_classguid = hidInterfaceClassGuid;
+		hotplugNotification = RegisterDeviceNotificationA(hotplugWindow, &notificationFilter, DEVICE_NOTIFY_WINDOW_HANDLE);
+		if (hotplugNotification == NULL)
+		{
+			DestroyWindow(hotplugWindow);
+			hotplugWindow = NULL;
+		}
+	}
+
+	setPlatformEvent(hotplugReadyEvent);
+	if (hotplugWindow == NULL)
+	{
+		UnregisterClassA(HOTPLUG_WINDOW_CLASS, instance);
+		return 1;
+	}
+
+	while (GetMessageA(&message, NULL, 0, 0) > 0)
+	{
+		TranslateMessage(&message);
+		DispatchMessageA(&message);
+	}
+
+	UnregisterDeviceNotification(hotplugNotification);
+	hotplugNotification = NULL;
+	UnregisterClassA(HOTPLUG_WINDOW_CLASS, instance);
+	return 0;
+}
+
+// Starts the hotplug monitor thread and waits for its window to be ready
+static BOOL startHotplugMonitor(HidHotplugCallback callback, LPVOID context)
+{
+	hotplugCallback = callback;
+	hotplugContext = context;
+	hotplugReadyEvent = createPlatformEvent(TRUE, FALSE);
+	if (hotplugReadyEvent == NULL)
+		return FALSE;
+
+	hotplugThread = createPlatformThread(hotplugMonitorThread, NULL);
+	if (hotplugThread != NULL)
+		waitForPlatformEvent(hotplugReadyEvent, PLATFORM_WAIT_INFINITE);
+	destroyPlatformEvent(hotplugReadyEvent);
+	hotplugReadyEvent = NULL;
+
+	if (hotplugWindow == NULL)
+	{
+		OutputDebugString("startHotplugMonitor: /!\\ Can't register for the device notifications");
+		joinPlatformThread(hotplugThread, PLATFORM_WAIT_INFINITE);
+		hotplugThread = NULL;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void stopHotplugMonitor(void)
+{
+	if (hotplugThread == NULL)
+		return;
+
+	PostMessageA(hotplugWindow, WM_CLOSE, 0, 0);
+	joinPlatformThread(hotplugThread, PLATFORM_WAIT_INFINITE);
+	hotplugThread = NULL;
+	hotplugWindow = NULL;
+}
+
+// HidTransport factory
+HidTransport CreateWindowsHidTransport()
+{
+	HidTransport transport;
+	transport.cancelIo = cancelIo;
+	transport.closeDevice = closeDevice;
+	transport.findDevicePath = findDevicePath;
+	transport.getDeviceModel = getDeviceModel;
+	transport.getFeature = getFeature;
+	transport.getInputReport = getInputReport;
+	transport.getReadEvent = getReadEvent;
+	transport.isMatchingDevicePath = isMatchingDevicePath;
+	transport.openDevice = openDevice;
+	transport.readReport = readReport;
+	transport.setFeature = setFeature;
+	transport.startHotplugMonitor = startHotplugMonitor;
+	transport.stopHotplugMonitor = stopHotplugMonitor;
+	transport.writeReport = writeReport;
+
+	return transport;
+}
+
+HidTransport CreatePlatformHidTransport()
+{
+	return CreateWindowsHidTransport();
+}
+
+#endif
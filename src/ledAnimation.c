@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * LED animation functions
+ * ledAnimation.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "ledAnimation.h"
+
+// Duration of a keyframe (nanoseconds)
+static unsigned long long getKeyframeDuration(const LedTimeline *timeline, int keyframe)
+{
+	return (unsigned long long) timeline->keyframes[keyframe].duration * 1000000ULL;
+}
+
+void initLedAnimator(LedAnimator *animator)
+{
+	memset(animator, 0, sizeof(LedAnimator));
+}
+
+BOOL startLedAnimation(LedAnimator *animator, const LedTimeline *timeline, int layer, unsigned long long now)
+{
+	LedAnimation *animation;
+	int keyframe;
+
+	if (layer < 0 || layer >= LED_ANIMATION_LAYERS || timeline == NULL || timeline->keyframeCount <= 0 || timeline->repeatCount < 0)
+		return FALSE;
+
+	// A keyframe of no time would never let the animation move on
+	for (keyframe = 0; keyframe < timeline->keyframeCount; keyframe++)
+	{
+		if (timeline->keyframes[keyframe].duration == 0)
+			return FALSE;
+	}
+
+	animation = &animator->layers[layer];
+	animation->timeline = timeline;
+	animation->keyframe = 0;
+	animation->repeat = 0;
+	animation->keyframeEnd = now + getKeyframeDuration(timeline, 0);
+	return TRUE;
+}
+
+void cancelLedAnimation(LedAnimator *animator, int layer)
+{
+	if (layer == LED_ANIMATION_ALL_LAYERS)
+		initLedAnimator(animator);
+	else if (layer >= 0 && layer < LED_ANIMATION_LAYERS)
+		animator->layers[layer].timeline = NULL;
+}
+
+void advanceLedAnimations(LedAnimator *animator, unsigned long long now)
+{
+	int layer;
+
+	for (layer = 0; layer < LED_ANIMATION_LAYERS; layer++)
+	{
+		LedAnimation *animation = &animator->layers[layer];
+
+		// The keyframe ends are added up from the start : a late advance does not shift the timeline
+		while (animation->timeline != NULL && animation->keyframeEnd <= now)
+		{
+			if (++animation->keyframe == animation->timeline->keyframeCount)
+			{
+				animation->keyframe = 0;
+				if (animation->timeline->repeatCount != 0 && ++animation->repeat == animation->timeline->repeatCount)
+				{
+					animation->timeline = NULL;
+					break;
+				}
+			}
+			animation->keyframeEnd += getKeyframeDuration(animation->timeline, animation->keyframe);
+		}
+	}
+}
+
+BOOL getLedAnimationFrame(const LedAnimator *animator, byte *leds)
+{
+	int layer;
+
+	for (layer = LED_ANIMATION_LAYERS - 1; layer >= 0; layer--)
+	{
+		const LedAnimation *animation = &animator->layers[layer];
+
+		if (animation->timeline != NULL)
+		{
+			*leds = animation->timeline->keyframes[animation->keyframe].leds;
+			return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+unsigned long long getLedAnimationDeadline(const LedAnimator *animator)
+{
+	unsigned long long deadline = 0;
+	int layer;
+
+	for (layer = 0; layer < LED_ANIMATION_LAYERS; layer++)
+	{
+		const LedAnimation *animation = &animator->layers[layer];
+
+		if (animation->timeline != NULL && (deadline == 0 || animation->keyframeEnd < deadline))
+			deadline = animation->keyframeEnd;
+	}
+
+	return deadline;
+}
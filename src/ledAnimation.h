@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * LED animation functions header
+ * ledAnimation.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LEDANIMATION_H
+#define LEDANIMATION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Layers an animation plays on : the highest layer playing shows its frame,
+// the lower ones keep playing underneath
+#define LED_ANIMATION_LAYERS 4
+
+// Layer to cancel the animations of every layer
+#define LED_ANIMATION_ALL_LAYERS -1
+
+// Frame of a timeline : the LEDs (button model register) shown for a duration (milliseconds, not 0)
+typedef struct LedKeyframe
+{
+	byte leds;
+	unsigned int duration;
+} LedKeyframe;
+
+// Keyframed LED timeline, played repeatCount times (0 loops until cancelled).
+// A timeline is not copied : it must live as long as it plays (a static table).
+typedef struct LedTimeline
+{
+	const LedKeyframe *keyframes;
+	int keyframeCount;
+	int repeatCount;
+} LedTimeline;
+
+// Timeline playing on a layer
+typedef struct LedAnimation
+{
+	// NULL while the layer plays nothing
+	const LedTimeline *timeline;
+
+	int keyframe;
+	int repeat;
+
+	// Monotonic time (nanoseconds) the keyframe shown ends
+	unsigned long long keyframeEnd;
+} LedAnimation;
+
+// Animations of a device, one per layer. Only the time given is looked at :
+// the owner advances the animations and shows their frame.
+typedef struct LedAnimator
+{
+	LedAnimation layers[LED_ANIMATION_LAYERS];
+} LedAnimator;
+
+/* Sets up an animator playing nothing.
+ */
+void initLedAnimator(LedAnimator *animator);
+
+/* Starts a timeline on a layer at a monotonic time (nanoseconds), replacing the animation playing there.
+ * Returns FALSE if the layer or the timeline is not valid.
+ */
+BOOL startLedAnimation(LedAnimator *animator, const LedTimeline *timeline, int layer, unsigned long long now);
+
+/* Cancels the animation of a layer, of every layer with LED_ANIMATION_ALL_LAYERS.
+ */
+void cancelLedAnimation(LedAnimator *animator, int layer);
+
+/* Advances the animations to a monotonic time : the keyframes over move on,
+ * the animations played to their end stop.
+ */
+void advanceLedAnimations(LedAnimator *animator, unsigned long long now);
+
+/* Gets the LEDs shown by the animations : the keyframe of the highest layer playing.
+ * Returns FALSE if no animation plays.
+ */
+BOOL getLedAnimationFrame(const LedAnimator *animator, byte *leds);
+
+/* Gets the monotonic time the next keyframe of any layer ends, 0 if no animation plays.
+ */
+unsigned long long getLedAnimationDeadline(const LedAnimator *animator);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * LED compositor functions
+ * ledCompositor.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "stdafx.h"
+#include "platform.h"
+#include "ledCompositor.h"
+
+void initLedCompositor(LedCompositor *compositor)
+{
+	int layer;
+
+	for (layer = 0; layer < ledLayerCount; layer++)
+		storeAtomic64(&compositor->layers[layer], 0);
+}
+
+BOOL setLedCompositorLayer(LedCompositor *compositor, enum LedLayer layer, byte mask, byte leds)
+{
+	if (layer <= ledStatusLayer || layer >= ledLayerCount)
+		return FALSE;
+
+	storeAtomic64(&compositor->layers[layer], ((long long) mask << LED_LAYER_MASK_SHIFT) | (leds & mask));
+	return TRUE;
+}
+
+BOOL hasLedCompositorOverlays(LedCompositor *compositor)
+{
+	int layer;
+
+	for (layer = ledStatusLayer + 1; layer < ledLayerCount; layer++)
+	{
+		if (loadAtomic64(&compositor->layers[layer]) != 0)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+byte composeLeds(LedCompositor *compositor, byte status)
+{
+	byte leds = status;
+	int layer;
+
+	for (layer = ledStatusLayer + 1; layer < ledLayerCount; layer++)
+	{
+		long long entry = loadAtomic64(&compositor->layers[layer]);
+		byte mask = (byte) (entry >> LED_LAYER_MASK_SHIFT);
+
+		leds = (byte) ((leds & ~mask) | ((byte) entry & mask));
+	}
+
+	return leds;
+}
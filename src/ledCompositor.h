@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * LED compositor functions header
+ * ledCompositor.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LEDCOMPOSITOR_H
+#define LEDCOMPOSITOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Layers of the LEDs of a device, from the lowest priority to the highest. Every subsystem owns
+// its layer : the status layer is the device state (the features sent and the buttons toggled by the user),
+// the notifications and the user override are set by the plugin, the animation layer by the LED animations.
+enum LedLayer {ledStatusLayer, ledNotificationLayer, ledAnimationLayer, ledOverrideLayer, ledLayerCount};
+
+// LEDs of a layer : the mask of the LEDs it shows above the value of these LEDs (bits 8-15 and 0-7)
+#define LED_LAYER_MASK_SHIFT 8
+
+// Layers shown over the status layer of a device, each in a single atomic entry : a layer is set
+// from any thread without lock, the owner of the LEDs composes them. A layer showing no LED
+// (mask 0) lets the ones below show through. The status layer, showing every LED, is not stored :
+// it is given to composeLeds.
+typedef struct LedCompositor
+{
+	volatile long long layers[ledLayerCount];
+} LedCompositor;
+
+/* Sets up a compositor showing the status layer only.
+ */
+void initLedCompositor(LedCompositor *compositor);
+
+/* Shows the LEDs of the mask on a layer above the status layer (button model registers),
+ * a mask of 0 clears the layer. Lock free, callable from any thread.
+ * Returns FALSE if the layer is the status layer or not valid.
+ */
+BOOL setLedCompositorLayer(LedCompositor *compositor, enum LedLayer layer, byte mask, byte leds);
+
+/* Determines whether a layer above the status layer shows LEDs.
+ */
+BOOL hasLedCompositorOverlays(LedCompositor *compositor);
+
+/* Composes the LEDs shown : the status layer, with the LEDs of every layer above it
+ * replacing the ones below from the lowest priority to the highest.
+ */
+byte composeLeds(LedCompositor *compositor, byte status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
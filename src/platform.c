@@ -0,0 +1,768 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Platform synchronization and timing functions
+ * platform.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _WIN32
+#define _GNU_SOURCE		// pthread_timedjoin_np
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include "stdafx.h"
+#include "platform.h"
+
+#ifdef _WIN32
+
+#include <malloc.h>		// _aligned_malloc
+
+struct PlatformEvent
+{
+	HANDLE handle;
+	BOOL owned;
+};
+
+PlatformEvent *createPlatformEvent(BOOL manualReset, BOOL initialState)
+{
+	PlatformEvent *event = (PlatformEvent *) allocatePlatformMemory(sizeof(PlatformEvent));
+
+	if (event == NULL)
+		return NULL;
+
+	event->handle = CreateEvent(NULL, manualReset, initialState, NULL);
+	event->owned = TRUE;
+	if (event->handle == NULL)
+	{
+		freePlatformMemory(event);
+		return NULL;
+	}
+
+	return event;
+}
+
+PlatformEvent *createPlatformEventFromHandle(HANDLE handle)
+{
+	PlatformEvent *event = (PlatformEvent *) allocatePlatformMemory(sizeof(PlatformEvent));
+
+	if (event == NULL)
+		return NULL;
+
+	event->handle = handle;
+	event->owned = FALSE;
+	return event;
+}
+
+void destroyPlatformEvent(PlatformEvent *event)
+{
+	if (event == NULL)
+		return;
+
+	if (event->owned)
+		CloseHandle(event->handle);
+	freePlatformMemory(event);
+}
+
+void setPlatformEvent(PlatformEvent *event)
+{
+	SetEvent(event->handle);
+}
+
+void resetPlatformEvent(PlatformEvent *event)
+{
+	ResetEvent(event->handle);
+}
+
+BOOL waitForPlatformEvent(PlatformEvent *event, DWORD timeoutMilliseconds)
+{
+	return WaitForSingleObject(event->handle, timeoutMilliseconds) == WAIT_OBJECT_0;
+}
+
+int waitForPlatformEvents(PlatformEvent **events, int eventCount, DWORD timeoutMilliseconds)
+{
+	HANDLE handles[PLATFORM_MAX_WAIT_EVENTS];
+	DWORD result;
+	int index;
+
+	for (index = 0; index < eventCount && index < PLATFORM_MAX_WAIT_EVENTS; index++)
+		handles[index] = events[index]->handle;
+
+	result = WaitForMultipleObjects(index, handles, FALSE, timeoutMilliseconds);
+	if (result >= WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + (DWORD) index)
+		return (int) (result - WAIT_OBJECT_0);
+
+	return -1;
+}
+
+HANDLE getPlatformEventHandle(PlatformEvent *event)
+{
+	return event->handle;
+}
+
+struct PlatformThread
+{
+	HANDLE handle;
+};
+
+PlatformThread *createPlatformThread(PlatformThreadRoutine routine, LPVOID argument)
+{
+	PlatformThread *thread = (PlatformThread *) allocatePlatformMemory(sizeof(PlatformThread));
+
+	if (thread == NULL)
+		return NULL;
+
+	thread->handle = CreateThread(NULL, 0, routine, argument, 0, NULL);
+	if (thread->handle == NULL)
+	{
+		freePlatformMemory(thread);
+		return NULL;
+	}
+
+	return thread;
+}
+
+BOOL joinPlatformThread(PlatformThread *thread, DWORD timeoutMilliseconds)
+{
+	BOOL exited;
+
+	if (thread == NULL)
+		return TRUE;
+
+	exited = WaitForSingleObject(thread->handle, timeoutMilliseconds) == WAIT_OBJECT_0;
+	CloseHandle(thread->handle);
+	freePlatformMemory(thread);
+
+	return exited;
+}
+
+unsigned long long getMonotonicTime(void)
+{
+	static LARGE_INTEGER frequency = { 0 };
+	LARGE_INTEGER counter;
+
+	if (frequency.QuadPart == 0)
+		QueryPerformanceFrequency(&frequency);
+
+	QueryPerformanceCounter(&counter);
+
+	// Split the conversion to avoid overflowing 64 bits with high frequency counters
+	return (unsigned long long) (counter.QuadPart / frequency.QuadPart) * 1000000000ULL
+		+ (unsigned long long) (counter.QuadPart % frequency.QuadPart) * 1000000000ULL / frequency.QuadPart;
+}
+
+long long addAtomic64(volatile long long *value, long long amount)
+{
+	return InterlockedExchangeAdd64(value, amount) + amount;
+}
+
+long long loadAtomic64(volatile long long *value)
+{
+	return InterlockedCompareExchange64(value, 0, 0);
+}
+
+void storeAtomic64(volatile long long *value, long long newValue)
+{
+	InterlockedExchange64(value, newValue);
+}
+
+long long exchangeAtomic64(volatile long long *value, long long newValue)
+{
+	return InterlockedExchange64(value, newValue);
+}
+
+BOOL compareExchangeAtomic64(volatile long long *value, long long expectedValue, long long newValue)
+{
+	return InterlockedCompareExchange64(value, newValue, expectedValue) == expectedValue;
+}
+
+void *exchangeAtomicPointer(void *volatile *pointer, void *newValue)
+{
+	return InterlockedExchangePointer(pointer, newValue);
+}
+
+BOOL compareExchangeAtomicPointer(void *volatile *pointer, void *expectedValue, void *newValue)
+{
+	return InterlockedCompareExchangePointer(pointer, newValue, expectedValue) == expectedValue;
+}
+
+void *loadAtomicPointer(void *volatile *pointer)
+{
+	return InterlockedCompareExchangePointer(pointer, NULL, NULL);
+}
+
+struct PlatformFileWatch
+{
+	HANDLE directory;
+	PlatformEvent *event;
+	OVERLAPPED overlapped;
+	DWORD buffer[1024];
+	BOOL pending;
+};
+
+// Queues the read of the next changes of the directory, the event is signaled once they come
+static BOOL watchDirectoryChanges(PlatformFileWatch *watch)
+{
+	ResetEvent(getPlatformEventHandle(watch->event));
+	memset(&watch->overlapped, 0, sizeof(watch->overlapped));
+	watch->overlapped.hEvent = getPlatformEventHandle(watch->event);
+	watch->pending = ReadDirectoryChangesW(watch->directory, watch->buffer, sizeof(watch->buffer), FALSE,
+		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE, NULL, &watch->overlapped, NULL);
+
+	return watch->pending;
+}
+
+PlatformFileWatch *createPlatformFileWatch(const char *directory)
+{
+	PlatformFileWatch *watch = (PlatformFileWatch *) allocatePlatformMemory(sizeof(PlatformFileWatch));
+
+	if (watch == NULL)
+		return NULL;
+
+	// Written in place, or replaced by a rename (editors saving a copy) or a deletion
+	watch->directory = CreateFileA(directory, FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+	if (watch->directory == INVALID_HANDLE_VALUE)
+	{
+		freePlatformMemory(watch);
+		return NULL;
+	}
+
+	watch->event = createPlatformEvent(TRUE, FALSE);
+	if (watch->event == NULL || !watchDirectoryChanges(watch))
+	{
+		destroyPlatformEvent(watch->event);
+		CloseHandle(watch->directory);
+		freePlatformMemory(watch);
+		return NULL;
+	}
+
+	return watch;
+}
+
+void destroyPlatformFileWatch(PlatformFileWatch *watch)
+{
+	DWORD length;
+
+	if (watch == NULL)
+		return;
+
+	// The read queued writes to the watch until it is cancelled
+	if (watch->pending && CancelIoEx(watch->directory, &watch->overlapped))
+		GetOverlappedResult(watch->directory, &watch->overlapped, &length, TRUE);
+	CloseHandle(watch->directory);
+	destroyPlatformEvent(watch->event);
+	freePlatformMemory(watch);
+}
+
+PlatformEvent *getPlatformFileWatchEvent(PlatformFileWatch *watch)
+{
+	return watch->event;
+}
+
+BOOL readPlatformFileWatch(PlatformFileWatch *watch, const char *fileName)
+{
+	WCHAR name[MAX_PATH];
+	DWORD length = 0;
+	BOOL changed;
+	int nameLength = MultiByteToWideChar(CP_ACP, 0, fileName, -1, name, MAX_PATH) - 1;
+
+	if (!watch->pending || !GetOverlappedResult(watch->directory, &watch->overlapped, &length, FALSE))
+	{
+		// Not completed yet, or failed : read again
+		if (watch->pending && GetLastError() == ERROR_IO_INCOMPLETE)
+			return FALSE;
+		watchDirectoryChanges(watch);
+		return FALSE;
+	}
+
+	// No record : more changes than the buffer holds, the file may be one of them
+	changed = length == 0;
+	if (length != 0)
+	{
+		const BYTE *record = (const BYTE *) watch->buffer;
+
+		for (;;)
+		{
+			const FILE_NOTIFY_INFORMATION *information = (const FILE_NOTIFY_INFORMATION *) record;
+
+			// File names are case insensitive, and not zero terminated in the record
+			changed |= nameLength > 0 && information->FileNameLength == (DWORD) nameLength * sizeof(WCHAR)
+				&& CompareStringOrdinal(information->FileName, nameLength, name, nameLength, TRUE) == CSTR_EQUAL;
+			if (information->NextEntryOffset == 0)
+				break;
+			record += information->NextEntryOffset;
+		}
+	}
+
+	watchDirectoryChanges(watch);
+	return changed;
+}
+
+BOOL openPlatformUrl(const char *url)
+{
+	return (INT_PTR) ShellExecute(NULL, "open", url, NULL, NULL, SW_SHOWDEFAULT) > 32;
+}
+
+#else
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/wait.h>
+
+struct PlatformEvent
+{
+	int descriptor;
+	BOOL manualReset;
+	BOOL owned;
+};
+
+PlatformEvent *createPlatformEvent(BOOL manualReset, BOOL initialState)
+{
+	PlatformEvent *event = (PlatformEvent *) allocatePlatformMemory(sizeof(PlatformEvent));
+
+	if (event == NULL)
+		return NULL;
+
+	// The eventfd counter is the signaled state, reading it resets the event
+	event->descriptor = eventfd(initialState ? 1 : 0, EFD_CLOEXEC | EFD_NONBLOCK);
+	event->manualReset = manualReset;
+	event->owned = TRUE;
+	if (event->descriptor < 0)
+	{
+		freePlatformMemory(event);
+		return NULL;
+	}
+
+	return event;
+}
+
+PlatformEvent *createPlatformEventFromDescriptor(int descriptor)
+{
+	PlatformEvent *event = (PlatformEvent *) allocatePlatformMemory(sizeof(PlatformEvent));
+
+	if (event == NULL)
+		return NULL;
+
+	// Signaled as long as the descriptor is readable, like a manual reset event
+	event->descriptor = descriptor;
+	event->manualReset = TRUE;
+	event->owned = FALSE;
+	return event;
+}
+
+void destroyPlatformEvent(PlatformEvent *event)
+{
+	if (event == NULL)
+		return;
+
+	if (event->owned)
+		close(event->descriptor);
+	freePlatformMemory(event);
+}
+
+void setPlatformEvent(PlatformEvent *event)
+{
+	uint64_t one = 1;
+
+	// Only fails with EAGAIN when the counter would overflow, the event is signaled anyway
+	if (write(event->descriptor, &one, sizeof(one)) < 0)
+		return;
+}
+
+void resetPlatformEvent(PlatformEvent *event)
+{
+	uint64_t counter;
+
+	// Non blocking descriptor, fails with EAGAIN when already reset
+	if (read(event->descriptor, &counter, sizeof(counter)) < 0)
+		return;
+}
+
+BOOL waitForPlatformEvent(PlatformEvent *event, DWORD timeoutMilliseconds)
+{
+	return waitForPlatformEvents(&event, 1, timeoutMilliseconds) == 0;
+}
+
+int waitForPlatformEvents(PlatformEvent **events, int eventCount, DWORD timeoutMilliseconds)
+{
+	struct pollfd pollDescriptors[PLATFORM_MAX_WAIT_EVENTS];
+	unsigned long long deadline = 0;
+	uint64_t counter;
+	int timeout = -1;
+	int index;
+
+	if (eventCount > PLATFORM_MAX_WAIT_EVENTS)
+		eventCount = PLATFORM_MAX_WAIT_EVENTS;
+
+	if (timeoutMilliseconds != PLATFORM_WAIT_INFINITE)
+		deadline = getMonotonicTime() + (unsigned long long) timeoutMilliseconds * 1000000ULL;
+
+	for (index = 0; index < eventCount; index++)
+	{
+		pollDescriptors[index].fd = events[index]->descriptor;
+		pollDescriptors[index].events = POLLIN;
+	}
+
+	for (;;)
+	{
+		if (timeoutMilliseconds != PLATFORM_WAIT_INFINITE)
+		{
+			unsigned long long now = getMonotonicTime();
+			timeout = now >= deadline ? 0 : (int) ((deadline - now + 999999ULL) / 1000000ULL);
+		}
+
+		if (poll(pollDescriptors, (nfds_t) eventCount, timeout) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+
+		for (index = 0; index < eventCount; index++)
+		{
+			// A descriptor in error (e.g. a device unplugged) is signaled for good
+			if (!(pollDescriptors[index].revents & (POLLIN | POLLERR | POLLHUP | POLLNVAL)))
+				continue;
+
+			if (events[index]->manualReset)
+				return index;
+
+			// Auto reset : only the waiter which consumes the counter is released
+			if (read(events[index]->descriptor, &counter, sizeof(counter)) == sizeof(counter))
+				return index;
+		}
+
+		if (timeout == 0)
+			return -1;
+	}
+}
+
+int getPlatformEventDescriptor(PlatformEvent *event)
+{
+	return event->descriptor;
+}
+
+struct PlatformThread
+{
+	pthread_t handle;
+};
+
+// Start parameters of a thread, released by the thread itself
+typedef struct PlatformThreadStart
+{
+	PlatformThreadRoutine routine;
+	LPVOID argument;
+} PlatformThreadStart;
+
+static void *runPlatformThread(void *argument)
+{
+	PlatformThreadStart start = *(PlatformThreadStart *) argument;
+
+	freePlatformMemory(argument);
+	start.routine(start.argument);
+	return NULL;
+}
+
+PlatformThread *createPlatformThread(PlatformThreadRoutine routine, LPVOID argument)
+{
+	PlatformThread *thread = (PlatformThread *) allocatePlatformMemory(sizeof(PlatformThread));
+	PlatformThreadStart *start = (PlatformThreadStart *) allocatePlatformMemory(sizeof(PlatformThreadStart));
+
+	if (thread == NULL || start == NULL)
+	{
+		freePlatformMemory(thread);
+		freePlatformMemory(start);
+		return NULL;
+	}
+
+	start->routine = routine;
+	start->argument = argument;
+	if (pthread_create(&thread->handle, NULL, runPlatformThread, start) != 0)
+	{
+		freePlatformMemory(thread);
+		freePlatformMemory(start);
+		return NULL;
+	}
+
+	return thread;
+}
+
+BOOL joinPlatformThread(PlatformThread *thread, DWORD timeoutMilliseconds)
+{
+	struct timespec deadline;
+	BOOL exited;
+
+	if (thread == NULL)
+		return TRUE;
+
+	if (timeoutMilliseconds == PLATFORM_WAIT_INFINITE)
+		exited = pthread_join(thread->handle, NULL) == 0;
+	else
+	{
+		// Timed joins use the realtime clock
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += timeoutMilliseconds / 1000;
+		deadline.tv_nsec += (long) (timeoutMilliseconds % 1000) * 1000000L;
+		if (deadline.tv_nsec >= 1000000000L)
+		{
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+
+		exited = pthread_timedjoin_np(thread->handle, NULL, &deadline) == 0;
+		if (!exited)
+			pthread_detach(thread->handle);
+	}
+
+	freePlatformMemory(thread);
+	return exited;
+}
+
+unsigned long long getMonotonicTime(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long) now.tv_sec * 1000000000ULL + (unsigned long long) now.tv_nsec;
+}
+
+long long addAtomic64(volatile long long *value, long long amount)
+{
+	return __atomic_add_fetch(value, amount, __ATOMIC_SEQ_CST);
+}
+
+long long loadAtomic64(volatile long long *value)
+{
+	return __atomic_load_n(value, __ATOMIC_SEQ_CST);
+}
+
+void storeAtomic64(volatile long long *value, long long newValue)
+{
+	__atomic_store_n(value, newValue, __ATOMIC_SEQ_CST);
+}
+
+long long exchangeAtomic64(volatile long long *value, long long newValue)
+{
+	return __atomic_exchange_n(value, newValue, __ATOMIC_SEQ_CST);
+}
+
+BOOL compareExchangeAtomic64(volatile long long *value, long long expectedValue, long long newValue)
+{
+	return __atomic_compare_exchange_n(value, &expectedValue, newValue, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+void *exchangeAtomicPointer(void *volatile *pointer, void *newValue)
+{
+	return __atomic_exchange_n(pointer, newValue, __ATOMIC_SEQ_CST);
+}
+
+BOOL compareExchangeAtomicPointer(void *volatile *pointer, void *expectedValue, void *newValue)
+{
+	return __atomic_compare_exchange_n(pointer, &expectedValue, newValue, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+void *loadAtomicPointer(void *volatile *pointer)
+{
+	return __atomic_load_n(pointer, __ATOMIC_SEQ_CST);
+}
+
+struct PlatformFileWatch
+{
+	int descriptor;
+	PlatformEvent *event;
+};
+
+PlatformFileWatch *createPlatformFileWatch(const char *directory)
+{
+	PlatformFileWatch *watch = (PlatformFileWatch *) allocatePlatformMemory(sizeof(PlatformFileWatch));
+
+	if (watch == NULL)
+		return NULL;
+
+	// Written in place, or replaced by a rename (editors saving a copy) or a deletion
+	watch->descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (watch->descriptor < 0)
+	{
+		freePlatformMemory(watch);
+		return NULL;
+	}
+
+	watch->event = createPlatformEventFromDescriptor(watch->descriptor);
+	if (inotify_add_watch(watch->descriptor, directory, IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) < 0
+		|| watch->event == NULL)
+	{
+		destroyPlatformEvent(watch->event);
+		close(watch->descriptor);
+		freePlatformMemory(watch);
+		return NULL;
+	}
+
+	return watch;
+}
+
+void destroyPlatformFileWatch(PlatformFileWatch *watch)
+{
+	if (watch == NULL)
+		return;
+
+	destroyPlatformEvent(watch->event);
+	close(watch->descriptor);
+	freePlatformMemory(watch);
+}
+
+PlatformEvent *getPlatformFileWatchEvent(PlatformFileWatch *watch)
+{
+	return watch->event;
+}
+
+BOOL readPlatformFileWatch(PlatformFileWatch *watch, const char *fileName)
+{
+	char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+	BOOL changed = FALSE;
+	ssize_t length;
+
+	// Non blocking descriptor, drained until EAGAIN
+	while ((length = read(watch->descriptor, buffer, sizeof(buffer))) > 0)
+	{
+		ssize_t offset = 0;
+
+		while (offset < length)
+		{
+			const struct inotify_event *event = (const struct inotify_event *) (buffer + offset);
+
+			changed |= event->len != 0 && strcmp(event->name, fileName) == 0;
+			offset += (ssize_t) (sizeof(struct inotify_event) + event->len);
+		}
+	}
+
+	return changed;
+}
+
+BOOL openPlatformUrl(const char *url)
+{
+	// No shell, the url is passed as is. The intermediate child exits at once
+	// so that xdg-open is not left a zombie of the client when it exits.
+	pid_t child = fork();
+
+	if (child == 0)
+	{
+		if (fork() == 0)
+			execlp("xdg-open", "xdg-open", url, (char *) NULL);
+		_exit(0);
+	}
+	if (child < 0)
+		return FALSE;
+
+	while (waitpid(child, NULL, 0) < 0 && errno == EINTR)
+		;
+	return TRUE;
+}
+
+#endif
+
+// Memory blocks allocated since the start, only counted in debug builds
+static volatile long long allocationCount = 0;
+
+#if defined(_DEBUG) && defined(_WIN32)
+
+#include <crtdbg.h>
+
+// Counts the blocks of the C runtime, installed by the first getPlatformAllocationCount
+static int __cdecl countCrtAllocation(int allocationType, void *userData, size_t size, int blockType,
+	long requestNumber, const unsigned char *fileName, int lineNumber)
+{
+	if (allocationType == _HOOK_ALLOC || allocationType == _HOOK_REALLOC)
+		addAtomic64(&allocationCount, 1);
+	return TRUE;
+}
+
+static volatile long long crtAllocationHooked = 0;
+
+#elif defined(_DEBUG) && defined(__GLIBC__)
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *memory, size_t size);
+
+// The allocator of the C library, interposed to count its blocks too.
+// Only the plugin calls these (hidden symbols), the tools and tests count the whole process.
+void *malloc(size_t size)
+{
+	addAtomic64(&allocationCount, 1);
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+	addAtomic64(&allocationCount, 1);
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *memory, size_t size)
+{
+	addAtomic64(&allocationCount, 1);
+	return __libc_realloc(memory, size);
+}
+
+#endif
+
+void *allocatePlatformMemory(size_t size)
+{
+	void *memory;
+
+	// Seen by the C runtime hook on Windows
+#if defined(_DEBUG) && !defined(_WIN32)
+	addAtomic64(&allocationCount, 1);
+#endif
+#ifdef _WIN32
+	memory = _aligned_malloc(size, PLATFORM_CACHE_LINE_SIZE);
+#else
+	if (posix_memalign(&memory, PLATFORM_CACHE_LINE_SIZE, size) != 0)
+		memory = NULL;
+#endif
+	if (memory != NULL)
+		memset(memory, 0, size);
+
+	return memory;
+}
+
+void freePlatformMemory(void *memory)
+{
+#ifdef _WIN32
+	_aligned_free(memory);
+#else
+	free(memory);
+#endif
+}
+
+long long getPlatformAllocationCount(void)
+{
+#if defined(_DEBUG) && defined(_WIN32)
+	if (exchangeAtomic64(&crtAllocationHooked, 1) == 0)
+		_CrtSetAllocHook(countCrtAllocation);
+#endif
+	return loadAtomic64(&allocationCount);
+}
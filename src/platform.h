@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Platform synchronization and timing functions header
+ * platform.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Timeout value to wait for an event without time limit
+#define PLATFORM_WAIT_INFINITE ((DWORD)0xFFFFFFFF)
+
+// Size of a processor cache line
+#define PLATFORM_CACHE_LINE_SIZE 64
+
+// Aligns a variable or a structure member on a cache line, e.g. to keep data written
+// by different threads on separate lines (allocatePlatformMemory honors it)
+#ifdef _WIN32
+#define PLATFORM_CACHE_ALIGNED __declspec(align(PLATFORM_CACHE_LINE_SIZE))
+#else
+#define PLATFORM_CACHE_ALIGNED __attribute__((aligned(PLATFORM_CACHE_LINE_SIZE)))
+#endif
+
+// Event a thread can block on until another thread signals it.
+// Backed by an event handle on Windows and an eventfd on Linux.
+typedef struct PlatformEvent PlatformEvent;
+
+/* Creates an event.
+ * A manual reset event stays signaled until it is reset, an auto reset event
+ * is reset as soon as a single waiting thread has been released.
+ */
+PlatformEvent *createPlatformEvent(BOOL manualReset, BOOL initialState);
+
+/* Destroys an event created with createPlatformEvent.
+ */
+void destroyPlatformEvent(PlatformEvent *event);
+
+/* Signals the event, releasing the waiting thread(s).
+ */
+void setPlatformEvent(PlatformEvent *event);
+
+/* Resets the event to the non signaled state.
+ */
+void resetPlatformEvent(PlatformEvent *event);
+
+/* Waits for the event to be signaled.
+ * Returns TRUE if the event has been signaled, FALSE on timeout.
+ */
+BOOL waitForPlatformEvent(PlatformEvent *event, DWORD timeoutMilliseconds);
+
+// Maximum number of events waitForPlatformEvents can wait for (MAXIMUM_WAIT_OBJECTS on Windows)
+#define PLATFORM_MAX_WAIT_EVENTS 64
+
+/* Waits for any of the events to be signaled.
+ * Returns the index of the signaled event (the lowest one if several are), -1 on timeout.
+ */
+int waitForPlatformEvents(PlatformEvent **events, int eventCount, DWORD timeoutMilliseconds);
+
+#ifdef _WIN32
+/* Gets the event handle, to wait for the event along with other kernel objects.
+ */
+HANDLE getPlatformEventHandle(PlatformEvent *event);
+
+/* Creates an event signaled while the specified kernel object is, e.g. the event of an overlapped IO,
+ * to wait for the object along with other events. The object is not closed by destroyPlatformEvent
+ * and the event must not be set nor reset.
+ */
+PlatformEvent *createPlatformEventFromHandle(HANDLE handle);
+#else
+/* Gets the event descriptor, readable while the event is signaled, to poll the event
+ * along with other descriptors. Polling does not reset an auto reset event.
+ */
+int getPlatformEventDescriptor(PlatformEvent *event);
+
+/* Creates an event signaled while the specified descriptor is readable (or in error), e.g. a device,
+ * to wait for the descriptor along with other events. The descriptor is not closed by
+ * destroyPlatformEvent and the event must not be set nor reset.
+ */
+PlatformEvent *createPlatformEventFromDescriptor(int descriptor);
+#endif
+
+// Thread running a routine with the Windows thread signature
+typedef struct PlatformThread PlatformThread;
+typedef DWORD (WINAPI *PlatformThreadRoutine)(LPVOID argument);
+
+/* Creates and starts a thread running the specified routine.
+ * Returns NULL if the thread cannot be created.
+ */
+PlatformThread *createPlatformThread(PlatformThreadRoutine routine, LPVOID argument);
+
+/* Waits for the thread to exit and releases it.
+ * A thread that does not exit in time is left running on its own.
+ * Returns TRUE if the thread exited.
+ */
+BOOL joinPlatformThread(PlatformThread *thread, DWORD timeoutMilliseconds);
+
+/* Gets a monotonic timestamp in nanoseconds, only meaningful when compared to another one.
+ */
+unsigned long long getMonotonicTime(void);
+
+/* Atomically increments a 64 bits counter by the specified amount and returns the new value.
+ */
+long long addAtomic64(volatile long long *value, long long amount);
+
+/* Atomically reads a 64 bits counter.
+ */
+long long loadAtomic64(volatile long long *value);
+
+/* Atomically sets a 64 bits counter.
+ */
+void storeAtomic64(volatile long long *value, long long newValue);
+
+/* Atomically sets a 64 bits counter and returns its previous value.
+ */
+long long exchangeAtomic64(volatile long long *value, long long newValue);
+
+/* Atomically sets a 64 bits counter if it holds the expected value.
+ * Returns TRUE if the counter has been set.
+ */
+BOOL compareExchangeAtomic64(volatile long long *value, long long expectedValue, long long newValue);
+
+/* Atomically sets a pointer and returns its previous value.
+ */
+void *exchangeAtomicPointer(void *volatile *pointer, void *newValue);
+
+/* Atomically sets a pointer if it holds the expected value.
+ * Returns TRUE if the pointer has been set.
+ */
+BOOL compareExchangeAtomicPointer(void *volatile *pointer, void *expectedValue, void *newValue);
+
+/* Atomically reads a pointer.
+ */
+void *loadAtomicPointer(void *volatile *pointer);
+
+// Watch of the files of a directory : its event is signaled when one of them is written,
+// created, renamed or deleted. Backed by ReadDirectoryChangesW on Windows and inotify on Linux.
+typedef struct PlatformFileWatch PlatformFileWatch;
+
+/* Starts watching the files of a directory.
+ * Returns NULL if the directory cannot be watched.
+ */
+PlatformFileWatch *createPlatformFileWatch(const char *directory);
+
+/* Stops watching and releases the watch, its event included.
+ */
+void destroyPlatformFileWatch(PlatformFileWatch *watch);
+
+/* Gets the event signaled on a change, until readPlatformFileWatch.
+ */
+PlatformEvent *getPlatformFileWatchEvent(PlatformFileWatch *watch);
+
+/* Acknowledges the changes signaled so far, the event is signaled again on the next one.
+ * Returns TRUE if the specified file (name in the directory) changed, or may have : on Windows,
+ * when more changes came than could be recorded.
+ */
+BOOL readPlatformFileWatch(PlatformFileWatch *watch, const char *fileName);
+
+/* Opens an url in the default web browser, without waiting for it.
+ * Returns FALSE if the opener (ShellExecute, xdg-open) cannot be launched.
+ */
+BOOL openPlatformUrl(const char *url);
+
+/* Allocates a zeroed memory block aligned on a cache line, freed with freePlatformMemory.
+ * Returns NULL if the memory cannot be allocated.
+ */
+void *allocatePlatformMemory(size_t size);
+
+/* Frees a memory block allocated with allocatePlatformMemory.
+ */
+void freePlatformMemory(void *memory);
+
+/* Gets the number of memory blocks allocated since the start : with allocatePlatformMemory and with
+ * the allocator of the C library (malloc, calloc and realloc ; on Windows, from the first call on).
+ * Only counted in debug builds (always 0 otherwise), to check a code path does not allocate.
+ */
+long long getPlatformAllocationCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Plugin configuration file functions
+ * pluginConfig.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "stdafx.h"
+#include "buttonDebouncer.h"
+#include "platform.h"
+#include "pluginConfig.h"
+#include "statistics.h"
+
+// Configurations : the one published, the one still read by the reader thread, and the one parsed into
+#define CONFIG_SLOTS 3
+
+// Longest configuration file path
+#define CONFIG_PATH_SIZE 1024
+
+static GameVoiceConfig configSlots[CONFIG_SLOTS];
+
+// Configuration published, and the one the reader thread pinned (hazard pointer) : a configuration
+// is only parsed into again once neither published nor pinned
+static void *volatile publishedConfig = NULL;
+static void *volatile pinnedConfig = NULL;
+
+// Generation of the last configuration published, by the reload thread (or startConfig before it)
+static unsigned long long configGeneration = 0;
+
+static char configPath[CONFIG_PATH_SIZE];
+static ConfigLogCallback configLog = NULL;
+
+// Text of the file read, and of the last one parsed : the changes of the other files
+// of the directory (Windows) or a file saved unchanged don't reload the configuration
+static char configText[CONFIG_FILE_MAX_SIZE + 1];
+static char loadedText[CONFIG_FILE_MAX_SIZE + 1];
+
+static PlatformFileWatch *configWatch = NULL;
+static PlatformEvent *configStopEvent = NULL;
+static PlatformThread *configThreadHandle = NULL;
+
+static void logConfig(const char *message, BOOL warning)
+{
+	OutputDebugString(message);
+	if (configLog != NULL)
+		configLog(message, warning);
+}
+
+static void setDefaultConfig(GameVoiceConfig *config)
+{
+	int button;
+
+	memset(config, 0, sizeof(GameVoiceConfig));
+
+	// The SideWinder Game Voice
+	config->supportedDevices[0].vid = 0x045E;
+	config->supportedDevices[0].pid = 0x003B;
+
+	for (button = 0; button < BUTTON_TRANSITIONS_MAX; button++)
+		config->debounceWindows[button] = DEFAULT_DEBOUNCE_WINDOW * 1000000ULL;
+
+	config->gestureTimings.holdTime = DEFAULT_HOLD_TIME * 1000000ULL;
+	config->gestureTimings.doubleTapTime = DEFAULT_DOUBLE_TAP_TIME * 1000000ULL;
+	config->gestureTimings.chordTime = DEFAULT_CHORD_TIME * 1000000ULL;
+
+	parseButtonBindings(DEFAULT_BUTTON_BINDINGS, &config->bindings);
+}
+
+// The environment variables set override the file, the invalid ones are ignored
+static void applyEnvironment(GameVoiceConfig *config)
+{
+	const char *setting;
+
+	if ((setting = getenv(DEBOUNCE_VARIABLE)) != NULL)
+		parseDebounceWindows(setting, config->debounceWindows);
+	if ((setting = getenv(GESTURES_VARIABLE)) != NULL)
+		parseGestureTimings(setting, &config->gestureTimings);
+	if ((setting = getenv(BINDINGS_VARIABLE)) != NULL)
+		parseButtonBindings(setting, &config->bindings);
+}
+
+void initDefaultConfig(GameVoiceConfig *config)
+{
+	setDefaultConfig(config);
+	applyEnvironment(config);
+}
+
+// Parses the USB VID and PID of the devices (hexadecimal), separated by commas : 045e:003b, 1234:5678
+static BOOL parseDevices(const char *setting, UsbDeviceId *deviceIds)
+{
+	UsbDeviceId parsed[USB_HID_MAX_DEVICE_IDS + 1];
+	const char *cursor = setting;
+	char *end;
+	int count = 0;
+
+	do
+	{
+		long vid = strtol(cursor, &end, 16), pid;
+
+		if (end == cursor || *end != ':' || vid <= 0 || vid > 0xFFFF || count == USB_HID_MAX_DEVICE_IDS)
+			return FALSE;
+
+		cursor = end + 1;
+		pid = strtol(cursor, &end, 16);
+		if (end == cursor || pid < 0 || pid > 0xFFFF)
+			return FALSE;
+
+		parsed[count].vid = (int) vid;
+		parsed[count++].pid = (int) pid;
+
+		while (*end == ' ' || *end == '\t')
+			end++;
+		cursor = end + 1;
+	} while (*end == ',');
+
+	if (*end != '\0')
+		return FALSE;
+
+	parsed[count].vid = 0;
+	parsed[count].pid = 0;
+	memcpy(deviceIds, parsed, (count + 1) * sizeof(UsbDeviceId));
+	return TRUE;
+}
+
+static BOOL isBlank(char character)
+{
+	return character == ' ' || character == '\t' || character == '\r';
+}
+
+BOOL parseConfig(const char *text, GameVoiceConfig *config, char *error, size_t errorSize)
+{
+	// Bindings of every bind line, one per line
+	char bindings[CONFIG_FILE_MAX_SIZE + 1];
+	char value[CONFIG_VALUE_SIZE];
+	size_t bindingsLength = 0;
+	const char *cursor = text;
+	int lineNumber = 0;
+
+	setDefaultConfig(config);
+	bindings[0] = '\0';
+
+	while (*cursor != '\0')
+	{
+		const char *end = cursor + strcspn(cursor, "\n");
+		const char *key = cursor, *keyEnd, *equals, *lineEnd = end;
+		size_t keyLength, valueLength;
+		BOOL valid;
+
+		lineNumber++;
+		cursor = *end == '\0' ? end : end + 1;
+
+		while (key < lineEnd && isBlank(*key))
+			key++;
+		while (lineEnd > key && isBlank(lineEnd[-1]))
+			lineEnd--;
+		if (key == lineEnd || *key == '#')
+			continue;
+
+		equals = (const char *) memchr(key, '=', (size_t) (lineEnd - key));
+		if (equals == NULL)
+		{
+			snprintf(error, errorSize, "line %d: <setting> = <value> expected", lineNumber);
+			return FALSE;
+		}
+
+		for (keyEnd = equals; keyEnd > key && isBlank(keyEnd[-1]); keyEnd--)
+			;
+		for (equals++; equals < lineEnd && isBlank(*equals); equals++)
+			;
+		keyLength = (size_t) (keyEnd - key);
+		valueLength = (size_t) (lineEnd - equals);
+		if (valueLength >= CONFIG_VALUE_SIZE)
+		{
+			snprintf(error, errorSize, "line %d: value too long", lineNumber);
+			return FALSE;
+		}
+
+		memcpy(value, equals, valueLength);
+		value[valueLength] = '\0';
+
+		if (keyLength == 7 && strncmp(key, "devices", 7) == 0)
+			valid = parseDevices(value, config->supportedDevices);
+		else if (keyLength == 8 && strncmp(key, "debounce", 8) == 0)
+			valid = parseDebounceWindows(value, config->debounceWindows);
+		else if (keyLength == 8 && strncmp(key, "gestures", 8) == 0)
+			valid = parseGestureTimings(value, &config->gestureTimings);
+		else if (keyLength == 4 && strncmp(key, "bind", 4) == 0)
+		{
+			// Checked alone for the line of the error, compiled with the others at the end
+			valid = parseButtonBindings(value, &config->bindings);
+			memcpy(bindings + bindingsLength, value, valueLength);
+			bindingsLength += valueLength;
+			bindings[bindingsLength++] = '\n';
+			bindings[bindingsLength] = '\0';
+		}
+		else
+		{
+			snprintf(error, errorSize, "line %d: unknown setting %.*s", lineNumber, (int) keyLength, key);
+			return FALSE;
+		}
+
+		if (!valid)
+		{
+			snprintf(error, errorSize, "line %d: invalid %.*s", lineNumber, (int) keyLength, key);
+			return FALSE;
+		}
+	}
+
+	// No bind line leaves the default bindings
+	if (bindingsLength == 0)
+		parseButtonBindings(DEFAULT_BUTTON_BINDINGS, &config->bindings);
+	else if (!parseButtonBindings(bindings, &config->bindings))
+	{
+		snprintf(error, errorSize, "more than %d bindings or %d actions", BUTTON_BINDINGS_MAX, BUTTON_ACTIONS_MAX);
+		return FALSE;
+	}
+
+	applyEnvironment(config);
+	return TRUE;
+}
+
+// Gets a configuration neither published nor pinned by the reader thread, to parse into : the last one
+// when the others are. The reader only pins the one published, checked again once pinned :
+// a configuration pinned after this check is no longer published and is not read.
+static GameVoiceConfig *getFreeConfig(void)
+{
+	void *published = loadAtomicPointer(&publishedConfig);
+	void *pinned = loadAtomicPointer(&pinnedConfig);
+	int slot;
+
+	for (slot = 0; slot < CONFIG_SLOTS - 1; slot++)
+	{
+		if (&configSlots[slot] != published && &configSlots[slot] != pinned)
+			break;
+	}
+
+	return &configSlots[slot];
+}
+
+static void publishConfig(GameVoiceConfig *config)
+{
+	config->generation = ++configGeneration;
+	exchangeAtomicPointer(&publishedConfig, config);
+}
+
+// Reads the configuration file into configText, an empty text if there is none.
+// Returns FALSE if the file is too large.
+static BOOL readConfigFile(void)
+{
+	FILE *file = fopen(configPath, "rb");
+	size_t length;
+
+	configText[0] = '\0';
+	if (file == NULL)
+		return TRUE;
+
+	length = fread(configText, 1, CONFIG_FILE_MAX_SIZE + 1, file);
+	fclose(file);
+	if (length > CONFIG_FILE_MAX_SIZE)
+	{
+		configText[0] = '\0';
+		return FALSE;
+	}
+
+	configText[length] = '\0';
+	return TRUE;
+}
+
+// Reads, validates and publishes the configuration file if it changed. An invalid file is rejected,
+// the configuration published is kept : the defaults for the initial load.
+static BOOL loadConfig(BOOL initial)
+{
+	char error[CONFIG_MESSAGE_SIZE];
+	char message[CONFIG_PATH_SIZE + 2 * CONFIG_MESSAGE_SIZE];
+	const GameVoiceConfig *previous = (const GameVoiceConfig *) loadAtomicPointer(&publishedConfig);
+	GameVoiceConfig *config = NULL;
+	BOOL valid;
+
+	if (!readConfigFile())
+	{
+		snprintf(error, sizeof(error), "larger than %d bytes", CONFIG_FILE_MAX_SIZE);
+		valid = FALSE;
+	}
+	else
+	{
+		if (!initial && strcmp(configText, loadedText) == 0)
+			return TRUE;
+
+		config = getFreeConfig();
+		valid = parseConfig(configText, config, error, sizeof(error));
+	}
+	memcpy(loadedText, configText, sizeof(loadedText));
+
+	if (!valid)
+	{
+		incrementStatistic(STATISTIC_CONFIG_REJECTED);
+		snprintf(message, sizeof(message), "%s: %s, the %s configuration is used", configPath, error, initial ? "default" : "previous");
+		logConfig(message, TRUE);
+		if (!initial)
+			return FALSE;
+
+		config = getFreeConfig();
+		initDefaultConfig(config);
+	}
+	else if (previous != NULL && memcmp(previous->supportedDevices, config->supportedDevices, sizeof(config->supportedDevices)) != 0)
+	{
+		logConfig("The devices of the configuration are only attached on the next start of the plugin", TRUE);
+	}
+
+	publishConfig(config);
+	if (valid && !initial)
+		incrementStatistic(STATISTIC_CONFIG_RELOADS);
+	if (valid && (!initial || configText[0] != '\0'))
+	{
+		// A missing (or removed) file is an empty one : the defaults
+		snprintf(message, sizeof(message), "%s %s", configPath, configText[0] != '\0' ? (initial ? "loaded" : "reloaded") : "removed or empty, the default configuration is used");
+		logConfig(message, FALSE);
+	}
+
+	return valid;
+}
+
+// Reloads the configuration file on its changes, once the file is left alone for CONFIG_RELOAD_DELAY
+static DWORD WINAPI configReloadThread(LPVOID pData)
+{
+	PlatformEvent *events[2];
+
+	events[0] = configStopEvent;
+	events[1] = getPlatformFileWatchEvent(configWatch);
+	while (waitForPlatformEvents(events, 2, PLATFORM_WAIT_INFINITE) == 1)
+	{
+		if (!readPlatformFileWatch(configWatch, CONFIG_FILE_NAME))
+			continue;
+
+		do
+		{
+			if (waitForPlatformEvent(configStopEvent, CONFIG_RELOAD_DELAY))
+				return 0;
+		} while (waitForPlatformEvent(events[1], 0) && readPlatformFileWatch(configWatch, CONFIG_FILE_NAME));
+
+		loadConfig(FALSE);
+	}
+
+	return 0;
+}
+
+BOOL startConfig(const char *directory, ConfigLogCallback log)
+{
+	GameVoiceConfig environment;
+	size_t length;
+	BOOL valid;
+
+	// The environment variables are only checked here, the slots belong to the publication
+	configLog = log;
+	setDefaultConfig(&environment);
+	if (getenv(DEBOUNCE_VARIABLE) != NULL && !parseDebounceWindows(getenv(DEBOUNCE_VARIABLE), environment.debounceWindows))
+		logConfig("Invalid debounce windows in " DEBOUNCE_VARIABLE ", ignored", TRUE);
+	if (getenv(GESTURES_VARIABLE) != NULL && !parseGestureTimings(getenv(GESTURES_VARIABLE), &environment.gestureTimings))
+		logConfig("Invalid gesture timings in " GESTURES_VARIABLE ", ignored", TRUE);
+	if (getenv(BINDINGS_VARIABLE) != NULL && !parseButtonBindings(getenv(BINDINGS_VARIABLE), &environment.bindings))
+		logConfig("Invalid button bindings in " BINDINGS_VARIABLE ", ignored", TRUE);
+
+	if (directory == NULL || directory[0] == '\0')
+	{
+		initDefaultConfig(&configSlots[0]);
+		publishConfig(&configSlots[0]);
+		return TRUE;
+	}
+
+	length = strlen(directory);
+	snprintf(configPath, sizeof(configPath), "%s%s%s", directory,
+		directory[length - 1] == '/' || directory[length - 1] == '\\' ? "" : "/", CONFIG_FILE_NAME);
+	valid = loadConfig(TRUE);
+
+	configWatch = createPlatformFileWatch(directory);
+	configStopEvent = createPlatformEvent(TRUE, FALSE);
+	if (configWatch != NULL && configStopEvent != NULL)
+		configThreadHandle = createPlatformThread(configReloadThread, NULL);
+
+	if (configThreadHandle == NULL)
+		logConfig("The configuration file won't be reloaded on its changes", TRUE);
+
+	return valid;
+}
+
+void stopConfig(void)
+{
+	if (configThreadHandle != NULL)
+	{
+		setPlatformEvent(configStopEvent);
+		joinPlatformThread(configThreadHandle, 5000);
+		configThreadHandle = NULL;
+	}
+
+	destroyPlatformFileWatch(configWatch);
+	configWatch = NULL;
+	destroyPlatformEvent(configStopEvent);
+	configStopEvent = NULL;
+
+	exchangeAtomicPointer(&publishedConfig, NULL);
+	exchangeAtomicPointer(&pinnedConfig, NULL);
+	configLog = NULL;
+}
+
+const GameVoiceConfig *acquireConfig(void)
+{
+	void *config;
+
+	// Pinned, then checked to still be the one published : the reload thread may have taken it meanwhile
+	do
+	{
+		config = loadAtomicPointer(&publishedConfig);
+		exchangeAtomicPointer(&pinnedConfig, config);
+	} while (loadAtomicPointer(&publishedConfig) != config);
+
+	return (const GameVoiceConfig *) config;
+}
+
+void releaseConfig(void)
+{
+	exchangeAtomicPointer(&pinnedConfig, NULL);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Plugin configuration file functions header
+ * pluginConfig.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLUGINCONFIG_H
+#define PLUGINCONFIG_H
+
+#include "buttonBindings.h"
+#include "buttonTransitions.h"
+#include "gestureRecognizer.h"
+#include "usbHidCommunication.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Configuration file, in the TS3 client configuration directory
+#define CONFIG_FILE_NAME "gamevoice.ini"
+
+// Largest configuration file read
+#define CONFIG_FILE_MAX_SIZE 16384
+
+// Time without any change of the file before it is read again (milliseconds) : editors write it in several steps
+#define CONFIG_RELOAD_DELAY 100
+
+// Size of the messages about the configuration file
+#define CONFIG_MESSAGE_SIZE 256
+
+// Size of the value of a setting, its terminator included : the longer ones are rejected
+#define CONFIG_VALUE_SIZE 1024
+
+// Settings of the plugin, a line of the file each : <key> = <value>, the lines starting with # are comments.
+//   devices = 045e:003b, ...			USB VID and PID of the devices driven (hexadecimal), on the next start only
+//   debounce = 10						debounce windows, see DEBOUNCE_VARIABLE
+//   gestures = hold=500,double=250		gesture timings, see GESTURES_VARIABLE
+//   bind = PRESS_TEAM=bookmark:TEAM		a binding (see parseButtonBindings) per line, replacing the default ones
+// The settings missing keep their default, and the environment variables, when set, take precedence over the file.
+typedef struct GameVoiceConfig
+{
+	// Number of the configuration, from 1 : every configuration published gets a new one
+	unsigned long long generation;
+
+	UsbDeviceId supportedDevices[USB_HID_MAX_DEVICE_IDS + 1];
+	unsigned long long debounceWindows[BUTTON_TRANSITIONS_MAX];
+	GestureTimings gestureTimings;
+	ButtonBindings bindings;
+} GameVoiceConfig;
+
+// Receives the messages about the configuration file (reloaded, or rejected and why), from any thread
+typedef void (*ConfigLogCallback)(const char *message, BOOL warning);
+
+/* Sets the default configuration, the environment variables applied.
+ */
+void initDefaultConfig(GameVoiceConfig *config);
+
+/* Parses and validates the text of a configuration file over the default configuration, then applies
+ * the environment variables. Returns FALSE if the file is invalid, with the line and the reason in the error.
+ */
+BOOL parseConfig(const char *text, GameVoiceConfig *config, char *error, size_t errorSize);
+
+/* Loads the configuration file of a directory and publishes it (the defaults if it is missing or invalid),
+ * then reloads it on a background thread whenever it changes. A NULL directory publishes the defaults only.
+ * Returns FALSE if the file is invalid.
+ */
+BOOL startConfig(const char *directory, ConfigLogCallback log);
+
+/* Stops reloading the configuration file, once the readers are done with it.
+ */
+void stopConfig(void);
+
+/* Gets the configuration published, kept as is until releaseConfig even if a new one is published meanwhile.
+ * One reader thread at a time (the thread dispatching the commands), lock free.
+ */
+const GameVoiceConfig *acquireConfig(void);
+
+/* Releases the configuration got by acquireConfig, the reload thread may reuse it from now on.
+ */
+void releaseConfig(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
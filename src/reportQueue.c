@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Input report queue functions
+ * reportQueue.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include "stdafx.h"
+#include "platform.h"
+#include "reportQueue.h"
+
+BOOL initReportQueue(ReportQueue *queue)
+{
+	queue->head = 0;
+	queue->tail = 0;
+	queue->discardedTail = 0;
+
+	// Auto reset : the single consumer is released once per signal
+	queue->readyEvent = createPlatformEvent(FALSE, FALSE);
+	return queue->readyEvent != NULL;
+}
+
+void finalizeReportQueue(ReportQueue *queue)
+{
+	destroyPlatformEvent(queue->readyEvent);
+	queue->readyEvent = NULL;
+}
+
+BOOL pushReport(ReportQueue *queue, const unsigned char *data, DWORD length, unsigned long long time, BOOL echo)
+{
+	long long tail = queue->tail;
+	TimedReport *report;
+
+	// The consumer index is read atomically, the slot is free once the consumer moved past it
+	if (tail - loadAtomic64(&queue->head) >= REPORT_QUEUE_CAPACITY)
+		return FALSE;
+
+	report = &queue->reports[tail & (REPORT_QUEUE_CAPACITY - 1)];
+	report->time = time;
+	report->echo = echo;
+	if (length > REPORT_SIZE)
+		length = REPORT_SIZE;
+	memcpy(report->data, data, length);
+	memset(report->data + length, 0, REPORT_SIZE - length);
+
+	// Publish the report, the atomic store orders the slot writes before the new index
+	storeAtomic64(&queue->tail, tail + 1);
+	setPlatformEvent(queue->readyEvent);
+	return TRUE;
+}
+
+BOOL popReport(ReportQueue *queue, TimedReport *report)
+{
+	long long head = queue->head;
+	long long discardedTail = loadAtomic64(&queue->discardedTail);
+
+	// Skip the discarded reports, their slots are released to the producer
+	if (head < discardedTail)
+	{
+		head = discardedTail;
+		storeAtomic64(&queue->head, head);
+	}
+	if (head == loadAtomic64(&queue->tail))
+		return FALSE;
+
+	*report = queue->reports[head & (REPORT_QUEUE_CAPACITY - 1)];
+
+	// Release the slot to the producer once it has been copied
+	storeAtomic64(&queue->head, head + 1);
+	return TRUE;
+}
+
+void discardReports(ReportQueue *queue)
+{
+	storeAtomic64(&queue->discardedTail, loadAtomic64(&queue->tail));
+}
+
+long long getQueuedReportCount(ReportQueue *queue)
+{
+	long long head = loadAtomic64(&queue->head);
+	long long discardedTail = loadAtomic64(&queue->discardedTail);
+
+	return loadAtomic64(&queue->tail) - (head < discardedTail ? discardedTail : head);
+}
+
+BOOL waitForReport(ReportQueue *queue, DWORD timeoutMilliseconds)
+{
+	return waitForPlatformEvent(queue->readyEvent, timeoutMilliseconds);
+}
+
+void releaseReportQueue(ReportQueue *queue)
+{
+	if (queue->readyEvent != NULL)
+		setPlatformEvent(queue->readyEvent);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Input report queue functions header
+ * reportQueue.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPORTQUEUE_H
+#define REPORTQUEUE_H
+
+#include "platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Size of a report buffer : the report ID followed by 64 bytes of data
+#define REPORT_SIZE 65
+
+// Number of reports the queue holds (power of two)
+#define REPORT_QUEUE_CAPACITY 64
+
+// Input report and the monotonic time (nanoseconds) it has been read from the device.
+// An echo reports the LED state written by a feature, not a change made by the user.
+typedef struct TimedReport
+{
+	unsigned long long time;
+	BOOL echo;
+	unsigned char data[REPORT_SIZE];
+} TimedReport;
+
+// Bounded single producer / single consumer queue of input reports.
+// The producer (HID worker thread) and the consumer (device user) never lock
+// nor wait for each other : each one only writes its own index.
+typedef struct ReportQueue
+{
+	TimedReport reports[REPORT_QUEUE_CAPACITY];
+
+	// Next report to pop, only written by the consumer
+	PLATFORM_CACHE_ALIGNED volatile long long head;
+
+	// Next report to push, only written by the producer (on another cache line)
+	PLATFORM_CACHE_ALIGNED volatile long long tail;
+
+	// Reports before it are skipped by the consumer, see discardReports
+	volatile long long discardedTail;
+
+	// Signaled when a report is pushed or the consumer must be released
+	PlatformEvent *readyEvent;
+} ReportQueue;
+
+/* Initializes an empty queue.
+ * Returns FALSE if the queue event cannot be created.
+ */
+BOOL initReportQueue(ReportQueue *queue);
+
+/* Releases the queue event.
+ */
+void finalizeReportQueue(ReportQueue *queue);
+
+/* Pushes a report at the end of the queue (producer only), echo of a feature or not.
+ * Returns FALSE, dropping the report, if the queue is full.
+ */
+BOOL pushReport(ReportQueue *queue, const unsigned char *data, DWORD length, unsigned long long time, BOOL echo);
+
+/* Pops the oldest report of the queue (consumer only).
+ * Returns FALSE if the queue is empty.
+ */
+BOOL popReport(ReportQueue *queue, TimedReport *report);
+
+/* Discards the reports queued so far, while the producer is not pushing (e.g. before a device is attached again).
+ * Only the consumer writes its index : it skips the discarded reports on its next pop.
+ */
+void discardReports(ReportQueue *queue);
+
+/* Gets the number of reports in the queue, from any thread.
+ */
+long long getQueuedReportCount(ReportQueue *queue);
+
+/* Waits for a report to be pushed, or the consumer to be released (consumer only).
+ * Returns FALSE on timeout.
+ */
+BOOL waitForReport(ReportQueue *queue, DWORD timeoutMilliseconds);
+
+/* Releases the consumer waiting for a report, e.g. when the device is detached.
+ */
+void releaseReportQueue(ReportQueue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
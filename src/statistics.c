@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Runtime statistics functions
+ * statistics.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include "stdafx.h"
+#include "platform.h"
+#include "statistics.h"
+
+// Latency histograms are log-linear : 8 buckets per power of two,
+// so a percentile is known within 12.5% whatever the magnitude
+#define LATENCY_SUB_BUCKETS_BITS 3
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKETS_BITS)
+#define LATENCY_BUCKETS ((64 - LATENCY_SUB_BUCKETS_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+static const char *counterNames[STATISTIC_COUNTER_COUNT] =
+{
+	"worker wakeups",
+	"worker idle wakeups",
+	"reports received",
+	"reports dropped",
+	"reports invalid",
+	"transitions filtered",
+	"commands dispatched",
+	"gestures recognized",
+	"features submitted",
+	"features coalesced",
+	"features sent",
+	"feature echoes",
+	"LED layer writes",
+	"hotplug events",
+	"hotplug events ignored",
+	"devices broken",
+	"recovery attempts",
+	"devices recovered",
+	"event loops abandoned",
+	"configuration reloads",
+	"configurations rejected"
+};
+
+static const char *latencyNames[STATISTIC_LATENCY_COUNT] =
+{
+	"press to dispatch",
+	"tap recognition",
+	"request completion",
+	"time to recover",
+	"TS3 callback time",
+	"device to read"
+};
+
+static volatile long long counters[STATISTIC_COUNTER_COUNT];
+static volatile long long latencyBuckets[STATISTIC_LATENCY_COUNT][LATENCY_BUCKETS];
+static volatile long long statisticsStartTime = 0;
+
+// Gets the histogram bucket of a value
+static int getLatencyBucket(unsigned long long value)
+{
+	int highestBit = 0;
+
+	if (value < (2 * LATENCY_SUB_BUCKETS))
+		return (int) value;
+
+	while ((value >> highestBit) > 1)
+		highestBit++;
+
+	return (highestBit - LATENCY_SUB_BUCKETS_BITS + 1) * LATENCY_SUB_BUCKETS
+		+ (int) ((value >> (highestBit - LATENCY_SUB_BUCKETS_BITS)) & (LATENCY_SUB_BUCKETS - 1));
+}
+
+// Gets the highest value stored in a histogram bucket
+static unsigned long long getLatencyBucketUpperBound(int bucket)
+{
+	int shift;
+
+	if (bucket < (2 * LATENCY_SUB_BUCKETS))
+		return (unsigned long long) bucket;
+
+	shift = bucket / LATENCY_SUB_BUCKETS - 1;
+	return (((unsigned long long) (LATENCY_SUB_BUCKETS + bucket % LATENCY_SUB_BUCKETS) + 1) << shift) - 1;
+}
+
+// Gets the measurement period start time, starting it on first use
+static unsigned long long getStatisticsStartTime(void)
+{
+	long long startTime = loadAtomic64(&statisticsStartTime);
+
+	if (startTime == 0)
+	{
+		startTime = (long long) getMonotonicTime();
+		storeAtomic64(&statisticsStartTime, startTime);
+	}
+
+	return (unsigned long long) startTime;
+}
+
+void incrementStatistic(enum StatisticCounter counter)
+{
+	addAtomic64(&counters[counter], 1);
+}
+
+void addStatistic(enum StatisticCounter counter, long long value)
+{
+	addAtomic64(&counters[counter], value);
+}
+
+long long getStatistic(enum StatisticCounter counter)
+{
+	return loadAtomic64(&counters[counter]);
+}
+
+void recordLatency(enum StatisticLatency latency, unsigned long long nanoseconds)
+{
+	addAtomic64(&latencyBuckets[latency][getLatencyBucket(nanoseconds)], 1);
+}
+
+unsigned long long getLatencyPercentile(enum StatisticLatency latency, double percentile)
+{
+	long long total = 0;
+	long long rank;
+	long long seen = 0;
+	int bucket;
+
+	for (bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+		total += loadAtomic64(&latencyBuckets[latency][bucket]);
+
+	if (total == 0)
+		return 0;
+
+	// Rank of the sample holding the percentile (nearest rank method)
+	rank = (long long) (percentile / 100.0 * (double) total + 0.5);
+	if (rank < 1)
+		rank = 1;
+
+	for (bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+	{
+		seen += loadAtomic64(&latencyBuckets[latency][bucket]);
+		if (seen >= rank)
+			return getLatencyBucketUpperBound(bucket);
+	}
+
+	return getLatencyBucketUpperBound(LATENCY_BUCKETS - 1);
+}
+
+void resetStatistics(void)
+{
+	int counter, latency, bucket;
+
+	for (counter = 0; counter < STATISTIC_COUNTER_COUNT; counter++)
+		storeAtomic64(&counters[counter], 0);
+
+	for (latency = 0; latency < STATISTIC_LATENCY_COUNT; latency++)
+		for (bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+			storeAtomic64(&latencyBuckets[latency][bucket], 0);
+
+	storeAtomic64(&statisticsStartTime, (long long) getMonotonicTime());
+}
+
+void formatStatistics(char *buffer, size_t bufferSize)
+{
+	unsigned long long startTime = getStatisticsStartTime();
+	double elapsedSeconds = (double) (getMonotonicTime() - startTime) / 1e9;
+	size_t length = 0;
+	int counter, latency;
+
+	if (bufferSize == 0)
+		return;
+
+	buffer[0] = '\0';
+	if (elapsedSeconds <= 0)
+		elapsedSeconds = 1e-9;
+
+	for (counter = 0; counter < STATISTIC_COUNTER_COUNT && length < bufferSize; counter++)
+	{
+		long long value = getStatistic((enum StatisticCounter) counter);
+		int written = snprintf(buffer + length, bufferSize - length, "%s: %lld (%.1f/s)\n",
+			counterNames[counter], value, (double) value / elapsedSeconds);
+		if (written < 0)
+			return;
+		length += (size_t) written;
+	}
+
+	for (latency = 0; latency < STATISTIC_LATENCY_COUNT && length < bufferSize; latency++)
+	{
+		enum StatisticLatency histogram = (enum StatisticLatency) latency;
+		int written = snprintf(buffer + length, bufferSize - length, "%s: p50 %.1fus p90 %.1fus p99 %.1fus max %.1fus\n",
+			latencyNames[latency],
+			(double) getLatencyPercentile(histogram, 50) / 1000.0,
+			(double) getLatencyPercentile(histogram, 90) / 1000.0,
+			(double) getLatencyPercentile(histogram, 99) / 1000.0,
+			(double) getLatencyPercentile(histogram, 100) / 1000.0);
+		if (written < 0)
+			return;
+		length += (size_t) written;
+	}
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Runtime statistics functions header
+ * statistics.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Event counters
+enum StatisticCounter
+{
+	STATISTIC_WORKER_WAKEUPS,		// Worker thread wakeups
+	STATISTIC_WORKER_IDLE_WAKEUPS,	// Worker thread wakeups without any request to process
+	STATISTIC_REPORTS_RECEIVED,		// Input reports read from the device
+	STATISTIC_REPORTS_DROPPED,		// Input reports lost because the report queue was full
+	STATISTIC_REPORTS_INVALID,		// Input reports of a button state the device can't report (glitches)
+	STATISTIC_TRANSITIONS_FILTERED,	// Button transitions dropped by the debounce (contact bounce)
+	STATISTIC_COMMANDS_DISPATCHED,	// Commands dispatched to TS3 actions
+	STATISTIC_GESTURES_RECOGNIZED,	// Gestures (tap, double tap, hold, chord) reported to TS3 as key events
+	STATISTIC_FEATURES_SUBMITTED,	// Feature writes requested
+	STATISTIC_FEATURES_COALESCED,	// Feature writes dropped as unchanged or merged into a later write
+	STATISTIC_FEATURES_SENT,		// Feature writes actually transferred to the device
+	STATISTIC_FEATURE_ECHOES,		// Input reports classified as the echo of a feature write
+	STATISTIC_LAYER_WRITES,			// LED writes of the layers above the device state (animation keyframes, notifications, overrides)
+	STATISTIC_HOTPLUG_EVENTS,		// Device arrivals and removals attaching or detaching a device
+	STATISTIC_HOTPLUG_EVENTS_IGNORED,	// Device arrivals and removals of other devices
+	STATISTIC_DEVICE_FAILURES,		// Devices found broken (not responding or failing to open)
+	STATISTIC_RECOVERY_ATTEMPTS,	// Attempts to reopen a broken device
+	STATISTIC_DEVICE_RECOVERIES,	// Broken devices reopened successfully
+	STATISTIC_EVENT_LOOPS_ABANDONED,	// Event loop threads left stuck in a transfer and replaced
+	STATISTIC_CONFIG_RELOADS,		// Configuration files changed, validated and published
+	STATISTIC_CONFIG_REJECTED,		// Configuration files changed but invalid, the previous configuration kept
+	STATISTIC_COUNTER_COUNT
+};
+
+// Latency histograms
+enum StatisticLatency
+{
+	STATISTIC_PRESS_TO_DISPATCH,	// From the input report read to the TS3 action dispatch
+	STATISTIC_TAP_RECOGNITION,		// From the release of a tap to its key event, the double tap time included
+	STATISTIC_REQUEST_COMPLETION,	// From the request submission to the end of its transfer
+	STATISTIC_TIME_TO_RECOVER,		// From a device found broken to its reopening
+	STATISTIC_CALLBACK_TIME,		// Time spent in plugin code by the TS3 client callbacks driving the devices
+	STATISTIC_DEVICE_TO_READ,		// From a button change of the simulated device to its input report read
+	STATISTIC_LATENCY_COUNT
+};
+
+/* Increments the specified counter.
+ */
+void incrementStatistic(enum StatisticCounter counter);
+
+/* Adds a value to the specified counter.
+ */
+void addStatistic(enum StatisticCounter counter, long long value);
+
+/* Gets the current value of the specified counter.
+ */
+long long getStatistic(enum StatisticCounter counter);
+
+/* Records a latency sample (in nanoseconds) in the specified histogram.
+ */
+void recordLatency(enum StatisticLatency latency, unsigned long long nanoseconds);
+
+/* Gets the specified percentile (0-100) of a latency histogram in nanoseconds.
+ * The value is the upper bound of the histogram bucket holding the percentile.
+ */
+unsigned long long getLatencyPercentile(enum StatisticLatency latency, double percentile);
+
+/* Clears all counters and histograms and restarts the measurement period.
+ */
+void resetStatistics(void);
+
+/* Formats a human readable statistics report (counters, rates and latency percentiles).
+ */
+void formatStatistics(char *buffer, size_t bufferSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,43 +1,84 @@
-/*
- * Copyright (c) 2012-2019 JoeBilly
- * Copyright (c) 2010 Simon Inns
- * 
- * Standard system include file
- * stdafx.h
- * JoeBilly (joebilly@users.sourceforge.net)
- * https://github.com/ghoebilly/ts3gamevoice
- *
- * Code adapted from usbHidCommunication
- * v1_1 2010-03-31
- * Simon Inns (simon.inns@gmail.com)
- * http://www.waitingforfriday.com
- * 
- *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
- *
- *  TeamSpeak 3 SideWinder Game Voice Plugin is free software: 
- *	you can redistribute it and/or modify it under the terms of the 
- *	GNU General Public License as published by the Free Software Foundation, 
- *	either version 3 of the License, or (at your option) any later version.
- *
- *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope 
- *  that it will be useful, but WITHOUT ANY WARRANTY; without even the 
- *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
- *  See the GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with TeamSpeak 3 SideWinder Game Voice Plugin. 
- *  If not, see <http://www.gnu.org/licenses/>.
- */
-
-#pragma once
-
-#ifdef _WIN32
-//#pragma warning(disable : 4996)  /* Disable unsafe localtime warning */
-#include <Windows.h>	// We require the datatypes from this header
-#include <stdio.h>
-#define snprintf sprintf_s
-#endif
-#include <string.h>
-#include <setupapi.h>	// setupapi.h provides the functions required to search for
-						// and identify our target USB device
-#include <Dbt.h>		// Required for WM_DEVICECHANGE messages (plug and play USB detection)
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ * Copyright (c) 2010 Simon Inns
+ * 
+ * Standard system include file
+ * stdafx.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ * Code adapted from usbHidCommunication
+ * v1_1 2010-03-31
+ * Simon Inns (simon.inns@gmail.com)
+ * http://www.waitingforfriday.com
+ * 
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software: 
+ *	you can redistribute it and/or modify it under the terms of the 
+ *	GNU General Public License as published by the Free Software Foundation, 
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope 
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the 
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin. 
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifdef _WIN32
+//#pragma warning(disable : 4996)  /* Disable unsafe localtime warning */
+#include <Windows.h>	// We require the datatypes from this header
+#include <stdio.h>
+// Visual Studio 2015 and later have the C99 snprintf, the older ones truncate with _snprintf_s only
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define snprintf(buffer, size, ...) _snprintf_s(buffer, size, _TRUNCATE, __VA_ARGS__)
+#endif
+#include <string.h>
+#include <setupapi.h>	// setupapi.h provides the functions required to search for
+						// and identify our target USB device
+#include <Dbt.h>		// Required for WM_DEVICECHANGE messages (plug and play USB detection)
+#else
+// Outside of Windows, provide the few Windows datatypes and functions the plugin relies on
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef int BOOL;
+typedef unsigned char byte;
+typedef uint32_t DWORD;
+typedef unsigned int UINT;
+typedef long LONG;
+typedef uintptr_t WPARAM;
+typedef intptr_t LPARAM;
+typedef void *HANDLE;
+typedef void *LPVOID;
+typedef char *LPSTR;
+typedef const char *LPCSTR;
+
+#define TRUE 1
+#define FALSE 0
+#define WINAPI
+#define INVALID_HANDLE_VALUE ((HANDLE) (intptr_t) -1)
+
+#ifdef _DEBUG
+#define OutputDebugString(message) fprintf(stderr, "%s\n", (message))
+#else
+#define OutputDebugString(message) ((void) (message))
+#endif
+
+static inline void Sleep(DWORD milliseconds)
+{
+	struct timespec duration;
+	duration.tv_sec = milliseconds / 1000;
+	duration.tv_nsec = (long) (milliseconds % 1000) * 1000000L;
+	nanosleep(&duration, NULL);
+}
+#endif
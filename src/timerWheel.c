@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Timer wheel functions
+ * timerWheel.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stdafx.h"
+#include "timerWheel.h"
+
+// Links a timer in the slot of its tick
+static void linkTimer(TimerWheel *wheel, WheelTimer *timer)
+{
+	WheelTimer **slot = &wheel->slots[timer->tick & (TIMER_WHEEL_SIZE - 1)];
+
+	timer->previous = NULL;
+	timer->next = *slot;
+	if (*slot != NULL)
+		(*slot)->previous = timer;
+	*slot = timer;
+	timer->scheduled = TRUE;
+	wheel->timerCount++;
+}
+
+static void unlinkTimer(TimerWheel *wheel, WheelTimer *timer)
+{
+	if (timer->previous != NULL)
+		timer->previous->next = timer->next;
+	else
+		wheel->slots[timer->tick & (TIMER_WHEEL_SIZE - 1)] = timer->next;
+	if (timer->next != NULL)
+		timer->next->previous = timer->previous;
+
+	timer->next = NULL;
+	timer->previous = NULL;
+	timer->scheduled = FALSE;
+	wheel->timerCount--;
+}
+
+void initTimerWheel(TimerWheel *wheel, unsigned long long now)
+{
+	memset(wheel->slots, 0, sizeof(wheel->slots));
+	wheel->currentTick = now / TIMER_WHEEL_TICK;
+	wheel->timerCount = 0;
+}
+
+void initWheelTimer(WheelTimer *timer, WheelTimerCallback callback, LPVOID context)
+{
+	memset(timer, 0, sizeof(WheelTimer));
+	timer->callback = callback;
+	timer->context = context;
+}
+
+void scheduleWheelTimer(TimerWheel *wheel, WheelTimer *timer, unsigned long long deadline)
+{
+	// Rounded up : a timer never expires before its deadline
+	unsigned long long tick = (deadline + TIMER_WHEEL_TICK - 1) / TIMER_WHEEL_TICK;
+
+	if (timer->scheduled)
+		unlinkTimer(wheel, timer);
+
+	timer->tick = tick > wheel->currentTick ? tick : wheel->currentTick + 1;
+	linkTimer(wheel, timer);
+}
+
+void cancelWheelTimer(TimerWheel *wheel, WheelTimer *timer)
+{
+	if (timer->scheduled)
+		unlinkTimer(wheel, timer);
+}
+
+int advanceTimerWheel(TimerWheel *wheel, unsigned long long now)
+{
+	unsigned long long tick = now / TIMER_WHEEL_TICK;
+	int expired = 0;
+
+	// Every slot is looked at once at most, however long the wheel was not advanced
+	if (tick > wheel->currentTick + TIMER_WHEEL_SIZE)
+		wheel->currentTick = tick - TIMER_WHEEL_SIZE;
+
+	// The current tick moves along : a timer scheduled again by its callback lands in a slot still ahead
+	while (wheel->currentTick < tick && wheel->timerCount != 0)
+	{
+		WheelTimer *timer = wheel->slots[++wheel->currentTick & (TIMER_WHEEL_SIZE - 1)];
+
+		while (timer != NULL)
+		{
+			WheelTimer *next = timer->next;
+
+			if (timer->tick <= tick)
+			{
+				unlinkTimer(wheel, timer);
+				expired++;
+				timer->callback(timer, timer->context);
+			}
+			timer = next;
+		}
+	}
+
+	if (tick > wheel->currentTick)
+		wheel->currentTick = tick;
+	return expired;
+}
+
+unsigned long long getTimerWheelDeadline(const TimerWheel *wheel)
+{
+	unsigned long long tick;
+	unsigned long long nearest = 0;
+
+	if (wheel->timerCount == 0)
+		return 0;
+
+	for (tick = wheel->currentTick + 1; tick <= wheel->currentTick + TIMER_WHEEL_SIZE; tick++)
+	{
+		const WheelTimer *timer;
+
+		for (timer = wheel->slots[tick & (TIMER_WHEEL_SIZE - 1)]; timer != NULL; timer = timer->next)
+		{
+			if (timer->tick == tick)
+				return tick * TIMER_WHEEL_TICK;
+			if (nearest == 0 || timer->tick < nearest)
+				nearest = timer->tick;
+		}
+	}
+
+	// Only timers further than a turn away : the wheel is looked at again a turn ahead at most
+	return (nearest < wheel->currentTick + TIMER_WHEEL_SIZE ? nearest : wheel->currentTick + TIMER_WHEEL_SIZE) * TIMER_WHEEL_TICK;
+}
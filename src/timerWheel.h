@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Timer wheel functions header
+ * timerWheel.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Resolution of the timers (nanoseconds) : a timer expires on the first tick at or after its deadline
+#define TIMER_WHEEL_TICK 1000000ULL
+
+// Slots of the wheel, one per tick (power of two) : a turn of the wheel is 256 ms,
+// the timers further away stay in their slot for the next turns
+#define TIMER_WHEEL_SIZE 256
+
+typedef struct WheelTimer WheelTimer;
+
+// Function called when a timer expires, on the thread advancing the wheel.
+// The timer is not scheduled anymore and may be scheduled again from the callback,
+// the other timers of the wheel must be left alone.
+typedef void (*WheelTimerCallback)(WheelTimer *timer, LPVOID context);
+
+// Timer of a wheel, embedded in its owner : scheduling and cancelling never allocate
+struct WheelTimer
+{
+	// Tick the timer expires on
+	unsigned long long tick;
+
+	WheelTimerCallback callback;
+	LPVOID context;
+
+	// Timers of the same slot, NULL previous for the first one
+	WheelTimer *next;
+	WheelTimer *previous;
+	BOOL scheduled;
+};
+
+// Hashed timer wheel : a timer is linked in the slot of its tick, scheduled and cancelled
+// in constant time, and the wheel only looks at the slots of the ticks elapsed when advanced.
+// A wheel belongs to a single thread, nothing is synchronized.
+typedef struct TimerWheel
+{
+	WheelTimer *slots[TIMER_WHEEL_SIZE];
+
+	// Last tick the wheel has been advanced to
+	unsigned long long currentTick;
+
+	int timerCount;
+} TimerWheel;
+
+/* Starts an empty wheel at a monotonic time (nanoseconds, see getMonotonicTime).
+ */
+void initTimerWheel(TimerWheel *wheel, unsigned long long now);
+
+/* Sets up a timer, not scheduled, with the function called when it expires.
+ */
+void initWheelTimer(WheelTimer *timer, WheelTimerCallback callback, LPVOID context);
+
+/* Schedules a timer to expire at a monotonic time, moving it if it is already scheduled.
+ * A deadline already over expires on the next tick.
+ */
+void scheduleWheelTimer(TimerWheel *wheel, WheelTimer *timer, unsigned long long deadline);
+
+/* Cancels a timer, nothing is done if it is not scheduled.
+ */
+void cancelWheelTimer(TimerWheel *wheel, WheelTimer *timer);
+
+/* Advances the wheel to a monotonic time, calling the timers expired meanwhile.
+ * Returns the number of timers expired.
+ */
+int advanceTimerWheel(TimerWheel *wheel, unsigned long long now);
+
+/* Gets the monotonic time the next timer expires, 0 if no timer is scheduled.
+ * A timer more than a turn of the wheel away is only looked for a turn ahead.
+ */
+unsigned long long getTimerWheelDeadline(const TimerWheel *wheel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
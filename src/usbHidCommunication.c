@@ -1,993 +1,2118 @@
-/*
- * Copyright (c) 2012-2019 JoeBilly
- * Copyright (C) 2010 Simon Inns
- * 
- * HID USB communication functions
- * usbHidCommunication.c
- * JoeBilly (joebilly@users.sourceforge.net)
- * https://github.com/ghoebilly/ts3gamevoice
- *
- * Code adapted from usbHidCommunication
- * v1_1 2010-03-31
- * Simon Inns (simon.inns@gmail.com)
- * http://www.waitingforfriday.com
- * 
- *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
- *
- *  TeamSpeak 3 SideWinder Game Voice Plugin is free software: 
- *	you can redistribute it and/or modify it under the terms of the 
- *	GNU General Public License as published by the Free Software Foundation, 
- *	either version 3 of the License, or (at your option) any later version.
- *
- *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope 
- *  that it will be useful, but WITHOUT ANY WARRANTY; without even the 
- *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
- *  See the GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with TeamSpeak 3 SideWinder Game Voice Plugin. 
- *  If not, see <http://www.gnu.org/licenses/>.
- */
-
-#include <stdio.h>
-#include "stdafx.h"
-
-#include <tchar.h>
-#include "hidsdi.h"			// From Windows DDK
-#include "usbHidCommunication.h"
-
-// Private variables for holding the device found state and the
-// read/write handles
-BOOL deviceAttached = FALSE;
-BOOL deviceAttachedButBroken = FALSE;
-static HANDLE WriteHandle = INVALID_HANDLE_VALUE;
-static HANDLE ReadHandle = INVALID_HANDLE_VALUE;
-static HANDLE FeatureHandle = INVALID_HANDLE_VALUE;
-static HANDLE ReportHandle = INVALID_HANDLE_VALUE;
-
-// Private variables to store the input and output
-// buffers for USB communication
-static unsigned char *outputBuffer;
-static unsigned char *inputBuffer;
-static unsigned char *featureBuffer;
-
-// Worker thread definitions
-static HANDLE usbWorkerThreadHandle = INVALID_HANDLE_VALUE;
-
-// State for the worker thread
-enum eWorkerThreadState workerThreadState = idle;
-
-// This public method detaches the USB device and forces the 
-// worker threads to cancel IO and abort if required.
-// This is used when we're done communicating with the device
-static void detachDevice()
-{
-	if (deviceAttached == TRUE)
-	{
-		OutputDebugString("Detaching device...");
-
-		if (workerThreadState != idle)
-		{
-			OutputDebugString("Cancelling IO ops...");
-
-			// Cancel any pending IO operations
-			CancelIoEx(WriteHandle, NULL);
-			CancelIoEx(ReadHandle, NULL);
-			CancelIoEx(FeatureHandle, NULL);
-			CancelIoEx(ReportHandle, NULL);
-
-			// Clear the worker thread flags
-			workerThreadState = idle;
-		}
-
-		// Unattach the device
-		deviceAttached = FALSE;
-		deviceAttachedButBroken = FALSE;
-
-		OutputDebugString("Closing worker thread...");
-
-		workerThreadState = terminated;
-
-		// Abort the worker thread
-		WaitForSingleObject(usbWorkerThreadHandle, 5000);
-		CloseHandle(usbWorkerThreadHandle);
-
-		OutputDebugString("Closing handles...");
-
-		// Close the device file handles
-		CloseHandle(WriteHandle);
-		CloseHandle(ReadHandle);
-		CloseHandle(FeatureHandle);
-		CloseHandle(ReportHandle);
-	}
-} // END detachUsbDevice Method
-
-
-// Initializes the hid communication instance 
-static void initUsbHidCommunication()
-{
-	int loopCounter;
-
-	// Set deviceAttached to FALSE
-	deviceAttached = FALSE;
-
-	// Set deviceAttachedButBroken to FALSE
-	deviceAttachedButBroken = FALSE;
-
-	// Set the read and write handles to invalid
-	WriteHandle = INVALID_HANDLE_VALUE;
-	ReadHandle = INVALID_HANDLE_VALUE;
-	FeatureHandle = INVALID_HANDLE_VALUE;
-	ReportHandle = INVALID_HANDLE_VALUE;
-
-	// Initialise the input and output buffers for communicating
-	// with the USB device
-	outputBuffer = (unsigned char *) malloc(65);
-	inputBuffer = (unsigned char *) malloc(65);
-	featureBuffer = (unsigned char *) malloc(65);
-
-	// Fill the outputBuffer with 0xFF (apparently this causes less EMI and power
-	// consumption)
-	for (loopCounter = 0; loopCounter < 65; loopCounter++) outputBuffer[loopCounter] = 0xFF;
-
-	// Clear the worker thread flag
-	workerThreadState = idle;
-} // END usbHidCommunication method
-
-// Destructor method
-static void finalizeUsbHidCommunication()
-{
-	// Cleanly detach ourselves from the USB device
-	detachDevice();	
-	free(outputBuffer);
-	free(inputBuffer);
-	free(featureBuffer);
-} // END ~usbHidCommunication method
-
-
-// This method is run as a background thread which reads
-// information from the USB device.  It is encapsulated in a worker
-// thread since the ReadFile() or WriteFile() commands could block if the USB
-// device is detached at an unfortunate point, or (more importantly
-// if the firmware of the device does not send a response when one
-// is expected (due to a software or firmware bug) - which would otherwise
-// lock-up the application...
-
-static DWORD WINAPI usbWorkerThread(LPVOID pData)
-{
-	// Variables for tracking how much is read and written
-	DWORD bytesRead = 0;
-	DWORD bytesWritten = 0;
-	LPSTR errorText = NULL;
-
-	// for DEBUG, REMOVE!
-	//int loopCounter = 0;
-	//char debugOutput[35];
-
-	while(workerThreadState != terminated)
-	{
-		if (workerThreadState == read)
-		{
-			//char debugOutput[20];
-
-			// Map the managed data array from the class to an unmanaged
-			// pointer for the ReadFile function
-			unsigned char * unmanagedInputBuffer = &inputBuffer[0];
-
-			// Get the packet from the USB device
-			OutputDebugString("usbWorkerThread:read: Read the packet from the USB device");
-			ReadFile(ReadHandle, unmanagedInputBuffer, 65, &bytesRead, 0);
-			//OutputDebugString("Read in input buffer");
-			//_snprintf(debugOutput, 20, "%d", bytesRead);
-			//OutputDebugString(debugOutput);
-
-			// DEBUG
-			//OutputDebugString("InputBuffer below");
-			//for (loopCounter = 0; loopCounter < 65; loopCounter++) 
-			//{
-			//	_snprintf(debugOutput, 20, "%d", inputBuffer[loopCounter]);
-			//	OutputDebugString(debugOutput);
-			//}
-
-			// Set the worker thread state to idle
-			workerThreadState = idle;
-		}
-
-		if (workerThreadState == writeRead)
-		{
-			// Map the managed data array from the class to an unmanaged
-			// pointer for the WriteFile function
-			unsigned char * unmanagedOutputBuffer = &outputBuffer[0];
-
-			// Send the packet to the USB device and then perform a read
-			// from the device (if the write was successful)
-			OutputDebugString("usbWorkerThread:writeRead: Send the packet to the USB device and try to perform a read");
-			if (WriteFile(WriteHandle, unmanagedOutputBuffer, 65, &bytesWritten, 0))
-			{
-				// Map the managed data array from the class to an unmanaged
-				// pointer for the ReadFile function
-				unsigned char * unmanagedInputBuffer = &inputBuffer[0];
-
-				// Get the packet from the USB device
-				ReadFile(ReadHandle, unmanagedInputBuffer, 65, &bytesRead, 0);
-			}
-
-			// Set the worker thread state to idle
-			workerThreadState = idle;
-		}
-
-		if (workerThreadState == setFeature)
-		{
-			// Map the managed data array from the class to an unmanaged
-			// pointer for the ReadFile function
-			unsigned char * unmanagedFeatureBuffer = &featureBuffer[0];
-
-			// Get the packet from the USB device
-			OutputDebugString("usbWorkerThread:setFeature: Set feature to the USB device");
-			if (HidD_SetFeature(WriteHandle, unmanagedFeatureBuffer, 65))
-			{
-				// We need to read the return from the device
-
-				// Map the managed data array from the class to an unmanaged
-				// pointer for the ReadFile function
-				unsigned char * unmanagedInputBuffer = &inputBuffer[0];
-
-				// Get the packet from the USB device
-				ReadFile(ReadHandle, unmanagedInputBuffer, 65, &bytesRead, 0);							
-			}
-			else
-				OutputDebugString("usbWorkerThread: /!\\ Failed to set feature to the USB device");																		
-							
-			//OutputDebugString("Read in input buffer");
-			//_snprintf(debugOutput, 20, "%d", bytesRead);
-			//OutputDebugString(debugOutput);
-
-			// DEBUG
-			//OutputDebugString("InputBuffer below");
-			//for (loopCounter = 0; loopCounter < 65; loopCounter++) 
-			//{
-			//	_snprintf(debugOutput, 20, "%d", inputBuffer[loopCounter]);
-			//	OutputDebugString(debugOutput);
-			//}
-
-			// Set the worker thread state to idle
-			workerThreadState = idle;
-		}
-
-		if (workerThreadState == write)
-		{
-			// Map the managed data array from the class to an unmanaged
-			// pointer for the WriteFile function
-			unsigned char * unmanagedOutputBuffer = &outputBuffer[0];						
-
-			// Send the packet to the USB device
-			OutputDebugString("usbWorkerThread:write: Send the packet to the USB device");
-			if (!WriteFile(WriteHandle, unmanagedOutputBuffer, 65, &bytesWritten, 0))
-			{
-				OutputDebugString("usbWorkerThread: /!\\ Failed to send the packet to the USB device");
-
-				//snprintf(debugOutput, 35, "usbWorkerThread:bytesWritten:%d", bytesWritten);
-				//OutputDebugString(debugOutput);
-
-				//FormatMessage(
-				//	// use system message tables to retrieve error text
-				//	FORMAT_MESSAGE_FROM_SYSTEM
-				//	// allocate buffer on local heap for error text
-				//	|FORMAT_MESSAGE_ALLOCATE_BUFFER
-				//	// Important! will fail otherwise, since we're not 
-				//	// (and CANNOT) pass insertion parameters
-				//	|FORMAT_MESSAGE_IGNORE_INSERTS,  
-				//	NULL,    // unused with FORMAT_MESSAGE_FROM_SYSTEM
-				//	GetLastError(),
-				//	MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-				//	(LPSTR)&errorText,  // output 
-				//	0, // minimum size for output buffer
-				//	NULL);   // arguments - see note 
-
-				//OutputDebugString(errorText);
-			}
-
-			// Set the worker thread state to idle
-			workerThreadState = idle;
-		}
-
-		if (workerThreadState == idle)
-		{
-			// Here we add a small delay to prevent the worker thread
-			// from executing too fast and using unnecessary processor
-			// time
-			Sleep(5);
-		}					
-	}
-
-	OutputDebugString("usbWorkerThread: Worker thread exited");
-	return 0;
-} // END usbWorkerThread method
-
-// This method attempts to find the target USB device and discover the device's path
-// Note: A limitation of this routine is that it cannot deal with two or more devices
-// connected to the host that have the same VID and PID, it will simply pick
-// the first one it finds...
-static void findDevice(int usbVid, int usbPid)
-{
-	HDEVINFO                         hDevInfo;
-	SP_DEVICE_INTERFACE_DATA         DevIntfData;
-	PSP_DEVICE_INTERFACE_DETAIL_DATA DevIntfDetailData;
-	SP_DEVINFO_DATA                  DevData;
-
-	DWORD dwSize, dwMemberIdx;
-
-	char usbId[18];
-	LPTSTR DeviceIDToFind;
-
-	DWORD ErrorStatusWrite;
-	DWORD ErrorStatusRead;
-	DWORD ErrorStatusFeature;
-	DWORD ErrorStatusReport;
-
-	GUID GUID_DEVINTERFACE_USB_DEVICE = {0x4d1e55b2, 0xf16f, 0x11cf, 0x88, 0xcb, 0x00, 0x11, 0x11, 0x00, 0x00, 0x30};
-
-	char debugOutput[40];
-
-	// Device ID
-	OutputDebugString("findDevice: Seaching for device ID below");
-	snprintf(usbId, 18, "vid_%04x&pid_%04x", usbVid, usbPid);
-	DeviceIDToFind = usbId;
-	OutputDebugString(DeviceIDToFind);
-
-	LocalFree(usbId);
-
-	OutputDebugString("findDevice: Detaching USB device just in case...");
-	// If the device is currently flagged as attached then we are 'rechecking' the device, probably
-	// due to some message receieved from Windows indicating a device status chanage.  In this case
-	// we should detach the USB device cleanly (if required) before reattaching it.
-	detachDevice();
-
-	OutputDebugString("findDevice: SetupDiGetClassDevs: Initializing HID class devices...");
-	// We will try to get device information set for all USB devices that have a
-	// device interface and are currently present on the system (plugged in).
-	hDevInfo = SetupDiGetClassDevs(
-		&GUID_DEVINTERFACE_USB_DEVICE, NULL, 0, DIGCF_DEVICEINTERFACE | DIGCF_PRESENT);
-	
-	if (hDevInfo != INVALID_HANDLE_VALUE)
-	{
-		// Prepare to enumerate all device interfaces for the device information
-		// set that we retrieved with SetupDiGetClassDevs(..)
-		DevIntfData.cbSize = sizeof(SP_DEVICE_INTERFACE_DATA);
-		dwMemberIdx = 0;
-
-		OutputDebugString("findDevice: SetupDiEnumDeviceInfo: Enumerating devices...");
-		// Next, we will keep calling this SetupDiEnumDeviceInterfaces(..) until this
-		// function causes GetLastError() to return  ERROR_NO_MORE_ITEMS. With each
-		// call the dwMemberIdx value needs to be incremented to retrieve the next
-		// device interface information.
-
-		SetupDiEnumDeviceInterfaces(hDevInfo, NULL, &GUID_DEVINTERFACE_USB_DEVICE,
-			dwMemberIdx, &DevIntfData);
-
-		while(GetLastError() != ERROR_NO_MORE_ITEMS)
-		{
-			// As a last step we will need to get some more details for each
-			// of device interface information we are able to retrieve. This
-			// device interface detail gives us the information we need to identify
-			// the device (VID/PID), and decide if it's useful to us. It will also
-			// provide a DEVINFO_DATA structure which we can use to know the serial
-			// port name for a virtual com port.
-
-			DevData.cbSize = sizeof(DevData);
-			
-			// Get the required buffer size. Call SetupDiGetDeviceInterfaceDetail with
-			// a NULL DevIntfDetailData pointer, a DevIntfDetailDataSize
-			// of zero, and a valid RequiredSize variable. In response to such a call,
-			// this function returns the required buffer size at dwSize.
-			SetupDiGetDeviceInterfaceDetail(
-					hDevInfo, &DevIntfData, NULL, 0, &dwSize, NULL);
-
-			// Allocate memory for the DeviceInterfaceDetail struct. Don't forget to
-			// deallocate it later!
-			DevIntfDetailData = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, dwSize);
-			DevIntfDetailData->cbSize = sizeof(SP_DEVICE_INTERFACE_DETAIL_DATA);
-
-			OutputDebugString("findDevice: SetupDiGetDeviceInterfaceDetail: Getting device interface detail to open the read and write handles required for USB communication...");
-
-			if (SetupDiGetDeviceInterfaceDetail(hDevInfo, &DevIntfData,
-				DevIntfDetailData, dwSize, &dwSize, &DevData))
-			{
-				// Finally we can start checking if we've found a useable device,
-				// by inspecting the DevIntfDetailData->DevicePath variable.
-				if (NULL != strstr((TCHAR*)DevIntfDetailData->DevicePath, _T(DeviceIDToFind)))
-				{					
-					OutputDebugString("findDevice: Device found, path is below");
-					OutputDebugString(DevIntfDetailData->DevicePath);
-
-					// Open the write handle
-					WriteHandle = CreateFile((DevIntfDetailData->DevicePath), 
-						GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, 0);
-					ErrorStatusWrite = GetLastError();
-
-					// Open the read handle
-					ReadHandle = CreateFile((DevIntfDetailData->DevicePath),
-						GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, 0);
-					ErrorStatusRead = GetLastError();
-
-					// Open the feature handle
-					FeatureHandle = CreateFile((DevIntfDetailData->DevicePath),
-						GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, 0);
-					ErrorStatusFeature = GetLastError();
-					
-					// Open the report handle
-					ReportHandle = CreateFile((DevIntfDetailData->DevicePath),
-						GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, 0);
-					ErrorStatusReport = GetLastError();
-
-					// Check to see if we opened the handles successfully
-					if ((ErrorStatusWrite == ERROR_SUCCESS) && (ErrorStatusRead == ERROR_SUCCESS) && (ErrorStatusFeature == ERROR_SUCCESS) && (ErrorStatusReport == ERROR_SUCCESS))
-					{
-						OutputDebugString("findDevice: Success ! Device is now attached");
-
-						// Handles opened successfully, device is now attached
-						deviceAttached = TRUE;
-						deviceAttachedButBroken = FALSE;
-
-						// Start the device communication worker thread
-						usbWorkerThreadHandle = CreateThread(NULL, 0, &usbWorkerThread, 0, 0, NULL);	
-					}
-					else
-					{
-						OutputDebugString("findDevice: Failed ! Something went wrong... Can't use the device :(");
-
-						// Something went wrong... If we managed to open either handle close them
-						// and set deviceAttachedButBroken since we found the device but, for some
-						// reason, can't use it.
-						if(ErrorStatusWrite == ERROR_SUCCESS)
-							CloseHandle(WriteHandle);
-						if(ErrorStatusRead == ERROR_SUCCESS)
-							CloseHandle(ReadHandle);
-						if (ErrorStatusFeature == ERROR_SUCCESS)
-							CloseHandle(FeatureHandle);
-						if (ErrorStatusReport == ERROR_SUCCESS)
-							CloseHandle(ReportHandle);
-
-						deviceAttached = FALSE;
-						deviceAttachedButBroken = TRUE;
-					}
-				}
-			}
-
-			HeapFree(GetProcessHeap(), 0, DevIntfDetailData);
-
-			if (deviceAttached || deviceAttachedButBroken)
-				break;
-
-			// Device not found, continue looping
-			SetupDiEnumDeviceInterfaces(
-				hDevInfo, NULL, &GUID_DEVINTERFACE_USB_DEVICE, ++dwMemberIdx, &DevIntfData);
-		}
-
-		SetupDiDestroyDeviceInfoList(hDevInfo);
-	}
-} // END findDevice
-
-
-// This public method requests that device notification messages are sent to the calling form
-// which the form must catch with a WndProc override.
-//
-// You will need to supply the handle of the calling form for this to work, usually
-// specified with 'this->form'.  Something like the following line needs to be placed
-// in the form's contructor method:
-// 
-// a_usbHidCommunication.requestDeviceNotificationsToForm(this->Handle);
-//
-static void requestDeviceNotificationsToForm(HANDLE handleOfWindow)
-{
-	// Define the Globally Unique Identifier (GUID) for HID class devices:
-	GUID InterfaceClassGuid = {0x4d1e55b2, 0xf16f, 0x11cf, 0x88, 0xcb, 0x00, 0x11, 0x11, 0x00, 0x00, 0x30};
-
-	// Register for WM_DEVICECHANGE notifications.  This code uses these messages to detect
-	// plug and play connection/disconnection events for USB devices
-	DEV_BROADCAST_DEVICEINTERFACE myDeviceBroadcastHeader;
-	myDeviceBroadcastHeader.dbcc_devicetype = DBT_DEVTYP_DEVICEINTERFACE;
-	myDeviceBroadcastHeader.dbcc_size = sizeof(DEV_BROADCAST_DEVICEINTERFACE);
-	myDeviceBroadcastHeader.dbcc_reserved = 0;
-	myDeviceBroadcastHeader.dbcc_classguid = InterfaceClassGuid;
-	RegisterDeviceNotification((HANDLE)handleOfWindow, &myDeviceBroadcastHeader, DEVICE_NOTIFY_WINDOW_HANDLE);
-}
-
-// This public method filters WndProc notification messages for the required
-// device notifications and triggers a re-detection of the USB device if required.
-//
-// The main form of the application needs to include an override of the WndProc
-// class for this to be called, usually this is defined as a protected method
-// of the main form and looks like the following:
-//
-// protected: virtual void WndProc(Message% m) override
-//		{
-//			a_usbHidCommunication.handleDeviceChangeMessages(m, vid, pid);
-//			Form::WndProc( m ); // Call the original method
-//		} // END WndProc method
-//
-static void handleDeviceChangeMessages(UINT uMsg, WPARAM wParam, LPARAM lParam, int vid, int pid)
-{
-		if(uMsg == WM_DEVICECHANGE)
-		{
-			if(((int)wParam == DBT_DEVICEARRIVAL) || ((int)wParam == DBT_DEVICEREMOVEPENDING) ||
-				((int)wParam == DBT_DEVICEREMOVECOMPLETE) || ((int)wParam == DBT_CONFIGCHANGED) )
-			{
-			// Check the device is still available
-			findDevice(vid, pid); // VID, PID
-			}
-		}
-}
-
-// This private method detaches the USB device and forces the 
-// worker threads to cancel IO and abort if required.
-// If the USB device stops responding to the read/write
-// operations (due to a software or firmware bug) you can use
-// this method to recover back into a known state.
-static void detachBrokenDevice()
-{
-	if (deviceAttached == TRUE)
-	{
-		OutputDebugString("detachBrokenDevice: Detaching broken device...");
-
-		if (workerThreadState != idle)
-		{
-			// Cancel any pending IO operations
-			CancelIoEx(WriteHandle, NULL);
-			CancelIoEx(ReadHandle, NULL);
-			CancelIoEx(FeatureHandle, NULL);
-			CancelIoEx(ReportHandle, NULL);
-
-			// Clear the worker thread flags
-			workerThreadState = idle;
-		}
-
-		// Unattach the device and indicate it is broken
-		deviceAttached = FALSE;
-		deviceAttachedButBroken = TRUE;
-
-		// Abort the worker thread
-		CloseHandle(usbWorkerThreadHandle);
-
-		// Close the device file handles
-		CloseHandle(WriteHandle);
-		CloseHandle(ReadHandle);
-		CloseHandle(FeatureHandle);
-		CloseHandle(ReportHandle);
-	}
-} // END detachBrokenUsbDevice Method
-
-
-// Define public method for reading the deviceAttached flag
-
-static BOOL isDeviceAttached(void)
-{
-	return deviceAttached;
-} // END isDeviceAttached method
-
-// Define public method for reading the deviceAttachedButBroken flag
-
-static BOOL isDeviceBroken(void)
-{
-	return deviceAttachedButBroken;
-} // END isDeviceBroken method
-			
-
-// The following private method waits for the worker thread to become
-// idle before returning.
-static BOOL waitForTheWorkerThreadToBeIdle(BOOL checkForTimeOut)
-{
-	int timeOutCounter = 0;
-
-	// Note: This is probably not ideal since it blocks the thread
-	//		 while it waits, but the USB communication is synchronous i.e.
-	//		 it matters what order the commands are sent and receieved...
-	while (workerThreadState != idle && workerThreadState != terminated &&
-		(timeOutCounter < 600))
-	{
-		Sleep(5);
-
-		if (checkForTimeOut)
-			timeOutCounter++;
-	}
-
-	// Did we timeout after 3 seconds?
-	if (workerThreadState != idle  && workerThreadState != terminated &&
-		(timeOutCounter >= 600))
-	{
-		OutputDebugString("waitForTheWorkerThreadToBeIdle: Worker thread timed out, detaching the USB device...");
-		// We timed out... something is blocking the worker thread and it's not
-		// responding.  This is probably due to a firmware/software bug where a 
-		// write/read operation was performed and the thread is still waiting for
-		// a read which is not coming.
-		//
-		// Let's detach the USB device to return us into a known state...
-		detachBrokenDevice();
-		return FALSE;
-	}
-
-	return TRUE;
-} // END waitForTheWorkerThreadToBeIdle method
-
-// The following method forces a feature request to the USB device (the device must have been found first!)
-static BOOL forceFeature(int usbCommandId)
-{
-	// Variables for tracking how much is read and written
-	DWORD bytesRead = 0;				
-	unsigned char * unmanagedFeatureBuffer = &featureBuffer[0];				
-	char strCommandId[40];
-
-	// Check to see if the device is already found
-	if (deviceAttached == FALSE)
-	{
-		// There is no device to communicate with... Exit with error status
-		return FALSE;
-	}
-
-	snprintf(strCommandId, 40, "forceFeature:command:%d", usbCommandId);
-	OutputDebugString(strCommandId);					
-
-	// The first byte of the input and feature buffers should be set to zero (this is not
-	// sent to the USB device)
-	inputBuffer[0] = 0;
-	featureBuffer[0] = 0;
-
-	// The second byte of the feature buffer contains the command to the USB device
-	// (the rest of the buffer is available for data transfer)
-	inputBuffer[1] = 0xFF;
-	featureBuffer[1] = usbCommandId;
-
-	// Get the packet from the USB device
-	OutputDebugString("forceFeature: Set feature to the USB device");
-	if (HidD_SetFeature(FeatureHandle, unmanagedFeatureBuffer, 65))
-	{
-		// We need to read the return from the device
-
-		// Map the managed data array from the class to an unmanaged
-		// pointer for the ReadFile function
-		// unsigned char * unmanagedInputBuffer = &inputBuffer[0];
-
-		// Get the packet from the USB device
-		// ReadFile(FeatureHandle, unmanagedInputBuffer, 65, &bytesRead, 0);
-					
-		// Return with success
-		return TRUE;
-	}
-	else
-		OutputDebugString("forceFeature: /!\\ Failed to set feature to the USB device");
-
-	return FALSE;
-}
-
-// The following method gets a report request from the USB device (the device must have been found first!)
-static byte getInputReport()
-{
-	// Variables for tracking how much is read
-	DWORD bytesRead = 0;
-	byte returnValue= NULL;
-	unsigned char *reportBuffer = (unsigned char *)malloc(65);
-	unsigned char * unmanagedReportBuffer = &reportBuffer[0];
-	char strCommandId[40];
-
-	// Check to see if the device is already found
-	if (deviceAttached == FALSE)
-	{
-		// There is no device to communicate with... Exit with error status
-		return NULL;
-	}
-
-	// The first byte of the report buffer should be set to zero (this is not
-	// sent to the USB device)
-	reportBuffer[0] = 0;
-	reportBuffer[1] = 0xFF;
-
-	// Get the input report from the USB device
-	OutputDebugString("getInputReport: Get input report from the USB device");
-	if (HidD_GetInputReport(FeatureHandle, unmanagedReportBuffer, 65))
-	{
-		snprintf(strCommandId, 40, "getInputReport:%d", reportBuffer[1]);
-		OutputDebugString(strCommandId);
-
-		// Return with success
-		returnValue = reportBuffer[1];
-	}
-	else
-		OutputDebugString("getInputReport: /!\\ Failed to get input report to the USB device");
-
-	free(reportBuffer);
-	return returnValue;
-}
-
-// The following method gets a feature request from the USB device (the device must have been found first!)
-static byte getFeature()
-{
-	// Variables for tracking how much is read
-	DWORD bytesRead = 0;				
-	unsigned char * unmanagedFeatureBuffer = &featureBuffer[0];				
-	char strCommandId[40];
-	
-	// Check to see if the device is already found
-	if (deviceAttached == FALSE)
-	{
-		// There is no device to communicate with... Exit with error status
-		return NULL;
-	}
-
-	// The first byte of the feature buffers should be set to zero (this is not
-	// sent to the USB device)
-	featureBuffer[0] = 0;
-	featureBuffer[1] = 0xFF;
-
-	// Get the packet from the USB device
-	OutputDebugString("getFeature: Get feature from the USB device");
-	if (HidD_GetFeature(FeatureHandle, unmanagedFeatureBuffer, 65))
-	{
-		snprintf(strCommandId, 40, "getFeature:%d", featureBuffer[1]);
-		OutputDebugString(strCommandId);
-
-		// Return with success
-		return featureBuffer[1];
-	}
-	else
-		OutputDebugString("getFeature: /!\\ Failed to get feature to the USB device");
-
-	return NULL;
-}
-
-// The following method sends a feature request to the USB device (the device must have been found first!)
-static BOOL sendFeature(int usbCommandId)
-{
-	char strCommandId[40];
-
-	// Check to see if the device is already found
-	if (deviceAttached == FALSE)
-	{
-		// There is no device to communicate with... Exit with error status
-		return FALSE;
-	}
-
-	//OutputDebugString("sendFeature");
-
-	// Wait for the worker thread to be idle before continuing
-	if (waitForTheWorkerThreadToBeIdle(TRUE))
-	{
-		snprintf(strCommandId, 40, "sendFeature:command:%d", usbCommandId);
-		OutputDebugString("sendFeature: Worker thread is idle, setting command ID and state to SetFeature...");
-		OutputDebugString(strCommandId);
-
-		// The first byte of the input and feature buffers should be set to zero (this is not
-		// sent to the USB device)
-		inputBuffer[0] = 0;
-		featureBuffer[0] = 0;
-
-		// The second byte of the feature buffer contains the command to the USB device
-		// (the rest of the buffer is available for data transfer)
-		inputBuffer[1] = 0xFF;
-		featureBuffer[1] = usbCommandId;					
-
-		// Write the buffer to the device and then read to the input buffer
-		workerThreadState = setFeature;
-
-		// Return with success
-		return TRUE;
-	}
-	else return FALSE;
-}
-
-// The following method sends a command to the USB device (the device must have been found first!)
-// This method is for commands that are sent, but no input is returned from the device
-static BOOL sendCommandWriteOnly(int usbCommandId)
-{
-	char strCommandId[40];
-
-	// Check to see if the device is already found
-	if (deviceAttached == FALSE)
-	{
-		// There is no device to communicate with... Exit with error status
-		return FALSE;
-	}
-
-	//OutputDebugString("sendCommandWriteOnly");
-
-	// Wait for the worker thread to be idle before continuing
-	if (waitForTheWorkerThreadToBeIdle(TRUE))
-	{
-		snprintf(strCommandId, 40, "sendCommandWriteOnly:command:%d", usbCommandId);
-		OutputDebugString("sendCommandWriteOnly: Worker thread is idle, setting command ID and state to Write...");
-		OutputDebugString(strCommandId);
-
-		// The first byte of the input and output buffers should be set to zero (this is not
-		// sent to the USB device)
-		outputBuffer[0] = 0;
-
-		// The second byte of the output buffer contains the command to the USB device
-		// (the rest of the buffer is available for data transfer)
-		outputBuffer[1] = usbCommandId;
-
-		// Write the buffer to the device
-		workerThreadState = write;
-
-		// Return with success
-		return TRUE;
-	} else return FALSE;
-				
-} // END sendUsbCommandWriteOnly Method
-
-
-// The following method sends a command to the USB device (the device must have been found first!)
-// This method is for commands that are sent and expect a reply
-static BOOL sendCommandWriteRead(int usbCommandId)
-{
-	// Check to see if the device is already found
-	if (deviceAttached == FALSE)
-	{
-		// There is no device to communicate with... Exit with error status
-		return FALSE;
-	}
-
-	//OutputDebugString("sendCommandWriteRead");
-
-	// Wait for the worker thread to be idle before continuing
-	if (waitForTheWorkerThreadToBeIdle(TRUE))
-	{
-		OutputDebugString("sendCommandWriteRead: Worker thread is idle, setting command ID and state to WriteRead...");
-
-		// The first byte of the input and output buffers should be set to zero (this is not
-		// sent to the USB device)
-		outputBuffer[0] = 0;
-		inputBuffer[0] = 0;
-
-		// The second byte of the output buffer contains the command to the USB device
-		// (the rest of the buffer is available for data transfer)
-		outputBuffer[1] = usbCommandId;
-		inputBuffer[1] = 0xFF;
-
-		// Write the buffer to the device and then read to the input buffer
-		workerThreadState = writeRead;
-
-		// Return with success
-		return TRUE;
-	}
-	else return FALSE;
-} // END sendUsbCommandReadWrite Method
-
-static BOOL receiveCommand()
-{
-	// Check to see if the device is already found
-	if (deviceAttached == FALSE)
-	{
-		// There is no device to communicate with... Exit with error status
-		return FALSE;
-	}
-
-	//OutputDebugString("receiveCommand");
-
-	// Wait for the worker thread to be idle before continuing
-	if (waitForTheWorkerThreadToBeIdle(TRUE))
-	{
-		OutputDebugString("receiveCommand: Worker thread is idle, setting state to Read...");
-
-		// The first byte of the input buffer should be set to zero (this is not
-		// sent to the USB device)
-		inputBuffer[0] = 0;
-		inputBuffer[1] = 0xFF;
-
-		// Write the buffer to the device and then read to the input buffer
-		workerThreadState = read;
-
-		// Return with success
-		return TRUE;
-	}
-	return FALSE;
-}
-
-// This public method allows writing to the output buffer
-// Note: you cannot write to byte 0 as these are reserved
-//       by the command communication - bytes 1 to 64 are available
-//		 for data
-static BOOL writeToTheOutputBuffer(int byteNumber, byte value)
-{
-	// Do not allow writing to byte 0 or 1, this is ignored
-	if (byteNumber < 1) return FALSE;
-
-	// Do not allow writing to bytes beyond the array size
-	if (byteNumber > 64) return FALSE;
-
-	// Ensure that the worker thread has finished reading before
-	// writing the data to the output buffer.
-	waitForTheWorkerThreadToBeIdle(FALSE);
-
-	// Write the byte to the output buffer
-	outputBuffer[byteNumber] = value;
-
-	return TRUE;
-} // END writeToTheOutputBuffer method
-
-
-// This public method allows reading from the input buffer
-// Note: you cannot read from byte 0  as these are reserved
-//       by the command communication - bytes 1 to 64 are available
-//		 for data
-static byte readFromTheInputBuffer(int byteNumber)
-{
-	// Do not allow reading from byte 0 or 1, just return zero
-	if (byteNumber < 1) return -1;
-
-	// Do not allow reading from bytes beyond the array size, just return zero
-	if (byteNumber > 64) return -1;
-
-	// Ensure that the worker thread has finished reading before
-	// grabbing the data from the input buffer.
-	waitForTheWorkerThreadToBeIdle(FALSE);
-
-	return inputBuffer[byteNumber];
-} // END readFromTheInputBuffer method
-
-// This public method allows reading from the feature buffer
-// Note: you cannot read from byte 0 as these are reserved
-//       by the command communication - bytes 1 to 64 are available
-//		 for data
-static byte readFromTheFeatureBuffer(int byteNumber)
-{
-	// Do not allow reading from byte 0 or 1, just return zero
-	if (byteNumber < 1) return -1;
-
-	// Do not allow reading from bytes beyond the array size, just return zero
-	if (byteNumber > 64) return -1;
-
-	// Ensure that the worker thread has finished reading before
-	// grabbing the data from the input buffer.
-	waitForTheWorkerThreadToBeIdle(FALSE);
-
-	return featureBuffer[byteNumber];
-} // END readFromTheFeatureBuffer method
-
-// This public method allows writing to the feature buffer
-// Note: you cannot write to byte 0 as these are reserved
-//       by the command communication - bytes 1 to 64 are available
-//		 for data
-static BOOL writeToTheFeatureBuffer(int byteNumber, byte value)
-{
-	// Do not allow writing to byte 0 or 1, this is ignored
-	if (byteNumber < 1) return FALSE;
-
-	// Do not allow writing to bytes beyond the array size
-	if (byteNumber > 64) return FALSE;
-
-	// Ensure that the worker thread has finished reading before
-	// writing the data to the output buffer.
-	waitForTheWorkerThreadToBeIdle(FALSE);
-
-	// Write the byte to the output buffer
-	featureBuffer[byteNumber] = value;
-
-	return TRUE;
-} // END writeToTheFeatureBuffer method
-
-// UsbHidCommunicator factory
-UsbHidCommunication CreateUsbHidCommunicator()
-{
-	UsbHidCommunication communicator;
-	communicator.detachBrokenDevice = detachBrokenDevice;
-	communicator.detachDevice = detachDevice;
-	communicator.finalizeUsbHidCommunication = finalizeUsbHidCommunication;
-	communicator.findDevice = findDevice;
-	communicator.forceFeature = forceFeature;
-	communicator.getInputReport = getInputReport;
-	communicator.getFeature = getFeature;
-	communicator.handleDeviceChangeMessages = handleDeviceChangeMessages;
-	communicator.initUsbHidCommunication = initUsbHidCommunication;
-	communicator.isDeviceAttached = isDeviceAttached;
-	communicator.isDeviceBroken = isDeviceBroken;
-	communicator.readFromTheFeatureBuffer = readFromTheFeatureBuffer;
-	communicator.readFromTheInputBuffer = readFromTheInputBuffer;
-	communicator.receiveCommand = receiveCommand;
-	communicator.requestDeviceNotificationsToForm = requestDeviceNotificationsToForm;
-	communicator.sendCommandWriteOnly = sendCommandWriteOnly;
-	communicator.sendCommandWriteRead = sendCommandWriteRead;
-	communicator.sendFeature = sendFeature;
-	communicator.writeToTheFeatureBuffer = writeToTheFeatureBuffer;
-	communicator.writeToTheOutputBuffer = writeToTheOutputBuffer;
-
-	return communicator;
-}
\ No newline at end of file
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ * Copyright (C) 2010 Simon Inns
+ * 
+ * HID USB communication functions
+ * usbHidCommunication.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ * Code adapted from usbHidCommunication
+ * v1_1 2010-03-31
+ * Simon Inns (simon.inns@gmail.com)
+ * http://www.waitingforfriday.com
+ * 
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software: 
+ *	you can redistribute it and/or modify it under the terms of the 
+ *	GNU General Public License as published by the Free Software Foundation, 
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope 
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the 
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin. 
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "stdafx.h"
+
+#include "flightRecorder.h"
+#include "hidDeviceModel.h"
+#include "hidRequest.h"
+#include "hidTransport.h"
+#include "ledAnimation.h"
+#include "ledCompositor.h"
+#include "platform.h"
+#include "reportQueue.h"
+#include "statistics.h"
+#include "timerWheel.h"
+#include "usbHidCommunication.h"
+
+// Time (nanoseconds) a device has to complete a transfer, it is considered broken otherwise.
+// A feature or output report transfer takes a few milliseconds.
+#define HID_REQUEST_TIMEOUT 500000000ULL
+
+// Time (nanoseconds) the event loop has to return from the transfer of a broken device once its IO
+// is cancelled, the event loop is abandoned to the transfer and replaced otherwise
+#define EVENT_LOOP_ABANDON_TIMEOUT 200000000ULL
+
+// Delays (nanoseconds) between the attempts to reopen a broken device, doubled on every failure
+#define RECOVERY_MIN_DELAY 10000000ULL
+#define RECOVERY_MAX_DELAY 2000000000ULL
+
+// Period (milliseconds) the recovery supervisor checks the transfers in progress at
+#define RECOVERY_WATCHDOG_PERIOD ((DWORD) (HID_REQUEST_TIMEOUT / 2000000ULL))
+
+// Cached device button/LED register value until the first one is known
+#define DEVICE_STATE_UNKNOWN -1
+
+// Feature writes tracked until their echo is read (power of two), and the time (nanoseconds)
+// an echo is waited for : a write not echoed by then is forgotten
+#define ECHO_TRACKER_SIZE 16
+#define ECHO_TIMEOUT 250000000ULL
+
+// Expected echo entry : the sequence of the write (from 1) above the cancelled flag and the state written
+#define ECHO_SEQUENCE_SHIFT 9
+#define ECHO_CANCELLED 0x100
+
+// Feature write whose echo is expected, published by its entry (written last)
+typedef struct ExpectedEcho
+{
+	volatile long long entry;
+	volatile long long writeTime;
+} ExpectedEcho;
+
+// State of a device slot : closed, being opened, served by the event loop, being detached
+// (the event loop leaves it alone) or to be closed by the event loop
+enum DeviceSlotState {slotClosed, slotOpening, slotServed, slotDetaching, slotClosing};
+
+struct UsbHidDevice
+{
+	int deviceIndex;
+
+	// Path of the device found or plugged in, empty while the slot is free
+	char devicePath[HID_DEVICE_PATH_SIZE];
+
+	// Private variables for holding the device found state and the
+	// operating system access to the device. The flags are read by any thread.
+	volatile long long deviceAttached;
+	volatile long long deviceAttachedButBroken;
+	HidDevice *hidDevice;
+	volatile long long slotState;
+
+	// Report layout of the device, from its report descriptor
+	HidDeviceModel model;
+
+	// Private variables to store the input and output
+	// buffers for USB communication, inline and on their own cache lines
+	// so that no report transfer allocates nor shares a line with the counters.
+	// The data of the commands, the last report received (receiveCommand thread)
+	// and the last feature got (event loop only, read once getFeature returns).
+	PLATFORM_CACHE_ALIGNED unsigned char outputBuffer[REPORT_SIZE];
+	PLATFORM_CACHE_ALIGNED unsigned char inputBuffer[REPORT_SIZE];
+	PLATFORM_CACHE_ALIGNED unsigned char featureBuffer[REPORT_SIZE];
+
+	// Requests submitted to the event loop, waiting to be transferred
+	PLATFORM_CACHE_ALIGNED HidRequestQueue requestQueue;
+
+	// Time (nanoseconds) a request transfer has been last started, 0 while no transfer is in progress
+	volatile long long requestStartTime;
+
+	// Input reports read by the event loop, waiting to be received
+	ReportQueue reportQueue;
+
+	// Cache of the device button/LED register, the status layer of its LEDs : the features written
+	// and the buttons toggled by the user (DEVICE_STATE_UNKNOWN until the first one is known)
+	PLATFORM_CACHE_ALIGNED volatile long long deviceState;
+
+	// Timestamp and button model register of the last input report received
+	unsigned long long inputReportTime;
+	byte inputState;
+
+	// Feature writes whose echo has not been read yet (devices echoing their LEDs) : claimed
+	// by the threads writing a feature (echoWrites), consumed by the event loop (echoReads)
+	ExpectedEcho expectedEchoes[ECHO_TRACKER_SIZE];
+	volatile long long echoWrites;
+	long long echoReads;
+
+	// Whether the last input report received is the echo of a feature write
+	BOOL inputEcho;
+
+	// Event loop side : reads failing (device unplugged) until the next wake up,
+	// and the event signaled once the device is closed
+	BOOL readFailed;
+	PlatformEvent *closedEvent;
+
+	// Recovery of a broken device : set by any thread finding it broken (see reportBrokenDevice),
+	// the time it was found broken (0 while it is not recovering), the time of the next attempt
+	// to reopen it and the delay before the following one (recovery supervisor only)
+	volatile long long brokenReported;
+	volatile long long brokenTime;
+	unsigned long long nextRecoveryTime;
+	unsigned long long recoveryDelay;
+
+	// Last feature (LED state) requested, replayed once the device is recovered (-1 for none)
+	volatile long long requestedFeature;
+
+	// LED layers shown over the device state, whether one changed since the LEDs were last shown
+	// (set by any thread, taken by the event loop) and the register shown : the last one written
+	// to the device or reported by it (DEVICE_STATE_UNKNOWN until then, event loop side)
+	LedCompositor compositor;
+	volatile long long layersChanged;
+	long long shownState;
+
+	// LED animations played by the event loop on the animation layer, the timer of their next keyframe
+	// and whether they must be advanced (keyframe over, animation started or cancelled)
+	LedAnimator animator;
+	WheelTimer animationTimer;
+	BOOL animationDue;
+};
+
+static HidTransport transport;
+
+// Device registry, the slots are reused by every findDevices
+static UsbHidDevice devices[USB_HID_MAX_DEVICES];
+static volatile long long deviceCount = 0;
+
+// Event loop thread definitions
+static PlatformThread *usbEventLoopThreadHandle = NULL;
+
+// State for the event loop thread
+enum eWorkerThreadState workerThreadState = idle;
+
+// Event signaled when a request is queued or a device is detached
+static PlatformEvent *eventLoopWakeEvent = NULL;
+
+// Set by the first request or layer change since the event loop last looked at the devices :
+// the ones after it don't signal the wake event again (a system call on every submission otherwise)
+static volatile long long eventLoopWakePending = 0;
+
+// Generation of the event loop thread serving the devices, an event loop of an older
+// generation (abandoned while stuck in a transfer) exits without touching the devices
+static volatile long long eventLoopGeneration = 0;
+
+// Recovery supervisor thread, reopening the broken devices
+static PlatformThread *recoveryThreadHandle = NULL;
+static PlatformEvent *recoveryWakeEvent = NULL;
+static volatile long long recoveryRunning = 0;
+
+// File the flight recorder is dumped to when a device is found broken (NULL for none),
+// and the dump requested to the recovery supervisor
+static const char *flightRecorderPath = NULL;
+static volatile long long flightRecorderDumpRequested = 0;
+
+// Next device receiveCommand looks at first
+static int nextReceivedDevice = 0;
+
+// Event signaled when a device is attached, to release receiveCommand
+static PlatformEvent *deviceArrivalEvent = NULL;
+
+// Set by releaseCommandWaiters (manual reset) : receiveCommand returns no device from then on
+static PlatformEvent *commandReleaseEvent = NULL;
+static volatile long long commandWaitersReleased = 0;
+
+// VID and PID of the devices the hotplug monitor attaches (zero terminated)
+static UsbDeviceId hotplugDeviceIds[USB_HID_MAX_DEVICE_IDS + 1];
+
+static DWORD WINAPI usbEventLoopThread(LPVOID pData);
+static DWORD WINAPI usbRecoveryThread(LPVOID pData);
+static HidRequest *submitRequest(UsbHidDevice *device, enum HidRequestType type, const unsigned char *buffer, HidRequestCallback callback, LPVOID context);
+static HidRequest *submitFeatureLeds(UsbHidDevice *device, byte mask, byte leds, HidRequestCallback callback, LPVOID context);
+
+// Expects the echo of a feature write, before the transfer : the echo may be read before it returns.
+// Returns the sequence of the write. Lock free, any thread writing a feature may call it.
+static long long expectEcho(UsbHidDevice *device, byte state)
+{
+	long long sequence = addAtomic64(&device->echoWrites, 1);
+	ExpectedEcho *echo = &device->expectedEchoes[(sequence - 1) & (ECHO_TRACKER_SIZE - 1)];
+
+	storeAtomic64(&echo->writeTime, (long long) getMonotonicTime());
+	storeAtomic64(&echo->entry, (sequence << ECHO_SEQUENCE_SHIFT) | state);
+	return sequence;
+}
+
+// Cancels the expected echo of a feature write that failed, unless overwritten by a later write meanwhile
+static void cancelEcho(UsbHidDevice *device, long long sequence, byte state)
+{
+	ExpectedEcho *echo = &device->expectedEchoes[(sequence - 1) & (ECHO_TRACKER_SIZE - 1)];
+
+	compareExchangeAtomic64(&echo->entry, (sequence << ECHO_SEQUENCE_SHIFT) | state, (sequence << ECHO_SEQUENCE_SHIFT) | ECHO_CANCELLED);
+}
+
+// Classifies an input report of the event loop as the echo of a feature write, or a change made by the user.
+// The report is the echo of the oldest write expected with its state : the writes before it are echoed
+// by this one (the device reports its register once for writes in a row). A write cancelled, not echoed
+// in time or overwritten in the tracker is skipped. Constant time, at most ECHO_TRACKER_SIZE writes looked at.
+static BOOL isFeatureEcho(UsbHidDevice *device, byte state, unsigned long long now)
+{
+	long long writes = loadAtomic64(&device->echoWrites);
+	long long sequence;
+
+	if (writes - device->echoReads > ECHO_TRACKER_SIZE)
+		device->echoReads = writes - ECHO_TRACKER_SIZE;
+
+	for (sequence = device->echoReads + 1; sequence <= writes; sequence++)
+	{
+		ExpectedEcho *echo = &device->expectedEchoes[(sequence - 1) & (ECHO_TRACKER_SIZE - 1)];
+		long long entry = loadAtomic64(&echo->entry);
+		BOOL expired;
+
+		// Claimed but not published yet : this write and the next ones are not transferred yet
+		if ((entry >> ECHO_SEQUENCE_SHIFT) != sequence)
+			break;
+
+		expired = (entry & ECHO_CANCELLED) || now > (unsigned long long) loadAtomic64(&echo->writeTime) + ECHO_TIMEOUT;
+		if (!expired && (byte) entry == state)
+		{
+			device->echoReads = sequence;
+			return TRUE;
+		}
+
+		// The oldest writes that won't be echoed anymore are forgotten
+		if (expired && sequence == device->echoReads + 1)
+			device->echoReads = sequence;
+	}
+
+	return FALSE;
+}
+
+// Transfers a button model register as the LED report of the device, feature or output report,
+// of its own length. The echo of the write is expected from the devices echoing their LEDs.
+static BOOL writeLeds(UsbHidDevice *device, byte state)
+{
+	unsigned char ledReport[REPORT_SIZE];
+	DWORD ledReportLength = encodeHidLeds(&device->model, state, ledReport);
+	long long echoSequence = 0;
+	BOOL written;
+
+	if (device->model.echoesLedState)
+		echoSequence = expectEcho(device, state);
+
+	if (device->model.ledReport == hidLedsInOutput)
+	{
+		written = transport.writeReport(device->hidDevice, ledReport, ledReportLength);
+		recordFlight(flightOutputReport, device->deviceIndex, written ? flightSucceeded : flightFailed, ledReport, ledReportLength, getMonotonicTime());
+	}
+	else
+	{
+		written = transport.setFeature(device->hidDevice, ledReport, ledReportLength);
+		recordFlight(flightSetFeature, device->deviceIndex, written ? flightSucceeded : flightFailed, ledReport, ledReportLength, getMonotonicTime());
+	}
+
+	if (!written && echoSequence != 0)
+		cancelEcho(device, echoSequence, state);
+
+	return written;
+} // END writeLeds method
+
+// Reads the button/LED register of a device from its input report.
+// For a device not echoing its LEDs, these are its buttons.
+static BOOL readDeviceRegister(UsbHidDevice *device, byte *state)
+{
+	unsigned char reportBuffer[REPORT_SIZE];
+
+	memset(reportBuffer, 0, device->model.inputReportLength);
+	reportBuffer[0] = device->model.inputReportId;
+
+	if (!transport.getInputReport(device->hidDevice, reportBuffer, device->model.inputReportLength)
+		|| !decodeHidButtons(&device->model, reportBuffer, device->model.inputReportLength, state))
+	{
+		recordFlight(flightGetInputReport, device->deviceIndex, flightFailed, NULL, 0, getMonotonicTime());
+		OutputDebugString("resyncDeviceState: /!\\ Failed to get input report to the USB device");
+		return FALSE;
+	}
+
+	recordFlight(flightGetInputReport, device->deviceIndex, flightSucceeded, reportBuffer, device->model.inputReportLength, getMonotonicTime());
+	return TRUE;
+} // END readDeviceRegister method
+
+// Shows the LEDs of a device : its state (the status layer) under the layers of its compositor.
+// Only the event loop writes the LEDs, once for all the layers changed, and only when the device
+// does not show them already : the subsystems setting their layer at once never write the device in turn.
+static enum FeatureWriteResult showLeds(UsbHidDevice *device)
+{
+	long long deviceState = loadAtomic64(&device->deviceState);
+	byte leds;
+
+	// A device without LED holds whatever is requested
+	if (device->model.ledReport == hidLedsNone)
+		return featureUnchanged;
+
+	// The layers are shown over the register the device holds, read first while unknown
+	if (deviceState == DEVICE_STATE_UNKNOWN)
+	{
+		byte state;
+
+		if (!hasLedCompositorOverlays(&device->compositor))
+			return featureUnchanged;
+		if (!readDeviceRegister(device, &state))
+			return featureWriteFailed;
+
+		compareExchangeAtomic64(&device->deviceState, DEVICE_STATE_UNKNOWN, state);
+		device->shownState = state;
+		deviceState = loadAtomic64(&device->deviceState);
+	}
+
+	leds = composeLeds(&device->compositor, (byte) deviceState);
+	if (leds == device->shownState)
+		return featureUnchanged;
+
+	if (!writeLeds(device, leds))
+	{
+		// The LEDs shown are not known anymore, written again with the next change
+		device->shownState = DEVICE_STATE_UNKNOWN;
+		return featureWriteFailed;
+	}
+
+	device->shownState = leds;
+	return featureWritten;
+} // END showLeds method
+
+// Sets the LEDs of a mask in the device state, the others are left as they are :
+// read from the device first while unknown
+static void setDeviceStateLeds(UsbHidDevice *device, byte mask, byte leds)
+{
+	long long deviceState = loadAtomic64(&device->deviceState);
+	byte state = 0;
+
+	if (deviceState == DEVICE_STATE_UNKNOWN && mask != 0xFF && readDeviceRegister(device, &state))
+		compareExchangeAtomic64(&device->deviceState, DEVICE_STATE_UNKNOWN, state);
+
+	do
+	{
+		deviceState = loadAtomic64(&device->deviceState);
+		state = deviceState == DEVICE_STATE_UNKNOWN ? 0 : (byte) deviceState;
+	} while (!compareExchangeAtomic64(&device->deviceState, deviceState, (state & ~mask) | (leds & mask)));
+} // END setDeviceStateLeds method
+
+// Reads the register of the device into the device state, on the event loop (see resyncDeviceState).
+// Once known, the state is kept while layers are shown above it : the register shows these.
+static BOOL resyncRegister(UsbHidDevice *device, byte *state)
+{
+	long long deviceState = loadAtomic64(&device->deviceState);
+
+	if (deviceState != DEVICE_STATE_UNKNOWN && hasLedCompositorOverlays(&device->compositor))
+	{
+		*state = (byte) deviceState;
+		return TRUE;
+	}
+
+	if (!readDeviceRegister(device, state))
+		return FALSE;
+
+	storeAtomic64(&device->deviceState, *state);
+	return TRUE;
+} // END resyncRegister method
+
+// Reads the LEDs of a device from its feature report, on the event loop (see getFeature)
+static BOOL readFeatureLeds(UsbHidDevice *device, byte *leds)
+{
+	// The first byte of the feature buffers holds the report ID (this is not
+	// sent to the USB device when the device does not number its reports)
+	memset(device->featureBuffer, 0, device->model.featureReportLength);
+	device->featureBuffer[0] = device->model.featureReportId;
+
+	// Get the packet from the USB device, its LEDs are stored as the button model register
+	if (!transport.getFeature(device->hidDevice, device->featureBuffer, device->model.featureReportLength))
+	{
+		OutputDebugString("getFeature: /!\\ Failed to get feature to the USB device");
+		recordFlight(flightGetFeature, device->deviceIndex, flightFailed, NULL, 0, getMonotonicTime());
+		return FALSE;
+	}
+
+	recordFlight(flightGetFeature, device->deviceIndex, flightSucceeded, device->featureBuffer, device->model.featureReportLength, getMonotonicTime());
+	*leds = decodeHidLeds(&device->model, device->featureBuffer, device->model.featureReportLength);
+	device->featureBuffer[0] = 0;
+	device->featureBuffer[1] = *leds;
+	return TRUE;
+} // END readFeatureLeds method
+
+// Feature write stage, in front of every feature transfer to the device : the LEDs of the feature are set
+// in the device state, then shown with the layers above it unless another feature follows (features in a row
+// are merged, the last one shows them). A feature leaving the LEDs shown as they are (unchanged,
+// or under a layer above the device state) is not transferred.
+static enum FeatureWriteResult writeFeature(UsbHidDevice *device, byte mask, byte leds, BOOL last)
+{
+	unsigned char feature[2] = {0, leds};
+	enum FeatureWriteResult result = featureUnchanged;
+
+	incrementStatistic(STATISTIC_FEATURES_SUBMITTED);
+	setDeviceStateLeds(device, mask, leds);
+
+	// The layers changed meanwhile are shown with it
+	if (last)
+	{
+		storeAtomic64(&device->layersChanged, 0);
+		result = showLeds(device);
+	}
+
+	if (result == featureUnchanged)
+	{
+		incrementStatistic(STATISTIC_FEATURES_COALESCED);
+		recordFlight(flightSetFeature, device->deviceIndex, flightUnchanged, feature, 2, getMonotonicTime());
+	}
+	else if (result == featureWritten)
+		incrementStatistic(STATISTIC_FEATURES_SENT);
+
+	return result;
+} // END writeFeature method
+
+// Fails the requests the event loop did not transfer
+static void failPendingRequests(UsbHidDevice *device)
+{
+	HidRequest *request = takeHidRequests(&device->requestQueue);
+
+	while (request != NULL)
+	{
+		HidRequest *next = request->next;
+		completeHidRequest(request, FALSE);
+		request = next;
+	}
+}
+
+// Wakes the event loop up for a request or a layer change, unless already woken since it last looked
+// at the devices : it clears the flag before looking at them, so it sees the changes made before setting it.
+static void wakeEventLoop(void)
+{
+	if (exchangeAtomic64(&eventLoopWakePending, 1) == 0)
+		setPlatformEvent(eventLoopWakeEvent);
+}
+
+// Hands a device over to the event loop for closing.
+// The caller owns the slot (slotDetaching) until then.
+static void requestDeviceClosing(UsbHidDevice *device)
+{
+	// Release the thread waiting for a report
+	releaseReportQueue(&device->reportQueue);
+
+	resetPlatformEvent(device->closedEvent);
+	storeAtomic64(&device->slotState, slotClosing);
+	setPlatformEvent(eventLoopWakeEvent);
+}
+
+// This public method detaches the USB device and forces the 
+// event loop to cancel IO and abort if required.
+// This is used when we're done communicating with the device
+static void detachDevice(UsbHidDevice *device)
+{
+	// A device detached on purpose is not recovered
+	if (device != NULL)
+		storeAtomic64(&device->brokenTime, 0);
+	if (device != NULL && loadAtomic64(&device->slotState) == slotServed)
+		recordFlight(flightDeviceDetached, device->deviceIndex, flightSucceeded, NULL, 0, getMonotonicTime());
+
+	// Take the slot over, the event loop does not touch it anymore
+	if (device != NULL && compareExchangeAtomic64(&device->slotState, slotServed, slotDetaching))
+	{
+		OutputDebugString("Detaching device...");
+
+		if (loadAtomic64(&device->requestStartTime) != 0)
+		{
+			OutputDebugString("Cancelling IO ops...");
+
+			// Cancel the transfer in progress
+			transport.cancelIo(device->hidDevice);
+		}
+
+		// Unattach the device
+		storeAtomic64(&device->deviceAttached, FALSE);
+		storeAtomic64(&device->deviceAttachedButBroken, FALSE);
+
+		OutputDebugString("Closing handles...");
+
+		// The event loop closes the device as soon as it is done with its current transfer
+		requestDeviceClosing(device);
+		if (!waitForPlatformEvent(device->closedEvent, 5000))
+			OutputDebugString("detachDevice: /!\\ The event loop did not close the device in time");
+	}
+	else if (device != NULL)
+		storeAtomic64(&device->deviceAttachedButBroken, FALSE);
+} // END detachUsbDevice Method
+
+// This public method detaches all the USB devices
+static void detachDevices()
+{
+	int deviceIndex;
+
+	for (deviceIndex = 0; deviceIndex < USB_HID_MAX_DEVICES; deviceIndex++)
+		detachDevice(&devices[deviceIndex]);
+} // END detachDevices Method
+
+// Reports a device found broken, from any thread : the recovery supervisor detaches it
+// and schedules its recovery (see handleBrokenDevice)
+static void reportBrokenDevice(UsbHidDevice *device)
+{
+	if (device == NULL)
+		return;
+
+	storeAtomic64(&device->brokenReported, 1);
+	setPlatformEvent(recoveryWakeEvent);
+} // END reportBrokenDevice method
+
+// Schedules the reopening of a device found broken, see usbRecoveryThread (recovery supervisor only)
+static void scheduleRecovery(UsbHidDevice *device)
+{
+	unsigned long long now = getMonotonicTime();
+
+	incrementStatistic(STATISTIC_DEVICE_FAILURES);
+	recordFlight(flightDeviceBroken, device->deviceIndex, flightFailed, NULL, 0, getMonotonicTime());
+
+	// Dumped on the next turn of the supervisor, once the device is handled
+	if (flightRecorderPath != NULL)
+		storeAtomic64(&flightRecorderDumpRequested, 1);
+
+	// The reports pending are about the device being detached, not the one reopened
+	storeAtomic64(&device->brokenReported, 0);
+	device->recoveryDelay = RECOVERY_MIN_DELAY;
+	device->nextRecoveryTime = now + RECOVERY_MIN_DELAY;
+	storeAtomic64(&device->brokenTime, (long long) now);
+	setPlatformEvent(recoveryWakeEvent);
+} // END scheduleRecovery method
+
+// This private method detaches the USB device and forces the 
+// event loop to cancel IO if required.
+// If the USB device stops responding to the read/write
+// operations (due to a software or firmware bug) this method
+// recovers back into a known state (recovery supervisor only).
+static void detachBrokenDevice(UsbHidDevice *device)
+{
+	if (compareExchangeAtomic64(&device->slotState, slotServed, slotDetaching))
+	{
+		OutputDebugString("detachBrokenDevice: Detaching broken device...");
+
+		// Cancel any pending IO operations
+		transport.cancelIo(device->hidDevice);
+
+		// Unattach the device and indicate it is broken
+		storeAtomic64(&device->deviceAttached, FALSE);
+		storeAtomic64(&device->deviceAttachedButBroken, TRUE);
+
+		// The event loop closes the device as soon as its pending IO is cancelled,
+		// the requests left are failed then, and the recovery supervisor reopens it.
+		// Closing first : the supervisor woken up finds the slot closing, with its abandon deadline
+		requestDeviceClosing(device);
+		scheduleRecovery(device);
+	}
+} // END detachBrokenUsbDevice Method
+
+
+// Initializes the hid communication instance 
+static void initUsbHidCommunication()
+{
+	int deviceIndex;
+	const char *simulatedDeviceScript;
+
+	// Use the simulated device when requested (load testing),
+	// the operating system access to the device otherwise
+	simulatedDeviceScript = getenv(SIMULATED_DEVICE_VARIABLE);
+	if (simulatedDeviceScript != NULL)
+	{
+		OutputDebugString("initUsbHidCommunication: Using the simulated device");
+		transport = CreateSimulatedHidTransport(simulatedDeviceScript);
+	}
+	else
+		transport = CreatePlatformHidTransport();
+
+	// Dump the flight recorder when a device is found broken, if requested
+	flightRecorderPath = getenv(FLIGHT_RECORDER_VARIABLE);
+	storeAtomic64(&flightRecorderDumpRequested, 0);
+
+	for (deviceIndex = 0; deviceIndex < USB_HID_MAX_DEVICES; deviceIndex++)
+	{
+		UsbHidDevice *device = &devices[deviceIndex];
+
+		memset(device, 0, sizeof(UsbHidDevice));
+		device->deviceIndex = deviceIndex;
+		device->slotState = slotClosed;
+		device->deviceState = DEVICE_STATE_UNKNOWN;
+		device->shownState = DEVICE_STATE_UNKNOWN;
+		device->requestedFeature = -1;
+
+		// Fill the outputBuffer with 0xFF (apparently this causes less EMI and power
+		// consumption)
+		memset(device->outputBuffer, 0xFF, REPORT_SIZE);
+
+		// Create the queue of the input reports read by the event loop
+		initReportQueue(&device->reportQueue);
+		device->closedEvent = createPlatformEvent(TRUE, TRUE);
+	}
+	storeAtomic64(&deviceCount, 0);
+	nextReceivedDevice = 0;
+
+	// Create the event loop wake event and the device arrival event (auto reset)
+	eventLoopWakeEvent = createPlatformEvent(FALSE, FALSE);
+	deviceArrivalEvent = createPlatformEvent(FALSE, FALSE);
+	commandReleaseEvent = createPlatformEvent(TRUE, FALSE);
+	storeAtomic64(&commandWaitersReleased, 0);
+
+	// Create the pool of requests up front : submitting a request allocates nothing afterwards
+	if (!initHidRequestPool())
+		OutputDebugString("initUsbHidCommunication: Failed to create the request pool, requests will be allocated");
+
+	// Start the event loop thread, it serves the devices as they are attached
+	workerThreadState = idle;
+	usbEventLoopThreadHandle = createPlatformThread(usbEventLoopThread, (LPVOID) (size_t) loadAtomic64(&eventLoopGeneration));
+
+	// Start the recovery supervisor thread, it reopens the devices found broken
+	recoveryWakeEvent = createPlatformEvent(FALSE, FALSE);
+	storeAtomic64(&recoveryRunning, 1);
+	recoveryThreadHandle = createPlatformThread(usbRecoveryThread, NULL);
+} // END usbHidCommunication method
+
+// Destructor method
+static void finalizeUsbHidCommunication()
+{
+	int deviceIndex;
+
+	// Stop the recovery supervisor, no device is reopened anymore
+	storeAtomic64(&recoveryRunning, 0);
+	setPlatformEvent(recoveryWakeEvent);
+	joinPlatformThread(recoveryThreadHandle, PLATFORM_WAIT_INFINITE);
+	recoveryThreadHandle = NULL;
+	destroyPlatformEvent(recoveryWakeEvent);
+	recoveryWakeEvent = NULL;
+
+	// No device is attached anymore, then cleanly detach ourselves from the USB devices
+	transport.stopHotplugMonitor();
+	detachDevices();
+
+	// Stop the event loop
+	workerThreadState = terminated;
+	setPlatformEvent(eventLoopWakeEvent);
+	joinPlatformThread(usbEventLoopThreadHandle, 5000);
+	usbEventLoopThreadHandle = NULL;
+
+	for (deviceIndex = 0; deviceIndex < USB_HID_MAX_DEVICES; deviceIndex++)
+	{
+		finalizeReportQueue(&devices[deviceIndex].reportQueue);
+		destroyPlatformEvent(devices[deviceIndex].closedEvent);
+		devices[deviceIndex].closedEvent = NULL;
+	}
+	storeAtomic64(&deviceCount, 0);
+
+	destroyPlatformEvent(eventLoopWakeEvent);
+	eventLoopWakeEvent = NULL;
+	destroyPlatformEvent(deviceArrivalEvent);
+	deviceArrivalEvent = NULL;
+	destroyPlatformEvent(commandReleaseEvent);
+	commandReleaseEvent = NULL;
+	finalizeHidRequestPool();
+} // END ~usbHidCommunication method
+
+// Animation timer of a device : a keyframe is over, the event loop shows the next one
+static void onAnimationTimer(WheelTimer *timer, LPVOID context)
+{
+	((UsbHidDevice *) context)->animationDue = TRUE;
+}
+
+// Advances the animations of a device once they are started, cancelled or a keyframe is over : the keyframe
+// of the highest animation playing is set on the animation layer and the timer of the next one is scheduled
+// on the wheel of the event loop. An animation never blocks, the reports are read between its keyframes.
+static void advanceAnimations(UsbHidDevice *device, TimerWheel *wheel)
+{
+	unsigned long long now = getMonotonicTime(), deadline;
+	byte leds;
+
+	if (!device->animationDue)
+		return;
+	device->animationDue = FALSE;
+
+	advanceLedAnimations(&device->animator, now);
+	if (getLedAnimationFrame(&device->animator, &leds))
+		setLedCompositorLayer(&device->compositor, ledAnimationLayer, 0xFF, leds);
+	else
+		setLedCompositorLayer(&device->compositor, ledAnimationLayer, 0, 0);
+	storeAtomic64(&device->layersChanged, 1);
+
+	deadline = getLedAnimationDeadline(&device->animator);
+	if (deadline != 0)
+		scheduleWheelTimer(wheel, &device->animationTimer, deadline);
+	else
+		cancelWheelTimer(wheel, &device->animationTimer);
+}
+
+// Shows the LEDs of a device once a layer changed : the keyframes of its animations,
+// or a layer set by another thread
+static enum FeatureWriteResult showChangedLayers(UsbHidDevice *device)
+{
+	enum FeatureWriteResult result;
+
+	if (!exchangeAtomic64(&device->layersChanged, 0))
+		return featureUnchanged;
+
+	result = showLeds(device);
+	if (result == featureWritten)
+		incrementStatistic(STATISTIC_LAYER_WRITES);
+	else if (result == featureWriteFailed)
+		OutputDebugString("usbEventLoopThread: /!\\ Failed to show the LED layers on the USB device");
+
+	return result;
+}
+
+// Advances the animations of a device and shows the layers changed, the transfer being watched like a request.
+// Returns FALSE if the event loop has been abandoned during the transfer.
+static BOOL showLayers(UsbHidDevice *device, long long generation, TimerWheel *wheel)
+{
+	advanceAnimations(device, wheel);
+	if (loadAtomic64(&device->layersChanged) == 0)
+		return TRUE;
+
+	storeAtomic64(&device->requestStartTime, (long long) getMonotonicTime());
+	showChangedLayers(device);
+
+	// Abandoned while stuck in the transfer : the device belongs to the new event loop
+	if (loadAtomic64(&eventLoopGeneration) != generation)
+		return FALSE;
+	storeAtomic64(&device->requestStartTime, 0);
+	return TRUE;
+}
+
+// Transfers the requests submitted to a device, in submission order.
+// Returns FALSE if the event loop has been abandoned during a transfer.
+static BOOL transferRequests(UsbHidDevice *device, long long generation, TimerWheel *wheel)
+{
+	HidRequest *request = takeHidRequests(&device->requestQueue);
+
+	while (request != NULL)
+	{
+		HidRequest *next = request->next;
+		unsigned long long startTime = getMonotonicTime(), completionTime;
+		BOOL succeeded;
+
+		storeAtomic64(&device->requestStartTime, (long long) startTime);
+		if (request->type == hidSetFeatureRequest)
+		{
+			// Set the feature, the device echoes it in an input report. Features queued during the previous
+			// transfer are merged before reaching the device : only the last one is transferred.
+			switch (writeFeature(device, request->ledMask, request->buffer[1], next == NULL || next->type != hidSetFeatureRequest))
+			{
+			case featureWritten:
+			case featureUnchanged:
+				succeeded = TRUE;
+				break;
+
+			default:
+				OutputDebugString("usbEventLoopThread: /!\\ Failed to set feature to the USB device");
+				succeeded = FALSE;
+				break;
+			}
+		}
+		else if (request->type == hidAnimationRequest)
+		{
+			// Started or cancelled, then shown : its first keyframe, or the layers below once none plays anymore
+			// (a device without LED plays none)
+			if (request->timeline != NULL)
+				succeeded = device->model.ledReport != hidLedsNone && startLedAnimation(&device->animator, request->timeline, request->layer, startTime);
+			else
+			{
+				cancelLedAnimation(&device->animator, request->layer);
+				succeeded = TRUE;
+			}
+			device->animationDue = TRUE;
+			advanceAnimations(device, wheel);
+			showChangedLayers(device);
+		}
+		else if (request->type == hidReadRegisterRequest)
+			succeeded = resyncRegister(device, &request->buffer[1]);
+		else if (request->type == hidGetFeatureRequest)
+			succeeded = readFeatureLeds(device, &request->buffer[1]);
+		else
+		{
+			// Send the packet to the USB device, the reply of a command
+			// is queued as any other input report
+			succeeded = device->model.outputReportLength != 0
+				&& transport.writeReport(device->hidDevice, request->buffer, device->model.outputReportLength);
+			recordFlight(flightOutputReport, device->deviceIndex, succeeded ? flightSucceeded : flightFailed, request->buffer, device->model.outputReportLength, startTime);
+			if (!succeeded)
+				OutputDebugString("usbEventLoopThread: /!\\ Failed to send the packet to the USB device");
+		}
+
+		// Abandoned while stuck in the transfer : the device belongs to the new event loop,
+		// only the requests taken are completed
+		if (loadAtomic64(&eventLoopGeneration) != generation)
+		{
+			while (request != NULL)
+			{
+				next = request->next;
+				completeHidRequest(request, FALSE);
+				request = next;
+			}
+			return FALSE;
+		}
+		storeAtomic64(&device->requestStartTime, 0);
+
+		// The request may be destroyed by its completion
+		completionTime = getMonotonicTime();
+		recordLatency(STATISTIC_REQUEST_COMPLETION, completionTime - request->submitTime);
+		completeHidRequest(request, succeeded);
+		request = next;
+	}
+
+	return TRUE;
+}
+
+// Applies the register reported by a device echoing its LEDs, changed by the user, to the device state :
+// the register shows the layers above it, the buttons toggled from the LEDs shown are toggled in the device state.
+// The layers are shown again over the LEDs toggled.
+static void toggleDeviceState(UsbHidDevice *device, byte state)
+{
+	long long deviceState, shownState = device->shownState;
+
+	do
+	{
+		deviceState = loadAtomic64(&device->deviceState);
+	} while (!compareExchangeAtomic64(&device->deviceState, deviceState,
+		deviceState == DEVICE_STATE_UNKNOWN || shownState == DEVICE_STATE_UNKNOWN ? state : deviceState ^ (state ^ shownState)));
+	device->shownState = state;
+
+	if (hasLedCompositorOverlays(&device->compositor))
+		storeAtomic64(&device->layersChanged, 1);
+}
+
+// Reads the input reports of a device until none is left.
+// Returns FALSE if the reads fail (IO cancelled or device unplugged).
+static BOOL readReports(UsbHidDevice *device)
+{
+	unsigned char readBuffer[REPORT_SIZE];
+	DWORD bytesRead = 0;
+	unsigned long long now;
+	BOOL echo;
+	byte state;
+
+	for (;;)
+	{
+		switch (transport.readReport(device->hidDevice, readBuffer, REPORT_SIZE, &bytesRead))
+		{
+		case reportRead:
+			now = getMonotonicTime();
+			incrementStatistic(STATISTIC_REPORTS_RECEIVED);
+
+			// Only the report holding the buttons is of interest
+			if (!decodeHidButtons(&device->model, readBuffer, bytesRead, &state))
+			{
+				recordFlight(flightInputReport, device->deviceIndex, flightIgnored, readBuffer, bytesRead, now);
+				break;
+			}
+
+			// The echo of a feature write is queued too, the receiver takes it as the LED state
+			// the next commands change : it is not a command itself
+			echo = device->model.echoesLedState && isFeatureEcho(device, state, now);
+			if (echo)
+				incrementStatistic(STATISTIC_FEATURE_ECHOES);
+
+			// The device reports its button/LED register, changed by the user
+			// (its buttons only when it does not echo its LEDs), the feature writes set it already
+			else if (device->model.echoesLedState)
+				toggleDeviceState(device, state);
+
+			if (!pushReport(&device->reportQueue, readBuffer, bytesRead, now, echo))
+			{
+				OutputDebugString("usbEventLoopThread: /!\\ Report queue full, report dropped");
+				incrementStatistic(STATISTIC_REPORTS_DROPPED);
+				recordFlight(flightInputReport, device->deviceIndex, flightDropped, readBuffer, bytesRead, now);
+			}
+			else
+				recordFlight(flightInputReport, device->deviceIndex, echo ? flightEcho : flightSucceeded, readBuffer, bytesRead, now);
+			break;
+
+		case readPending:
+			device->readFailed = FALSE;
+			return TRUE;
+
+		default:
+			// Retried on the next wake up (request or detach) rather than failing in a loop
+			if (!device->readFailed)
+			{
+				OutputDebugString("usbEventLoopThread: /!\\ Failed to read the packet from the USB device");
+				recordFlight(flightInputReport, device->deviceIndex, flightFailed, NULL, 0, getMonotonicTime());
+			}
+			device->readFailed = TRUE;
+			return FALSE;
+		}
+	}
+}
+
+// Closes a device handed over by a detach, once the event loop is done with it
+static void closeDevice(UsbHidDevice *device, TimerWheel *wheel)
+{
+	transport.closeDevice(device->hidDevice);
+	device->hidDevice = NULL;
+	failPendingRequests(device);
+
+	// Its animations stop with it, the other layers are kept for its next attachment
+	cancelWheelTimer(wheel, &device->animationTimer);
+	initLedAnimator(&device->animator);
+	device->animationDue = FALSE;
+	setLedCompositorLayer(&device->compositor, ledAnimationLayer, 0, 0);
+
+	storeAtomic64(&device->slotState, slotClosed);
+	setPlatformEvent(device->closedEvent);
+
+	// A broken device can be reopened now
+	if (loadAtomic64(&device->brokenTime) != 0)
+		setPlatformEvent(recoveryWakeEvent);
+}
+
+// This method is run as a background thread which serves all the USB devices :
+// it transfers the requests submitted to them, shows their LED layers, plays their animations from its
+// timer wheel and reads their input reports, then waits for any of them to have something to do.
+// The reads never block, the transfers (feature and output reports) could block
+// if the USB device is detached at an unfortunate point, or (more importantly
+// if the firmware of the device does not send a response when one
+// is expected (due to a software or firmware bug) - which would otherwise
+// lock-up the application...
+
+static DWORD WINAPI usbEventLoopThread(LPVOID pData)
+{
+	// Wake event, followed by the read events of the devices
+	PlatformEvent *events[USB_HID_MAX_DEVICES + 1];
+	int eventCount, deviceIndex, signaled;
+	long long generation = (long long) (size_t) pData;
+	TimerWheel animationWheel;
+	unsigned long long deadline;
+	DWORD timeout;
+
+	// The animations of the devices are resumed by the event loop replacing an abandoned one
+	initTimerWheel(&animationWheel, getMonotonicTime());
+	for (deviceIndex = 0; deviceIndex < USB_HID_MAX_DEVICES; deviceIndex++)
+	{
+		initWheelTimer(&devices[deviceIndex].animationTimer, onAnimationTimer, &devices[deviceIndex]);
+		devices[deviceIndex].animationDue = TRUE;
+	}
+
+	while (workerThreadState != terminated && loadAtomic64(&eventLoopGeneration) == generation)
+	{
+		events[0] = eventLoopWakeEvent;
+		eventCount = 1;
+		exchangeAtomic64(&eventLoopWakePending, 0);
+
+		// The devices whose keyframe is over show the next one below
+		advanceTimerWheel(&animationWheel, getMonotonicTime());
+
+		for (deviceIndex = 0; deviceIndex < USB_HID_MAX_DEVICES; deviceIndex++)
+		{
+			UsbHidDevice *device = &devices[deviceIndex];
+
+			switch (loadAtomic64(&device->slotState))
+			{
+			case slotServed:
+				if (!transferRequests(device, generation, &animationWheel) || !showLayers(device, generation, &animationWheel))
+				{
+					OutputDebugString("usbEventLoopThread: Abandoned event loop exited");
+					return 0;
+				}
+				if (readReports(device))
+					events[eventCount++] = transport.getReadEvent(device->hidDevice);
+				break;
+
+			case slotClosing:
+				closeDevice(device, &animationWheel);
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		if (workerThreadState == terminated)
+			break;
+
+		// Until the next keyframe of an animation, rounded up
+		deadline = getTimerWheelDeadline(&animationWheel);
+		timeout = PLATFORM_WAIT_INFINITE;
+		if (deadline != 0)
+		{
+			unsigned long long now = getMonotonicTime();
+
+			timeout = deadline > now ? (DWORD) ((deadline - now + 999999ULL) / 1000000ULL) : 0;
+		}
+
+#ifdef GAMEVOICE_POLLING_WORKER
+		// Former worker thread, for the benchmarks only : it woke up every 5ms whatever happened
+		// and only then looked at the device (see the CMake option of the same name)
+		Sleep(5);
+		signaled = waitForPlatformEvents(events, eventCount, 0);
+		if (signaled < 0)
+			signaled = 0;
+#else
+		signaled = waitForPlatformEvents(events, eventCount, timeout);
+#endif
+		if (signaled == 0)
+		{
+			BOOL idleWakeup = workerThreadState != terminated;
+
+			incrementStatistic(STATISTIC_WORKER_WAKEUPS);
+			for (deviceIndex = 0; deviceIndex < USB_HID_MAX_DEVICES && idleWakeup; deviceIndex++)
+				idleWakeup = devices[deviceIndex].requestQueue.head == NULL && loadAtomic64(&devices[deviceIndex].layersChanged) == 0
+					&& loadAtomic64(&devices[deviceIndex].slotState) != slotClosing;
+			if (idleWakeup)
+				incrementStatistic(STATISTIC_WORKER_IDLE_WAKEUPS);
+		}
+	}
+
+	// Close the devices detached while stopping, unless abandoned
+	for (deviceIndex = 0; deviceIndex < USB_HID_MAX_DEVICES && loadAtomic64(&eventLoopGeneration) == generation; deviceIndex++)
+	{
+		if (loadAtomic64(&devices[deviceIndex].slotState) == slotClosing)
+			closeDevice(&devices[deviceIndex], &animationWheel);
+	}
+
+	OutputDebugString("usbEventLoopThread: Event loop thread exited");
+	return 0;
+} // END usbEventLoopThread method
+
+// Hands an opened device over to the event loop
+static void attachDevice(UsbHidDevice *device, HidDevice *hidDevice)
+{
+	// The buttons and LEDs the device describes, the Game Voice ones if its descriptor is unknown
+	if (!transport.getDeviceModel(hidDevice, &device->model))
+	{
+		OutputDebugString("attachDevice: /!\\ Unknown report layout, using the Game Voice one");
+		initGameVoiceDeviceModel(&device->model);
+	}
+
+	device->hidDevice = hidDevice;
+	device->echoReads = loadAtomic64(&device->echoWrites);
+	device->readFailed = FALSE;
+	initLedAnimator(&device->animator);
+	device->animationDue = FALSE;
+	setLedCompositorLayer(&device->compositor, ledAnimationLayer, 0, 0);
+	storeAtomic64(&device->requestStartTime, 0);
+	storeAtomic64(&device->deviceState, DEVICE_STATE_UNKNOWN);
+	device->shownState = DEVICE_STATE_UNKNOWN;
+
+	// The layers set while the device was away are shown once it is served
+	storeAtomic64(&device->layersChanged, hasLedCompositorOverlays(&device->compositor));
+
+	// Drop the reports left by the previous attachment : the consumer skips them,
+	// and the device until it is published as attached below
+	discardReports(&device->reportQueue);
+
+	// Requests submitted while the device was detaching
+	failPendingRequests(device);
+
+	// Published once the device is reset, the atomic store orders the writes above before it
+	storeAtomic64(&device->deviceAttachedButBroken, FALSE);
+	storeAtomic64(&device->deviceAttached, TRUE);
+
+	recordFlight(flightDeviceAttached, device->deviceIndex, flightSucceeded, NULL, 0, getMonotonicTime());
+	storeAtomic64(&device->slotState, slotServed);
+	setPlatformEvent(eventLoopWakeEvent);
+	setPlatformEvent(deviceArrivalEvent);
+
+	// The recovery supervisor watches the transfers of the device from now on
+	setPlatformEvent(recoveryWakeEvent);
+}
+
+// Define public methods for the device registry
+
+static int getDeviceCount(void)
+{
+	return (int) loadAtomic64(&deviceCount);
+} // END getDeviceCount method
+
+static UsbHidDevice *getDevice(int deviceIndex)
+{
+	if (deviceIndex < 0 || deviceIndex >= getDeviceCount())
+		return NULL;
+
+	return &devices[deviceIndex];
+} // END getDevice method
+
+static int getDeviceIndex(UsbHidDevice *device)
+{
+	return device->deviceIndex;
+} // END getDeviceIndex method
+
+// Sends the last feature (LED state) requested again to a recovered device
+static void replayRequestedFeature(UsbHidDevice *device)
+{
+	unsigned char buffer[REPORT_SIZE];
+	long long feature = loadAtomic64(&device->requestedFeature);
+
+	if (feature < 0)
+		return;
+
+	memset(buffer, 0, REPORT_SIZE);
+	buffer[1] = (unsigned char) feature;
+	releaseHidRequest(submitRequest(device, hidSetFeatureRequest, buffer, NULL, NULL));
+} // END replayRequestedFeature
+
+// Opens the device of the specified path in a free slot and attaches it.
+// The slot is claimed first : the hotplug monitor, findDevices and the recovery supervisor
+// never open the same slot at once (deviceBroken is returned to the late one).
+static enum HidTransportOpenResult openDeviceSlot(UsbHidDevice *device, const char *devicePath)
+{
+	HidDevice *hidDevice = NULL;
+	enum HidTransportOpenResult result;
+	char debugOutput[80];
+	long long brokenTime;
+
+	if (!compareExchangeAtomic64(&device->slotState, slotClosed, slotOpening))
+	{
+		OutputDebugString("openDeviceSlot: /!\\ Device slot busy");
+		return deviceBroken;
+	}
+
+	// The path may be the one of the slot (recovery)
+	if (device->devicePath != devicePath)
+		snprintf(device->devicePath, HID_DEVICE_PATH_SIZE, "%s", devicePath);
+
+	result = transport.openDevice(device->devicePath, &hidDevice);
+	if (result == deviceOpened)
+	{
+		snprintf(debugOutput, sizeof(debugOutput), "openDeviceSlot: Success ! Device %d is now attached", device->deviceIndex);
+		OutputDebugString(debugOutput);
+
+		// Device opened successfully, device is now attached
+		attachDevice(device, hidDevice);
+
+		// Found broken before : recovered, with the LED state it had
+		brokenTime = exchangeAtomic64(&device->brokenTime, 0);
+		if (brokenTime != 0)
+		{
+			recordLatency(STATISTIC_TIME_TO_RECOVER, getMonotonicTime() - (unsigned long long) brokenTime);
+			incrementStatistic(STATISTIC_DEVICE_RECOVERIES);
+			replayRequestedFeature(device);
+		}
+		return result;
+	}
+
+	storeAtomic64(&device->slotState, slotClosed);
+	if (result == deviceBroken)
+	{
+		OutputDebugString("openDeviceSlot: Failed ! Something went wrong... Can't use the device :(");
+
+		// We found the device but, for some reason, can't use it : retried by the recovery supervisor
+		storeAtomic64(&device->deviceAttached, FALSE);
+		storeAtomic64(&device->deviceAttachedButBroken, TRUE);
+		if (loadAtomic64(&device->brokenTime) == 0)
+			reportBrokenDevice(device);
+	}
+	else
+	{
+		// Unplugged meanwhile, the slot stays free and is not recovered
+		device->devicePath[0] = '\0';
+		storeAtomic64(&device->deviceAttachedButBroken, FALSE);
+		storeAtomic64(&device->brokenTime, 0);
+	}
+
+	return result;
+} // END openDeviceSlot
+
+// This method attempts to find the target USB devices and attach to them
+static int findDevices(const UsbDeviceId *deviceIds)
+{
+	char devicePath[HID_DEVICE_PATH_SIZE];
+	int deviceIndex, idIndex, pathIndex, count = 0;
+
+	OutputDebugString("findDevices: Detaching USB devices just in case...");
+	// If the devices are currently flagged as attached then we are 'rechecking' the devices, probably
+	// due to some message receieved from Windows indicating a device status chanage.  In this case
+	// we should detach the USB devices cleanly (if required) before reattaching them.
+	detachDevices();
+
+	for (deviceIndex = 0; deviceIndex < USB_HID_MAX_DEVICES; deviceIndex++)
+		devices[deviceIndex].devicePath[0] = '\0';
+
+	// The devices of every supported model, in the order of the table
+	deviceIndex = 0;
+	for (idIndex = 0; deviceIds[idIndex].vid != 0 && deviceIndex < USB_HID_MAX_DEVICES; idIndex++)
+	{
+		for (pathIndex = 0; transport.findDevicePath(deviceIds[idIndex].vid, deviceIds[idIndex].pid, pathIndex, devicePath); pathIndex++)
+		{
+			// A device the event loop did not close yet (stuck in a transfer) can't be attached again
+			while (deviceIndex < USB_HID_MAX_DEVICES && loadAtomic64(&devices[deviceIndex].slotState) != slotClosed)
+			{
+				OutputDebugString("findDevices: /!\\ Device still closing, skipped");
+				deviceIndex++;
+			}
+
+			if (deviceIndex == USB_HID_MAX_DEVICES)
+				break;
+
+			if (openDeviceSlot(&devices[deviceIndex], devicePath) != deviceNotFound)
+				count = ++deviceIndex;
+		}
+	}
+
+	storeAtomic64(&deviceCount, count);
+	return count;
+} // END findDevices
+
+// Finds the slot of the device of the specified path, NULL if the device is not known
+static UsbHidDevice *findDeviceSlot(const char *devicePath)
+{
+	int deviceIndex;
+
+	for (deviceIndex = 0; deviceIndex < USB_HID_MAX_DEVICES; deviceIndex++)
+	{
+		if (strcmp(devices[deviceIndex].devicePath, devicePath) == 0)
+			return &devices[deviceIndex];
+	}
+
+	return NULL;
+} // END findDeviceSlot
+
+// Determines whether a device path belongs to one of the supported devices
+static BOOL isSupportedDevicePath(const char *devicePath, const UsbDeviceId *deviceIds)
+{
+	int idIndex;
+
+	for (idIndex = 0; deviceIds[idIndex].vid != 0; idIndex++)
+	{
+		if (transport.isMatchingDevicePath(devicePath, deviceIds[idIndex].vid, deviceIds[idIndex].pid))
+			return TRUE;
+	}
+
+	return FALSE;
+} // END isSupportedDevicePath
+
+// This method attaches or detaches the device plugged in or unplugged.
+// The other devices are left alone : an unrelated device (USB stick, keyboard...) changes nothing.
+static void handleDevicePathChange(enum HidHotplugEvent event, const char *devicePath, const UsbDeviceId *deviceIds)
+{
+	UsbHidDevice *device = findDeviceSlot(devicePath);
+	int deviceIndex;
+
+	if (event == hidDeviceRemoved)
+	{
+		// Not one of the devices found
+		if (device == NULL)
+		{
+			incrementStatistic(STATISTIC_HOTPLUG_EVENTS_IGNORED);
+			return;
+		}
+
+		OutputDebugString("handleDevicePathChange: Device unplugged, path is below");
+		OutputDebugString(devicePath);
+		detachDevice(device);
+		device->devicePath[0] = '\0';
+		incrementStatistic(STATISTIC_HOTPLUG_EVENTS);
+		return;
+	}
+
+	// Already attached (repeated notification) or not a target device
+	if ((device != NULL && loadAtomic64(&device->deviceAttached)) || !isSupportedDevicePath(devicePath, deviceIds))
+	{
+		incrementStatistic(STATISTIC_HOTPLUG_EVENTS_IGNORED);
+		return;
+	}
+
+	OutputDebugString("handleDevicePathChange: Device plugged in, path is below");
+	OutputDebugString(devicePath);
+
+	// Reuse the slot of the device found broken, the first free slot otherwise
+	for (deviceIndex = 0; device == NULL && deviceIndex < USB_HID_MAX_DEVICES; deviceIndex++)
+	{
+		if (devices[deviceIndex].devicePath[0] == '\0' && loadAtomic64(&devices[deviceIndex].slotState) == slotClosed)
+			device = &devices[deviceIndex];
+	}
+
+	if (device == NULL || loadAtomic64(&device->slotState) != slotClosed)
+	{
+		OutputDebugString("handleDevicePathChange: /!\\ No free device slot, device ignored");
+		return;
+	}
+
+	if (openDeviceSlot(device, devicePath) != deviceNotFound)
+	{
+		if (device->deviceIndex >= getDeviceCount())
+			storeAtomic64(&deviceCount, device->deviceIndex + 1);
+		incrementStatistic(STATISTIC_HOTPLUG_EVENTS);
+	}
+} // END handleDevicePathChange
+
+// Hotplug monitor callback
+static void onHotplugEvent(enum HidHotplugEvent event, const char *devicePath, LPVOID context)
+{
+	handleDevicePathChange(event, devicePath, hotplugDeviceIds);
+} // END onHotplugEvent
+
+// This public method starts monitoring the devices plugged in and unplugged
+static BOOL startHotplugMonitoring(const UsbDeviceId *deviceIds)
+{
+	int idIndex;
+
+	for (idIndex = 0; deviceIds[idIndex].vid != 0 && idIndex < USB_HID_MAX_DEVICE_IDS; idIndex++)
+		hotplugDeviceIds[idIndex] = deviceIds[idIndex];
+	hotplugDeviceIds[idIndex].vid = 0;
+	hotplugDeviceIds[idIndex].pid = 0;
+
+	return transport.startHotplugMonitor(onHotplugEvent, NULL);
+} // END startHotplugMonitoring
+
+// This public method stops monitoring the devices plugged in and unplugged
+static void stopHotplugMonitoring()
+{
+	transport.stopHotplugMonitor();
+} // END stopHotplugMonitoring
+
+// This public method requests that device notification messages are sent to the calling form
+// which the form must catch with a WndProc override.
+//
+// You will need to supply the handle of the calling form for this to work, usually
+// specified with 'this->form'.  Something like the following line needs to be placed
+// in the form's contructor method:
+// 
+// a_usbHidCommunication.requestDeviceNotificationsToForm(this->Handle);
+//
+static void requestDeviceNotificationsToForm(HANDLE handleOfWindow)
+{
+#ifdef _WIN32
+	// Define the Globally Unique Identifier (GUID) for HID class devices:
+	GUID InterfaceClassGuid = {0x4d1e55b2, 0xf16f, 0x11cf, 0x88, 0xcb, 0x00, 0x11, 0x11, 0x00, 0x00, 0x30};
+
+	// Register for WM_DEVICECHANGE notifications.  This code uses these messages to detect
+	// plug and play connection/disconnection events for USB devices
+	DEV_BROADCAST_DEVICEINTERFACE myDeviceBroadcastHeader;
+	myDeviceBroadcastHeader.dbcc_devicetype = DBT_DEVTYP_DEVICEINTERFACE;
+	myDeviceBroadcastHeader.dbcc_size = sizeof(DEV_BROADCAST_DEVICEINTERFACE);
+	myDeviceBroadcastHeader.dbcc_reserved = 0;
+	myDeviceBroadcastHeader.dbcc_classguid = InterfaceClassGuid;
+	RegisterDeviceNotification((HANDLE)handleOfWindow, &myDeviceBroadcastHeader, DEVICE_NOTIFY_WINDOW_HANDLE);
+#endif
+}
+
+// This public method filters WndProc notification messages for the required
+// device notifications and triggers a re-detection of the USB devices if required.
+//
+// The main form of the application needs to include an override of the WndProc
+// class for this to be called, usually this is defined as a protected method
+// of the main form and looks like the following:
+//
+// protected: virtual void WndProc(Message% m) override
+//		{
+//			a_usbHidCommunication.handleDeviceChangeMessages(m, vid, pid);
+//			Form::WndProc( m ); // Call the original method
+//		} // END WndProc method
+//
+static void handleDeviceChangeMessages(UINT uMsg, WPARAM wParam, LPARAM lParam, int vid, int pid)
+{
+#ifdef _WIN32
+		UsbDeviceId deviceIds[2] = {{0, 0}, {0, 0}};
+
+		deviceIds[0].vid = vid;
+		deviceIds[0].pid = pid;
+
+		if(uMsg == WM_DEVICECHANGE)
+		{
+			if(((int)wParam == DBT_DEVICEARRIVAL) || ((int)wParam == DBT_DEVICEREMOVECOMPLETE))
+			{
+				DEV_BROADCAST_HDR *header = (DEV_BROADCAST_HDR *) lParam;
+				char devicePath[HID_DEVICE_PATH_SIZE];
+
+				// Only the device interfaces have a path (not the volumes nor the ports),
+				// the path is lower case like the one findDevices got
+				if (header != NULL && header->dbch_devicetype == DBT_DEVTYP_DEVICEINTERFACE)
+				{
+					snprintf(devicePath, HID_DEVICE_PATH_SIZE, "%s", ((DEV_BROADCAST_DEVICEINTERFACE_A *) header)->dbcc_name);
+					CharLowerA(devicePath);
+
+					// Attach or detach the affected device only
+					handleDevicePathChange((int)wParam == DBT_DEVICEARRIVAL ? hidDeviceArrived : hidDeviceRemoved, devicePath, deviceIds);
+				}
+				else
+					incrementStatistic(STATISTIC_HOTPLUG_EVENTS_IGNORED);
+			}
+		}
+#endif
+}
+
+// Define public method for reading the deviceAttached flag
+
+static BOOL isDeviceAttached(UsbHidDevice *device)
+{
+	return device != NULL && loadAtomic64(&device->deviceAttached);
+} // END isDeviceAttached method
+
+// Define public method for reading the deviceAttachedButBroken flag
+
+static BOOL isDeviceBroken(UsbHidDevice *device)
+{
+	return device != NULL && loadAtomic64(&device->deviceAttachedButBroken);
+} // END isDeviceBroken method
+			
+
+// Define public method for reading the monotonic timestamp of the last input report read
+
+static unsigned long long getInputReportTime(UsbHidDevice *device)
+{
+	return device->inputReportTime;
+} // END getInputReportTime method
+
+// Define public method for reading the button model register of the last input report received
+
+static byte getInputState(UsbHidDevice *device)
+{
+	return device->inputState;
+} // END getInputState method
+
+// Define public method telling whether the last input report received is the echo of a feature write
+
+static BOOL isInputEcho(UsbHidDevice *device)
+{
+	return device->inputEcho;
+} // END isInputEcho method
+
+// Define public method checking a button model register against the states the device can report
+
+static BOOL isValidInputState(UsbHidDevice *device, byte state)
+{
+	return isValidHidButtonState(&device->model, state);
+} // END isValidInputState method
+
+// Define public method telling whether the buttons of the device are latched
+
+static BOOL hasLatchedButtons(UsbHidDevice *device)
+{
+	return device->model.latchedButtons;
+} // END hasLatchedButtons method
+
+// The following private method checks the event loop is not stuck in a transfer to the device.
+static BOOL isWorkerThreadResponding(UsbHidDevice *device)
+{
+	unsigned long long startTime = (unsigned long long) loadAtomic64(&device->requestStartTime);
+
+	// Did the transfer in progress not complete within HID_REQUEST_TIMEOUT (500ms)?
+	if (startTime != 0 && getMonotonicTime() - startTime > HID_REQUEST_TIMEOUT)
+	{
+		OutputDebugString("isWorkerThreadResponding: Event loop timed out, reporting the USB device broken...");
+		// We timed out... something is blocking the event loop and it's not
+		// responding.  This is probably due to a firmware/software bug where a 
+		// write/read operation was performed and the thread is still waiting for
+		// a read which is not coming.
+		//
+		// Let the supervisor detach the USB device to return us into a known state...
+		reportBrokenDevice(device);
+		return FALSE;
+	}
+
+	return TRUE;
+} // END isWorkerThreadResponding method
+
+// The following private method creates a request to a device, NULL if the device is not attached or not responding.
+// The buffer is copied, so it can be modified as soon as the request is created.
+static HidRequest *createDeviceRequest(UsbHidDevice *device, enum HidRequestType type, const unsigned char *buffer, HidRequestCallback callback, LPVOID context)
+{
+	HidRequest *request;
+
+	// Check to see if the device is already found and still responding
+	if (device == NULL || !loadAtomic64(&device->deviceAttached) || !isWorkerThreadResponding(device))
+		return NULL;
+
+	request = createHidRequest(type, buffer, callback, context);
+	if (request == NULL)
+		OutputDebugString("submitRequest: /!\\ Failed to create the request");
+
+	return request;
+} // END createDeviceRequest method
+
+// The following private method queues a request (NULL for none) to the event loop and wakes it up
+static HidRequest *queueRequest(UsbHidDevice *device, HidRequest *request)
+{
+	if (request == NULL)
+		return NULL;
+
+	pushHidRequest(&device->requestQueue, request);
+	wakeEventLoop();
+	return request;
+} // END queueRequest method
+
+// The following private method queues a request to the event loop and wakes it up.
+// The buffer is copied, so it can be modified as soon as the request is submitted.
+static HidRequest *submitRequest(UsbHidDevice *device, enum HidRequestType type, const unsigned char *buffer, HidRequestCallback callback, LPVOID context)
+{
+	return queueRequest(device, createDeviceRequest(device, type, buffer, callback, context));
+} // END submitRequest method
+
+// Replaces the event loop stuck in the transfer of a broken device even though its IO has been
+// cancelled : the stuck thread keeps the device handle (never closed) and exits once its transfer
+// returns, a new event loop serves the devices meanwhile.
+static void abandonEventLoop(UsbHidDevice *device)
+{
+	long long generation = addAtomic64(&eventLoopGeneration, 1);
+
+	OutputDebugString("abandonEventLoop: /!\\ Event loop stuck in a transfer, starting a new one...");
+	incrementStatistic(STATISTIC_EVENT_LOOPS_ABANDONED);
+
+	// Left running on its own
+	joinPlatformThread(usbEventLoopThreadHandle, 0);
+
+	device->hidDevice = NULL;
+	failPendingRequests(device);
+	storeAtomic64(&device->requestStartTime, 0);
+	storeAtomic64(&device->slotState, slotClosed);
+	setPlatformEvent(device->closedEvent);
+
+	usbEventLoopThreadHandle = createPlatformThread(usbEventLoopThread, (LPVOID) (size_t) generation);
+} // END abandonEventLoop method
+
+// Detaches a device reported broken and schedules its recovery, or only schedules it
+// for a device that could not be opened (recovery supervisor only)
+static void handleBrokenDevice(UsbHidDevice *device)
+{
+	if (loadAtomic64(&device->slotState) == slotServed)
+		detachBrokenDevice(device);
+	else if (loadAtomic64(&device->slotState) == slotClosed && loadAtomic64(&device->deviceAttachedButBroken)
+		&& loadAtomic64(&device->brokenTime) == 0)
+		scheduleRecovery(device);
+} // END handleBrokenDevice method
+
+// Attempts to reopen a broken device, the next attempt is delayed twice as long on failure
+static void recoverDevice(UsbHidDevice *device, unsigned long long now)
+{
+	incrementStatistic(STATISTIC_RECOVERY_ATTEMPTS);
+	OutputDebugString("recoverDevice: Reopening the broken device...");
+
+	// Unplugged meanwhile : the hotplug monitor attaches it once plugged in again
+	if (device->devicePath[0] == '\0')
+	{
+		storeAtomic64(&device->brokenTime, 0);
+		storeAtomic64(&device->deviceAttachedButBroken, FALSE);
+		return;
+	}
+
+	if (openDeviceSlot(device, device->devicePath) == deviceBroken)
+	{
+		device->recoveryDelay = device->recoveryDelay * 2 > RECOVERY_MAX_DELAY ? RECOVERY_MAX_DELAY : device->recoveryDelay * 2;
+		device->nextRecoveryTime = now + device->recoveryDelay;
+	}
+} // END recoverDevice method
+
+// This method is run as a background thread supervising the devices : it detaches the devices
+// not completing a transfer in time, replaces the event loop left stuck in such a transfer and
+// reopens the broken devices with an exponential backoff, replaying their LED state.
+// It only wakes up periodically while a device is served, to check its transfer in progress.
+static DWORD WINAPI usbRecoveryThread(LPVOID pData)
+{
+	int deviceIndex;
+
+	while (loadAtomic64(&recoveryRunning))
+	{
+		unsigned long long now = getMonotonicTime();
+		unsigned long long deadline = 0;
+		DWORD timeout = PLATFORM_WAIT_INFINITE;
+
+		// A device has been found broken : keep the transactions that led to it
+		if (exchangeAtomic64(&flightRecorderDumpRequested, 0) && flightRecorderPath != NULL)
+		{
+			OutputDebugString("usbRecoveryThread: Dumping the flight recorder, path is below");
+			OutputDebugString(flightRecorderPath);
+			dumpFlightRecorder(flightRecorderPath);
+		}
+
+		for (deviceIndex = 0; deviceIndex < USB_HID_MAX_DEVICES; deviceIndex++)
+		{
+			UsbHidDevice *device = &devices[deviceIndex];
+			unsigned long long brokenTime = (unsigned long long) loadAtomic64(&device->brokenTime);
+			unsigned long long deviceDeadline = 0;
+
+			switch (loadAtomic64(&device->slotState))
+			{
+			case slotServed:
+				// Reports the device broken if its transfer is not completed in time
+				isWorkerThreadResponding(device);
+				break;
+
+			case slotClosing:
+				// The event loop did not return from the cancelled transfer
+				if (brokenTime != 0 && now - brokenTime > EVENT_LOOP_ABANDON_TIMEOUT)
+					abandonEventLoop(device);
+				break;
+
+			case slotClosed:
+				if (brokenTime != 0 && now >= device->nextRecoveryTime)
+					recoverDevice(device, now);
+				break;
+
+			default:
+				break;
+			}
+
+			// Found broken by another thread, or by the check above
+			if (exchangeAtomic64(&device->brokenReported, 0))
+				handleBrokenDevice(device);
+
+			// Next thing to do for the device, from its new state
+			brokenTime = (unsigned long long) loadAtomic64(&device->brokenTime);
+			switch (loadAtomic64(&device->slotState))
+			{
+			case slotServed:
+				timeout = RECOVERY_WATCHDOG_PERIOD;
+				break;
+
+			case slotClosing:
+				if (brokenTime != 0)
+					deviceDeadline = brokenTime + EVENT_LOOP_ABANDON_TIMEOUT + 1;
+				break;
+
+			case slotDetaching:
+				// Being handed over to the event loop, closing in a moment : the same deadline,
+				// then checked again every millisecond until it is closing
+				if (brokenTime != 0 && now - brokenTime > EVENT_LOOP_ABANDON_TIMEOUT)
+					timeout = 1;
+				else if (brokenTime != 0)
+					deviceDeadline = brokenTime + EVENT_LOOP_ABANDON_TIMEOUT + 1;
+				break;
+
+			case slotClosed:
+				if (brokenTime != 0)
+					deviceDeadline = device->nextRecoveryTime;
+				break;
+
+			default:
+				break;
+			}
+
+			if (deviceDeadline != 0 && (deadline == 0 || deviceDeadline < deadline))
+				deadline = deviceDeadline;
+		}
+
+		// Wait for the next attempt, the next check or a device found broken
+		if (deadline != 0)
+		{
+			now = getMonotonicTime();
+			if (deadline <= now)
+				continue;
+			if ((deadline - now + 999999ULL) / 1000000ULL < timeout)
+				timeout = (DWORD) ((deadline - now + 999999ULL) / 1000000ULL);
+		}
+		waitForPlatformEvent(recoveryWakeEvent, timeout);
+	}
+
+	OutputDebugString("usbRecoveryThread: Recovery supervisor thread exited");
+	return 0;
+} // END usbRecoveryThread method
+
+// The following method forces the LEDs of a mask to the USB device, the others are left as they are
+// (the device must have been found first!) The event loop shows them, the only writer of the LEDs :
+// the caller waits for it, in time unless the device is broken.
+static enum FeatureWriteResult forceFeatureLeds(UsbHidDevice *device, byte mask, byte leds)
+{
+	HidRequest *request = submitFeatureLeds(device, mask, leds, NULL, NULL);
+	BOOL succeeded;
+
+	// Check to see if the device is already found
+	if (request == NULL)
+	{
+		// There is no device to communicate with... Exit with error status
+		return featureWriteFailed;
+	}
+
+	// Set the feature to the USB device
+	succeeded = waitForHidRequest(request, getMonotonicTime() + HID_REQUEST_TIMEOUT + EVENT_LOOP_ABANDON_TIMEOUT)
+		&& getHidRequestStatus(request) == hidRequestSucceeded;
+	releaseHidRequest(request);
+	if (!succeeded)
+		OutputDebugString("forceFeature: /!\\ Failed to set feature to the USB device");
+
+	return succeeded ? featureWritten : featureWriteFailed;
+} // END forceFeatureLeds method
+
+// The following method forces a feature request to the USB device (the device must have been found first!)
+static enum FeatureWriteResult forceFeature(UsbHidDevice *device, int usbCommandId)
+{
+	return forceFeatureLeds(device, 0xFF, (byte) usbCommandId);
+}
+
+// The following method reads the button/LED register from the device into the cache (the device must have been found first!)
+// The read is a request of the event loop : the caller waits for it, the device is never accessed from its thread.
+static byte resyncDeviceState(UsbHidDevice *device)
+{
+	HidRequest *request = submitRequest(device, hidReadRegisterRequest, NULL, NULL, NULL);
+	long long deviceState;
+	byte state = 0;
+
+	// Check to see if the device is already found
+	if (request == NULL)
+	{
+		// There is no device to communicate with... Exit with error status
+		return 0;
+	}
+
+	if (waitForHidRequest(request, getMonotonicTime() + HID_REQUEST_TIMEOUT + EVENT_LOOP_ABANDON_TIMEOUT)
+		&& getHidRequestStatus(request) == hidRequestSucceeded)
+		state = request->buffer[1];
+	else
+	{
+		// The cached state, if any
+		deviceState = loadAtomic64(&device->deviceState);
+		state = deviceState == DEVICE_STATE_UNKNOWN ? 0 : (byte) deviceState;
+	}
+	releaseHidRequest(request);
+
+	return state;
+} // END resyncDeviceState method
+
+// The following method gets a report request from the USB device (the device must have been found first!)
+static byte getInputReport(UsbHidDevice *device)
+{
+	return resyncDeviceState(device);
+}
+
+// Define public method for reading the cached button/LED register of the device
+static byte getDeviceState(UsbHidDevice *device)
+{
+	long long state;
+
+	if (device == NULL)
+		return 0;
+
+	// Nothing read nor written yet : no button known active, until resyncDeviceState
+	state = loadAtomic64(&device->deviceState);
+	if (state == DEVICE_STATE_UNKNOWN)
+		return 0;
+
+	return (byte) state;
+} // END getDeviceState method
+
+// The following method gets a feature request from the USB device (the device must have been found first!)
+// The event loop reads it, the caller waits for the request.
+static byte getFeature(UsbHidDevice *device)
+{
+	HidRequest *request;
+	byte leds = 0;
+
+	// The LEDs can only be read back from a feature report
+	if (device == NULL || device->model.ledReport != hidLedsInFeature)
+		return 0;
+
+	request = submitRequest(device, hidGetFeatureRequest, NULL, NULL, NULL);
+
+	// Check to see if the device is already found
+	if (request == NULL)
+	{
+		// There is no device to communicate with... Exit with error status
+		return 0;
+	}
+
+	if (waitForHidRequest(request, getMonotonicTime() + HID_REQUEST_TIMEOUT + EVENT_LOOP_ABANDON_TIMEOUT)
+		&& getHidRequestStatus(request) == hidRequestSucceeded)
+		leds = request->buffer[1];
+	releaseHidRequest(request);
+
+	return leds;
+}
+
+// Sets the LEDs of a mask in the last feature requested, replayed once the device is recovered
+static void requestFeatureLeds(UsbHidDevice *device, byte mask, byte leds)
+{
+	long long requested, feature, deviceState;
+
+	// Nothing requested yet : the LEDs left as they are are the ones of the device state
+	do
+	{
+		requested = loadAtomic64(&device->requestedFeature);
+		deviceState = loadAtomic64(&device->deviceState);
+		feature = requested >= 0 ? requested : (deviceState == DEVICE_STATE_UNKNOWN ? 0 : deviceState);
+	} while (!compareExchangeAtomic64(&device->requestedFeature, requested, (feature & ~mask) | (leds & mask)));
+} // END requestFeatureLeds method
+
+// The following method submits the LEDs of a mask to the USB device, the others are left as they are
+// (the device must have been found first!)
+static HidRequest *submitFeatureLeds(UsbHidDevice *device, byte mask, byte leds, HidRequestCallback callback, LPVOID context)
+{
+	HidRequest *request;
+
+	if (device == NULL)
+		return NULL;
+
+	// Replayed to the device recovered, even if it is broken now
+	requestFeatureLeds(device, mask, leds);
+
+	// The first byte of the feature should be set to zero (this is not sent to the USB device),
+	// the second byte contains the LEDs, merged into the device state by the event loop
+	request = createDeviceRequest(device, hidSetFeatureRequest, NULL, callback, context);
+	if (request != NULL)
+	{
+		request->buffer[0] = 0;
+		request->buffer[1] = leds;
+		request->ledMask = mask;
+	}
+
+	return queueRequest(device, request);
+} // END submitFeatureLeds method
+
+// The following method submits a feature request to the USB device (the device must have been found first!)
+static HidRequest *submitFeature(UsbHidDevice *device, int usbCommandId, HidRequestCallback callback, LPVOID context)
+{
+	// The command is the LEDs of the feature, set to the device : the event loop drops the echo
+	return submitFeatureLeds(device, 0xFF, (byte) usbCommandId, callback, context);
+} // END submitFeature method
+
+// The following method submits a command to the USB device (the device must have been found first!)
+static HidRequest *submitCommand(UsbHidDevice *device, int usbCommandId, HidRequestCallback callback, LPVOID context)
+{
+	HidRequest *request;
+
+	if (device == NULL)
+		return NULL;
+
+	// The request gets a copy of the output buffer, the data written with writeToTheOutputBuffer.
+	// The first byte of the report holds the report ID (this is not sent to the USB device when
+	// the device does not number its reports), the second byte contains the command to the USB device
+	request = createDeviceRequest(device, hidWriteRequest, device->outputBuffer, callback, context);
+	if (request != NULL)
+	{
+		request->buffer[0] = device->model.outputReportId;
+		request->buffer[1] = (byte) usbCommandId;
+	}
+
+	// Write the buffer to the device, a reply is received with receiveCommand
+	return queueRequest(device, request);
+} // END submitCommand method
+
+// The following method submits an LED animation to the USB device (the device must have been found first!)
+static HidRequest *submitAnimation(UsbHidDevice *device, const LedTimeline *timeline, int layer, HidRequestCallback callback, LPVOID context)
+{
+	HidRequest *request = createDeviceRequest(device, hidAnimationRequest, NULL, callback, context);
+
+	// The event loop starts the timeline on the layer, or cancels the layer without timeline
+	if (request != NULL)
+	{
+		request->timeline = timeline;
+		request->layer = layer;
+	}
+
+	return queueRequest(device, request);
+} // END submitAnimation method
+
+// The following method starts an LED animation on the USB device without waiting (the device must have been found first!)
+static BOOL startAnimation(UsbHidDevice *device, const LedTimeline *timeline, int layer)
+{
+	HidRequest *request;
+
+	if (timeline == NULL)
+		return FALSE;
+
+	request = submitAnimation(device, timeline, layer, NULL, NULL);
+	releaseHidRequest(request);
+	return request != NULL;
+} // END startAnimation method
+
+// The following method cancels an LED animation of the USB device without waiting (the device must have been found first!)
+static BOOL cancelAnimation(UsbHidDevice *device, int layer)
+{
+	HidRequest *request = submitAnimation(device, NULL, layer, NULL, NULL);
+
+	releaseHidRequest(request);
+	return request != NULL;
+} // END cancelAnimation method
+
+// The following method shows LEDs on a layer above the state of the USB device without waiting (see ledCompositor.h)
+static BOOL setLedLayer(UsbHidDevice *device, enum LedLayer layer, byte mask, byte leds)
+{
+	// The status layer is the device state set by the features, the animation layer belongs to the animations
+	if (device == NULL || layer == ledAnimationLayer || !setLedCompositorLayer(&device->compositor, layer, mask, leds))
+		return FALSE;
+
+	// Shown by the event loop with the other changes, or once the device is attached
+	storeAtomic64(&device->layersChanged, 1);
+	wakeEventLoop();
+	return TRUE;
+} // END setLedLayer method
+
+// The following method sends a feature request to the USB device (the device must have been found first!)
+static BOOL sendFeature(UsbHidDevice *device, int usbCommandId)
+{
+	HidRequest *request = submitFeature(device, usbCommandId, NULL, NULL);
+
+	// The request completes on its own, the caller does not wait for it
+	releaseHidRequest(request);
+	return request != NULL;
+}
+
+// The following method sends a command to the USB device (the device must have been found first!)
+// This method is for commands that are sent, but no input is returned from the device
+static BOOL sendCommandWriteOnly(UsbHidDevice *device, int usbCommandId)
+{
+	HidRequest *request = submitCommand(device, usbCommandId, NULL, NULL);
+
+	releaseHidRequest(request);
+	return request != NULL;
+} // END sendUsbCommandWriteOnly Method
+
+
+// The following method sends a command to the USB device (the device must have been found first!)
+// This method is for commands that are sent and expect a reply
+static BOOL sendCommandWriteRead(UsbHidDevice *device, int usbCommandId)
+{
+	HidRequest *request = submitCommand(device, usbCommandId, NULL, NULL);
+
+	// The reply is received with receiveCommand
+	releaseHidRequest(request);
+	return request != NULL;
+} // END sendUsbCommandReadWrite Method
+
+static UsbHidDevice *receiveCommandWithin(DWORD timeoutMilliseconds, BOOL *timedOut)
+{
+	PlatformEvent *readyEvents[USB_HID_MAX_DEVICES + 2];
+	TimedReport report;
+	int deviceIndex, count, eventCount;
+	unsigned long long deadline = getMonotonicTime() + (unsigned long long) timeoutMilliseconds * 1000000ULL;
+
+	//OutputDebugString("receiveCommand");
+	*timedOut = FALSE;
+
+	// Take the next report read by the event loop, waiting for one if none is queued.
+	// The devices are looked at in turn, starting after the last one served.
+	// The detach releases the wait, and so does releaseCommandWaiters.
+	for (;;)
+	{
+		if (loadAtomic64(&commandWaitersReleased))
+			return NULL;
+
+		count = getDeviceCount();
+		eventCount = 0;
+
+		for (deviceIndex = 0; deviceIndex < count; deviceIndex++)
+		{
+			UsbHidDevice *device = &devices[(nextReceivedDevice + deviceIndex) % count];
+
+			if (!loadAtomic64(&device->deviceAttached))
+				continue;
+
+			if (popReport(&device->reportQueue, &report))
+			{
+				nextReceivedDevice = (device->deviceIndex + 1) % count;
+
+				memcpy(device->inputBuffer, report.data, REPORT_SIZE);
+				decodeHidButtons(&device->model, report.data, REPORT_SIZE, &device->inputState);
+				device->inputReportTime = report.time;
+				device->inputEcho = report.echo;
+				return device;
+			}
+
+			readyEvents[eventCount++] = device->reportQueue.readyEvent;
+		}
+
+		// A device plugged in meanwhile is served as well, and waited for while there is none
+		readyEvents[eventCount++] = deviceArrivalEvent;
+		readyEvents[eventCount++] = commandReleaseEvent;
+		if (timeoutMilliseconds != PLATFORM_WAIT_INFINITE)
+		{
+			unsigned long long now = getMonotonicTime();
+
+			// Rounded up : the caller is never woken up before the deadline
+			timeoutMilliseconds = now < deadline ? (DWORD) ((deadline - now + 999999ULL) / 1000000ULL) : 0;
+		}
+		if (waitForPlatformEvents(readyEvents, eventCount, timeoutMilliseconds) < 0)
+		{
+			*timedOut = TRUE;
+			return NULL;
+		}
+	}
+}
+
+static UsbHidDevice *receiveCommand()
+{
+	BOOL timedOut;
+
+	return receiveCommandWithin(PLATFORM_WAIT_INFINITE, &timedOut);
+}
+
+// This public method releases the threads waiting for a command for good, the devices are left attached
+static void releaseCommandWaiters()
+{
+	storeAtomic64(&commandWaitersReleased, 1);
+	setPlatformEvent(commandReleaseEvent);
+} // END releaseCommandWaiters method
+
+// This public method allows writing to the output buffer
+// Note: you cannot write to byte 0 as these are reserved
+//       by the command communication - bytes 1 to 64 are available
+//		 for data
+static BOOL writeToTheOutputBuffer(UsbHidDevice *device, int byteNumber, byte value)
+{
+	// Do not allow writing to byte 0 or 1, this is ignored
+	if (byteNumber < 1) return FALSE;
+
+	// Do not allow writing to bytes beyond the array size
+	if (byteNumber > 64) return FALSE;
+
+	// Write the byte to the output buffer
+	device->outputBuffer[byteNumber] = value;
+
+	return TRUE;
+} // END writeToTheOutputBuffer method
+
+
+// This public method allows reading from the input buffer
+// Note: you cannot read from byte 0  as these are reserved
+//       by the command communication - bytes 1 to 64 are available
+//		 for data
+static byte readFromTheInputBuffer(UsbHidDevice *device, int byteNumber)
+{
+	// Do not allow reading from byte 0 or 1, just return zero
+	if (byteNumber < 1) return -1;
+
+	// Do not allow reading from bytes beyond the array size, just return zero
+	if (byteNumber > 64) return -1;
+
+	// The input buffer holds the last report received, only written by receiveCommand
+	return device->inputBuffer[byteNumber];
+} // END readFromTheInputBuffer method
+
+// This public method allows reading from the feature buffer
+// Note: you cannot read from byte 0 as these are reserved
+//       by the command communication - bytes 1 to 64 are available
+//		 for data
+static byte readFromTheFeatureBuffer(UsbHidDevice *device, int byteNumber)
+{
+	// Do not allow reading from byte 0 or 1, just return zero
+	if (byteNumber < 1) return -1;
+
+	// Do not allow reading from bytes beyond the array size, just return zero
+	if (byteNumber > 64) return -1;
+
+	return device->featureBuffer[byteNumber];
+} // END readFromTheFeatureBuffer method
+
+
+// UsbHidCommunicator factory
+UsbHidCommunication CreateUsbHidCommunicator()
+{
+	UsbHidCommunication communicator;
+	communicator.cancelAnimation = cancelAnimation;
+	communicator.detachBrokenDevice = reportBrokenDevice;
+	communicator.detachDevice = detachDevice;
+	communicator.detachDevices = detachDevices;
+	communicator.finalizeUsbHidCommunication = finalizeUsbHidCommunication;
+	communicator.findDevices = findDevices;
+	communicator.forceFeature = forceFeature;
+	communicator.forceFeatureLeds = forceFeatureLeds;
+	communicator.getDevice = getDevice;
+	communicator.getDeviceCount = getDeviceCount;
+	communicator.getDeviceIndex = getDeviceIndex;
+	communicator.getInputReport = getInputReport;
+	communicator.getDeviceState = getDeviceState;
+	communicator.getInputReportTime = getInputReportTime;
+	communicator.getInputState = getInputState;
+	communicator.getFeature = getFeature;
+	communicator.handleDeviceChangeMessages = handleDeviceChangeMessages;
+	communicator.initUsbHidCommunication = initUsbHidCommunication;
+	communicator.isDeviceAttached = isDeviceAttached;
+	communicator.isDeviceBroken = isDeviceBroken;
+	communicator.isInputEcho = isInputEcho;
+	communicator.isValidInputState = isValidInputState;
+	communicator.hasLatchedButtons = hasLatchedButtons;
+	communicator.readFromTheFeatureBuffer = readFromTheFeatureBuffer;
+	communicator.readFromTheInputBuffer = readFromTheInputBuffer;
+	communicator.receiveCommand = receiveCommand;
+	communicator.receiveCommandWithin = receiveCommandWithin;
+	communicator.releaseCommandWaiters = releaseCommandWaiters;
+	communicator.requestDeviceNotificationsToForm = requestDeviceNotificationsToForm;
+	communicator.resyncDeviceState = resyncDeviceState;
+	communicator.sendCommandWriteOnly = sendCommandWriteOnly;
+	communicator.sendCommandWriteRead = sendCommandWriteRead;
+	communicator.sendFeature = sendFeature;
+	communicator.setLedLayer = setLedLayer;
+	communicator.startAnimation = startAnimation;
+	communicator.startHotplugMonitoring = startHotplugMonitoring;
+	communicator.stopHotplugMonitoring = stopHotplugMonitoring;
+	communicator.submitAnimation = submitAnimation;
+	communicator.submitCommand = submitCommand;
+	communicator.submitFeature = submitFeature;
+	communicator.submitFeatureLeds = submitFeatureLeds;
+	communicator.writeToTheOutputBuffer = writeToTheOutputBuffer;
+
+	return communicator;
+}
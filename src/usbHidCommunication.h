@@ -1,156 +1,288 @@
-/*
- * Copyright (c) 2012-2019 JoeBilly
- * Copyright (C) 2010 Simon Inns
- * 
- * HID USB communication functions header
- * usbHidCommunication.h
- * JoeBilly (joebilly@users.sourceforge.net)
- * https://github.com/ghoebilly/ts3gamevoice
- *
- * Code adapted from usbHidCommunication
- * v1_1 2010-03-31
- * Simon Inns (simon.inns@gmail.com)
- * http://www.waitingforfriday.com
- * 
- *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
- *
- *  TeamSpeak 3 SideWinder Game Voice Plugin is free software: 
- *	you can redistribute it and/or modify it under the terms of the 
- *	GNU General Public License as published by the Free Software Foundation, 
- *	either version 3 of the License, or (at your option) any later version.
- *
- *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope 
- *  that it will be useful, but WITHOUT ANY WARRANTY; without even the 
- *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
- *  See the GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with TeamSpeak 3 SideWinder Game Voice Plugin. 
- *  If not, see <http://www.gnu.org/licenses/>.
- */
-
-#ifndef USBHIDCOMMUNICATION_H
-#define USBHIDCOMMUNICATION_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-// Flags for the worker thread
-enum eWorkerThreadState {idle, read, writeRead, setFeature, write, terminated};
-
-typedef struct UsbHidCommunication
-{
-// This public method detaches the USB device and forces the 
-// worker threads to cancel IO and abort if required.
-// This is used when we're done communicating with the device
-void (*detachDevice)();
-
-// Constructor method
-void (*initUsbHidCommunication)();
-
-// Destructor method
-void (*finalizeUsbHidCommunication)();
-	
-// This method attempts to find the target USB device and discover the device's path
-//
-// Note: A limitation of this routine is that it cannot deal with two or more devices
-//       connected to the host that have the same VID and PID, it will simply pick
-//       the first one it finds...
-void (*findDevice)(int usbVid, int usbPid);
-			
-// This public method requests that device notification messages are sent to the calling form
-// which the form must catch with a WndProc override.
-//
-// You will need to supply the handle of the calling form for this to work, usually
-// specified with 'this->form'.  Something like the following line needs to be placed
-// in the form's contructor method:
-// 
-// a_usbHidCommunication.requestDeviceNotificationsToForm(this->Handle);
-// 
-void (*requestDeviceNotificationsToForm)(HANDLE handleOfWindow);
-
-// This public method filters WndProc notification messages for the required
-// device notifications and triggers a re-detection of the USB device if required.
-//
-// The main form of the application needs to include an override of the WndProc
-// class for this to be called, usually this is defined as a protected method
-// of the main form and looks like the following:
-//
-// protected: virtual void WndProc(Message% m) override
-//		{
-//			a_usbHidCommunication.handleDeviceChangeMessages(m, vid, pid);
-//			Form::WndProc( m ); // Call the original method
-//		} // END WndProc method
-//
-void (*handleDeviceChangeMessages)(UINT uMsg, WPARAM wParam, LPARAM lParam, int vid, int pid);
-
-// This private method detaches the USB device and forces the 
-// worker threads to cancel IO and abort if required.
-// If the USB device stops responding to the read/write
-// operations (due to a software or firmware bug) you can use
-// this method to recover back into a known state.
-void (*detachBrokenDevice)();
-
-// Define public method for reading the deviceAttached flag
-BOOL (*isDeviceAttached)(void);
-
-// Define public method for reading the deviceAttachedButBroken flag
-BOOL (*isDeviceBroken)(void);
-
-// The following method forces a feature request to the USB device (the device must have been found first!)
-BOOL (*forceFeature)(int usbCommandId);
-
-// The following method gets a report request from the USB device (the device must have been found first!)
-byte(*getInputReport)();
-
-// The following method gets a feature request from the USB device (the device must have been found first!)
-byte (*getFeature)();
-
-// The following method sends a feature request to the USB device (the device must have been found first!)
-BOOL (*sendFeature)(int usbCommandId);
-
-// The following method sends a command to the USB device (the device must have been found first!)
-// This method is for commands that are sent, but no input is returned from the device
-BOOL (*sendCommandWriteOnly)(int usbCommandId);
-
-// The following method sends a command to the USB device (the device must have been found first!)
-// This method is for commands that are sent and expect a reply
-BOOL (*sendCommandWriteRead)(int usbCommandId);
-
-// The following method receive a command from the USB device (the device must have been found first!)
-// This method is for commands that are received and expect a reply
-BOOL (*receiveCommand)();
-
-// This public method allows writing to the output buffer
-// Note: you cannot write to byte 0 as these are reserved
-//       by the command communication - bytes 1 to 64 are available
-//		 for data
-BOOL (*writeToTheOutputBuffer)(int byteNumber, byte value);
-
-// This public method allows reading from the input buffer
-// Note: you cannot read from byte 0  as these are reserved
-//       by the command communication - bytes 1 to 64 are available
-//		 for data
-byte (*readFromTheInputBuffer)(int byteNumber);
-
-// This public method allows reading from the feature buffer
-// Note: you cannot read from byte 0 as these are reserved
-//       by the command communication - bytes 1 to 64 are available
-//		 for data
-byte (*readFromTheFeatureBuffer)(int byteNumber);
-
-// This public method allows writing to the feature buffer
-// Note: you cannot write to byte 0 as these are reserved
-//       by the command communication - bytes 1 to 64 are available
-//		 for data
-BOOL (*writeToTheFeatureBuffer)(int byteNumber, byte value);	
-} UsbHidCommunication;
-
-UsbHidCommunication CreateUsbHidCommunicator();
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif
\ No newline at end of file
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ * Copyright (C) 2010 Simon Inns
+ * 
+ * HID USB communication functions header
+ * usbHidCommunication.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ * Code adapted from usbHidCommunication
+ * v1_1 2010-03-31
+ * Simon Inns (simon.inns@gmail.com)
+ * http://www.waitingforfriday.com
+ * 
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software: 
+ *	you can redistribute it and/or modify it under the terms of the 
+ *	GNU General Public License as published by the Free Software Foundation, 
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope 
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the 
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin. 
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef USBHIDCOMMUNICATION_H
+#define USBHIDCOMMUNICATION_H
+
+#include "hidRequest.h"
+#include "ledCompositor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Flags for the event loop thread
+enum eWorkerThreadState {idle, read, writeRead, setFeature, write, terminated};
+
+// Outcome of a feature write : failed, transferred, or dropped since the device already holds the value
+enum FeatureWriteResult {featureWriteFailed, featureWritten, featureUnchanged};
+
+// Maximum number of devices driven at once
+#define USB_HID_MAX_DEVICES 16
+
+// Maximum number of device models (VID and PID) attached by the hotplug monitor
+#define USB_HID_MAX_DEVICE_IDS 16
+
+// USB VID and PID of a supported device model, tables of them end with a zero VID
+typedef struct UsbDeviceId
+{
+	int vid;
+	int pid;
+} UsbDeviceId;
+
+// Device found by findDevices or plugged in later : its own buffers, request and report queues and state.
+// A device keeps its index and address until the communication is finalized,
+// it is only attached again (or not) by the next findDevices or hotplug event.
+typedef struct UsbHidDevice UsbHidDevice;
+
+typedef struct UsbHidCommunication
+{
+// This public method detaches the USB device and forces the 
+// event loop to cancel its IO if required.
+// This is used when we're done communicating with the device
+void (*detachDevice)(UsbHidDevice *device);
+
+// This public method detaches all the USB devices
+void (*detachDevices)();
+
+// Constructor method, starts the event loop thread serving all the devices
+void (*initUsbHidCommunication)();
+
+// Destructor method
+void (*finalizeUsbHidCommunication)();
+	
+// This method attempts to find every target USB device and attach to them,
+// in a stable order while the devices stay plugged in : the devices of the first VID and PID
+// of the table come first. The buttons and LEDs of every device are found from its report
+// descriptor, and mapped onto the 8 bits button/LED register of the Game Voice.
+// The devices already attached are detached first.
+// Returns the number of devices found, including the ones found broken.
+int (*findDevices)(const UsbDeviceId *deviceIds);
+
+// Gets the number of device slots used by the last findDevices and the hotplug events since
+int (*getDeviceCount)(void);
+
+// Gets a device found by the last findDevices or plugged in since, NULL if there are not as many devices
+UsbHidDevice *(*getDevice)(int deviceIndex);
+
+// Gets the index of a device
+int (*getDeviceIndex)(UsbHidDevice *device);
+			
+// This public method requests that device notification messages are sent to the calling form
+// which the form must catch with a WndProc override.
+//
+// You will need to supply the handle of the calling form for this to work, usually
+// specified with 'this->form'.  Something like the following line needs to be placed
+// in the form's contructor method:
+// 
+// a_usbHidCommunication.requestDeviceNotificationsToForm(this->Handle);
+// 
+void (*requestDeviceNotificationsToForm)(HANDLE handleOfWindow);
+
+// This public method starts monitoring the devices plugged in and unplugged, after findDevices.
+// Only the device matching a VID and PID of the table is attached or detached, the devices already attached
+// are not disturbed. The events are handled on the monitor thread, findDevices must not run meanwhile.
+// Returns FALSE if the device changes can't be monitored.
+BOOL (*startHotplugMonitoring)(const UsbDeviceId *deviceIds);
+
+// This public method stops monitoring the devices plugged in and unplugged
+void (*stopHotplugMonitoring)();
+
+// This public method filters WndProc notification messages for the required
+// device notifications and attaches or detaches the affected USB device if required.
+// Alternative to startHotplugMonitoring for applications with their own window.
+//
+// The main form of the application needs to include an override of the WndProc
+// class for this to be called, usually this is defined as a protected method
+// of the main form and looks like the following:
+//
+// protected: virtual void WndProc(Message% m) override
+//		{
+//			a_usbHidCommunication.handleDeviceChangeMessages(m, vid, pid);
+//			Form::WndProc( m ); // Call the original method
+//		} // END WndProc method
+//
+void (*handleDeviceChangeMessages)(UINT uMsg, WPARAM wParam, LPARAM lParam, int vid, int pid);
+
+// This method reports the USB device broken : the recovery supervisor (started with the
+// communication) detaches it and forces the event loop to cancel its IO and abort if required.
+// If the USB device stops responding to the read/write
+// operations (due to a software or firmware bug) you can use
+// this method to recover back into a known state, from any thread.
+// The supervisor also reports a transfer not completed in time on its own, then reopens the
+// device with an exponential backoff and replays the last feature requested. An event loop
+// stuck in the transfer despite the cancellation is abandoned to it and replaced.
+void (*detachBrokenDevice)(UsbHidDevice *device);
+
+// Define public method for reading the deviceAttached flag
+BOOL (*isDeviceAttached)(UsbHidDevice *device);
+
+// Define public method for reading the deviceAttachedButBroken flag, set until the device is recovered
+BOOL (*isDeviceBroken)(UsbHidDevice *device);
+
+// The following method forces a feature request to the USB device (the device must have been found first!)
+// The event loop, the only writer of the LEDs, sets it and the caller waits for it : featureWritten once
+// it is done, even if the LEDs shown did not change (the device shows them already, or a layer above hides them).
+enum FeatureWriteResult (*forceFeature)(UsbHidDevice *device, int usbCommandId);
+
+// The following method forces the LEDs of a mask to the USB device like forceFeature, the others are left
+// as they are (the device must have been found first!) The buttons toggled meanwhile by the user are never lost.
+enum FeatureWriteResult (*forceFeatureLeds)(UsbHidDevice *device, byte mask, byte leds);
+
+// The following method gets a report request from the USB device (the device must have been found first!)
+byte(*getInputReport)(UsbHidDevice *device);
+
+// The following method reads the button/LED register from the device, updating the cached device state
+// (the device must have been found first!) For a device not echoing its LEDs, these are its buttons.
+// The event loop reads it, the caller waits for the request : the cached state is returned if it fails.
+byte (*resyncDeviceState)(UsbHidDevice *device);
+
+// Define public method for reading the cached button/LED register of the device.
+// The event loop updates it with every input report and feature write, no IO is ever performed :
+// 0 (no button active) until something has been read or written, see resyncDeviceState.
+// This is the status layer of the LEDs : the LEDs shown are this state under the layers above it (see setLedLayer).
+byte (*getDeviceState)(UsbHidDevice *device);
+
+// Define public method for reading the monotonic timestamp (nanoseconds) of the last input report read
+unsigned long long (*getInputReportTime)(UsbHidDevice *device);
+
+// Define public method for reading the buttons of the last input report read, as the 8 bits
+// button/LED register whatever the report layout of the device (button n is bit n)
+byte (*getInputState)(UsbHidDevice *device);
+
+// Define public method telling whether the last input report received is the echo of a feature write
+// (the LED state written, reported back by the device) rather than a change made by the user
+BOOL (*isInputEcho)(UsbHidDevice *device);
+
+// Define public method checking a button model register against the states the device can report,
+// see HidDeviceModel.validStates
+BOOL (*isValidInputState)(UsbHidDevice *device, byte state);
+
+// The following method determines whether the buttons of the device are latched (see HidDeviceModel) :
+// a press toggles the button, the release is not reported
+BOOL (*hasLatchedButtons)(UsbHidDevice *device);
+
+// The following method gets a feature request from the USB device (the device must have been found first!)
+// The event loop reads it, the caller waits for the request.
+// Returns the LEDs as the button/LED register, 0 if the device can't report them.
+byte (*getFeature)(UsbHidDevice *device);
+
+// The following method sends a feature request to the USB device (the device must have been found first!)
+BOOL (*sendFeature)(UsbHidDevice *device, int usbCommandId);
+
+// The following method submits a feature request to the USB device (the device must have been found first!)
+// Features queued while the event loop is busy are merged, only the last one is transferred,
+// and unchanged features are dropped.
+// The returned request is completed once the feature is shown : the caller may wait for it,
+// poll it or get the callback (optional) called, then must release it with releaseHidRequest.
+// Returns NULL if the device is not attached or not responding.
+HidRequest *(*submitFeature)(UsbHidDevice *device, int usbCommandId, HidRequestCallback callback, LPVOID context);
+
+// The following method submits the LEDs of a mask to the USB device like submitFeature, the others are left
+// as they are (the device must have been found first!)
+HidRequest *(*submitFeatureLeds)(UsbHidDevice *device, byte mask, byte leds, HidRequestCallback callback, LPVOID context);
+
+// The following method shows the LEDs of a mask on a layer above the device state (see ledCompositor.h),
+// a mask of 0 clears the layer. Lock free and without waiting, from any thread : the event loop composes
+// the layers and writes the LEDs once for all the changes, only when they differ from the LEDs shown.
+// The layer is kept while the device is detached. Returns FALSE for the status and animation layers,
+// set by the features and the animations.
+BOOL (*setLedLayer)(UsbHidDevice *device, enum LedLayer layer, byte mask, byte leds);
+
+// The following method submits a command to the USB device (the device must have been found first!)
+// The returned request is completed once the command is written, see submitFeature.
+HidRequest *(*submitCommand)(UsbHidDevice *device, int usbCommandId, HidRequestCallback callback, LPVOID context);
+
+// The following method submits an LED animation to the USB device (the device must have been found first!)
+// The event loop plays the timeline on the layer (see ledAnimation.h), a NULL timeline cancels the layer
+// (every layer with LED_ANIMATION_ALL_LAYERS). The animations show on the animation layer of the LEDs, over the
+// device state and the notifications : the features sent meanwhile set the device state shown again once
+// no animation plays. The returned request is completed once the animation
+// is started or cancelled and the LEDs show it, see submitFeature.
+HidRequest *(*submitAnimation)(UsbHidDevice *device, const LedTimeline *timeline, int layer, HidRequestCallback callback, LPVOID context);
+
+// The following method starts an LED animation on a layer of the USB device without waiting, see submitAnimation
+BOOL (*startAnimation)(UsbHidDevice *device, const LedTimeline *timeline, int layer);
+
+// The following method cancels the LED animation of a layer of the USB device without waiting, see submitAnimation
+BOOL (*cancelAnimation)(UsbHidDevice *device, int layer);
+
+// The following method sends a command to the USB device (the device must have been found first!)
+// This method is for commands that are sent, but no input is returned from the device
+BOOL (*sendCommandWriteOnly)(UsbHidDevice *device, int usbCommandId);
+
+// The following method sends a command to the USB device (the device must have been found first!)
+// This method is for commands that are sent and expect a reply
+BOOL (*sendCommandWriteRead)(UsbHidDevice *device, int usbCommandId);
+
+// The following method receive a command from any USB device (the devices must have been found first!)
+// It waits for the next input report read by the event loop and returns its device,
+// getInputState (or readFromTheInputBuffer, for the raw report) then reads it.
+// While no device is attached it waits for one to be plugged in. Returns NULL once the waiters are released.
+// Reports are queued in order, none is lost or merged while the previous one is processed.
+// The devices are served in turn so a busy device does not starve the others.
+UsbHidDevice *(*receiveCommand)();
+
+// The following method receives a command like receiveCommand, waiting for it at most the timeout
+// (milliseconds, or PLATFORM_WAIT_INFINITE). Returns NULL and sets timedOut when no report came in time.
+UsbHidDevice *(*receiveCommandWithin)(DWORD timeoutMilliseconds, BOOL *timedOut);
+
+// The following method releases the threads waiting for a command, for good (shutdown) :
+// receiveCommand returns NULL from then on, the devices stay attached until finalizeUsbHidCommunication.
+void (*releaseCommandWaiters)();
+
+// This public method allows writing to the output buffer
+// Note: you cannot write to byte 0 as these are reserved
+//       by the command communication - bytes 1 to 64 are available
+//		 for data
+BOOL (*writeToTheOutputBuffer)(UsbHidDevice *device, int byteNumber, byte value);
+
+// This public method allows reading from the input buffer
+// Note: you cannot read from byte 0  as these are reserved
+//       by the command communication - bytes 1 to 64 are available
+//		 for data
+byte (*readFromTheInputBuffer)(UsbHidDevice *device, int byteNumber);
+
+// This public method allows reading from the feature buffer
+// Note: you cannot read from byte 0 as these are reserved
+//       by the command communication - bytes 1 to 64 are available
+//		 for data
+// The feature buffer holds the last feature got with getFeature, the features sent carry their LEDs only.
+byte (*readFromTheFeatureBuffer)(UsbHidDevice *device, int byteNumber);
+} UsbHidCommunication;
+
+UsbHidCommunication CreateUsbHidCommunicator();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
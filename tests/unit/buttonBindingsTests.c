@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Unit tests of the button bindings
+ * buttonBindingsTests.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string.h>
+#include "unitTests.h"
+#include "buttonBindings.h"
+
+// Event of a binding case : a button event (edge of a button), or a gesture (type of a button combination)
+typedef struct BindingEvent
+{
+	BOOL gesture;
+	int edgeOrType;
+	byte buttons;
+} BindingEvent;
+
+#define BUTTON_EVENT(edge, button) {FALSE, (edge), (byte) (button)}
+#define GESTURE_EVENT(type, buttons) {TRUE, (type), (byte) (buttons)}
+
+// Setting accepted, its binding count and the bindings of one event, described as
+// "<modifier mask>/<modifier state>=<action>[:<argument>],..." in hexadecimal and separated by spaces
+typedef struct BindingCase
+{
+	const char *setting;
+	unsigned int bindingCount;
+	BindingEvent event;
+	const char *expected;
+} BindingCase;
+
+static const BindingCase bindingCases[] =
+{
+	{DEFAULT_BUTTON_BINDINGS, 6, BUTTON_EVENT(buttonDown, 7), "00/00=mute_input"},
+	{DEFAULT_BUTTON_BINDINGS, 6, BUTTON_EVENT(buttonDown, 6), "80/00=mute_output"},
+	{DEFAULT_BUTTON_BINDINGS, 6, BUTTON_EVENT(buttonPress, 1), "c0/00=bookmark:TEAM"},
+	{DEFAULT_BUTTON_BINDINGS, 6, BUTTON_EVENT(buttonRelease, 1), ""},
+	{"", 0, BUTTON_EVENT(buttonPress, 0), ""},
+	{" ;;\n; ", 0, BUTTON_EVENT(buttonPress, 0), ""},
+	{"PRESS_TEAM/+MUTE-COMMAND = away , back", 1, BUTTON_EVENT(buttonPress, 1), "c0/80=away,back"},
+	{"UP_CHANNEL_4/-CHANNEL_3=unmute_output", 1, BUTTON_EVENT(buttonUp, 5), "10/00=unmute_output"},
+	{"TAP_ALL=away;PRESS_ALL=back;TAP_ALL/+MUTE=back", 3, GESTURE_EVENT(gestureTap, 0x01), "00/00=away 80/80=back"},
+	{"CHORD_ALL+TEAM=bookmark: My server \r\n", 1, GESTURE_EVENT(gestureChord, 0x03), "00/00=bookmark:My server"},
+	{"CHORD_TEAM+ALL=mute_input", 1, GESTURE_EVENT(gestureChord, 0x03), "00/00=mute_input"},
+	{"DOUBLE_CHANNEL_1=mute_input\nHOLD_CHANNEL_4=unmute_input", 2, GESTURE_EVENT(gestureHold, 0x20), "00/00=unmute_input"},
+	{"DOUBLE_CHANNEL_1=mute_input\nHOLD_CHANNEL_4=unmute_input", 2, GESTURE_EVENT(gestureDoubleTap, 0x04), "00/00=mute_input"},
+	{"DOUBLE_CHANNEL_1=mute_input\nHOLD_CHANNEL_4=unmute_input", 2, GESTURE_EVENT(gestureHold, 0x04), ""}
+};
+
+// Settings rejected
+static const char *rejectedSettings[] =
+{
+	"PRESS_TEAM=explode",
+	"PRESS_BOGUS=away",
+	"PRESS_CHANNEL_=away",
+	"press_team=away",
+	"SLIDE_TEAM=away",
+	"PRESS_ALL+TEAM=away",
+	"TAP_ALL+TEAM=away",
+	"CHORD_ALL=away",
+	"CHORD_ALL+ALL=away",
+	"PRESS_TEAM/+TEAM=away",
+	"PRESS_TEAM/*MUTE=away",
+	"PRESS_TEAM/+MUTE+MUTE=away",
+	"PRESS_TEAM/=away",
+	"PRESS_TEAM",
+	"PRESS_TEAM away",
+	"PRESS_TEAM=",
+	"PRESS_TEAM=away,",
+	"PRESS_TEAM=away back",
+	"PRESS_TEAM=away:x",
+	"PRESS_TEAM=bookmark",
+	"PRESS_TEAM=bookmark:",
+	"PRESS_TEAM=bookmark: ,away",
+	"PRESS_TEAM=away;PRESS_ALL=bogus"
+};
+
+static unsigned int getBindingEventCode(const BindingEvent *event)
+{
+	return event->gesture ? getGestureEventCode((enum GestureType) event->edgeOrType, event->buttons)
+		: getButtonEventCode((enum ButtonEdge) event->edgeOrType, event->buttons);
+}
+
+// Describes the bindings of an event, in the format of the expected ones
+static void describeBindings(const ButtonBindings *bindings, unsigned int eventCode, char *text, size_t size)
+{
+	unsigned int count, bindingIndex;
+	const ButtonBinding *binding = getEventBindings(bindings, eventCode, &count);
+	size_t length = 0;
+
+	text[0] = '\0';
+	for (bindingIndex = 0; bindingIndex < count && length < size; bindingIndex++, binding++)
+	{
+		unsigned int actionIndex;
+
+		length += (size_t) snprintf(text + length, size - length, "%s%02x/%02x=", bindingIndex == 0 ? "" : " ",
+			binding->modifierMask, binding->modifierState);
+		for (actionIndex = 0; actionIndex < binding->actionCount && length < size; actionIndex++)
+		{
+			const ButtonAction *action = &bindings->actions[binding->firstAction + actionIndex];
+			static const char *actionNames[buttonActionTypeCount] =
+			{
+				"mute_input", "unmute_input", "mute_output", "unmute_output", "away", "back", "bookmark"
+			};
+
+			length += (size_t) snprintf(text + length, size - length, "%s%s%s%s", actionIndex == 0 ? "" : ",",
+				actionNames[action->type], action->argument[0] != '\0' ? ":" : "", action->argument);
+		}
+	}
+}
+
+static void checkBindingCases(void)
+{
+	size_t caseIndex;
+
+	for (caseIndex = 0; caseIndex < sizeof(bindingCases) / sizeof(bindingCases[0]); caseIndex++)
+	{
+		const BindingCase *testCase = &bindingCases[caseIndex];
+		static ButtonBindings bindings;
+		char description[256];
+		char name[512];
+
+		if (!CHECK(testCase->setting, parseButtonBindings(testCase->setting, &bindings)))
+			continue;
+
+		CHECK_EQUAL(testCase->setting, testCase->bindingCount, bindings.bindingCount);
+		describeBindings(&bindings, getBindingEventCode(&testCase->event), description, sizeof(description));
+		snprintf(name, sizeof(name), "%s: \"%s\"", testCase->setting, description);
+		CHECK(name, strcmp(description, testCase->expected) == 0);
+	}
+}
+
+// Checks a setting is rejected, the bindings left alone
+static void checkRejected(const char *testCase, const char *setting)
+{
+	static ButtonBindings bindings, original;
+
+	parseButtonBindings(DEFAULT_BUTTON_BINDINGS, &bindings);
+	original = bindings;
+
+	CHECK(testCase, !parseButtonBindings(setting, &bindings));
+	CHECK(testCase, memcmp(&bindings, &original, sizeof(bindings)) == 0);
+}
+
+static void checkRejectedSettings(void)
+{
+	static ButtonBindings bindings;
+	static char setting[BUTTON_ACTIONS_MAX * 16];
+	size_t caseIndex, length;
+	int index;
+
+	for (caseIndex = 0; caseIndex < sizeof(rejectedSettings) / sizeof(rejectedSettings[0]); caseIndex++)
+		checkRejected(rejectedSettings[caseIndex], rejectedSettings[caseIndex]);
+
+	// Bookmark label of the argument size, without room for its terminator
+	strcpy(setting, "PRESS_TEAM=bookmark:");
+	length = strlen(setting);
+	memset(setting + length, 'x', BUTTON_ACTION_ARGUMENT_SIZE);
+	setting[length + BUTTON_ACTION_ARGUMENT_SIZE] = '\0';
+	checkRejected("too long bookmark label", setting);
+	setting[length + BUTTON_ACTION_ARGUMENT_SIZE - 1] = '\0';
+	CHECK("longest bookmark label", parseButtonBindings(setting, &bindings));
+
+	// One binding more than the table
+	setting[0] = '\0';
+	for (index = 0; index <= BUTTON_BINDINGS_MAX; index++)
+		strcat(setting, "TAP_ALL=away;");
+	checkRejected("too many bindings", setting);
+
+	// One action more than the table
+	strcpy(setting, "TAP_ALL=away");
+	for (index = 1; index <= BUTTON_ACTIONS_MAX; index++)
+		strcat(setting, ",back");
+	checkRejected("too many actions", setting);
+}
+
+// Modifiers of a binding, the states of the register and whether it runs
+typedef struct ModifierCase
+{
+	const char *setting;
+	byte state;
+	BOOL matches;
+} ModifierCase;
+
+static const ModifierCase modifierCases[] =
+{
+	{"PRESS_TEAM=away", 0xff, TRUE},
+	{"PRESS_TEAM=away", 0x00, TRUE},
+	{"PRESS_TEAM/+MUTE-COMMAND=away", 0x80, TRUE},
+	{"PRESS_TEAM/+MUTE-COMMAND=away", 0x83, TRUE},
+	{"PRESS_TEAM/+MUTE-COMMAND=away", 0xc0, FALSE},
+	{"PRESS_TEAM/+MUTE-COMMAND=away", 0x00, FALSE},
+	{"PRESS_TEAM/-ALL=away", 0x02, TRUE},
+	{"PRESS_TEAM/-ALL=away", 0x03, FALSE}
+};
+
+static void checkModifierCases(void)
+{
+	size_t caseIndex;
+
+	for (caseIndex = 0; caseIndex < sizeof(modifierCases) / sizeof(modifierCases[0]); caseIndex++)
+	{
+		const ModifierCase *testCase = &modifierCases[caseIndex];
+		static ButtonBindings bindings;
+		const ButtonBinding *binding;
+		unsigned int count;
+
+		if (!CHECK(testCase->setting, parseButtonBindings(testCase->setting, &bindings)))
+			continue;
+
+		binding = getEventBindings(&bindings, getButtonEventCode(buttonPress, 1), &count);
+		if (CHECK_EQUAL(testCase->setting, 1, count))
+			CHECK_EQUAL(testCase->setting, testCase->matches, matchesBindingModifiers(binding, testCase->state));
+	}
+}
+
+int main(void)
+{
+	static ButtonBindings bindings;
+	unsigned int count;
+
+	checkBindingCases();
+	checkRejectedSettings();
+	checkModifierCases();
+
+	// Event codes out of the table have no bindings
+	parseButtonBindings(DEFAULT_BUTTON_BINDINGS, &bindings);
+	CHECK("event code out of the table", getEventBindings(&bindings, BINDING_EVENT_CODES, &count) == NULL && count == 0);
+	CHECK("button names", strcmp(getBindingButtonName(2), "CHANNEL_1") == 0 && strcmp(getBindingButtonName(8), "UNKNOWN") == 0);
+
+	return reportChecks("buttonBindingsTests");
+}
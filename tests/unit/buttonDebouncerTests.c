@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Unit tests of the button debounce
+ * buttonDebouncerTests.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string.h>
+#include "unitTests.h"
+#include "buttonDebouncer.h"
+
+#define MS 1000000ULL
+
+// Step of a debounce scenario : a state read, the settle of the windows over, or an echo rebasing the buttons
+enum DebounceOperation {debounceRead, debounceSettle, debounceRebase};
+
+typedef struct DebounceStep
+{
+	enum DebounceOperation operation;
+	unsigned long long time;
+	byte state;
+
+	// Debounced state, changes filtered by the step and settle deadline expected after it
+	byte expectedState;
+	int expectedFiltered;
+	unsigned long long expectedDeadline;
+} DebounceStep;
+
+#define DEBOUNCE_STEPS_MAX 8
+
+typedef struct DebounceScenario
+{
+	const char *name;
+	unsigned long long window;
+	byte initialState;
+	int stepCount;
+	DebounceStep steps[DEBOUNCE_STEPS_MAX];
+} DebounceScenario;
+
+static const DebounceScenario debounceScenarios[] =
+{
+	{"change taken at once", 10 * MS, 0x00, 1, {
+		{debounceRead, 100 * MS, 0x01, 0x01, 0, 0}}},
+	{"bounce filtered then settled released", 10 * MS, 0x00, 4, {
+		{debounceRead, 100 * MS, 0x01, 0x01, 0, 0},
+		{debounceRead, 102 * MS, 0x00, 0x01, 1, 110 * MS},
+		{debounceSettle, 105 * MS, 0x00, 0x01, 0, 110 * MS},
+		{debounceSettle, 110 * MS, 0x00, 0x00, 0, 0}}},
+	{"bounce back to the state taken", 10 * MS, 0x00, 3, {
+		{debounceRead, 100 * MS, 0x01, 0x01, 0, 0},
+		{debounceRead, 101 * MS, 0x00, 0x01, 1, 110 * MS},
+		{debounceRead, 102 * MS, 0x01, 0x01, 0, 0}}},
+	{"change after the window", 10 * MS, 0x00, 2, {
+		{debounceRead, 100 * MS, 0x01, 0x01, 0, 0},
+		{debounceRead, 111 * MS, 0x00, 0x00, 0, 0}}},
+	{"buttons locked separately", 10 * MS, 0x00, 3, {
+		{debounceRead, 100 * MS, 0x01, 0x01, 0, 0},
+		{debounceRead, 105 * MS, 0x02, 0x03, 1, 110 * MS},
+		{debounceSettle, 110 * MS, 0x02, 0x02, 0, 0}}},
+	{"window of 0 filters nothing", 0, 0x00, 3, {
+		{debounceRead, 100 * MS, 0x01, 0x01, 0, 0},
+		{debounceRead, 100 * MS, 0x00, 0x00, 0, 0},
+		{debounceRead, 100 * MS, 0x01, 0x01, 0, 0}}},
+	{"echo rebases without filtering", 10 * MS, 0x00, 3, {
+		{debounceRebase, 100 * MS, 0x05, 0x05, 0, 0},
+		{debounceRead, 101 * MS, 0x05, 0x05, 0, 0},
+		{debounceRead, 102 * MS, 0x04, 0x04, 0, 0}}},
+	{"echo keeps the buttons locked", 10 * MS, 0x00, 3, {
+		{debounceRead, 100 * MS, 0x01, 0x01, 0, 0},
+		{debounceRebase, 101 * MS, 0x00, 0x00, 0, 0},
+		{debounceRead, 102 * MS, 0x01, 0x00, 1, 110 * MS}}}
+};
+
+static void runDebounceScenario(const DebounceScenario *scenario)
+{
+	unsigned long long windows[BUTTON_TRANSITIONS_MAX];
+	ButtonDebouncer debouncer;
+	int button, stepIndex;
+
+	for (button = 0; button < BUTTON_TRANSITIONS_MAX; button++)
+		windows[button] = scenario->window;
+	initButtonDebouncer(&debouncer, windows, scenario->initialState);
+
+	for (stepIndex = 0; stepIndex < scenario->stepCount; stepIndex++)
+	{
+		const DebounceStep *step = &scenario->steps[stepIndex];
+		int filtered = 0;
+		byte state;
+
+		switch (step->operation)
+		{
+		case debounceRead:
+			state = debounceButtons(&debouncer, step->state, step->time, &filtered);
+			break;
+
+		case debounceSettle:
+			state = settleButtons(&debouncer, step->time);
+			break;
+
+		default:
+			rebaseButtons(&debouncer, step->state);
+			state = debouncer.state;
+			break;
+		}
+
+		CHECK_EQUAL(scenario->name, step->expectedState, state);
+		CHECK_EQUAL(scenario->name, step->expectedFiltered, filtered);
+		CHECK_EQUAL(scenario->name, step->expectedDeadline, getDebounceDeadline(&debouncer));
+	}
+}
+
+// Setting parsed, and the windows of buttons 0 and 7 expected (milliseconds) if valid
+typedef struct WindowsCase
+{
+	const char *setting;
+	BOOL valid;
+	unsigned long long first;
+	unsigned long long last;
+} WindowsCase;
+
+static const WindowsCase windowsCases[] =
+{
+	{"20", TRUE, 20, 20},
+	{"0", TRUE, 0, 0},
+	{"10,10,30,30,10,10,10,40", TRUE, 10, 40},
+	{"1000", TRUE, 1000, 1000},
+	{"", FALSE, 0, 0},
+	{"1001", FALSE, 0, 0},
+	{"-1", FALSE, 0, 0},
+	{"10,20", FALSE, 0, 0},
+	{"10,10,10,10,10,10,10,10,10", FALSE, 0, 0},
+	{"10ms", FALSE, 0, 0},
+	{"10,", FALSE, 0, 0}
+};
+
+static void checkWindowsCases(void)
+{
+	size_t caseIndex;
+
+	for (caseIndex = 0; caseIndex < sizeof(windowsCases) / sizeof(windowsCases[0]); caseIndex++)
+	{
+		const WindowsCase *testCase = &windowsCases[caseIndex];
+		unsigned long long windows[BUTTON_TRANSITIONS_MAX];
+		unsigned long long untouched[BUTTON_TRANSITIONS_MAX];
+
+		memset(windows, 0xab, sizeof(windows));
+		memcpy(untouched, windows, sizeof(windows));
+
+		CHECK_EQUAL(testCase->setting, testCase->valid, parseDebounceWindows(testCase->setting, windows));
+		if (testCase->valid)
+		{
+			CHECK_EQUAL(testCase->setting, testCase->first * MS, windows[0]);
+			CHECK_EQUAL(testCase->setting, testCase->last * MS, windows[BUTTON_TRANSITIONS_MAX - 1]);
+		}
+		else
+			CHECK(testCase->setting, memcmp(windows, untouched, sizeof(windows)) == 0);
+	}
+}
+
+int main(void)
+{
+	size_t scenarioIndex;
+
+	for (scenarioIndex = 0; scenarioIndex < sizeof(debounceScenarios) / sizeof(debounceScenarios[0]); scenarioIndex++)
+		runDebounceScenario(&debounceScenarios[scenarioIndex]);
+	checkWindowsCases();
+
+	return reportChecks("buttonDebouncerTests");
+}
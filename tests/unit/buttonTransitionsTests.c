@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Unit tests of the button transitions
+ * buttonTransitionsTests.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "unitTests.h"
+#include "buttonTransitions.h"
+
+// Transitions expected between two states, the buttons changed from the lowest one
+typedef struct TransitionCase
+{
+	const char *name;
+	byte previous;
+	byte current;
+	byte pressed;
+	byte released;
+	int count;
+	int buttons[BUTTON_TRANSITIONS_MAX];
+} TransitionCase;
+
+static const TransitionCase transitionCases[] =
+{
+	{"no change", 0x00, 0x00, 0x00, 0x00, 0, {0}},
+	{"no change held", 0x5a, 0x5a, 0x00, 0x00, 0, {0}},
+	{"press of button 0", 0x00, 0x01, 0x01, 0x00, 1, {0}},
+	{"release of button 7", 0x80, 0x00, 0x00, 0x80, 1, {7}},
+	{"press with a button held", 0x04, 0x0c, 0x08, 0x00, 1, {3}},
+	{"press and release at once", 0x02, 0x10, 0x10, 0x02, 2, {1, 4}},
+	{"chord of the highest buttons", 0x00, 0xc0, 0xc0, 0x00, 2, {6, 7}},
+	{"every button pressed", 0x00, 0xff, 0xff, 0x00, 8, {0, 1, 2, 3, 4, 5, 6, 7}},
+	{"every button toggled", 0x55, 0xaa, 0xaa, 0x55, 8, {0, 1, 2, 3, 4, 5, 6, 7}},
+	{"button 0 among others", 0x01, 0x22, 0x22, 0x01, 3, {0, 1, 5}}
+};
+
+static void checkTransitionCases(void)
+{
+	size_t caseIndex;
+	int transition;
+
+	for (caseIndex = 0; caseIndex < sizeof(transitionCases) / sizeof(transitionCases[0]); caseIndex++)
+	{
+		const TransitionCase *testCase = &transitionCases[caseIndex];
+		ButtonTransitions transitions = getButtonTransitions(testCase->previous, testCase->current);
+
+		CHECK_EQUAL(testCase->name, testCase->pressed, transitions.pressed);
+		CHECK_EQUAL(testCase->name, testCase->released, transitions.released);
+		CHECK_EQUAL(testCase->name, testCase->count, transitions.count);
+		for (transition = 0; transition < testCase->count && transition < transitions.count; transition++)
+		{
+			int button = testCase->buttons[transition];
+
+			CHECK_EQUAL(testCase->name, button, getTransitionButton(&transitions, transition));
+			CHECK_EQUAL(testCase->name, (testCase->current >> button) & 1, isPressTransition(&transitions, transition));
+		}
+	}
+}
+
+// Every pair of states against the bits of their difference, in order
+static void checkEveryState(void)
+{
+	char name[32];
+	int previous, current, button;
+
+	for (previous = 0; previous < 256; previous++)
+	{
+		for (current = 0; current < 256; current++)
+		{
+			ButtonTransitions transitions = getButtonTransitions((byte) previous, (byte) current);
+			int transition = 0;
+			BOOL ordered = TRUE;
+
+			for (button = 0; button < BUTTON_TRANSITIONS_MAX; button++)
+			{
+				if ((((previous ^ current) >> button) & 1) == 0)
+					continue;
+
+				ordered = ordered && transition < transitions.count && getTransitionButton(&transitions, transition) == button
+					&& isPressTransition(&transitions, transition) == ((current >> button) & 1);
+				transition++;
+			}
+
+			snprintf(name, sizeof(name), "states %02x to %02x", previous, current);
+			CHECK(name, ordered && transition == transitions.count);
+			CHECK(name, transitions.pressed == (byte) (current & ~previous) && transitions.released == (byte) (previous & ~current));
+		}
+	}
+}
+
+int main(void)
+{
+	checkTransitionCases();
+	checkEveryState();
+
+	return reportChecks("buttonTransitionsTests");
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Unit tests of the command state snapshots
+ * commandStateTests.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <string.h>
+#include "unitTests.h"
+#include "platform.h"
+#include "commandState.h"
+
+// The commands and the LEDs are set apart : neither overwrites the other
+static void checkCommandAndLeds(void)
+{
+	CommandState commandState;
+	GameVoiceSnapshot snapshot;
+
+	initCommandState(&commandState);
+	readCommandState(&commandState, &snapshot);
+	CHECK_EQUAL("initial state", 0, snapshot.sequence);
+	CHECK_EQUAL("initial state", 0, snapshot.buttons);
+	CHECK_EQUAL("initial state", 0, snapshot.leds);
+
+	setCommandStateLeds(&commandState, 0xFF, 0x81);
+	publishCommandState(&commandState, 0x12, 0x34, 0x0812, 123456789ULL);
+	readCommandState(&commandState, &snapshot);
+	CHECK_EQUAL("command published", 1, snapshot.sequence);
+	CHECK_EQUAL("command published", 0x12, snapshot.buttons);
+	CHECK_EQUAL("command published", 0x34, snapshot.previousButtons);
+	CHECK_EQUAL("command published", 0x0812, snapshot.effectiveCommand);
+	CHECK_EQUAL("command published", 123456789ULL, snapshot.commandTime);
+	CHECK_EQUAL("LEDs kept by a command", 0x81, snapshot.leds);
+
+	setCommandStateLeds(&commandState, 0x0F, 0x06);
+	readCommandState(&commandState, &snapshot);
+	CHECK_EQUAL("LEDs of the mask only", 0x86, snapshot.leds);
+	CHECK_EQUAL("command kept by the LEDs", 1, snapshot.sequence);
+	CHECK_EQUAL("command kept by the LEDs", 0x12, snapshot.buttons);
+	CHECK_EQUAL("command kept by the LEDs", 0x0812, snapshot.effectiveCommand);
+
+	setCommandStateLeds(&commandState, 0x01, 0xFE);
+	readCommandState(&commandState, &snapshot);
+	CHECK_EQUAL("LEDs outside the mask ignored", 0x86, snapshot.leds);
+}
+
+// Commands published by a thread while another one sets the LEDs and a third one reads the snapshots
+#define PUBLISHED_COMMANDS 200000
+
+typedef struct ConcurrentContext
+{
+	CommandState *commandState;
+	volatile long long publishing;
+
+	// LED settings overwritten by a command
+	int lostLeds;
+} ConcurrentContext;
+
+// Every command is derived from its number : a snapshot mixing two of them is torn
+static DWORD WINAPI commandThread(LPVOID argument)
+{
+	ConcurrentContext *context = (ConcurrentContext *) argument;
+	unsigned long long command;
+
+	for (command = 1; command <= PUBLISHED_COMMANDS; command++)
+		publishCommandState(context->commandState, (byte) command, (byte) (command - 1), (size_t) (command & 0xFFFF), command);
+
+	storeAtomic64(&context->publishing, FALSE);
+	return 0;
+}
+
+// The only thread setting the LEDs : the ones it set last are the ones read back
+static DWORD WINAPI ledThread(LPVOID argument)
+{
+	ConcurrentContext *context = (ConcurrentContext *) argument;
+	byte leds = 0;
+
+	while (loadAtomic64(&context->publishing))
+	{
+		GameVoiceSnapshot snapshot;
+
+		leds++;
+		setCommandStateLeds(context->commandState, 0xFF, leds);
+		readCommandState(context->commandState, &snapshot);
+		context->lostLeds += snapshot.leds != leds;
+	}
+	return 0;
+}
+
+static void checkConcurrentSnapshots(void)
+{
+	CommandState commandState;
+	ConcurrentContext context;
+	PlatformThread *publisher, *ledSetter;
+	unsigned long long lastSequence = 0;
+	int torn = 0, backwards = 0;
+
+	initCommandState(&commandState);
+	context.commandState = &commandState;
+	context.publishing = TRUE;
+	context.lostLeds = 0;
+	publisher = createPlatformThread(commandThread, &context);
+	ledSetter = createPlatformThread(ledThread, &context);
+	if (!CHECK("concurrent snapshots", publisher != NULL && ledSetter != NULL))
+		return;
+
+	while (loadAtomic64(&context.publishing))
+	{
+		GameVoiceSnapshot snapshot;
+
+		readCommandState(&commandState, &snapshot);
+		torn += snapshot.commandTime != snapshot.sequence
+			|| snapshot.buttons != (byte) snapshot.sequence
+			|| (snapshot.sequence != 0 && snapshot.previousButtons != (byte) (snapshot.sequence - 1))
+			|| snapshot.effectiveCommand != (snapshot.sequence & 0xFFFF);
+		backwards += snapshot.sequence < lastSequence;
+		lastSequence = snapshot.sequence;
+	}
+
+	CHECK("concurrent snapshots", joinPlatformThread(publisher, 5000));
+	CHECK("concurrent snapshots", joinPlatformThread(ledSetter, 5000));
+	CHECK_EQUAL("concurrent snapshots, torn", 0, torn);
+	CHECK_EQUAL("concurrent snapshots, sequence going backwards", 0, backwards);
+	CHECK_EQUAL("concurrent snapshots, LEDs overwritten by a command", 0, context.lostLeds);
+}
+
+int main(void)
+{
+	checkCommandAndLeds();
+	checkConcurrentSnapshots();
+
+	return reportChecks("commandStateTests");
+}
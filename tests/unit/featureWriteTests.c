@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Unit tests of the feature writes against the simulated device
+ * featureWriteTests.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "unitTests.h"
+#include "gamevoice_functions.h"
+#include "hidTransport.h"
+#include "platform.h"
+#include "statistics.h"
+
+// A single Game Voice playing one release only, the features written are echoed back
+#define TEST_DEVICE_SCRIPT "devices=1 rate=1 count=1 steps=0"
+
+static GameVoiceFunctions gameVoice;
+
+// Feature writes counted by the write stage since the last call
+typedef struct FeatureWrites
+{
+	long long submitted;
+	long long sent;
+	long long coalesced;
+} FeatureWrites;
+
+static FeatureWrites takeFeatureWrites(void)
+{
+	FeatureWrites writes;
+
+	writes.submitted = getStatistic(STATISTIC_FEATURES_SUBMITTED);
+	writes.sent = getStatistic(STATISTIC_FEATURES_SENT);
+	writes.coalesced = getStatistic(STATISTIC_FEATURES_COALESCED);
+	resetStatistics();
+	return writes;
+}
+
+static void checkFeatureWrites(const char *testCase, long long submitted, long long sent, long long coalesced)
+{
+	FeatureWrites writes = takeFeatureWrites();
+
+	CHECK_EQUAL(testCase, submitted, writes.submitted);
+	CHECK_EQUAL(testCase, sent, writes.sent);
+	CHECK_EQUAL(testCase, coalesced, writes.coalesced);
+}
+
+// The release played at once sets the register of the device : read before the LEDs are written
+static void waitForTimeline(void)
+{
+	unsigned long long deadline = getMonotonicTime() + 5000000000ULL;
+
+	while (getSimulatedEventsPlayed() == 0 && getMonotonicTime() < deadline)
+		Sleep(1);
+	CHECK_EQUAL("timeline played", 1, getSimulatedEventsPlayed());
+}
+
+static void checkResetWrites(GameVoiceDevice *device)
+{
+	takeFeatureWrites();
+
+	// LEDs on : the first write of the reset switches them off, the second one finds them off
+	CHECK("LEDs set", gameVoice.forceFeature(device, TEAM | CHANNEL_1));
+	checkFeatureWrites("LEDs set", 1, 1, 0);
+	CHECK_EQUAL("LEDs read back", TEAM | CHANNEL_1, gameVoice.resyncDeviceState(device));
+	gameVoice.resetDevice(device);
+	checkFeatureWrites("reset of LEDs on", 2, 1, 1);
+	CHECK_EQUAL("reset of LEDs on", 0, gameVoice.getLastFeatureSent(device));
+
+	// Nothing to write anymore
+	gameVoice.resetDevice(device);
+	checkFeatureWrites("reset of LEDs off", 2, 0, 2);
+	CHECK("same LEDs again", gameVoice.forceFeature(device, NONE));
+	checkFeatureWrites("same LEDs again", 1, 0, 1);
+}
+
+int main(void)
+{
+	GameVoiceDevice *device;
+
+#ifdef _WIN32
+	_putenv_s(SIMULATED_DEVICE_VARIABLE, TEST_DEVICE_SCRIPT);
+#else
+	setenv(SIMULATED_DEVICE_VARIABLE, TEST_DEVICE_SCRIPT, 1);
+#endif
+
+	gameVoice = InitGameVoiceFunctions();
+	if (!CHECK("device loaded", gameVoice.loadDevices()))
+		return reportChecks("featureWriteTests");
+
+	device = gameVoice.getDevice(0);
+	waitForTimeline();
+	checkResetWrites(device);
+
+	gameVoice.releaseCommandWaiters();
+	gameVoice.unloadDevices();
+	return reportChecks("featureWriteTests");
+}
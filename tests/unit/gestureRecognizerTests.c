@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Unit tests of the gesture recognizer
+ * gestureRecognizerTests.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string.h>
+#include "unitTests.h"
+#include "gestureRecognizer.h"
+
+#define MS 1000000ULL
+
+// Step of a gesture scenario : a state of the button register read (momentary or latched buttons),
+// or the timers run. The gestures read after the step are expected as "+TYPE:buttons" (start)
+// and "-TYPE:buttons" (end), separated by spaces.
+enum GestureOperation {gestureRead, gestureToggle, gestureAdvance};
+
+typedef struct GestureStep
+{
+	enum GestureOperation operation;
+	unsigned long long time;
+	byte state;
+	const char *expected;
+} GestureStep;
+
+#define GESTURE_STEPS_MAX 6
+
+typedef struct GestureScenario
+{
+	const char *name;
+	const char *timings;
+	int stepCount;
+	GestureStep steps[GESTURE_STEPS_MAX];
+} GestureScenario;
+
+static const GestureScenario gestureScenarios[] =
+{
+	{"tap after the double tap time", "hold=500,double=250,chord=50", 3, {
+		{gestureRead, 0, 0x01, ""},
+		{gestureRead, 100, 0x00, ""},
+		{gestureAdvance, 349, 0x00, ""}}},
+	{"tap recognized", "hold=500,double=250,chord=50", 3, {
+		{gestureRead, 0, 0x01, ""},
+		{gestureRead, 100, 0x00, ""},
+		{gestureAdvance, 350, 0x00, "+TAP:01 -TAP:01"}}},
+	{"tap on release without double taps", "hold=500,double=0,chord=50", 2, {
+		{gestureRead, 0, 0x04, ""},
+		{gestureRead, 100, 0x00, "+TAP:04 -TAP:04"}}},
+	{"double tap", "hold=500,double=250,chord=50", 4, {
+		{gestureRead, 0, 0x01, ""},
+		{gestureRead, 100, 0x00, ""},
+		{gestureRead, 200, 0x01, "+DOUBLE:01"},
+		{gestureRead, 300, 0x00, "-DOUBLE:01"}}},
+	{"other button ends the tap", "hold=500,double=250,chord=50", 5, {
+		{gestureRead, 0, 0x01, ""},
+		{gestureRead, 100, 0x00, ""},
+		{gestureRead, 150, 0x02, "+TAP:01 -TAP:01"},
+		{gestureRead, 200, 0x00, ""},
+		{gestureAdvance, 450, 0x00, "+TAP:02 -TAP:02"}}},
+	{"hold", "hold=500,double=250,chord=50", 4, {
+		{gestureRead, 0, 0x01, ""},
+		{gestureAdvance, 499, 0x01, ""},
+		{gestureAdvance, 500, 0x01, "+HOLD:01"},
+		{gestureRead, 800, 0x00, "-HOLD:01"}}},
+	{"presses ignored while a hold is active", "hold=500,double=250,chord=50", 4, {
+		{gestureRead, 0, 0x01, ""},
+		{gestureAdvance, 500, 0x01, "+HOLD:01"},
+		{gestureRead, 600, 0x03, ""},
+		{gestureRead, 700, 0x00, "-HOLD:01"}}},
+	{"holds off", "hold=0,double=250,chord=50", 3, {
+		{gestureRead, 0, 0x01, ""},
+		{gestureAdvance, 5000, 0x01, ""},
+		{gestureRead, 5100, 0x00, ""}}},
+	{"chord within the chord time", "hold=500,double=250,chord=50", 4, {
+		{gestureRead, 0, 0x01, ""},
+		{gestureRead, 20, 0x03, ""},
+		{gestureAdvance, 70, 0x03, "+CHORD:03"},
+		{gestureRead, 200, 0x02, "-CHORD:03"}}},
+	{"chord released before the chord time", "hold=500,double=250,chord=50", 2, {
+		{gestureRead, 0, 0x03, ""},
+		{gestureRead, 30, 0x00, "+CHORD:03 -CHORD:03"}}},
+	{"chord at once without chord time", "hold=500,double=250,chord=0", 2, {
+		{gestureRead, 0, 0x81, "+CHORD:81"},
+		{gestureRead, 30, 0x00, "-CHORD:81"}}},
+	{"latched toggle is a tap", "hold=500,double=250,chord=50", 2, {
+		{gestureToggle, 0, 0x01, ""},
+		{gestureAdvance, 250, 0x01, "+TAP:01 -TAP:01"}}},
+	{"latched toggles make a double tap", "hold=500,double=250,chord=50", 2, {
+		{gestureToggle, 0, 0x01, ""},
+		{gestureToggle, 100, 0x00, "+DOUBLE:01 -DOUBLE:01"}}},
+	{"latched button never holds", "hold=500,double=250,chord=50", 3, {
+		{gestureToggle, 0, 0x10, ""},
+		{gestureAdvance, 250, 0x10, "+TAP:10 -TAP:10"},
+		{gestureAdvance, 1000, 0x10, ""}}},
+	{"latched buttons toggled together", "hold=500,double=250,chord=50", 2, {
+		{gestureToggle, 0, 0x09, "+CHORD:09 -CHORD:09"},
+		// Releasing the latch toggles them again
+		{gestureToggle, 100, 0x00, "+CHORD:09 -CHORD:09"}}}
+};
+
+// Reads the gestures recognized, in the format of the expected ones
+static void readGestures(GestureRecognizer *recognizer, char *text, size_t size)
+{
+	Gesture gesture;
+	size_t length = 0;
+
+	text[0] = '\0';
+	while (readGesture(recognizer, &gesture) && length < size)
+		length += (size_t) snprintf(text + length, size - length, "%s%c%s:%02x", length == 0 ? "" : " ",
+			gesture.down ? '+' : '-', getGestureTypeName(gesture.type), gesture.buttons);
+}
+
+static void runGestureScenario(const GestureScenario *scenario)
+{
+	GestureRecognizer recognizer;
+	GestureTimings timings;
+	char gestures[128];
+	char name[256];
+	byte state = 0;
+	int stepIndex;
+
+	CHECK(scenario->name, parseGestureTimings(scenario->timings, &timings));
+	initGestureRecognizer(&recognizer, &timings);
+
+	for (stepIndex = 0; stepIndex < scenario->stepCount; stepIndex++)
+	{
+		const GestureStep *step = &scenario->steps[stepIndex];
+		ButtonTransitions transitions = getButtonTransitions(state, step->state);
+
+		switch (step->operation)
+		{
+		case gestureRead:
+			feedGestureTransitions(&recognizer, &transitions, step->time * MS);
+			break;
+
+		case gestureToggle:
+			feedGestureToggles(&recognizer, &transitions, step->time * MS);
+			break;
+
+		default:
+			advanceGestures(&recognizer, step->time * MS);
+			break;
+		}
+		state = step->state;
+
+		readGestures(&recognizer, gestures, sizeof(gestures));
+		snprintf(name, sizeof(name), "%s, step %d: \"%s\"", scenario->name, stepIndex + 1, gestures);
+		CHECK(name, strcmp(gestures, step->expected) == 0);
+	}
+}
+
+// Setting parsed, and the timings expected (milliseconds) if valid, over hold=1,double=2,chord=3
+typedef struct TimingsCase
+{
+	const char *setting;
+	BOOL valid;
+	unsigned long long hold;
+	unsigned long long doubleTap;
+	unsigned long long chord;
+} TimingsCase;
+
+static const TimingsCase timingsCases[] =
+{
+	{"hold=500,double=250,chord=50", TRUE, 500, 250, 50},
+	{"chord=80", TRUE, 1, 2, 80},
+	{"double=0,hold=5000", TRUE, 5000, 0, 3},
+	{"hold=5001", FALSE, 0, 0, 0},
+	{"hold=-1", FALSE, 0, 0, 0},
+	{"hold", FALSE, 0, 0, 0},
+	{"hold=", FALSE, 0, 0, 0},
+	{"tap=100", FALSE, 0, 0, 0},
+	{"hold=100;double=100", FALSE, 0, 0, 0},
+	{"holdtime=100", FALSE, 0, 0, 0}
+};
+
+static void checkTimingsCases(void)
+{
+	size_t caseIndex;
+
+	for (caseIndex = 0; caseIndex < sizeof(timingsCases) / sizeof(timingsCases[0]); caseIndex++)
+	{
+		const TimingsCase *testCase = &timingsCases[caseIndex];
+		GestureTimings timings = {1 * MS, 2 * MS, 3 * MS};
+
+		CHECK_EQUAL(testCase->setting, testCase->valid, parseGestureTimings(testCase->setting, &timings));
+		if (!testCase->valid)
+		{
+			CHECK(testCase->setting, timings.holdTime == 1 * MS && timings.doubleTapTime == 2 * MS && timings.chordTime == 3 * MS);
+			continue;
+		}
+
+		CHECK_EQUAL(testCase->setting, testCase->hold * MS, timings.holdTime);
+		CHECK_EQUAL(testCase->setting, testCase->doubleTap * MS, timings.doubleTapTime);
+		CHECK_EQUAL(testCase->setting, testCase->chord * MS, timings.chordTime);
+	}
+}
+
+int main(void)
+{
+	size_t scenarioIndex;
+
+	for (scenarioIndex = 0; scenarioIndex < sizeof(gestureScenarios) / sizeof(gestureScenarios[0]); scenarioIndex++)
+		runGestureScenario(&gestureScenarios[scenarioIndex]);
+	checkTimingsCases();
+
+	return reportChecks("gestureRecognizerTests");
+}
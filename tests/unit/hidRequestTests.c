@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Unit tests of the HID requests, their pool and queue
+ * hidRequestTests.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <string.h>
+#include "unitTests.h"
+#include "hidRequest.h"
+#include "platform.h"
+
+// Callback counting the completions of a request
+static void countCompletion(HidRequest *request, LPVOID context)
+{
+	(void) request;
+	(*(int *) context)++;
+}
+
+// Without the pool events, requests are allocated and destroyed with their last reference
+static void checkUninitializedPool(void)
+{
+	HidRequest *request = createHidRequest(hidWriteRequest, NULL, NULL, NULL);
+
+	if (!CHECK("uninitialized pool", request != NULL))
+		return;
+	CHECK_EQUAL("uninitialized pool", -1, request->poolIndex);
+	releaseHidRequest(request);
+}
+
+static void checkPoolExhaustion(void)
+{
+	HidRequest *requests[HID_REQUEST_POOL_SIZE + 1];
+	HidRequest *reused;
+	int index;
+	BOOL distinct = TRUE;
+
+	for (index = 0; index < HID_REQUEST_POOL_SIZE + 1; index++)
+		requests[index] = createHidRequest(hidWriteRequest, NULL, NULL, NULL);
+
+	// Lowest free bit first, every pool request once
+	for (index = 0; index < HID_REQUEST_POOL_SIZE; index++)
+		distinct &= requests[index] != NULL && requests[index]->poolIndex == index;
+	CHECK("pool requests in order", distinct);
+
+	// Falls back to an allocated request once all of them are in use
+	if (CHECK("allocated when exhausted", requests[HID_REQUEST_POOL_SIZE] != NULL))
+		CHECK_EQUAL("allocated when exhausted", -1, requests[HID_REQUEST_POOL_SIZE]->poolIndex);
+
+	// A released request is the next one taken, its completion event reset
+	completeHidRequest(requests[5], TRUE);
+	releaseHidRequest(requests[5]);
+	reused = createHidRequest(hidSetFeatureRequest, NULL, NULL, NULL);
+	if (CHECK("released request reused", reused == requests[5]))
+	{
+		CHECK_EQUAL("released request reused", hidRequestPending, getHidRequestStatus(reused));
+		CHECK("released request event reset", !waitForPlatformEvent(reused->completedEvent, 0));
+		CHECK_EQUAL("released request references", 1, reused->references);
+	}
+	requests[5] = reused;
+
+	for (index = 0; index < HID_REQUEST_POOL_SIZE + 1; index++)
+		releaseHidRequest(requests[index]);
+
+	// Back to a free pool
+	reused = createHidRequest(hidWriteRequest, NULL, NULL, NULL);
+	if (CHECK("free pool", reused != NULL))
+		CHECK_EQUAL("free pool", 0, reused->poolIndex);
+	releaseHidRequest(reused);
+}
+
+static void checkReferences(void)
+{
+	HidRequestQueue queue = {NULL};
+	unsigned char buffer[REPORT_SIZE];
+	HidRequest *request, *other, *taken;
+	int completions = 0;
+
+	memset(buffer, 0x5a, sizeof(buffer));
+	request = createHidRequest(hidWriteRequest, buffer, countCompletion, &completions);
+	if (!CHECK("references", request != NULL))
+		return;
+	CHECK_EQUAL("buffer copied", 0x5a, request->buffer[REPORT_SIZE - 1]);
+	CHECK_EQUAL("references of the submitter", 1, request->references);
+
+	pushHidRequest(&queue, request);
+	CHECK_EQUAL("references of the submitter and queue", 2, request->references);
+
+	// The submitter gone, the queue keeps the request out of the pool
+	releaseHidRequest(request);
+	other = createHidRequest(hidWriteRequest, NULL, NULL, NULL);
+	CHECK("request kept by the queue", other != request);
+	releaseHidRequest(other);
+
+	taken = takeHidRequests(&queue);
+	CHECK("request taken", taken == request && taken->next == NULL);
+	CHECK("queue emptied", takeHidRequests(&queue) == NULL);
+	CHECK("pending until the deadline", !waitForHidRequest(request, getMonotonicTime() + 1000000ULL));
+
+	// The completion releases the queue reference : back to the pool
+	completeHidRequest(taken, FALSE);
+	CHECK_EQUAL("callback called once", 1, completions);
+	other = createHidRequest(hidWriteRequest, NULL, NULL, NULL);
+	CHECK("request returned to the pool", other == request);
+	releaseHidRequest(other);
+}
+
+static void checkCompletion(void)
+{
+	HidRequest *request = createHidRequest(hidSetFeatureRequest, NULL, NULL, NULL);
+
+	if (!CHECK("completion", request != NULL))
+		return;
+
+	// The waiters and later waits are released, with the status
+	completeHidRequest(request, TRUE);
+	CHECK("completed", waitForHidRequest(request, HID_REQUEST_NO_DEADLINE));
+	CHECK("completed, deadline over", waitForHidRequest(request, 1));
+	CHECK_EQUAL("completion status", hidRequestSucceeded, getHidRequestStatus(request));
+	CHECK("completion time", request->completionTime >= request->submitTime);
+	releaseHidRequest(request);
+}
+
+static void checkSubmissionOrder(void)
+{
+	HidRequestQueue queue = {NULL};
+	HidRequest *requests[3];
+	HidRequest *taken;
+	int index;
+
+	for (index = 0; index < 3; index++)
+	{
+		requests[index] = createHidRequest(hidWriteRequest, NULL, NULL, NULL);
+		pushHidRequest(&queue, requests[index]);
+	}
+
+	// Oldest first, linked to the next ones
+	taken = takeHidRequests(&queue);
+	for (index = 0; index < 3; index++)
+	{
+		if (!CHECK("submission order", taken == requests[index]))
+			break;
+		taken = taken->next;
+	}
+
+	for (index = 0; index < 3; index++)
+	{
+		completeHidRequest(requests[index], TRUE);
+		releaseHidRequest(requests[index]);
+	}
+}
+
+// Requests created and released by several threads at once, each one taken by a single owner
+#define SUBMITTER_THREADS 4
+#define SUBMITTED_REQUESTS 20000
+
+static volatile long long sharedRequests = 0;
+
+static DWORD WINAPI submitterThread(LPVOID argument)
+{
+	int index;
+
+	(void) argument;
+	for (index = 0; index < SUBMITTED_REQUESTS; index++)
+	{
+		HidRequest *request = createHidRequest(hidWriteRequest, NULL, NULL, NULL);
+
+		if (request == NULL)
+			continue;
+
+		// A request handed out twice has another reference by now
+		if (addAtomic64(&request->references, 1) != 2)
+			addAtomic64(&sharedRequests, 1);
+		addAtomic64(&request->references, -1);
+		releaseHidRequest(request);
+	}
+	return 0;
+}
+
+static void checkConcurrentSubmitters(void)
+{
+	PlatformThread *threads[SUBMITTER_THREADS];
+	HidRequest *request;
+	int index;
+
+	for (index = 0; index < SUBMITTER_THREADS; index++)
+		threads[index] = createPlatformThread(submitterThread, NULL);
+	for (index = 0; index < SUBMITTER_THREADS; index++)
+		CHECK("concurrent submitters", threads[index] != NULL && joinPlatformThread(threads[index], 30000));
+
+	CHECK_EQUAL("requests handed out twice", 0, loadAtomic64(&sharedRequests));
+
+	// Every request returned
+	request = createHidRequest(hidWriteRequest, NULL, NULL, NULL);
+	if (CHECK("concurrent submitters, free pool", request != NULL))
+		CHECK_EQUAL("concurrent submitters, free pool", 0, request->poolIndex);
+	releaseHidRequest(request);
+}
+
+int main(void)
+{
+	checkUninitializedPool();
+	if (!CHECK("pool initialized", initHidRequestPool()))
+		return reportChecks("hidRequestTests");
+
+	checkPoolExhaustion();
+	checkReferences();
+	checkCompletion();
+	checkSubmissionOrder();
+	checkConcurrentSubmitters();
+
+	finalizeHidRequestPool();
+	return reportChecks("hidRequestTests");
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Unit tests of the LED animations
+ * ledAnimationTests.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <string.h>
+#include "unitTests.h"
+#include "ledAnimation.h"
+
+#define MS 1000000ULL
+
+// Time the animations are played from : the scenario times are offsets from it (milliseconds)
+#define START_TIME 7000000000000ULL
+
+static const LedKeyframe blinkKeyframes[] = {{0x01, 100}, {0x00, 100}};
+static const LedTimeline blinkTwice = {blinkKeyframes, 2, 2};
+
+static const LedKeyframe loopKeyframes[] = {{0x10, 50}, {0x20, 50}};
+static const LedTimeline loopForever = {loopKeyframes, 2, 0};
+
+static const LedKeyframe pulseKeyframes[] = {{0x40, 30}};
+static const LedTimeline pulseOnce = {pulseKeyframes, 1, 1};
+
+static const LedKeyframe stuckKeyframes[] = {{0x40, 30}, {0x00, 0}};
+static const LedTimeline stuckTimeline = {stuckKeyframes, 2, 1};
+
+// Step of an animation scenario : a timeline started on a layer at a time, a layer cancelled,
+// or the animations advanced to a time
+enum AnimationOperation {animationStart, animationCancel, animationAdvance};
+
+typedef struct AnimationStep
+{
+	enum AnimationOperation operation;
+	const LedTimeline *timeline;
+	int layer;
+	unsigned long long time;
+
+	// Timeline started, then the frame shown after the step (none if not playing) and the next deadline (0 if none)
+	BOOL expectedStarted;
+	BOOL expectedPlaying;
+	byte expectedLeds;
+	unsigned long long expectedDeadline;
+} AnimationStep;
+
+#define ANIMATION_STEPS_MAX 8
+
+typedef struct AnimationScenario
+{
+	const char *name;
+	int stepCount;
+	AnimationStep steps[ANIMATION_STEPS_MAX];
+} AnimationScenario;
+
+static const AnimationScenario animationScenarios[] =
+{
+	{"keyframes move on at their end", 6, {
+		{animationStart, &blinkTwice, 0, 0, TRUE, TRUE, 0x01, 100},
+		{animationAdvance, NULL, 0, 99, TRUE, TRUE, 0x01, 100},
+		{animationAdvance, NULL, 0, 100, TRUE, TRUE, 0x00, 200},
+		{animationAdvance, NULL, 0, 200, TRUE, TRUE, 0x01, 300},
+		{animationAdvance, NULL, 0, 399, TRUE, TRUE, 0x00, 400},
+		{animationAdvance, NULL, 0, 400, TRUE, FALSE, 0, 0}}},
+	{"late advance keeps the timeline", 2, {
+		{animationStart, &blinkTwice, 0, 0, TRUE, TRUE, 0x01, 100},
+		{animationAdvance, NULL, 0, 250, TRUE, TRUE, 0x01, 300}}},
+	{"looping timeline never ends", 3, {
+		{animationStart, &loopForever, 1, 0, TRUE, TRUE, 0x10, 50},
+		{animationAdvance, NULL, 0, 1025, TRUE, TRUE, 0x10, 1050},
+		{animationAdvance, NULL, 0, 1075, TRUE, TRUE, 0x20, 1100}}},
+	{"highest layer shown, the lower ones keep playing", 4, {
+		{animationStart, &blinkTwice, 0, 0, TRUE, TRUE, 0x01, 100},
+		{animationStart, &pulseOnce, 2, 50, TRUE, TRUE, 0x40, 80},
+		{animationAdvance, NULL, 0, 80, TRUE, TRUE, 0x01, 100},
+		{animationAdvance, NULL, 0, 100, TRUE, TRUE, 0x00, 200}}},
+	{"earliest deadline of the layers", 3, {
+		{animationStart, &loopForever, 3, 0, TRUE, TRUE, 0x10, 50},
+		{animationStart, &pulseOnce, 0, 10, TRUE, TRUE, 0x10, 40},
+		{animationAdvance, NULL, 0, 40, TRUE, TRUE, 0x10, 50}}},
+	{"restarted layer plays from its start", 3, {
+		{animationStart, &loopForever, 1, 0, TRUE, TRUE, 0x10, 50},
+		{animationAdvance, NULL, 0, 60, TRUE, TRUE, 0x20, 100},
+		{animationStart, &loopForever, 1, 70, TRUE, TRUE, 0x10, 120}}},
+	{"cancelled layers", 4, {
+		{animationStart, &blinkTwice, 0, 0, TRUE, TRUE, 0x01, 100},
+		{animationStart, &loopForever, 1, 0, TRUE, TRUE, 0x10, 50},
+		{animationCancel, NULL, 1, 0, TRUE, TRUE, 0x01, 100},
+		{animationCancel, NULL, LED_ANIMATION_ALL_LAYERS, 0, TRUE, FALSE, 0, 0}}},
+	{"invalid timelines and layers not started", 4, {
+		{animationStart, &blinkTwice, LED_ANIMATION_LAYERS, 0, FALSE, FALSE, 0, 0},
+		{animationStart, &blinkTwice, -1, 0, FALSE, FALSE, 0, 0},
+		{animationStart, &stuckTimeline, 0, 0, FALSE, FALSE, 0, 0},
+		{animationStart, NULL, 0, 0, FALSE, FALSE, 0, 0}}}
+};
+
+static void runAnimationScenario(const AnimationScenario *scenario)
+{
+	LedAnimator animator;
+	int stepIndex;
+
+	initLedAnimator(&animator);
+	for (stepIndex = 0; stepIndex < scenario->stepCount; stepIndex++)
+	{
+		const AnimationStep *step = &scenario->steps[stepIndex];
+		char testCase[256];
+		byte leds = 0;
+
+		snprintf(testCase, sizeof(testCase), "%s, step %d", scenario->name, stepIndex + 1);
+		switch (step->operation)
+		{
+		case animationStart:
+			CHECK_EQUAL(testCase, step->expectedStarted, startLedAnimation(&animator, step->timeline, step->layer, START_TIME + step->time * MS));
+			break;
+		case animationCancel:
+			cancelLedAnimation(&animator, step->layer);
+			break;
+		case animationAdvance:
+			advanceLedAnimations(&animator, START_TIME + step->time * MS);
+			break;
+		}
+
+		if (CHECK_EQUAL(testCase, step->expectedPlaying, getLedAnimationFrame(&animator, &leds)) && step->expectedPlaying)
+			CHECK_EQUAL(testCase, step->expectedLeds, leds);
+		CHECK_EQUAL(testCase, step->expectedDeadline == 0 ? 0 : START_TIME + step->expectedDeadline * MS, getLedAnimationDeadline(&animator));
+	}
+}
+
+int main(void)
+{
+	size_t scenarioIndex;
+
+	for (scenarioIndex = 0; scenarioIndex < sizeof(animationScenarios) / sizeof(animationScenarios[0]); scenarioIndex++)
+		runAnimationScenario(&animationScenarios[scenarioIndex]);
+
+	return reportChecks("ledAnimationTests");
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Unit tests of the LED compositor
+ * ledCompositorTests.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <string.h>
+#include "unitTests.h"
+#include "platform.h"
+#include "ledCompositor.h"
+
+// Step of a compositor scenario : the LEDs of a mask set on a layer, then the LEDs composed over a status
+typedef struct CompositorStep
+{
+	enum LedLayer layer;
+	byte mask;
+	byte leds;
+	byte status;
+
+	// Layer set, LEDs composed and layers shown over the status after the step
+	BOOL expectedSet;
+	byte expectedLeds;
+	BOOL expectedOverlays;
+} CompositorStep;
+
+#define COMPOSITOR_STEPS_MAX 6
+
+typedef struct CompositorScenario
+{
+	const char *name;
+	int stepCount;
+	CompositorStep steps[COMPOSITOR_STEPS_MAX];
+} CompositorScenario;
+
+static const CompositorScenario compositorScenarios[] =
+{
+	{"status shown alone", 1, {
+		{ledNotificationLayer, 0x00, 0x00, 0x5A, TRUE, 0x5A, FALSE}}},
+	{"layer replaces the LEDs of its mask only", 2, {
+		{ledNotificationLayer, 0x0F, 0x05, 0xF0, TRUE, 0xF5, TRUE},
+		{ledNotificationLayer, 0x0F, 0x05, 0xFF, TRUE, 0xF5, TRUE}}},
+	{"LEDs outside the mask ignored", 1, {
+		{ledNotificationLayer, 0x01, 0xFF, 0x00, TRUE, 0x01, TRUE}}},
+	{"higher layer over the lower ones", 3, {
+		{ledNotificationLayer, 0xFF, 0x11, 0x00, TRUE, 0x11, TRUE},
+		{ledAnimationLayer, 0x0F, 0x02, 0x00, TRUE, 0x12, TRUE},
+		{ledOverrideLayer, 0x03, 0x01, 0x00, TRUE, 0x11, TRUE}}},
+	{"layer set in any order keeps its priority", 3, {
+		{ledOverrideLayer, 0x01, 0x01, 0x00, TRUE, 0x01, TRUE},
+		{ledAnimationLayer, 0x03, 0x02, 0x00, TRUE, 0x03, TRUE},
+		{ledNotificationLayer, 0xFF, 0x00, 0x00, TRUE, 0x03, TRUE}}},
+	{"cleared layer lets the ones below show through", 4, {
+		{ledNotificationLayer, 0xFF, 0x0F, 0x00, TRUE, 0x0F, TRUE},
+		{ledOverrideLayer, 0xFF, 0xF0, 0x00, TRUE, 0xF0, TRUE},
+		{ledOverrideLayer, 0x00, 0x00, 0x00, TRUE, 0x0F, TRUE},
+		{ledNotificationLayer, 0x00, 0x00, 0x33, TRUE, 0x33, FALSE}}},
+	{"status layer and invalid layers not set", 3, {
+		{ledStatusLayer, 0xFF, 0xFF, 0x00, FALSE, 0x00, FALSE},
+		{ledLayerCount, 0xFF, 0xFF, 0x00, FALSE, 0x00, FALSE},
+		{(enum LedLayer) -1, 0xFF, 0xFF, 0x00, FALSE, 0x00, FALSE}}}
+};
+
+static void runCompositorScenario(const CompositorScenario *scenario)
+{
+	LedCompositor compositor;
+	int stepIndex;
+
+	initLedCompositor(&compositor);
+	for (stepIndex = 0; stepIndex < scenario->stepCount; stepIndex++)
+	{
+		const CompositorStep *step = &scenario->steps[stepIndex];
+		char testCase[256];
+
+		snprintf(testCase, sizeof(testCase), "%s, step %d", scenario->name, stepIndex + 1);
+		CHECK_EQUAL(testCase, step->expectedSet, setLedCompositorLayer(&compositor, step->layer, step->mask, step->leds));
+		CHECK_EQUAL(testCase, step->expectedLeds, composeLeds(&compositor, step->status));
+		CHECK_EQUAL(testCase, step->expectedOverlays, hasLedCompositorOverlays(&compositor));
+	}
+}
+
+int main(void)
+{
+	size_t scenarioIndex;
+
+	for (scenarioIndex = 0; scenarioIndex < sizeof(compositorScenarios) / sizeof(compositorScenarios[0]); scenarioIndex++)
+		runCompositorScenario(&compositorScenarios[scenarioIndex]);
+
+	return reportChecks("ledCompositorTests");
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Unit tests of the configuration file
+ * pluginConfigTests.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "unitTests.h"
+#include "buttonDebouncer.h"
+#include "pluginConfig.h"
+
+#define MS 1000000ULL
+
+// Configuration file accepted and the settings expected : the device count and the last device,
+// the debounce windows of the first and the last buttons, the gesture timings (milliseconds) and the binding count
+typedef struct ConfigCase
+{
+	const char *text;
+	int deviceCount;
+	UsbDeviceId lastDevice;
+	unsigned long long firstDebounce;
+	unsigned long long lastDebounce;
+	unsigned long long hold;
+	unsigned long long doubleTap;
+	unsigned long long chord;
+	unsigned int bindingCount;
+} ConfigCase;
+
+static const ConfigCase configCases[] =
+{
+	{"", 1, {0x045E, 0x003B}, 10, 10, 500, 250, 50, 6},
+	{"# comment only\n\n \t \n", 1, {0x045E, 0x003B}, 10, 10, 500, 250, 50, 6},
+	{"devices = 045e:003b, 1234:ABCD\r\n", 2, {0x1234, 0xABCD}, 10, 10, 500, 250, 50, 6},
+	{"  devices=1234:0000", 1, {0x1234, 0x0000}, 10, 10, 500, 250, 50, 6},
+	{"debounce = 5,5,5,5,5,5,30,30", 1, {0x045E, 0x003B}, 5, 30, 500, 250, 50, 6},
+	{"debounce = 0", 1, {0x045E, 0x003B}, 0, 0, 500, 250, 50, 6},
+	{"gestures = hold=800", 1, {0x045E, 0x003B}, 10, 10, 800, 250, 50, 6},
+	{"gestures = hold=100\r\ngestures = double=100\r\n", 1, {0x045E, 0x003B}, 10, 10, 100, 100, 50, 6},
+	{"bind = PRESS_TEAM=away\n# bind = PRESS_ALL=back\nbind=TAP_ALL=back , mute_input", 1, {0x045E, 0x003B}, 10, 10, 500, 250, 50, 2},
+	{"bind = PRESS_TEAM=away;PRESS_ALL=back", 1, {0x045E, 0x003B}, 10, 10, 500, 250, 50, 2},
+	{"bind =", 1, {0x045E, 0x003B}, 10, 10, 500, 250, 50, 0},
+	{"# Game Voice\ndevices = 045e:003b\ndebounce = 20\ngestures = chord=0\nbind = DOWN_MUTE=mute_input\n",
+		1, {0x045E, 0x003B}, 20, 20, 500, 250, 0, 1}
+};
+
+// Configuration file rejected and its error
+typedef struct ConfigErrorCase
+{
+	const char *text;
+	const char *error;
+} ConfigErrorCase;
+
+static const ConfigErrorCase configErrorCases[] =
+{
+	{"volume = 3", "line 1: unknown setting volume"},
+	{" = 3", "line 1: unknown setting "},
+	{"Devices = 045e:003b", "line 1: unknown setting Devices"},
+	{"\n# devices\ndevices", "line 3: <setting> = <value> expected"},
+	{"gestures = hold=800\r\ndebounce 10\r\n", "line 2: <setting> = <value> expected"},
+	{"devices = 045e", "line 1: invalid devices"},
+	{"devices = 0000:003b", "line 1: invalid devices"},
+	{"devices = 045e:10000", "line 1: invalid devices"},
+	{"devices = 045e:003b,", "line 1: invalid devices"},
+	{"devices = 045e:003b 1234:5678", "line 1: invalid devices"},
+	{"devices =", "line 1: invalid devices"},
+	{"debounce = fast", "line 1: invalid debounce"},
+	{"debounce = 10,10", "line 1: invalid debounce"},
+	{"gestures = hold=9000", "line 1: invalid gestures"},
+	{"gestures = tap=100", "line 1: invalid gestures"},
+	{"bind = PRESS_TEAM=away\nbind = PRESS_TEAM=explode", "line 2: invalid bind"},
+	{"bind = PRESS_TEAM", "line 1: invalid bind"}
+};
+
+// Sets an environment variable, or removes it if NULL
+static void setVariable(const char *name, const char *value)
+{
+#ifdef _WIN32
+	_putenv_s(name, value != NULL ? value : "");
+#else
+	if (value != NULL)
+		setenv(name, value, 1);
+	else
+		unsetenv(name);
+#endif
+}
+
+static void clearVariables(void)
+{
+	setVariable(DEBOUNCE_VARIABLE, NULL);
+	setVariable(GESTURES_VARIABLE, NULL);
+	setVariable(BINDINGS_VARIABLE, NULL);
+}
+
+static void checkConfigCases(void)
+{
+	size_t caseIndex;
+
+	for (caseIndex = 0; caseIndex < sizeof(configCases) / sizeof(configCases[0]); caseIndex++)
+	{
+		const ConfigCase *testCase = &configCases[caseIndex];
+		static GameVoiceConfig config;
+		char error[CONFIG_MESSAGE_SIZE] = "";
+		char name[CONFIG_MESSAGE_SIZE * 2];
+		int deviceCount = 0;
+
+		snprintf(name, sizeof(name), "\"%s\"", testCase->text);
+		if (!CHECK(name, parseConfig(testCase->text, &config, error, sizeof(error))))
+		{
+			printf("%s: %s\n", name, error);
+			continue;
+		}
+
+		while (config.supportedDevices[deviceCount].vid != 0)
+			deviceCount++;
+		if (CHECK_EQUAL(name, testCase->deviceCount, deviceCount))
+		{
+			CHECK_EQUAL(name, testCase->lastDevice.vid, config.supportedDevices[deviceCount - 1].vid);
+			CHECK_EQUAL(name, testCase->lastDevice.pid, config.supportedDevices[deviceCount - 1].pid);
+		}
+
+		CHECK_EQUAL(name, testCase->firstDebounce * MS, config.debounceWindows[0]);
+		CHECK_EQUAL(name, testCase->lastDebounce * MS, config.debounceWindows[BUTTON_TRANSITIONS_MAX - 1]);
+		CHECK_EQUAL(name, testCase->hold * MS, config.gestureTimings.holdTime);
+		CHECK_EQUAL(name, testCase->doubleTap * MS, config.gestureTimings.doubleTapTime);
+		CHECK_EQUAL(name, testCase->chord * MS, config.gestureTimings.chordTime);
+		CHECK_EQUAL(name, testCase->bindingCount, config.bindings.bindingCount);
+	}
+}
+
+static void checkConfigError(const char *testCase, const char *text, const char *expected)
+{
+	static GameVoiceConfig config;
+	char error[CONFIG_MESSAGE_SIZE] = "";
+	char name[CONFIG_MESSAGE_SIZE * 2];
+
+	CHECK(testCase, !parseConfig(text, &config, error, sizeof(error)));
+	snprintf(name, sizeof(name), "%s: \"%s\"", testCase, error);
+	CHECK(name, strcmp(error, expected) == 0);
+}
+
+static void checkConfigErrorCases(void)
+{
+	static char text[CONFIG_FILE_MAX_SIZE + 1];
+	char expected[CONFIG_MESSAGE_SIZE];
+	size_t caseIndex, length;
+	int index;
+
+	for (caseIndex = 0; caseIndex < sizeof(configErrorCases) / sizeof(configErrorCases[0]); caseIndex++)
+		checkConfigError(configErrorCases[caseIndex].text, configErrorCases[caseIndex].text, configErrorCases[caseIndex].error);
+
+	// A value without room for its terminator
+	strcpy(text, "gestures = ");
+	length = strlen(text);
+	memset(text + length, '0', CONFIG_VALUE_SIZE);
+	text[length + CONFIG_VALUE_SIZE] = '\0';
+	checkConfigError("too long value", text, "line 1: value too long");
+
+	// One device more than the table
+	strcpy(text, "devices = ");
+	for (index = 0; index <= USB_HID_MAX_DEVICE_IDS; index++)
+		strcat(text, index == 0 ? "045e:003b" : ", 045e:003b");
+	checkConfigError("too many devices", text, "line 1: invalid devices");
+
+	// One binding more than the table, each bind line valid alone
+	text[0] = '\0';
+	for (index = 0; index <= BUTTON_BINDINGS_MAX; index++)
+		strcat(text, "bind = TAP_ALL=away\n");
+	snprintf(expected, sizeof(expected), "more than %d bindings or %d actions", BUTTON_BINDINGS_MAX, BUTTON_ACTIONS_MAX);
+	checkConfigError("too many bindings", text, expected);
+}
+
+// The environment variables take precedence over the file, unless invalid
+static void checkEnvironment(void)
+{
+	static GameVoiceConfig config;
+	char error[CONFIG_MESSAGE_SIZE];
+
+	setVariable(DEBOUNCE_VARIABLE, "20");
+	initDefaultConfig(&config);
+	CHECK_EQUAL("default debounce from the environment", 20 * MS, config.debounceWindows[0]);
+	clearVariables();
+
+	setVariable(GESTURES_VARIABLE, "hold=900");
+	CHECK("gestures from the environment", parseConfig("gestures = hold=100,double=100", &config, error, sizeof(error)));
+	CHECK_EQUAL("gestures from the environment", 900 * MS, config.gestureTimings.holdTime);
+	CHECK_EQUAL("gestures from the environment", 100 * MS, config.gestureTimings.doubleTapTime);
+
+	setVariable(GESTURES_VARIABLE, "hold=fast");
+	CHECK("invalid gestures in the environment", parseConfig("gestures = hold=100", &config, error, sizeof(error)));
+	CHECK_EQUAL("invalid gestures in the environment", 100 * MS, config.gestureTimings.holdTime);
+	clearVariables();
+
+	setVariable(BINDINGS_VARIABLE, "PRESS_ALL=away");
+	CHECK("bindings from the environment", parseConfig("bind = PRESS_TEAM=away\nbind = PRESS_MUTE=back", &config, error, sizeof(error)));
+	CHECK_EQUAL("bindings from the environment", 1, config.bindings.bindingCount);
+	clearVariables();
+}
+
+int main(void)
+{
+	// The settings of the environment running the tests would override the ones checked
+	clearVariables();
+
+	checkConfigCases();
+	checkConfigErrorCases();
+	checkEnvironment();
+
+	return reportChecks("pluginConfigTests");
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Unit tests of the input report queue
+ * reportQueueTests.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <string.h>
+#include "unitTests.h"
+#include "platform.h"
+#include "reportQueue.h"
+
+// Step of a queue scenario : a report pushed or popped (its first data byte), or the reports discarded
+enum QueueOperation {queuePush, queuePop, queueDiscard};
+
+typedef struct QueueStep
+{
+	enum QueueOperation operation;
+	int repeat;
+	byte value;
+
+	// Result of each operation (pushed, popped), and reports left queued after the step
+	BOOL expectedResult;
+	long long expectedCount;
+} QueueStep;
+
+#define QUEUE_STEPS_MAX 8
+
+typedef struct QueueScenario
+{
+	const char *name;
+	int stepCount;
+	QueueStep steps[QUEUE_STEPS_MAX];
+} QueueScenario;
+
+static const QueueScenario queueScenarios[] =
+{
+	{"empty queue pops nothing", 1, {
+		{queuePop, 1, 0, FALSE, 0}}},
+	{"reports popped in order", 4, {
+		{queuePush, 1, 1, TRUE, 1},
+		{queuePush, 1, 2, TRUE, 2},
+		{queuePop, 1, 1, TRUE, 1},
+		{queuePop, 1, 2, TRUE, 0}}},
+	{"full queue drops the report", 3, {
+		{queuePush, REPORT_QUEUE_CAPACITY, 7, TRUE, REPORT_QUEUE_CAPACITY},
+		{queuePush, 1, 8, FALSE, REPORT_QUEUE_CAPACITY},
+		{queuePop, REPORT_QUEUE_CAPACITY, 7, TRUE, 0}}},
+	{"slot freed by a pop", 3, {
+		{queuePush, REPORT_QUEUE_CAPACITY, 7, TRUE, REPORT_QUEUE_CAPACITY},
+		{queuePop, 1, 7, TRUE, REPORT_QUEUE_CAPACITY - 1},
+		{queuePush, 1, 8, TRUE, REPORT_QUEUE_CAPACITY}}},
+	{"wrap around the ring", 6, {
+		{queuePush, REPORT_QUEUE_CAPACITY - 2, 1, TRUE, REPORT_QUEUE_CAPACITY - 2},
+		{queuePop, REPORT_QUEUE_CAPACITY - 2, 1, TRUE, 0},
+		{queuePush, 3, 2, TRUE, 3},
+		{queuePush, 2, 3, TRUE, 5},
+		{queuePop, 3, 2, TRUE, 2},
+		{queuePop, 2, 3, TRUE, 0}}},
+	{"discarded reports skipped", 5, {
+		{queuePush, 3, 1, TRUE, 3},
+		{queueDiscard, 1, 0, TRUE, 0},
+		{queuePop, 1, 0, FALSE, 0},
+		{queuePush, 1, 2, TRUE, 1},
+		{queuePop, 1, 2, TRUE, 0}}},
+	{"discard of a full queue frees it on the next pop", 4, {
+		{queuePush, REPORT_QUEUE_CAPACITY, 1, TRUE, REPORT_QUEUE_CAPACITY},
+		{queueDiscard, 1, 0, TRUE, 0},
+		{queuePop, 1, 0, FALSE, 0},
+		{queuePush, REPORT_QUEUE_CAPACITY, 2, TRUE, REPORT_QUEUE_CAPACITY}}}
+};
+
+static void runQueueScenario(const QueueScenario *scenario)
+{
+	ReportQueue queue;
+	int stepIndex, repeat;
+
+	if (!CHECK(scenario->name, initReportQueue(&queue)))
+		return;
+
+	for (stepIndex = 0; stepIndex < scenario->stepCount; stepIndex++)
+	{
+		const QueueStep *step = &scenario->steps[stepIndex];
+		char testCase[256];
+
+		snprintf(testCase, sizeof(testCase), "%s, step %d", scenario->name, stepIndex + 1);
+		for (repeat = 0; repeat < step->repeat; repeat++)
+		{
+			unsigned char data[REPORT_SIZE];
+			TimedReport report;
+
+			switch (step->operation)
+			{
+			case queuePush:
+				memset(data, step->value, sizeof(data));
+				CHECK_EQUAL(testCase, step->expectedResult, pushReport(&queue, data, sizeof(data), step->value, FALSE));
+				break;
+			case queuePop:
+				if (CHECK_EQUAL(testCase, step->expectedResult, popReport(&queue, &report)) && step->expectedResult)
+				{
+					CHECK_EQUAL(testCase, step->value, report.data[0]);
+					CHECK_EQUAL(testCase, step->value, report.data[REPORT_SIZE - 1]);
+					CHECK_EQUAL(testCase, step->value, report.time);
+				}
+				break;
+			case queueDiscard:
+				discardReports(&queue);
+				break;
+			}
+		}
+		CHECK_EQUAL(testCase, step->expectedCount, getQueuedReportCount(&queue));
+	}
+
+	finalizeReportQueue(&queue);
+}
+
+// Reports pushed by another thread, many times around the ring
+#define PRODUCED_REPORTS 100000
+
+typedef struct ProducerContext
+{
+	ReportQueue *queue;
+	long long dropped;
+} ProducerContext;
+
+static DWORD WINAPI producerThread(LPVOID argument)
+{
+	ProducerContext *context = (ProducerContext *) argument;
+	unsigned long long sequence;
+
+	// Retried when full : the consumer must see every report, in order
+	for (sequence = 0; sequence < PRODUCED_REPORTS; sequence++)
+	{
+		unsigned char data[REPORT_SIZE];
+
+		memset(data, (int) (sequence & 0xFF), sizeof(data));
+		while (!pushReport(context->queue, data, sizeof(data), sequence, FALSE))
+			context->dropped++;
+	}
+	return 0;
+}
+
+static void checkConcurrentWrap(void)
+{
+	ReportQueue queue;
+	ProducerContext context;
+	PlatformThread *producer;
+	unsigned long long expected = 0;
+	int torn = 0;
+
+	if (!CHECK("concurrent wrap", initReportQueue(&queue)))
+		return;
+
+	context.queue = &queue;
+	context.dropped = 0;
+	producer = createPlatformThread(producerThread, &context);
+	if (!CHECK("concurrent wrap", producer != NULL))
+		return;
+
+	while (expected < PRODUCED_REPORTS)
+	{
+		TimedReport report;
+
+		if (!popReport(&queue, &report))
+		{
+			waitForReport(&queue, 10);
+			continue;
+		}
+		if (report.time != expected)
+			break;
+
+		// A slot overwritten while copied shows other bytes than its sequence
+		torn += report.data[0] != (expected & 0xFF) || report.data[REPORT_SIZE - 1] != (expected & 0xFF);
+		expected++;
+	}
+
+	CHECK("concurrent wrap", joinPlatformThread(producer, 5000));
+	CHECK_EQUAL("concurrent wrap, reports in order", PRODUCED_REPORTS, expected);
+	CHECK_EQUAL("concurrent wrap, torn reports", 0, torn);
+	CHECK_EQUAL("concurrent wrap", 0, getQueuedReportCount(&queue));
+	finalizeReportQueue(&queue);
+}
+
+int main(void)
+{
+	size_t scenarioIndex;
+
+	for (scenarioIndex = 0; scenarioIndex < sizeof(queueScenarios) / sizeof(queueScenarios[0]); scenarioIndex++)
+		runQueueScenario(&queueScenarios[scenarioIndex]);
+	checkConcurrentWrap();
+
+	return reportChecks("reportQueueTests");
+}
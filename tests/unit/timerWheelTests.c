@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Unit tests of the timer wheel
+ * timerWheelTests.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#include <string.h>
+#include "unitTests.h"
+#include "timerWheel.h"
+
+#define US 1000ULL
+
+// Time the wheel starts at, on a tick : the scenario times are offsets from it (microseconds)
+#define START_TIME 5000000000000ULL
+
+// Step of a wheel scenario : a timer scheduled at a time or cancelled, or the wheel advanced to a time
+enum WheelOperation {wheelSchedule, wheelCancel, wheelAdvance};
+
+typedef struct WheelStep
+{
+	enum WheelOperation operation;
+	int timer;
+	unsigned long long time;
+
+	// Timers expired by an advance, and deadline of the wheel after the step (0 if no timer is scheduled)
+	int expectedExpired;
+	unsigned long long expectedDeadline;
+} WheelStep;
+
+#define WHEEL_TIMERS 3
+#define WHEEL_STEPS_MAX 8
+
+typedef struct WheelScenario
+{
+	const char *name;
+
+	// Period of the timers scheduled again by their callback (microseconds, 0 for none)
+	unsigned long long period;
+	int stepCount;
+	WheelStep steps[WHEEL_STEPS_MAX];
+} WheelScenario;
+
+static const WheelScenario wheelScenarios[] =
+{
+	{"expires on the first tick at its deadline", 0, 4, {
+		{wheelSchedule, 0, 2500, 0, 3000},
+		{wheelAdvance, 0, 2999, 0, 3000},
+		{wheelAdvance, 0, 3000, 1, 0},
+		{wheelAdvance, 0, 10000, 0, 0}}},
+	{"deadline over expires on the next tick", 0, 4, {
+		{wheelAdvance, 0, 10000, 0, 0},
+		{wheelSchedule, 0, 5000, 0, 11000},
+		{wheelAdvance, 0, 10999, 0, 11000},
+		{wheelAdvance, 0, 11000, 1, 0}}},
+	{"cancelled timer never expires", 0, 3, {
+		{wheelSchedule, 0, 5000, 0, 5000},
+		{wheelCancel, 0, 0, 0, 0},
+		{wheelAdvance, 0, 20000, 0, 0}}},
+	{"rescheduled timer moves", 0, 4, {
+		{wheelSchedule, 0, 5000, 0, 5000},
+		{wheelSchedule, 0, 8000, 0, 8000},
+		{wheelAdvance, 0, 7999, 0, 8000},
+		{wheelAdvance, 0, 8000, 1, 0}}},
+	{"nearest timer first", 0, 6, {
+		{wheelSchedule, 0, 30000, 0, 30000},
+		{wheelSchedule, 1, 10000, 0, 10000},
+		{wheelSchedule, 2, 20000, 0, 10000},
+		{wheelAdvance, 0, 10000, 1, 20000},
+		{wheelAdvance, 0, 25000, 1, 30000},
+		{wheelAdvance, 0, 30000, 1, 0}}},
+	{"same slot a turn apart", 0, 5, {
+		{wheelSchedule, 0, 5000, 0, 5000},
+		{wheelSchedule, 1, 5000 + TIMER_WHEEL_SIZE * 1000, 0, 5000},
+		{wheelAdvance, 0, 5000, 1, 5000 + TIMER_WHEEL_SIZE * 1000},
+		{wheelAdvance, 0, 4999 + TIMER_WHEEL_SIZE * 1000, 0, 5000 + TIMER_WHEEL_SIZE * 1000},
+		{wheelAdvance, 0, 5000 + TIMER_WHEEL_SIZE * 1000, 1, 0}}},
+	{"timer further than a turn looked for a turn ahead", 0, 4, {
+		{wheelSchedule, 0, 1000000, 0, TIMER_WHEEL_SIZE * 1000},
+		{wheelAdvance, 0, TIMER_WHEEL_SIZE * 1000, 0, 2 * TIMER_WHEEL_SIZE * 1000},
+		{wheelAdvance, 0, 999999, 0, 1000000},
+		{wheelAdvance, 0, 1000000, 1, 0}}},
+	{"late advance expires every timer once", 0, 4, {
+		{wheelSchedule, 0, 5000, 0, 5000},
+		{wheelSchedule, 1, 300000, 0, 5000},
+		{wheelSchedule, 2, 600000, 0, 5000},
+		{wheelAdvance, 0, 1000000, 3, 0}}},
+	{"timer scheduled again by its callback", 10000, 3, {
+		{wheelSchedule, 0, 10000, 0, 10000},
+		{wheelAdvance, 0, 35000, 3, 40000},
+		{wheelCancel, 0, 0, 0, 0}}}
+};
+
+// Timer of a scenario, checking it never expires before its deadline
+typedef struct ScenarioTimer
+{
+	WheelTimer timer;
+	TimerWheel *wheel;
+	const char *testCase;
+	unsigned long long deadline;
+	unsigned long long period;
+} ScenarioTimer;
+
+// Time the wheel is being advanced to
+static unsigned long long advancedTime;
+
+static void onScenarioTimer(WheelTimer *timer, LPVOID context)
+{
+	ScenarioTimer *scenarioTimer = (ScenarioTimer *) context;
+
+	CHECK(scenarioTimer->testCase, timer == &scenarioTimer->timer);
+	CHECK(scenarioTimer->testCase, advancedTime >= scenarioTimer->deadline);
+	CHECK(scenarioTimer->testCase, !timer->scheduled);
+
+	if (scenarioTimer->period != 0)
+	{
+		scenarioTimer->deadline += scenarioTimer->period;
+		scheduleWheelTimer(scenarioTimer->wheel, timer, scenarioTimer->deadline);
+	}
+}
+
+static void runWheelScenario(const WheelScenario *scenario)
+{
+	TimerWheel wheel;
+	ScenarioTimer timers[WHEEL_TIMERS];
+	int stepIndex, timerIndex;
+
+	initTimerWheel(&wheel, START_TIME);
+	for (timerIndex = 0; timerIndex < WHEEL_TIMERS; timerIndex++)
+	{
+		initWheelTimer(&timers[timerIndex].timer, onScenarioTimer, &timers[timerIndex]);
+		timers[timerIndex].wheel = &wheel;
+		timers[timerIndex].testCase = scenario->name;
+		timers[timerIndex].deadline = 0;
+		timers[timerIndex].period = scenario->period * US;
+	}
+
+	for (stepIndex = 0; stepIndex < scenario->stepCount; stepIndex++)
+	{
+		const WheelStep *step = &scenario->steps[stepIndex];
+		ScenarioTimer *timer = &timers[step->timer];
+		char testCase[256];
+
+		snprintf(testCase, sizeof(testCase), "%s, step %d", scenario->name, stepIndex + 1);
+		switch (step->operation)
+		{
+		case wheelSchedule:
+			timer->deadline = START_TIME + step->time * US;
+			scheduleWheelTimer(&wheel, &timer->timer, timer->deadline);
+			break;
+		case wheelCancel:
+			cancelWheelTimer(&wheel, &timer->timer);
+			CHECK(testCase, !timer->timer.scheduled);
+			break;
+		case wheelAdvance:
+			advancedTime = START_TIME + step->time * US;
+			CHECK_EQUAL(testCase, step->expectedExpired, advanceTimerWheel(&wheel, advancedTime));
+			break;
+		}
+		CHECK_EQUAL(testCase, step->expectedDeadline == 0 ? 0 : START_TIME + step->expectedDeadline * US, getTimerWheelDeadline(&wheel));
+	}
+}
+
+int main(void)
+{
+	size_t scenarioIndex;
+
+	for (scenarioIndex = 0; scenarioIndex < sizeof(wheelScenarios) / sizeof(wheelScenarios[0]); scenarioIndex++)
+		runWheelScenario(&wheelScenarios[scenarioIndex]);
+
+	return reportChecks("timerWheelTests");
+}
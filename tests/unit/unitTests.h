@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Checks shared by the unit tests of the button processing and the configuration
+ * unitTests.h
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef UNITTESTS_H
+#define UNITTESTS_H
+
+#include <stdio.h>
+#include "stdafx.h"
+
+// Checks failed by the test program : its exit status, ctest reports the program failed if any
+static int failedChecks = 0;
+static int passedChecks = 0;
+
+// Checks a condition, printing the case and the failed condition otherwise, returns the condition
+#define CHECK(testCase, condition) checkCondition((condition), (testCase), #condition, __FILE__, __LINE__)
+
+// Checks two integer values are equal, printing both otherwise, returns whether equal
+#define CHECK_EQUAL(testCase, expected, actual) checkEqual((long long) (expected), (long long) (actual), (testCase), #actual, __FILE__, __LINE__)
+
+static BOOL checkCondition(BOOL condition, const char *testCase, const char *text, const char *file, int line)
+{
+	if (condition)
+	{
+		passedChecks++;
+		return TRUE;
+	}
+
+	failedChecks++;
+	printf("%s:%d: %s: check failed: %s\n", file, line, testCase, text);
+	return FALSE;
+}
+
+static BOOL checkEqual(long long expected, long long actual, const char *testCase, const char *text, const char *file, int line)
+{
+	if (expected == actual)
+	{
+		passedChecks++;
+		return TRUE;
+	}
+
+	failedChecks++;
+	printf("%s:%d: %s: %s is %lld, expected %lld\n", file, line, testCase, text, actual, expected);
+	return FALSE;
+}
+
+// Prints the outcome of the checks, returns the exit status of the test program
+static int reportChecks(const char *testName)
+{
+	printf("%s: %d checks passed, %d failed\n", testName, passedChecks, failedChecks);
+	return failedChecks == 0 ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Headless load test of the plugin with the simulated device
+ * gamevoice_bench.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Runs the whole plugin pipeline (HID worker thread, GameVoiceThread and TS3 actions)
+// against the simulated device, with stubbed TeamSpeak 3 client functions.
+//
+// Usage : gamevoice_bench [script] [seconds] [dump]
+//   script   simulated device script, see CreateSimulatedHidTransport (default "rate=20000 count=100000")
+//   seconds  maximum duration of the run (default 30)
+//   dump     file the flight recorder is dumped to at the end of the run, see gamevoice_trace
+//
+// While it runs, the output mute of the client is toggled like the TS3 event thread would, to measure
+// the time its callbacks spend in the plugin (TS3 callback time, expected to be a few microseconds).
+//
+// The run stops when the timeline is over or the maximum duration elapsed,
+// then the plugin statistics are printed (and, in debug builds, the number of
+// memory allocations made during the run, expected to be 0).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "stdafx.h"
+
+#include "public_errors.h"
+#include "public_definitions.h"
+#include "ts3_functions.h"
+#include "plugin.h"
+#include "buttonDebouncer.h"
+#include "flightRecorder.h"
+#include "hidTransport.h"
+#include "platform.h"
+#include "statistics.h"
+
+#define DEFAULT_SCRIPT "rate=20000 count=100000"
+#define DEFAULT_DURATION 30
+#define STATISTICS_BUFSIZE 2048
+
+// Time without any new event after which the timeline is considered over
+#define IDLE_TIMEOUT 1000000000ULL
+
+static unsigned int logMessage(const char* logMessage, enum LogLevel severity, const char* channel, uint64 logID)
+{
+	if (severity <= LogLevel_WARNING)
+		fprintf(stderr, "%s: %s\n", channel, logMessage);
+	return ERROR_ok;
+}
+
+static uint64 getCurrentServerConnectionHandlerID()
+{
+	return 1;
+}
+
+static unsigned int setClientSelfVariableAsInt(uint64 serverConnectionHandlerID, size_t flag, int value)
+{
+	return ERROR_ok;
+}
+
+static unsigned int flushClientSelfUpdates(uint64 serverConnectionHandlerID, const char* returnCode)
+{
+	return ERROR_ok;
+}
+
+static unsigned int getBookmarkList(struct PluginBookmarkList** list)
+{
+	static struct PluginBookmarkList emptyList;
+	*list = &emptyList;
+	return ERROR_ok;
+}
+
+static unsigned int guiConnectBookmark(enum PluginConnectTab connectTab, const char* bookmarkuuid, uint64* scHandlerID)
+{
+	return ERROR_ok;
+}
+
+static unsigned int freeMemory(void* pointer)
+{
+	return ERROR_ok;
+}
+
+static unsigned int getErrorMessage(unsigned int errorCode, char** error)
+{
+	static char message[] = "error";
+	*error = message;
+	return ERROR_ok;
+}
+
+static void printMessageToCurrentTab(const char* message)
+{
+	printf("%s\n", message);
+}
+
+static void setSimulatedDeviceScript(const char *script)
+{
+#ifdef _WIN32
+	_putenv_s(SIMULATED_DEVICE_VARIABLE, script);
+#else
+	setenv(SIMULATED_DEVICE_VARIABLE, script, 1);
+#endif
+}
+
+// The scripted timelines toggle the buttons far faster than a hand : the debounce is off
+// unless the environment sets it, the bench measures the raw pipeline
+static void disableDebounce()
+{
+	if (getenv(DEBOUNCE_VARIABLE) != NULL)
+		return;
+
+#ifdef _WIN32
+	_putenv_s(DEBOUNCE_VARIABLE, "0");
+#else
+	setenv(DEBOUNCE_VARIABLE, "0", 1);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+	struct TS3Functions functions;
+	char statistics[STATISTICS_BUFSIZE];
+	const char *script = argc > 1 ? argv[1] : DEFAULT_SCRIPT;
+	unsigned long long duration = (unsigned long long) (argc > 2 ? atoi(argv[2]) : DEFAULT_DURATION) * 1000000000ULL;
+	unsigned long long startTime, lastEventTime, now;
+	long long lastEvents = 0;
+	BOOL outputMuted = FALSE;
+#ifdef _DEBUG
+	long long startAllocations;
+#endif
+
+	setSimulatedDeviceScript(script);
+	disableDebounce();
+
+	memset(&functions, 0, sizeof(functions));
+	functions.logMessage = logMessage;
+	functions.getCurrentServerConnectionHandlerID = getCurrentServerConnectionHandlerID;
+	functions.setClientSelfVariableAsInt = setClientSelfVariableAsInt;
+	functions.flushClientSelfUpdates = flushClientSelfUpdates;
+	functions.getBookmarkList = getBookmarkList;
+	functions.guiConnectBookmark = guiConnectBookmark;
+	functions.freeMemory = freeMemory;
+	functions.getErrorMessage = getErrorMessage;
+	functions.printMessageToCurrentTab = printMessageToCurrentTab;
+	ts3plugin_setFunctionPointers(functions);
+
+	printf("Simulated device script: %s\n", script);
+	if (ts3plugin_init() != 0)
+	{
+		fprintf(stderr, "Plugin initialization failed\n");
+		return 1;
+	}
+
+#ifdef _DEBUG
+	// Everything allocated by the initialization, the run itself should not allocate
+	startAllocations = getPlatformAllocationCount();
+#endif
+	startTime = lastEventTime = getMonotonicTime();
+	do
+	{
+		long long events;
+
+		Sleep(100);
+		outputMuted = !outputMuted;
+		ts3plugin_onClientSelfVariableUpdateEvent(1, CLIENT_OUTPUT_MUTED, outputMuted ? "0" : "1", outputMuted ? "1" : "0");
+		now = getMonotonicTime();
+		events = getSimulatedEventsPlayed() + getSimulatedEventsDropped();
+		if (events != lastEvents)
+		{
+			lastEvents = events;
+			lastEventTime = now;
+		}
+	} while (now - lastEventTime < IDLE_TIMEOUT && now - startTime < duration);
+
+	formatStatistics(statistics, STATISTICS_BUFSIZE);
+	printf("duration: %.3fs\n", (double) (now - startTime) / 1e9);
+	printf("simulated events played: %lld\n", getSimulatedEventsPlayed());
+	printf("simulated events dropped: %lld\n", getSimulatedEventsDropped());
+	printf("%s", statistics);
+#ifdef _DEBUG
+	printf("allocations during the run: %lld\n", getPlatformAllocationCount() - startAllocations);
+#endif
+
+	if (argc > 3 && !dumpFlightRecorder(argv[3]))
+		fprintf(stderr, "Can't write the flight recorder dump %s\n", argv[3]);
+
+	ts3plugin_shutdown();
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Micro benchmarks of the button processing building blocks
+ * gamevoice_microbench.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Times the building blocks the device thread runs for every command, in a tight loop
+// over a pseudo random sequence of button states, and checks them against their plain definition.
+//
+// Usage : gamevoice_microbench [iterations]
+//   iterations  number of states processed by each benchmark (default 100000000)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "stdafx.h"
+
+#include "buttonTransitions.h"
+#include "gamevoice_functions.h"
+#include "platform.h"
+
+#define DEFAULT_ITERATIONS 100000000LL
+
+// Button states played in turn (power of two)
+#define STATE_COUNT 4096
+
+static byte states[STATE_COUNT];
+
+// Results are accumulated here so that the compiler keeps the work
+static volatile unsigned long long sink;
+
+// Checks the transitions of every pair of states against the bitwise definition
+static BOOL checkButtonTransitions(void)
+{
+	int previous, current, button, transition;
+
+	for (previous = 0; previous < 256; previous++)
+	{
+		for (current = 0; current < 256; current++)
+		{
+			ButtonTransitions transitions = getButtonTransitions((byte) previous, (byte) current);
+
+			if (transitions.pressed != (~previous & current) || transitions.released != (previous & ~current))
+				return FALSE;
+
+			// Every changed button once, from the lowest one
+			transition = 0;
+			for (button = 0; button < BUTTON_TRANSITIONS_MAX; button++)
+			{
+				if (!(((previous ^ current) >> button) & 1))
+					continue;
+
+				if (transition >= transitions.count || getTransitionButton(&transitions, transition) != button
+					|| isPressTransition(&transitions, transition) != ((current >> button) & 1))
+					return FALSE;
+				transition++;
+			}
+
+			if (transition != transitions.count)
+				return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+// Effective command of waitForCommand before the transition engine : one direction per command
+static size_t getLegacyEffectiveCommand(byte previous, byte current)
+{
+	byte command = previous ^ current;
+
+	if (command & COMMAND)
+		command = COMMAND;
+
+	if (command & current)
+		return current | ACTIVATED;
+	return command | DEACTIVATED;
+}
+
+static void printTiming(const char *name, unsigned long long startTime, long long iterations)
+{
+	printf("%-28s %6.2f ns/state\n", name, (double) (getMonotonicTime() - startTime) / (double) iterations);
+}
+
+int main(int argc, char **argv)
+{
+	long long iterations = argc > 1 ? atoll(argv[1]) : DEFAULT_ITERATIONS;
+	unsigned long long startTime, total;
+	unsigned int seed = 12345;
+	long long iteration;
+	int stateIndex;
+
+	if (iterations <= 0)
+	{
+		fprintf(stderr, "Usage: gamevoice_microbench [iterations]\n");
+		return 2;
+	}
+
+	for (stateIndex = 0; stateIndex < STATE_COUNT; stateIndex++)
+	{
+		seed = seed * 1103515245 + 12345;
+		states[stateIndex] = (byte) (seed >> 16);
+	}
+
+	if (!checkButtonTransitions())
+	{
+		fprintf(stderr, "Button transitions: /!\\ mismatch\n");
+		return 1;
+	}
+	printf("Button transitions: every pair of states checked\n");
+
+	total = 0;
+	startTime = getMonotonicTime();
+	for (iteration = 1; iteration <= iterations; iteration++)
+		total += getLegacyEffectiveCommand(states[(iteration - 1) & (STATE_COUNT - 1)], states[iteration & (STATE_COUNT - 1)]);
+	printTiming("legacy effective command", startTime, iterations);
+	sink = total;
+
+	total = 0;
+	startTime = getMonotonicTime();
+	for (iteration = 1; iteration <= iterations; iteration++)
+	{
+		ButtonTransitions transitions = getButtonTransitions(states[(iteration - 1) & (STATE_COUNT - 1)], states[iteration & (STATE_COUNT - 1)]);
+		total += transitions.pressed + transitions.released + transitions.order;
+	}
+	printTiming("button transitions", startTime, iterations);
+	sink = total;
+
+	// Transitions walked one by one, like a dispatcher handling every button event
+	total = 0;
+	startTime = getMonotonicTime();
+	for (iteration = 1; iteration <= iterations; iteration++)
+	{
+		ButtonTransitions transitions = getButtonTransitions(states[(iteration - 1) & (STATE_COUNT - 1)], states[iteration & (STATE_COUNT - 1)]);
+		int transition;
+
+		for (transition = 0; transition < transitions.count; transition++)
+			total += getTransitionButton(&transitions, transition) + isPressTransition(&transitions, transition);
+	}
+	printTiming("button transitions walked", startTime, iterations);
+	sink = total;
+
+	return 0;
+}
@@ -0,0 +1,479 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Offline replay of a flight recorder dump through the plugin
+ * gamevoice_replay.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Replays the input reports of a flight recorder dump (see flightRecorder.h) through the whole plugin
+// pipeline (HID worker thread, GameVoiceThread and TS3 actions) with the simulated devices,
+// against a stand-in TeamSpeak 3 client recording the calls the plugin makes.
+//
+// Usage : gamevoice_replay [--fast | --speed <factor>] [--layout <gamevoice|buttonbox>] [--calls <log>] [--expect <log>] <dump>
+//   --fast    replays as fast as the reports are read instead of at their recorded times :
+//             a stress test, the plugin may drop reports it can't dispatch in time
+//   --speed   replays that many times faster than recorded (default 1)
+//             The debounce (see buttonDebouncer.h) is off when replaying faster, unless the environment sets it :
+//             the presses come closer than its window and would be filtered. The gesture timings
+//             (see gestureRecognizer.h) are divided by the factor, unless the environment sets them.
+//   --layout  report layout of the recorded devices (default gamevoice)
+//   --calls   file the TS3 calls are written to, one per line
+//   --expect  TS3 calls log of a previous replay (or build) the calls are compared to
+//
+// The statistics printed at the end hold the dispatch timings of the replayed events
+// ("press to dispatch"). The exit code is 1 if the calls differ from the expected ones.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include "stdafx.h"
+
+#include "public_errors.h"
+#include "public_definitions.h"
+#include "ts3_functions.h"
+#include "plugin.h"
+#include "buttonDebouncer.h"
+#include "flightRecorder.h"
+#include "gestureRecognizer.h"
+#include "hidTransport.h"
+#include "platform.h"
+#include "statistics.h"
+
+#define SCRIPT_SIZE 512
+#define STATISTICS_BUFSIZE 2048
+
+// TS3 calls kept, the further ones are only counted
+#define MAX_CALLS 65536
+#define CALL_SIZE 96
+
+// Differences between the calls and the expected ones printed
+#define MAX_DIFFERENCES 10
+
+// Time without any new TS3 call or LED write after which the plugin is done with its startup,
+// or with the replay once every report is read
+#define SETTLE_TIME 200000000ULL
+
+// Time without any report read after which a fast replay is considered stuck
+#define IDLE_TIMEOUT 1000000000ULL
+
+// TS3 calls of the plugin, in the order they are made
+static char calls[MAX_CALLS][CALL_SIZE];
+static volatile long long callCount = 0;
+
+// Bookmarks of the stand-in client, the ones the plugin connects to. The list is allocated
+// with room for its items like the client does, the SDK declares a single one.
+#define BOOKMARK_COUNT 2
+static struct PluginBookmarkList *bookmarks = NULL;
+
+static void recordCall(const char *format, ...)
+{
+	long long call = addAtomic64(&callCount, 1) - 1;
+	va_list arguments;
+
+	if (call >= MAX_CALLS)
+		return;
+
+	va_start(arguments, format);
+	vsnprintf(calls[call], CALL_SIZE, format, arguments);
+	va_end(arguments);
+}
+
+static const char *getClientVariableName(size_t flag)
+{
+	switch (flag)
+	{
+	case CLIENT_INPUT_MUTED:
+		return "CLIENT_INPUT_MUTED";
+	case CLIENT_OUTPUT_MUTED:
+		return "CLIENT_OUTPUT_MUTED";
+	case CLIENT_AWAY:
+		return "CLIENT_AWAY";
+	case CLIENT_AWAY_MESSAGE:
+		return "CLIENT_AWAY_MESSAGE";
+	default:
+		return "?";
+	}
+}
+
+static unsigned int logMessage(const char* logMessage, enum LogLevel severity, const char* channel, uint64 logID)
+{
+	if (severity <= LogLevel_WARNING)
+		fprintf(stderr, "%s: %s\n", channel, logMessage);
+	return ERROR_ok;
+}
+
+static uint64 getCurrentServerConnectionHandlerID()
+{
+	return 1;
+}
+
+static unsigned int getServerConnectionHandlerList(uint64** result)
+{
+	static uint64 handlers[] = {1, 0};
+	*result = handlers;
+	return ERROR_ok;
+}
+
+static unsigned int getClientID(uint64 serverConnectionHandlerID, anyID* result)
+{
+	*result = 1;
+	return ERROR_ok;
+}
+
+static unsigned int setClientSelfVariableAsInt(uint64 serverConnectionHandlerID, size_t flag, int value)
+{
+	recordCall("setClientSelfVariableAsInt %llu %s %d", (unsigned long long) serverConnectionHandlerID, getClientVariableName(flag), value);
+	return ERROR_ok;
+}
+
+static unsigned int setClientSelfVariableAsString(uint64 serverConnectionHandlerID, size_t flag, const char* value)
+{
+	recordCall("setClientSelfVariableAsString %llu %s %s", (unsigned long long) serverConnectionHandlerID, getClientVariableName(flag), value);
+	return ERROR_ok;
+}
+
+static unsigned int flushClientSelfUpdates(uint64 serverConnectionHandlerID, const char* returnCode)
+{
+	recordCall("flushClientSelfUpdates %llu", (unsigned long long) serverConnectionHandlerID);
+	return ERROR_ok;
+}
+
+static unsigned int requestClientMove(uint64 serverConnectionHandlerID, anyID clientID, uint64 newChannelID, const char* password, const char* returnCode)
+{
+	recordCall("requestClientMove %llu %u %llu", (unsigned long long) serverConnectionHandlerID, clientID, (unsigned long long) newChannelID);
+	return ERROR_ok;
+}
+
+static unsigned int setPlaybackConfigValue(uint64 serverConnectionHandlerID, const char* ident, const char* value)
+{
+	recordCall("setPlaybackConfigValue %llu %s %s", (unsigned long long) serverConnectionHandlerID, ident, value);
+	return ERROR_ok;
+}
+
+static unsigned int getBookmarkList(struct PluginBookmarkList** list)
+{
+	*list = bookmarks;
+	return ERROR_ok;
+}
+
+static unsigned int guiConnectBookmark(enum PluginConnectTab connectTab, const char* bookmarkuuid, uint64* scHandlerID)
+{
+	recordCall("guiConnectBookmark %d %s", connectTab, bookmarkuuid);
+	return ERROR_ok;
+}
+
+static void notifyKeyEvent(const char *pluginID, const char *keyIdentifier, int up_down)
+{
+	recordCall("notifyKeyEvent %s %d", keyIdentifier, up_down);
+}
+
+static unsigned int freeMemory(void* pointer)
+{
+	return ERROR_ok;
+}
+
+static unsigned int getErrorMessage(unsigned int errorCode, char** error)
+{
+	static char message[] = "error";
+	*error = message;
+	return ERROR_ok;
+}
+
+static void printMessageToCurrentTab(const char* message)
+{
+	printf("%s\n", message);
+}
+
+static void setSimulatedDeviceScript(const char *script)
+{
+#ifdef _WIN32
+	_putenv_s(SIMULATED_DEVICE_VARIABLE, script);
+#else
+	setenv(SIMULATED_DEVICE_VARIABLE, script, 1);
+#endif
+}
+
+// Sets a timings environment variable, unless the environment already sets it
+static void setDefaultTimings(const char *variable, const char *timings)
+{
+	if (getenv(variable) != NULL)
+		return;
+
+#ifdef _WIN32
+	_putenv_s(variable, timings);
+#else
+	setenv(variable, timings, 1);
+#endif
+}
+
+// Fits the input timings of the plugin to a replay faster than recorded
+static void scaleTimings(long speed)
+{
+	char gestureTimings[SCRIPT_SIZE];
+
+	setDefaultTimings(DEBOUNCE_VARIABLE, "0");
+
+	snprintf(gestureTimings, SCRIPT_SIZE, "hold=%ld,double=%ld,chord=%ld",
+		DEFAULT_HOLD_TIME / speed, DEFAULT_DOUBLE_TAP_TIME / speed, DEFAULT_CHORD_TIME / speed);
+	setDefaultTimings(GESTURES_VARIABLE, gestureTimings);
+}
+
+// Gets the time between the first and the last input report of a dump
+static unsigned long long getRecordedDuration(const char *path)
+{
+	FlightRecorderFileHeader header;
+	FlightRecord record;
+	unsigned long long firstTime = 0, lastTime = 0;
+	unsigned int recordIndex;
+	FILE *file = openFlightRecorderDump(path, &header);
+
+	if (file == NULL)
+		return 0;
+
+	for (recordIndex = 0; recordIndex < header.recordCount && fread(&record, sizeof(record), 1, file) == 1; recordIndex++)
+	{
+		if (record.type != flightInputReport)
+			continue;
+
+		if (firstTime == 0)
+			firstTime = record.time;
+		lastTime = record.time;
+	}
+
+	fclose(file);
+	return lastTime - firstTime;
+}
+
+// Writes the TS3 calls made, one per line
+static BOOL writeCalls(const char *path, long long count)
+{
+	FILE *file = fopen(path, "w");
+	long long call;
+	BOOL written;
+
+	if (file == NULL)
+		return FALSE;
+
+	for (call = 0; call < count; call++)
+		fprintf(file, "%s\n", calls[call]);
+
+	written = !ferror(file);
+	return fclose(file) == 0 && written;
+}
+
+// Compares the TS3 calls made to the ones of a log, line by line.
+// Returns the number of differing lines, -1 if the log can't be read.
+static long long compareCalls(const char *path, long long count)
+{
+	char expected[CALL_SIZE + 2];
+	long long call = 0, differences = 0;
+	FILE *file = fopen(path, "r");
+
+	if (file == NULL)
+		return -1;
+
+	while (fgets(expected, sizeof(expected), file) != NULL)
+	{
+		expected[strcspn(expected, "\r\n")] = '\0';
+		if (call >= count || strcmp(expected, calls[call]) != 0)
+		{
+			if (differences < MAX_DIFFERENCES)
+				printf("call %lld: expected \"%s\", got \"%s\"\n", call + 1, expected, call < count ? calls[call] : "(none)");
+			differences++;
+		}
+		call++;
+	}
+	fclose(file);
+
+	for (; call < count; call++)
+	{
+		if (differences < MAX_DIFFERENCES)
+			printf("call %lld: expected (none), got \"%s\"\n", call + 1, calls[call]);
+		differences++;
+	}
+
+	return differences;
+}
+
+static void printUsage(void)
+{
+	fprintf(stderr, "Usage: gamevoice_replay [--fast | --speed <factor>] [--layout <gamevoice|buttonbox>] [--calls <log>] [--expect <log>] <dump>\n");
+}
+
+int main(int argc, char **argv)
+{
+	struct TS3Functions functions;
+	char statistics[STATISTICS_BUFSIZE];
+	char script[SCRIPT_SIZE];
+	const char *layout = "gamevoice";
+	const char *callsPath = NULL;
+	const char *expectedPath = NULL;
+	const char *dumpPath = NULL;
+	struct PluginBookmarkItem *bookmarkItems;
+	BOOL fast = FALSE;
+	long speed = 1;
+	unsigned long long startTime, lastActivityTime, now;
+	long long replayed, lastReplayed = 0, lastCalls = 0, count, differences = 0;
+	int argument;
+
+	for (argument = 1; argument < argc; argument++)
+	{
+		if (strcmp(argv[argument], "--fast") == 0)
+			fast = TRUE;
+		else if (strcmp(argv[argument], "--speed") == 0 && argument + 1 < argc && (speed = atol(argv[argument + 1])) >= 1)
+			argument++;
+		else if (strcmp(argv[argument], "--layout") == 0 && argument + 1 < argc)
+			layout = argv[++argument];
+		else if (strcmp(argv[argument], "--calls") == 0 && argument + 1 < argc)
+			callsPath = argv[++argument];
+		else if (strcmp(argv[argument], "--expect") == 0 && argument + 1 < argc)
+			expectedPath = argv[++argument];
+		else if (argv[argument][0] != '-' && dumpPath == NULL)
+			dumpPath = argv[argument];
+		else
+		{
+			printUsage();
+			return 2;
+		}
+	}
+
+	if (dumpPath == NULL)
+	{
+		printUsage();
+		return 2;
+	}
+
+	snprintf(script, SCRIPT_SIZE, "replay=%s layout=%s speed=%ld%s", dumpPath, layout, speed, fast ? " rate=0" : "");
+	setSimulatedDeviceScript(script);
+	if (speed > 1)
+		scaleTimings(speed);
+	else if (fast)
+		setDefaultTimings(DEBOUNCE_VARIABLE, "0");
+
+	bookmarks = (struct PluginBookmarkList *) calloc(1, sizeof(struct PluginBookmarkList) + (BOOKMARK_COUNT - 1) * sizeof(struct PluginBookmarkItem));
+	if (bookmarks == NULL)
+		return 1;
+	bookmarkItems = bookmarks->items;
+	bookmarks->itemcount = BOOKMARK_COUNT;
+	bookmarkItems[0].name = "TEAM";
+	bookmarkItems[0].uuid = "team";
+	bookmarkItems[1].name = "ALL";
+	bookmarkItems[1].uuid = "all";
+
+	memset(&functions, 0, sizeof(functions));
+	functions.logMessage = logMessage;
+	functions.getCurrentServerConnectionHandlerID = getCurrentServerConnectionHandlerID;
+	functions.getServerConnectionHandlerList = getServerConnectionHandlerList;
+	functions.getClientID = getClientID;
+	functions.setClientSelfVariableAsInt = setClientSelfVariableAsInt;
+	functions.setClientSelfVariableAsString = setClientSelfVariableAsString;
+	functions.flushClientSelfUpdates = flushClientSelfUpdates;
+	functions.requestClientMove = requestClientMove;
+	functions.setPlaybackConfigValue = setPlaybackConfigValue;
+	functions.getBookmarkList = getBookmarkList;
+	functions.guiConnectBookmark = guiConnectBookmark;
+	functions.notifyKeyEvent = notifyKeyEvent;
+	functions.freeMemory = freeMemory;
+	functions.getErrorMessage = getErrorMessage;
+	functions.printMessageToCurrentTab = printMessageToCurrentTab;
+	ts3plugin_setFunctionPointers(functions);
+	ts3plugin_registerPluginID("gamevoice_replay");
+
+	printf("Simulated device script: %s\n", script);
+	if (ts3plugin_init() != 0)
+	{
+		fprintf(stderr, "Plugin initialization failed\n");
+		return 1;
+	}
+
+	if (getSimulatedReplayEventCount() == 0)
+	{
+		fprintf(stderr, "Nothing to replay from %s\n", dumpPath);
+		ts3plugin_shutdown();
+		return 1;
+	}
+
+	// The startup LED chase done, the replay starts with the plugin waiting for the devices
+	lastActivityTime = getMonotonicTime();
+	do
+	{
+		Sleep(10);
+		now = getMonotonicTime();
+		count = loadAtomic64(&callCount) + getStatistic(STATISTIC_FEATURES_SUBMITTED) + getStatistic(STATISTIC_LAYER_WRITES);
+		if (count != lastCalls)
+		{
+			lastCalls = count;
+			lastActivityTime = now;
+		}
+	} while (now - lastActivityTime < SETTLE_TIME);
+
+	resetStatistics();
+	startSimulatedReplay();
+
+	// Every report read, then the dispatch settled : no more TS3 calls
+	lastCalls = loadAtomic64(&callCount);
+	startTime = lastActivityTime = getMonotonicTime();
+	do
+	{
+		Sleep(10);
+		now = getMonotonicTime();
+		replayed = getSimulatedEventsPlayed() + getSimulatedEventsDropped();
+		count = loadAtomic64(&callCount);
+		if (replayed != lastReplayed || count != lastCalls)
+		{
+			lastReplayed = replayed;
+			lastCalls = count;
+			lastActivityTime = now;
+		}
+	} while (replayed < getSimulatedReplayEventCount() ? !fast || now - lastActivityTime < IDLE_TIMEOUT : now - lastActivityTime < SETTLE_TIME);
+
+	count = loadAtomic64(&callCount);
+	formatStatistics(statistics, STATISTICS_BUFSIZE);
+	printf("replay duration: %.3fs (recorded %.3fs)\n", (double) (now - startTime) / 1e9, (double) getRecordedDuration(dumpPath) / 1e9);
+	printf("input reports replayed: %lld of %lld\n", getSimulatedEventsPlayed(), getSimulatedReplayEventCount());
+	printf("input reports dropped: %lld\n", getSimulatedEventsDropped());
+	printf("TS3 calls: %lld\n", count);
+	printf("%s", statistics);
+	ts3plugin_shutdown();
+	free(bookmarks);
+
+	if (count > MAX_CALLS)
+	{
+		fprintf(stderr, "Only the first %d TS3 calls are kept\n", MAX_CALLS);
+		count = MAX_CALLS;
+	}
+
+	if (callsPath != NULL && !writeCalls(callsPath, count))
+		fprintf(stderr, "Can't write the TS3 calls to %s\n", callsPath);
+
+	if (expectedPath != NULL)
+	{
+		differences = compareCalls(expectedPath, count);
+		if (differences < 0)
+			fprintf(stderr, "Can't read the expected TS3 calls %s\n", expectedPath);
+		else if (differences > 0)
+			printf("%lld TS3 calls differ from %s\n", differences, expectedPath);
+		else
+			printf("TS3 calls match %s\n", expectedPath);
+	}
+
+	return differences != 0 ? 1 : 0;
+}
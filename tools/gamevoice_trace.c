@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2012-2019 JoeBilly
+ *
+ * Decoder of the HID transaction flight recorder dumps
+ * gamevoice_trace.c
+ * JoeBilly (joebilly@users.sourceforge.net)
+ * https://github.com/ghoebilly/ts3gamevoice
+ *
+ *  This file is part of TeamSpeak 3 SideWinder Game Voice Plugin.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is free software:
+ *	you can redistribute it and/or modify it under the terms of the
+ *	GNU General Public License as published by the Free Software Foundation,
+ *	either version 3 of the License, or (at your option) any later version.
+ *
+ *  TeamSpeak 3 SideWinder Game Voice Plugin is distributed in the hope
+ *  that it will be useful, but WITHOUT ANY WARRANTY; without even the
+ *  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with TeamSpeak 3 SideWinder Game Voice Plugin.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Prints the transactions of a flight recorder dump (see flightRecorder.h), one per line,
+// or converts them to CSV for analysis in a spreadsheet or a script.
+//
+// Usage : gamevoice_trace [--csv] <dump>
+//
+// Times are relative to the first transaction of the dump. The report bytes are the ones
+// recorded, from the report ID byte : the tail of the long reports is not kept,
+// and the trailing zero bytes are only printed in CSV.
+
+#include <stdio.h>
+#include "stdafx.h"
+
+#include "flightRecorder.h"
+
+// Prints the first report bytes of a record in hexadecimal
+static void printReport(const FlightRecord *record, int byteCount)
+{
+	int byteIndex;
+
+	for (byteIndex = 0; byteIndex < byteCount && byteIndex < FLIGHT_RECORD_DATA_SIZE; byteIndex++)
+		printf(byteIndex == 0 ? "%02x" : " %02x", record->data[byteIndex]);
+}
+
+static void printRecord(const FlightRecord *record, unsigned long long startTime, BOOL csv)
+{
+	double time = (double) (record->time - startTime) / 1e6;
+
+	if (csv)
+	{
+		printf("%llu,%.6f,%u,%s,%s,%u,", record->sequence, time, record->deviceIndex,
+			getFlightRecordTypeName(record->type), getFlightRecordResultName(record->result), record->reportLength);
+		printReport(record, record->dataLength);
+		printf("\n");
+		return;
+	}
+
+	printf("%10llu %14.6fms  device %2u  %-11s %-9s", record->sequence, time, record->deviceIndex,
+		getFlightRecordTypeName(record->type), getFlightRecordResultName(record->result));
+	if (record->dataLength != 0)
+	{
+		// The trailing zero bytes are left out, the report ID and the first data byte are always printed
+		int byteCount = record->dataLength;
+
+		while (byteCount > 2 && record->data[byteCount - 1] == 0)
+			byteCount--;
+
+		printf(" [%u] ", record->reportLength);
+		printReport(record, byteCount);
+		if ((unsigned int) byteCount < record->reportLength)
+			printf(" ...");
+	}
+	printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+	FlightRecorderFileHeader header;
+	FlightRecord record;
+	unsigned long long startTime = 0;
+	unsigned int recordIndex;
+	BOOL csv = argc > 2 && strcmp(argv[1], "--csv") == 0;
+	const char *path = argv[argc - 1];
+	FILE *file;
+
+	if (argc < 2 || (argc > 2 && !csv) || argc > 3)
+	{
+		fprintf(stderr, "Usage: gamevoice_trace [--csv] <dump>\n");
+		return 2;
+	}
+
+	file = openFlightRecorderDump(path, &header);
+	if (file == NULL)
+	{
+		fprintf(stderr, "Can't read %s, or it is not a version %u flight recorder dump\n", path, FLIGHT_RECORDER_VERSION);
+		return 1;
+	}
+
+	if (csv)
+		printf("sequence,time_ms,device,type,result,length,report\n");
+	else
+		printf("%u transactions\n", header.recordCount);
+
+	for (recordIndex = 0; recordIndex < header.recordCount; recordIndex++)
+	{
+		if (fread(&record, sizeof(record), 1, file) != 1)
+		{
+			fprintf(stderr, "%s: truncated after %u transactions\n", path, recordIndex);
+			fclose(file);
+			return 1;
+		}
+
+		if (recordIndex == 0)
+			startTime = record.time;
+		printRecord(&record, startTime, csv);
+	}
+
+	fclose(file);
+	return 0;
+}